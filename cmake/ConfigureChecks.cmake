@@ -121,7 +121,7 @@ IF (WINDOWS)
   SET (USE_INCLUDES ${USE_INCLUDES} "windows.h")
 ENDIF (WINDOWS)
 
-TEST_BIG_ENDIAN(EAVL_WORDS_BIGENDIAN)
+TEST_BIG_ENDIAN(WORDS_BIGENDIAN)
 
 #-----------------------------------------------------------------------------
 # Check IF header file exists and add it to the list.
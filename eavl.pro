@@ -33,8 +33,10 @@ SOURCES += \
     src/common/eavlExecutor.cpp \
     src/common/eavlFlatArray.cpp \
     src/common/eavlLogicalStructure.cpp \
+    src/common/eavlMappedFile.cpp \
     src/common/eavlNewIsoTables.cpp \
     src/common/eavlOperation.cpp \
+    src/common/eavlThreadPool.cpp \
     src/common/eavlTimer.cpp \
     src/common/eavlUtility.cpp \
     src/exporters/eavlPNMExporter.cpp \
@@ -45,10 +47,11 @@ SOURCES += \
     src/filters/eavlElevateMutator.cpp \
     src/filters/eavlExternalFaceMutator.cpp \
     src/filters/eavlIsosurfaceFilter.cu \
+    src/filters/eavlIsosurfaceIndex.cpp \
     src/filters/eavlScalarBinFilter.cu \
     src/filters/eavlSurfaceNormalMutator.cu \
     src/filters/eavlTesselate2DFilter.cpp \
-    src/filters/eavlThresholdMutator.cpp \
+    src/filters/eavlThresholdMutator.cu \
     src/filters/eavlTransformMutator.cu \
     src/filters/eavlUnaryMathMutator.cu \
     src/fonts/Liberation2Mono.cpp \
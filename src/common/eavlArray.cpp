@@ -1,10 +1,21 @@
 // Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
 #include "eavlArray.h"
+#include "eavlImplicitArray.h"
 
 template<> const char *eavlConcreteArray<int>::GetBasicType() const { return "int"; }
 template<> const char *eavlConcreteArray<byte>::GetBasicType() const { return "byte"; }
 template<> const char *eavlConcreteArray<float>::GetBasicType() const { return "float"; }
 
+unsigned long
+eavlArray::NewStamp()
+{
+    static unsigned long laststamp = 0;
+    unsigned long stamp;
+#pragma omp critical(eavlArrayNewStamp)
+    stamp = ++laststamp;
+    return stamp;
+}
+
 eavlArray *
 eavlArray::CreateObjFromName(const string &nm)
 {
@@ -14,6 +25,18 @@ eavlArray::CreateObjFromName(const string &nm)
 	return new eavlConcreteArray<byte>("");
     else if (nm == "eavlConcreteArray<int>")
 	return new eavlConcreteArray<int>("");
+    else if (nm == "eavlConstantArray<float>")
+	return new eavlConstantArray<float>("");
+    else if (nm == "eavlConstantArray<int>")
+	return new eavlConstantArray<int>("");
+    else if (nm == "eavlCountingArray<float>")
+	return new eavlCountingArray<float>("");
+    else if (nm == "eavlCountingArray<int>")
+	return new eavlCountingArray<int>("");
+    else if (nm == "eavlUniformArray<float>")
+	return new eavlUniformArray<float>("");
+    else if (nm == "eavlCartesianProductArray<float>")
+	return new eavlCartesianProductArray<float>("");
     else
 	throw;
 }
@@ -7,6 +7,8 @@
 #include "eavlException.h"
 #include "eavlCUDA.h"
 #include "eavlSerialize.h"
+#include "eavlMappedFile.h"
+#include "eavlReferenceCounted.h"
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -34,16 +36,60 @@
 // Creation:    February 14, 2011
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Cache the per-component and magnitude ranges.  They are computed
+//   by a parallel reduction over the raw values on the first query,
+//   and recomputed only after something may have written the array.
+//
+//   agent, October 17, 2026
+//   Added a modification stamp, so other structures derived from the
+//   values can tell when they are stale.
+//
+//   agent, October 17, 2026
+//   Added ShareHostArray.
+//
+//   agent, October 17, 2026
+//   Made reference counted, so fields of several data sets can share one.
+//
+//   agent, October 17, 2026
+//   Added GetConstHostArray, GetConstCUDAArray and GetConstRawPointer,
+//   for reading the values without discarding the cached ranges.
+//
+//   agent, October 17, 2026
+//   Added GetHostStorage, so arrays sharing their values can be found.
+//
 // ****************************************************************************
-class eavlArray
+class eavlArray : public eavlReferenceCounted
 {
   protected:
     string        name;
     int           ncomponents;
+
+    bool           rangesValid;
+    unsigned long  modificationStamp;
+    bool           stampCurrent;
+    static unsigned long NewStamp();
+    vector<double> componentMins;
+    vector<double> componentMaxs;
+    double         magnitudeMin;
+    double         magnitudeMax;
+    ///\brief Fill in componentMins, componentMaxs, magnitudeMin and
+    /// magnitudeMax from the current values.
+    virtual void   ComputeRanges() = 0;
+    void UpdateRanges()
+    {
+        if (!rangesValid)
+        {
+            ComputeRanges();
+            rangesValid = true;
+        }
+    }
   public:
     eavlArray(const string &n,     ///< name
               int nc = 1)          ///< number of components
-        : name(n)
+        : name(n), rangesValid(false), modificationStamp(0),
+          stampCurrent(false),
+          magnitudeMin(0), magnitudeMax(0)
     {
         SetNumberOfComponents(nc);
     }
@@ -57,6 +103,7 @@ class eavlArray
     virtual eavlStream& deserialize(eavlStream &s)
     {
 	s >> name >> ncomponents;
+	InvalidateRanges();
 	return s;
     }
 
@@ -70,6 +117,7 @@ class eavlArray
     }
     virtual eavlArray *Create(const string &n, int nc = 1, int nt = 0) = 0;
     virtual const char *GetBasicType() const = 0;
+    virtual int    GetBasicTypeSize() const = 0;
     virtual void   SetNumberOfTuples(int) = 0;
     virtual int    GetNumberOfTuples() const = 0;
     virtual double GetComponentAsDouble(
@@ -85,6 +133,31 @@ class eavlArray
     virtual void *GetCUDAArray() {THROW(eavlException,"CUDA not available");}
 #endif
     virtual void *GetHostArray() = 0;
+    ///\brief The host or device values, for reading only.  Unlike
+    /// GetHostArray and GetCUDAArray, these don't discard the cached
+    /// ranges or change the modification stamp, so arrays which are only
+    /// read keep them, and operations running at the same time can read
+    /// the same array.
+    virtual const void *GetConstHostArray() = 0;
+#ifdef HAVE_CUDA
+    virtual const void *GetConstCUDAArray() = 0;
+#else
+    virtual const void *GetConstCUDAArray() {THROW(eavlException,"CUDA not available");}
+#endif
+    ///\brief Read the host values of another array of the same type and
+    /// number of components, without copying them, until this is called
+    /// again.  Like an externally-provided array, this one can't then be
+    /// written or resized, and the other array must outlive the sharing
+    /// (or at least keep its values where they are).
+    virtual void ShareHostArray(eavlArray *source) = 0;
+    ///\brief The bytes holding the host values, as they are now (without
+    /// moving them to the host), or NULL if there are none.  Different
+    /// arrays whose ranges overlap share values, e.g. through
+    /// ShareHostArray or being given the same external memory.
+    virtual void GetHostStorage(const char *&begin, const char *&end) const
+    {
+        begin = end = NULL;
+    }
     ///\todo: Refresh is a little odd; we're using it for CUDA-based
     /// in situ where we need some way of forcing it to assume the 
     /// device data has been updated and force new data back to the host.
@@ -96,6 +169,13 @@ class eavlArray
         else
             return GetCUDAArray();
     }
+    const void *GetConstRawPointer(Location loc)
+    {
+        if (loc == HOST)
+            return GetConstHostArray();
+        else
+            return GetConstCUDAArray();
+    }
 
     virtual long long GetMemoryUsage()
     {
@@ -135,54 +215,68 @@ class eavlArray
         return sqrt(mymag);
     }
 
-    double GetComponentWiseMin()
+    ///\brief Discard the cached ranges.  Anything which may write the
+    /// values (including handing out the raw host or device pointer,
+    /// except through the const accessors) calls this, so callers only
+    /// need it after writing through a pointer they kept from earlier.
+    void InvalidateRanges()
     {
-        int nt = GetNumberOfTuples();
-        double mymin = +DBL_MAX;
-        for (int i=0; i<nt; i++)
+        rangesValid = false;
+        stampCurrent = false;
+    }
+    ///\brief A stamp which changes whenever the values may have been
+    /// written (i.e. the ranges were invalidated) since it was last
+    /// asked for.  Stamps are unique across all arrays, so a structure
+    /// built from an array's values is still current if the array
+    /// returns the same stamp.
+    unsigned long GetModificationStamp()
+    {
+        if (!stampCurrent)
         {
-            double v = GetTupleMin(i);
-            if (v < mymin)
-                mymin = v;
+            modificationStamp = NewStamp();
+            stampCurrent = true;
         }
+        return modificationStamp;
+    }
+    /// The ranges below ignore NaN values.  Those of an empty array are
+    /// +DBL_MAX for the minima, -DBL_MAX for the component maxima, and
+    /// 0 for the magnitude maximum.
+    double GetComponentMin(int c)
+    {
+        UpdateRanges();
+        return componentMins[c];
+    }
+    double GetComponentMax(int c)
+    {
+        UpdateRanges();
+        return componentMaxs[c];
+    }
+    double GetComponentWiseMin()
+    {
+        UpdateRanges();
+        double mymin = +DBL_MAX;
+        for (int j=0; j<ncomponents; j++)
+            mymin = std::min(mymin, componentMins[j]);
         return mymin;
     }
     double GetComponentWiseMax()
     {
-        int nt = GetNumberOfTuples();
+        UpdateRanges();
         double mymax = -DBL_MAX;
-        for (int i=0; i<nt; i++)
-        {
-            double v = GetTupleMax(i);
-            if (v > mymax)
-                mymax = v;
-        }
+        for (int j=0; j<ncomponents; j++)
+            mymax = std::max(mymax, componentMaxs[j]);
         return mymax;
     }
 
     double GetMagnitudeMin()
     {
-        int nt = GetNumberOfTuples();
-        double mymin = +DBL_MAX;
-        for (int i=0; i<nt; i++)
-        {
-            double v = GetTupleMagnitude(i);
-            if (v < mymin)
-                mymin = v;
-        }
-        return mymin;
+        UpdateRanges();
+        return magnitudeMin;
     }
     double GetMagnitudeMax()
     {
-        int nt = GetNumberOfTuples();
-        double mymax = 0;
-        for (int i=0; i<nt; i++)
-        {
-            double v = GetTupleMagnitude(i);
-            if (v > mymax)
-                mymax = v;
-        }
-        return mymax;
+        UpdateRanges();
+        return magnitudeMax;
     }
 
     void PrintSummary(ostream &out)
@@ -224,6 +318,91 @@ class eavlArray
     }
 };
 
+// ****************************************************************************
+// Class:  eavlStridedView
+//
+// Purpose:
+///   A typed, non-virtual view of n elements in host memory, element i
+///   starting at values[i*stride].  In a view of a whole array the
+///   stride is the number of components, so (i,c) is component c of
+///   tuple i; in a view of one component of an array, [i] is that
+///   component of tuple i.  Loops over a view are plain loads and
+///   stores the compiler can inline and vectorize, which loops calling
+///   the virtual GetComponentAsDouble for every value are not.  T is
+///   const for read-only views.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlStridedView
+{
+    typedef T type;
+    T   *values;
+    int  stride;
+    int  n;
+
+    eavlStridedView(T *v, int s, int count) : values(v), stride(s), n(count)
+    {
+    }
+    int size() const
+    {
+        return n;
+    }
+    T &operator[](int i) const
+    {
+        return values[i*stride];
+    }
+    T &operator()(int i, int c) const
+    {
+        return values[i*stride + c];
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlGenericView
+//
+// Purpose:
+///   A read-only view with the interface of eavlStridedView over an array
+///   of any kind, reading each value with GetComponentAsDouble.  It is
+///   what eavlDispatchView passes for arrays it has no typed view of, so
+///   loops written against views still work on them, just without the
+///   speed of a typed view.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlGenericView
+{
+    typedef double type;
+    eavlArray *array;
+    int        component;
+    int        stride;
+    int        n;
+
+    eavlGenericView(eavlArray *a, int c)
+        : array(a), component(c), stride(a->GetNumberOfComponents()),
+          n(a->GetNumberOfTuples())
+    {
+    }
+    int size() const
+    {
+        return n;
+    }
+    double operator[](int i) const
+    {
+        return array->GetComponentAsDouble(i, component);
+    }
+    double operator()(int i, int c) const
+    {
+        return array->GetComponentAsDouble(i, component + c);
+    }
+};
+
 // ****************************************************************************
 // Class:  eavlConcreteArray
 //
@@ -244,6 +423,15 @@ class eavlArray
 //   Allow externally-provided device arrays, for tightly-coupled in situ for
 //   CUDA-based codes.  Changed method signature to specify the location.
 //
+//   agent, October 17, 2026
+//   Allow host arrays backed by a memory-mapped file region, either
+//   read-only or copy-on-write, so importers can hand out file contents
+//   without reading them into heap memory.
+//
+//   agent, October 17, 2026
+//   Added ShareHostArray, to point an existing array at another's host
+//   values, e.g. for re-running a captured plan over new data.
+//
 // ****************************************************************************
 template<class T>
 class eavlConcreteArray : public eavlArray
@@ -255,6 +443,47 @@ class eavlConcreteArray : public eavlArray
     T *host_values_external;
     int provided_ntuples;
     bool host_provided; ///< we don't own the host array, it was given to us, and we cannot write to it
+    eavlMappedFile *host_mapping; ///< if set, the provided host array is this file region, writable if copy-on-write
+    bool HostWritable() const
+    {
+        return !host_provided || (host_mapping && host_mapping->IsWritable());
+    }
+    T *HostValues()
+    {
+        if (host_provided)
+            return host_values_external;
+        else if (host_values_self.empty())
+            return NULL;
+        else
+            return &(host_values_self[0]);
+    }
+    void MapHostValues(const string &filename, size_t offset,
+                       eavlMappedFile::Mode mode, int nt)
+    {
+        eavlMappedFile *m = new eavlMappedFile(filename, offset,
+                                               sizeof(T)*ncomponents*nt, mode);
+        ReleaseHostMapping();
+        vector<T>().swap(host_values_self);
+        InvalidateRanges();
+        host_mapping = m;
+        host_values_external = (T*)m->GetData();
+        provided_ntuples = nt;
+        host_provided = true;
+#ifdef HAVE_CUDA
+        host_dirty = true;
+        device_dirty = false;
+#endif
+    }
+    void ReleaseHostMapping()
+    {
+        if (!host_mapping)
+            return;
+        delete host_mapping;
+        host_mapping = NULL;
+        host_values_external = NULL;
+        provided_ntuples = -1;
+        host_provided = false;
+    }
 #ifdef HAVE_CUDA
     bool device_provided; ///< we don't own the dev array, it was given to us, and we cannot write to it
     bool host_dirty;
@@ -262,7 +491,7 @@ class eavlConcreteArray : public eavlArray
     T *device_values;
     void NeedToUseOnHost()
     {
-        if (host_provided)
+        if (host_provided && !HostWritable())
         {
             // nothing to do
             return;
@@ -279,8 +508,8 @@ class eavlConcreteArray : public eavlArray
 #ifdef DEBUG_ARRAY_TRANSFERS
             cerr << "Transferring "<<name<<" array to host\n";
 #endif
-            int nbytes = host_values_self.size() * sizeof(T);
-            cudaMemcpy(&(host_values_self[0]), device_values,
+            int nbytes = GetNumberOfTuples() * ncomponents * sizeof(T);
+            cudaMemcpy(HostValues(), device_values,
                        nbytes, cudaMemcpyDeviceToHost);
             CUDA_CHECK_ERROR();
         }
@@ -294,7 +523,7 @@ class eavlConcreteArray : public eavlArray
             // nothing to do
             return;
         }
-        int nbytes = host_values_self.size() * sizeof(T);
+        int nbytes = GetNumberOfTuples() * ncomponents * sizeof(T);
         if (device_values == NULL)
         {
             CUDA_CHECK_ERROR();
@@ -315,7 +544,7 @@ class eavlConcreteArray : public eavlArray
 #ifdef DEBUG_ARRAY_TRANSFERS
             cerr << "Transferring "<<name<<" array to device\n";
 #endif
-            cudaMemcpy(device_values, &(host_values_self[0]),
+            cudaMemcpy(device_values, HostValues(),
                        nbytes, cudaMemcpyHostToDevice);
             CUDA_CHECK_ERROR();
         }
@@ -324,6 +553,7 @@ class eavlConcreteArray : public eavlArray
     }
     void MarkAsDirty(eavlArray::Location loc)
     {
+        InvalidateRanges();
         if (loc == eavlArray::DEVICE)
         {
             device_dirty = true;
@@ -339,11 +569,12 @@ class eavlConcreteArray : public eavlArray
 #else
     void NeedToUseOnHost() const {}
     void NeedToUseOnDevice() const {}
-    void MarkAsDirty(eavlArray::Location) {}
+    void MarkAsDirty(eavlArray::Location) { InvalidateRanges(); }
 #endif
   public:
     eavlConcreteArray(const string &n, int nc = 1, int nt = 0) : eavlArray(n,nc)
     {
+        host_mapping = NULL;
         host_values_external = NULL;
         provided_ntuples = -1;
         host_provided = false;
@@ -362,6 +593,7 @@ class eavlConcreteArray : public eavlArray
     eavlConcreteArray(eavlArray::Location loc, T *extarray,
                       const string &n, int nc, int nt) : eavlArray(n,nc)
     {
+        host_mapping = NULL;
         provided_ntuples = nt;
 
         if (loc == eavlArray::HOST)
@@ -391,8 +623,30 @@ class eavlConcreteArray : public eavlArray
 #endif
         }
     }
+    ///\brief Create an array whose host values are nt tuples of nc
+    /// components of type T, stored natively at the given byte offset
+    /// in a file, which is mapped rather than read.  A READONLY array
+    /// may not be written; a COPYONWRITE one may, without changing the
+    /// file.  Neither may be resized.
+    eavlConcreteArray(const string &filename, size_t offset,
+                      eavlMappedFile::Mode mode,
+                      const string &n, int nc, int nt) : eavlArray(n,nc)
+    {
+        host_mapping = NULL;
+        host_values_external = NULL;
+        provided_ntuples = -1;
+        host_provided = false;
+#ifdef HAVE_CUDA
+        device_provided = false;
+        host_dirty = false;
+        device_dirty = false;
+        device_values = NULL;
+#endif
+        MapHostValues(filename, offset, mode, nt);
+    }
     virtual ~eavlConcreteArray()
     {
+        ReleaseHostMapping();
 #ifdef HAVE_CUDA
         if (device_values)
             cudaFree(device_values);
@@ -408,31 +662,115 @@ class eavlConcreteArray : public eavlArray
     {
 	s << className();
 	eavlArray::serialize(s);
-	s << provided_ntuples << host_provided;
-	s << host_values_self;
+	// provided and mapped host values are written out like our own;
+	// the stream must not depend on memory or files that may be gone
+	// when it is read
+	int ntuples = -1;
+	bool provided = false;
+	s << ntuples << provided;
+	if (host_provided)
+	{
+	    size_t sz = ncomponents * provided_ntuples;
+	    s << sz;
+	    if (sz > 0)
+		s.write((const char*)host_values_external, sz*sizeof(T));
+	}
+	else
+	{
+	    s << host_values_self;
+	}
 	return s;
     }
     virtual eavlStream& deserialize(eavlStream &s)
     {
 	eavlArray::deserialize(s);
+	ReleaseHostMapping();
 	s >> provided_ntuples >> host_provided;
-	s >> host_values_self;
+	provided_ntuples = -1;
+	host_provided = false;
+	host_values_external = NULL;
+
+	// when the stream is reading a file we can map, and the values
+	// are suitably aligned in it, map them instead of reading them
+	size_t sz;
+	s >> sz;
+	std::streamoff offset = s.CanMap() ? (std::streamoff)s.tellg() : -1;
+	if (sz > 0 && ncomponents > 0 && offset >= 0 &&
+	    offset % sizeof(T) == 0)
+	{
+	    MapHostValues(s.GetMapFileName(), offset,
+			  s.GetMapCopyOnWrite() ? eavlMappedFile::COPYONWRITE
+						: eavlMappedFile::READONLY,
+			  sz / ncomponents);
+	    s.seekg(sz*sizeof(T), std::ios::cur);
+	}
+	else
+	{
+	    host_values_self.resize(sz);
+	    if (sz > 0)
+		s.read((char*)&(host_values_self[0]), sz*sizeof(T));
+	}
 	return s;
     }
     virtual const char *GetBasicType() const;
+    virtual int GetBasicTypeSize() const
+    {
+        return sizeof(T);
+    }
     virtual void *GetHostArray() ///\todo: we might like to make this return const
     {
         NeedToUseOnHost();
+        InvalidateRanges();
+        return HostValues();
+    }
+    virtual const void *GetConstHostArray()
+    {
+        NeedToUseOnHost();
+        return HostValues();
+    }
+    virtual void ShareHostArray(eavlArray *source)
+    {
+        eavlConcreteArray<T> *src = dynamic_cast<eavlConcreteArray<T>*>(source);
+        if (!src || src->ncomponents != ncomponents)
+            THROW(eavlException, "Can only share the host values of an array "
+                  "of the same type and number of components");
+        if (src == this)
+            return;
+        src->NeedToUseOnHost();
+        int nt = src->GetNumberOfTuples();
+        T *values = src->HostValues();
+        ReleaseHostMapping();
+        vector<T>().swap(host_values_self);
+        InvalidateRanges();
+        host_values_external = values;
+        host_provided = true;
+#ifdef HAVE_CUDA
+        if (device_values && nt != provided_ntuples)
+        {
+            cudaFree(device_values);
+            device_values = NULL;
+        }
+        host_dirty = true;
+        device_dirty = false;
+#endif
+        provided_ntuples = nt;
+    }
+    virtual void GetHostStorage(const char *&begin, const char *&end) const
+    {
         if (host_provided)
-            return host_values_external;
+            begin = (const char*)host_values_external;
+        else if (host_values_self.empty())
+            begin = NULL;
         else
-            return &(host_values_self[0]);
+            begin = (const char*)&(host_values_self[0]);
+        end = begin ? begin + sizeof(T)*ncomponents*GetNumberOfTuples() : NULL;
     }
     virtual void SetNumberOfTuples(int n)
     {
         if (host_provided)
             THROW(eavlException, "Cannot resize externally-provided array");
         NeedToUseOnHost();
+        InvalidateRanges();
         host_values_self.resize(ncomponents * n);
     }
     virtual int GetNumberOfTuples() const
@@ -451,11 +789,13 @@ class eavlConcreteArray : public eavlArray
     }
     void SetTuple(int index, T *v)
     {
-        if (host_provided)
+        if (!HostWritable())
             THROW(eavlException, "Cannot write to externally-provided array");
         NeedToUseOnHost();
+        InvalidateRanges();
+        T *values = HostValues();
         for (int c=0; c<ncomponents; c++)
-            host_values_self[index*ncomponents+c] = v[c];
+            values[index*ncomponents+c] = v[c];
     }
     const T *GetTuple(int index) // can't make this method const
     {
@@ -467,10 +807,45 @@ class eavlConcreteArray : public eavlArray
     }
     T *GetTupleWritable(int index)
     {
-        if (host_provided)
+        if (!HostWritable())
+            THROW(eavlException, "Cannot write to externally-provided array");
+        NeedToUseOnHost();
+        InvalidateRanges();
+        return &(HostValues()[index*ncomponents]);
+    }
+    ///\brief A read-only view of every tuple, or of component c of
+    /// every tuple.  Views of a host-writable array stay valid until it
+    /// is resized; writing through the writable versions is seen by the
+    /// array (the cached ranges are discarded when they are handed out).
+    eavlStridedView<const T> GetView()
+    {
+        NeedToUseOnHost();
+        return eavlStridedView<const T>(HostValues(), ncomponents,
+                                        GetNumberOfTuples());
+    }
+    eavlStridedView<const T> GetComponentView(int c)
+    {
+        NeedToUseOnHost();
+        return eavlStridedView<const T>(HostValues() + c, ncomponents,
+                                        GetNumberOfTuples());
+    }
+    eavlStridedView<T> GetViewWritable()
+    {
+        if (!HostWritable())
+            THROW(eavlException, "Cannot write to externally-provided array");
+        NeedToUseOnHost();
+        InvalidateRanges();
+        return eavlStridedView<T>(HostValues(), ncomponents,
+                                  GetNumberOfTuples());
+    }
+    eavlStridedView<T> GetComponentViewWritable(int c)
+    {
+        if (!HostWritable())
             THROW(eavlException, "Cannot write to externally-provided array");
         NeedToUseOnHost();
-        return &(host_values_self[index*ncomponents]);
+        InvalidateRanges();
+        return eavlStridedView<T>(HostValues() + c, ncomponents,
+                                  GetNumberOfTuples());
     }
     T GetValue(int index)
     {
@@ -483,18 +858,20 @@ class eavlConcreteArray : public eavlArray
     }
     void SetValue(int index, T v)
     {
-        if (host_provided)
+        if (!HostWritable())
             THROW(eavlException, "Cannot write to externally-provided array");
         // assert ncomponents==1?
         NeedToUseOnHost();
-        host_values_self[index*ncomponents+0] = v;
+        InvalidateRanges();
+        HostValues()[index*ncomponents+0] = v;
     }
     void AddValue(T v)
     {
         if (host_provided)
-            THROW(eavlException, "Cannot write to externally-provided array");
+            THROW(eavlException, "Cannot resize externally-provided array");
         // assert ncomponents==1?
         NeedToUseOnHost();
+        InvalidateRanges();
         host_values_self.push_back(v);
     }
     virtual double GetComponentAsDouble(int i, int c)
@@ -513,9 +890,90 @@ class eavlConcreteArray : public eavlArray
     virtual void *GetCUDAArray()
     {
         NeedToUseOnDevice();
+        InvalidateRanges();
         return (void*)(device_values);
     }
+    virtual const void *GetConstCUDAArray()
+    {
+        NeedToUseOnDevice();
+        return (const void*)(device_values);
+    }
 #endif
+  protected:
+    virtual void ComputeRanges()
+    {
+        NeedToUseOnHost();
+        int nt = GetNumberOfTuples();
+        int nc = ncomponents;
+        const T *values = (nt > 0 && nc > 0) ? HostValues() : NULL;
+
+        // each thread reduces its share of the tuples into its own
+        // ranges, which are merged at the end; magnitudes are compared
+        // squared, and square-rooted only once at the end
+        componentMins.assign(nc, +DBL_MAX);
+        componentMaxs.assign(nc, -DBL_MAX);
+        double mag2min = +DBL_MAX;
+        double mag2max = 0;
+#pragma omp parallel if (nt > 10000)
+        {
+            vector<double> lmin(nc, +DBL_MAX);
+            vector<double> lmax(nc, -DBL_MAX);
+            double lmag2min = +DBL_MAX;
+            double lmag2max = 0;
+            if (nc == 1)
+            {
+                // a simple loop the compiler can vectorize
+                double mn = +DBL_MAX, mx = -DBL_MAX;
+#pragma omp for nowait
+                for (int i=0; i<nt; i++)
+                {
+                    double v = values[i];
+                    double v2 = v*v;
+                    mn = (v < mn) ? v : mn;
+                    mx = (v > mx) ? v : mx;
+                    lmag2min = (v2 < lmag2min) ? v2 : lmag2min;
+                    lmag2max = (v2 > lmag2max) ? v2 : lmag2max;
+                }
+                lmin[0] = mn;
+                lmax[0] = mx;
+            }
+            else if (nc > 1)
+            {
+#pragma omp for nowait
+                for (int i=0; i<nt; i++)
+                {
+                    const T *tuple = values + i*nc;
+                    double mag2 = 0;
+                    for (int c=0; c<nc; c++)
+                    {
+                        double v = tuple[c];
+                        if (v < lmin[c])
+                            lmin[c] = v;
+                        if (v > lmax[c])
+                            lmax[c] = v;
+                        mag2 += v*v;
+                    }
+                    if (mag2 < lmag2min)
+                        lmag2min = mag2;
+                    if (mag2 > lmag2max)
+                        lmag2max = mag2;
+                }
+            }
+#pragma omp critical(eavlArrayRanges)
+            {
+                for (int c=0; c<nc; c++)
+                {
+                    componentMins[c] = std::min(componentMins[c], lmin[c]);
+                    componentMaxs[c] = std::max(componentMaxs[c], lmax[c]);
+                }
+                mag2min = std::min(mag2min, lmag2min);
+                mag2max = std::max(mag2max, lmag2max);
+            }
+        }
+        magnitudeMin = (mag2min == +DBL_MAX) ? +DBL_MAX : sqrt(mag2min);
+        magnitudeMax = sqrt(mag2max);
+    }
+  public:
     virtual long long GetMemoryUsage()
     {
         ///\todo: ignores device memory; is that right??
@@ -538,4 +996,79 @@ typedef eavlConcreteArray<int> eavlIntArray;
 typedef eavlConcreteArray<byte> eavlByteArray;
 typedef eavlConcreteArray<float> eavlFloatArray;
 
+// ****************************************************************************
+// Function:  eavlDispatchView
+//
+// Purpose:
+///   Calls functor(view) with a typed, read-only eavlStridedView of the
+///   array: of every tuple if c is negative, otherwise of component c.
+///   The functor's operator() is a template on the view type, so a loop
+///   over an array of any value type is compiled once per type, and the
+///   type is looked up once per array instead of once per value.  Arrays
+///   other than float, int and byte ones get an eavlGenericView.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class F>
+inline void eavlDispatchView(eavlArray *arr, F &functor, int c = -1)
+{
+    if (eavlFloatArray *a = dynamic_cast<eavlFloatArray*>(arr))
+        functor(c < 0 ? a->GetView() : a->GetComponentView(c));
+    else if (eavlIntArray *a = dynamic_cast<eavlIntArray*>(arr))
+        functor(c < 0 ? a->GetView() : a->GetComponentView(c));
+    else if (eavlByteArray *a = dynamic_cast<eavlByteArray*>(arr))
+        functor(c < 0 ? a->GetView() : a->GetComponentView(c));
+    else
+        functor(eavlGenericView(arr, c < 0 ? 0 : c));
+}
+
+#ifndef DOXYGEN
+struct eavlGatherTuplesFunctor
+{
+    const int *ids;
+    int n;
+    eavlStridedView<float> out;
+    eavlGatherTuplesFunctor(const int *i, int count, eavlStridedView<float> o)
+        : ids(i), n(count), out(o)
+    {
+    }
+    template <class V>
+    void operator()(const V &in)
+    {
+        int nc = in.stride;
+        for (int j=0; j<n; j++)
+        {
+            int e = ids[j];
+            for (int k=0; k<nc; k++)
+                out(j,k) = float(in(e,k));
+        }
+    }
+};
+#endif
+
+// ****************************************************************************
+// Function:  eavlGatherTuples
+//
+// Purpose:
+///   Sets tuple j of the output array to tuple ids[j] of the input
+///   array, for the n tuples of the output, converting the values to
+///   float.  The arrays must have the same number of components.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+inline void eavlGatherTuples(eavlArray *in, const int *ids, eavlFloatArray *out)
+{
+    if (in->GetNumberOfComponents() != out->GetNumberOfComponents())
+        THROW(eavlException, "eavlGatherTuples needs arrays with the same number of components");
+    eavlStridedView<float> outview = out->GetViewWritable();
+    eavlGatherTuplesFunctor gather(ids, outview.size(), outview);
+    eavlDispatchView(in, gather);
+}
+
 #endif
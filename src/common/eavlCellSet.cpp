@@ -4,6 +4,16 @@
 #include "eavlCellSetAllStructured.h"
 #include "eavlCellSetExplicit.h"
 
+unsigned long
+eavlCellSet::NewStamp()
+{
+    static unsigned long laststamp = 0;
+    unsigned long stamp;
+#pragma omp critical(eavlCellSetNewStamp)
+    stamp = ++laststamp;
+    return stamp;
+}
+
 eavlCellSet *
 eavlCellSet::CreateObjFromName(const string &nm)
 {
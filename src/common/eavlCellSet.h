@@ -19,17 +19,35 @@
 //   Jeremy Meredith, Fri Oct 19 16:54:36 EDT 2012
 //   Added reverse connectivity (i.e. get cells attached to a node).
 //
+//   agent, October 17, 2026
+//   Added GetEdgeNodes.
+//
+//   agent, October 17, 2026
+//   Made reference counted, so several data sets can share one.
+//
+//   agent, October 17, 2026
+//   Added a modification stamp.
+//
 // ****************************************************************************
 
-class eavlCellSet
+class eavlCellSet : public eavlReferenceCounted
 {
   protected:
     string              name;           ///< e.g. atoms, cells, nodes, faces
     int                 dimensionality; ///< e.g. 0, 1, 2, 3, (more?)
 
     int                 dataset_numpoints; ///< the number of points in the container data set
+
+    unsigned long       modificationStamp;
+    static unsigned long NewStamp();
+    /// Subclasses call this whenever they change their cells.
+    void Modified() { modificationStamp = NewStamp(); }
   public:
-    eavlCellSet(const string &n, int d) : name(n), dimensionality(d), dataset_numpoints(0) { }
+    eavlCellSet(const string &n, int d)
+        : name(n), dimensionality(d), dataset_numpoints(0),
+          modificationStamp(NewStamp())
+    {
+    }
     virtual ~eavlCellSet() { }
     virtual string className() const {return "eavlCellSet";}
     virtual eavlStream& serialize(eavlStream &s) const;
@@ -54,6 +72,13 @@ class eavlCellSet
         c.numIndices = 0;
         return c;
     }
+    virtual eavlCell GetEdgeNodes(int)
+    {
+        eavlCell c;
+        c.type=EAVL_OTHER;
+        c.numIndices = 0;
+        return c;
+    }
     virtual eavlCell GetNodeCells(int)
     {
         eavlCell c;
@@ -62,6 +87,16 @@ class eavlCellSet
         return c;
     }
     virtual void PrintSummary(ostream&) = 0;
+    ///\brief A stamp which changes whenever the cells are changed.
+    /// Stamps are unique across all cell sets and never reused, so
+    /// unlike the cell set's address, a stamp kept from one cell set
+    /// can't match another allocated after it was deleted.  A cell set
+    /// defined by another one (e.g. a subset) does not see changes to
+    /// that one.
+    unsigned long GetModificationStamp() const
+    {
+        return modificationStamp;
+    }
     virtual long long GetMemoryUsage()
     {
         long long mem = 0;
@@ -93,6 +128,8 @@ class eavlCellSet
     /// happen to be at the tail end of the list).
     virtual void SetDSNumPoints(int n)
     {
+        if (n != dataset_numpoints)
+            Modified();
         dataset_numpoints = n;
     }
 
@@ -109,6 +146,7 @@ inline eavlStream& eavlCellSet::serialize(eavlStream &s) const
 inline eavlStream& eavlCellSet::deserialize(eavlStream &s)
 {
     s >> name >> dimensionality >> dataset_numpoints;
+    Modified();
     return s;
 }
 
@@ -62,13 +62,7 @@ class eavlCellSetAllEdgesOfExplicit : public eavlCellSet
     }
     virtual eavlCell GetCellNodes(int edgeindex)
     {
-        const eavlExplicitConnectivity &conn = 
-            parent->GetConnectivity(EAVL_NODES_OF_EDGES);
-        eavlCell cell;
-        cell.type = eavlCellShape(conn.GetElementComponents(edgeindex,
-                                                            cell.numIndices,
-                                                            cell.indices));
-        return cell;
+        return parent->GetElement(EAVL_NODES_OF_EDGES, edgeindex);
     }
 };
 
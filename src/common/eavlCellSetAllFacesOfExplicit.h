@@ -65,13 +65,7 @@ class eavlCellSetAllFacesOfExplicit : public eavlCellSet
     }
     virtual eavlCell GetCellNodes(int faceindex)
     {
-        const eavlExplicitConnectivity &conn = 
-            parent->GetConnectivity(EAVL_NODES_OF_FACES);
-        eavlCell cell;
-        cell.type = eavlCellShape(conn.GetElementComponents(faceindex,
-                                                            cell.numIndices,
-                                                            cell.indices));
-        return cell;
+        return parent->GetElement(EAVL_NODES_OF_FACES, faceindex);
     }
 };
 
@@ -18,6 +18,9 @@
 //   Jeremy Meredith, Fri Oct 19 16:54:36 EDT 2012
 //   Added reverse connectivity (i.e. get cells attached to a node).
 //
+//   agent, October 17, 2026
+//   Added GetEdgeNodes.
+//
 // ****************************************************************************
 
 class eavlCellSetAllStructured : public eavlCellSet
@@ -75,6 +78,14 @@ class eavlCellSetAllStructured : public eavlCellSet
                                                               c.indices);
         return c;
     }
+    virtual eavlCell GetEdgeNodes(int index)
+    {
+        eavlCell c;
+        c.type = (eavlCellShape)regularStructure.GetEdgeNodes(index,
+                                                              c.numIndices,
+                                                              c.indices);
+        return c;
+    }
     virtual eavlCell GetCellFaces(int index)
     {
         eavlCell c;
@@ -1,127 +1,362 @@
 // Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
 #include "eavlCellSetExplicit.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlScatterOp.h"
+#include "eavlExecutor.h"
+#include <algorithm>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
 
-using std::multimap;
+//
+// Edges and faces are deduplicated by sorting every (cell, local edge or
+// face) slot on its node ids instead of inserting them into a map.  The
+// slots are first bucketed by their lowest node id with a parallel
+// counting sort (i.e. one radix pass with a digit per node), and then each
+// bucket -- which only holds the few edges or faces incident to that node
+// -- is sorted on the remaining node ids and the slot index.  The first
+// slot of every run of equal keys is its representative, and numbering the
+// representatives with a scan gives every unique edge or face the same id
+// (first occurrence in cell order) the map-based construction produced.
+//
 
-class eavlEdge
+static int eavlGetShapeEdges(int shape, signed char (*&edges)[2])
 {
- public:
-    int a;
-    int b;
-    bool operator<(const eavlEdge &e) const
+    switch (shape)
     {
-        if (a < e.a)
+      case EAVL_TET:     edges = eavlTetEdges;     return 6;
+      case EAVL_PYRAMID: edges = eavlPyramidEdges; return 8;
+      case EAVL_WEDGE:   edges = eavlWedgeEdges;   return 9;
+      case EAVL_HEX:     edges = eavlHexEdges;     return 12;
+      case EAVL_VOXEL:   edges = eavlVoxEdges;     return 12;
+      case EAVL_TRI:     edges = eavlTriEdges;     return 3;
+      case EAVL_QUAD:    edges = eavlQuadEdges;    return 4;
+      case EAVL_PIXEL:   edges = eavlPixelEdges;   return 4;
+      default:           edges = NULL;             return 0;
+    }
+}
+
+// returns the number of triangle faces; quad faces always follow them
+static int eavlGetShapeFaces(int shape,
+                             signed char (*&tris)[3],
+                             int &nquads, signed char (*&quads)[4])
+{
+    tris = NULL;
+    quads = NULL;
+    nquads = 0;
+    switch (shape)
+    {
+      case EAVL_HEX:
+        nquads = 6;
+        quads = eavlHexQuadFaces;
+        return 0;
+      case EAVL_VOXEL:
+        nquads = 6;
+        quads = eavlVoxQuadFaces;
+        return 0;
+      case EAVL_TET:
+        tris = eavlTetTriangleFaces;
+        return 4;
+      case EAVL_PYRAMID:
+        tris = eavlPyramidTriangleFaces;
+        nquads = 1;
+        quads = eavlPyramidQuadFaces;
+        return 4;
+      case EAVL_WEDGE:
+        tris = eavlWedgeTriangleFaces;
+        nquads = 3;
+        quads = eavlWedgeQuadFaces;
+        return 2;
+      default:
+        return 0;
+    }
+}
+
+// in-place exclusive scan of the first n values; returns the total
+static int eavlExclusiveScan(vector<int> &v, int n)
+{
+#ifdef HAVE_OPENMP
+    int nthreads = omp_get_max_threads();
+    if (nthreads > 1 && n >= 4*nthreads*1024)
+    {
+        vector<int> partial(nthreads+1, 0);
+        int nused = 1;
+#pragma omp parallel num_threads(nthreads)
+        {
+            int t = omp_get_thread_num();
+            int nt = omp_get_num_threads();
+            int begin = (long long)n * t / nt;
+            int end = (long long)n * (t+1) / nt;
+            int sum = 0;
+            for (int i=begin; i<end; i++)
+                sum += v[i];
+            partial[t+1] = sum;
+#pragma omp barrier
+#pragma omp single
+            {
+                nused = nt;
+                for (int i=0; i<nt; i++)
+                    partial[i+1] += partial[i];
+            }
+            sum = partial[t];
+            for (int i=begin; i<end; i++)
+            {
+                int val = v[i];
+                v[i] = sum;
+                sum += val;
+            }
+        }
+        return partial[nused];
+    }
+#endif
+    int sum = 0;
+    for (int i=0; i<n; i++)
+    {
+        int val = v[i];
+        v[i] = sum;
+        sum += val;
+    }
+    return sum;
+}
+
+// the node ids (after the lowest one) which identify an edge
+struct eavlEdgeKey
+{
+    const int *hi;
+    eavlEdgeKey(const int *h) : hi(h) { }
+    bool less(int s0, int s1) const { return hi[s0] < hi[s1]; }
+    bool equal(int s0, int s1) const { return hi[s0] == hi[s1]; }
+};
+
+// the node ids (after the lowest one) which identify a face
+struct eavlFaceKey
+{
+    const int *b, *c;
+    eavlFaceKey(const int *bb, const int *cc) : b(bb), c(cc) { }
+    bool less(int s0, int s1) const
+    {
+        return b[s0] < b[s1] || (b[s0] == b[s1] && c[s0] < c[s1]);
+    }
+    bool equal(int s0, int s1) const
+    {
+        return b[s0] == b[s1] && c[s0] == c[s1];
+    }
+};
+
+template <class KEY>
+struct eavlSlotOrder
+{
+    KEY key;
+    eavlSlotOrder(const KEY &k) : key(k) { }
+    bool operator()(int s0, int s1) const
+    {
+        if (key.less(s0, s1))
             return true;
-        if (a > e.a)
+        if (key.less(s1, s0))
             return false;
-        if (b < e.b)
-            return true;
-        return false;
+        return s0 < s1;
     }
-    eavlEdge() { }
-    eavlEdge(const eavlEdge &e) : a(e.a), b(e.b) { }
-    eavlEdge(int p0, int p1)
+};
+
+// Given nslots slots keyed by a lowest node id in [0,nnodes) and the rest
+// of their key, sets first[s] to the earliest slot with the same key as s,
+// and id[s] to the number of distinct keys first seen before slot s (so
+// id[first[s]] is the new id for slot s).  Returns the number of distinct
+// keys.
+template <class KEY>
+static int eavlFindFirstOccurrences(int nslots, int nnodes,
+                                    const vector<int> &lowest, const KEY &key,
+                                    vector<int> &first, vector<int> &id)
+{
+    first.resize(nslots);
+    id.resize(nslots);
+    if (nslots == 0)
+        return 0;
+
+    // counting sort on the lowest node id
+    vector<int> bucketstart(nnodes+1, 0);
+#pragma omp parallel for
+    for (int s=0; s<nslots; s++)
     {
-        if (p0 < p1)
+#pragma omp atomic
+        bucketstart[lowest[s]]++;
+    }
+    bucketstart[nnodes] = eavlExclusiveScan(bucketstart, nnodes);
+
+    vector<int> cursor(bucketstart.begin(), bucketstart.end() - 1);
+    vector<int> sorted(nslots);
+#pragma omp parallel for
+    for (int s=0; s<nslots; s++)
+    {
+        int pos;
+#pragma omp atomic capture
+        pos = cursor[lowest[s]]++;
+        sorted[pos] = s;
+    }
+
+    // sort each bucket on the rest of the key, then on the slot
+    // index, so the first slot in each run of equal keys is the
+    // earliest occurrence regardless of the scatter order above
+    eavlSlotOrder<KEY> order(key);
+#pragma omp parallel for schedule(dynamic,256)
+    for (int n=0; n<nnodes; n++)
+    {
+        int *begin = &sorted[0] + bucketstart[n];
+        int *end   = &sorted[0] + bucketstart[n+1];
+        if (end - begin < 32)
         {
-            a = p0;
-            b = p1;
+            for (int *i = begin+1; i < end; i++)
+            {
+                int s = *i;
+                int *j = i;
+                for ( ; j > begin && order(s, *(j-1)); j--)
+                    *j = *(j-1);
+                *j = s;
+            }
         }
         else
         {
-            a = p1;
-            b = p0;
+            std::sort(begin, end, order);
+        }
+
+        int rep = -1;
+        for (int *i = begin; i < end; i++)
+        {
+            if (i == begin || !key.equal(*(i-1), *i))
+                rep = *i;
+            first[*i] = rep;
+            id[*i] = (rep == *i) ? 1 : 0;
         }
     }
-};
 
+    return eavlExclusiveScan(id, nslots);
+}
+
+// Builds the explicit connectivity of a topology if it isn't yet.  The
+// builders read the explicit cell->node connectivity, so if only its
+// packed form is kept, it is unpacked for them and released again.
+void eavlCellSetExplicit::BuildConnectivity(eavlTopology topology)
+{
+    bool built = true;
+    switch (topology)
+    {
+      case EAVL_NODES_OF_CELLS:
+        break;
+      case EAVL_CELLS_OF_NODES:
+        built = haveNodeCellConnectivity;
+        break;
+      case EAVL_NODES_OF_EDGES:
+      case EAVL_EDGES_OF_CELLS:
+        built = (numEdges >= 0);
+        break;
+      case EAVL_NODES_OF_FACES:
+      case EAVL_FACES_OF_CELLS:
+        built = (numFaces >= 0);
+        break;
+      default:
+        THROW(eavlException,"unexpected topology type in BuildConnectivity");
+    }
+    if (built)
+        return;
+
+    bool released = releasedConnectivity[EAVL_NODES_OF_CELLS];
+    UnpackedConnectivity(EAVL_NODES_OF_CELLS);
+    if (topology == EAVL_CELLS_OF_NODES)
+        BuildNodeCellConnectivity();
+    else if (topology == EAVL_NODES_OF_EDGES ||
+             topology == EAVL_EDGES_OF_CELLS)
+        BuildEdgeConnectivity();
+    else
+        BuildFaceConnectivity();
+    if (released)
+        ReleaseConnectivity(EAVL_NODES_OF_CELLS);
+}
 
 void eavlCellSetExplicit::BuildEdgeConnectivity()
 {
     if (numEdges >= 0)
         return; // already done!
 
-    numEdges = 0;
-
-    map<eavlEdge,int> mapEdgesToEdgeIDs; ///<\todo: horribly inefficient
-
-    cellEdgeConnectivity.shapetype.clear();
-    cellEdgeConnectivity.connectivity.clear();
-    edgeNodeConnectivity.shapetype.clear();
-    edgeNodeConnectivity.connectivity.clear();
-
     int nCells = GetNumCells();
+
+    // one slot for each edge of each cell
+    vector<int> edgestart(nCells+1);
+#pragma omp parallel for
     for (int i=0; i<nCells; i++)
     {
-        eavlCell el = GetCellNodes(i);
-
-        int nedges = 0;
         signed char (*edges)[2];
-        switch (el.type)
-        {
-          case EAVL_TET:
-            edges = eavlTetEdges;
-            nedges = 6;
-            break;
-          case EAVL_PYRAMID:
-            edges = eavlPyramidEdges;
-            nedges = 8;
-            break;
-          case EAVL_WEDGE:
-            edges = eavlWedgeEdges;
-            nedges = 9;
-            break;
-          case EAVL_HEX:
-            edges = eavlHexEdges;
-            nedges = 12;
-            break;
-          case EAVL_VOXEL:
-            edges = eavlVoxEdges;
-            nedges = 12;
-            break;
-          case EAVL_TRI:
-            edges = eavlTriEdges;
-            nedges = 3;
-            break;
-          case EAVL_QUAD:
-            edges = eavlQuadEdges;
-            nedges = 4;
-            break;
-          case EAVL_PIXEL:
-            edges = eavlPixelEdges;
-            nedges = 4;
-            break;
-                
-          default:
-            edges = NULL;
-            break;
-        }
-        cellEdgeConnectivity.shapetype.push_back(cellNodeConnectivity.shapetype[i]);
-        cellEdgeConnectivity.connectivity.push_back(nedges);
-        for (int j=0; j<nedges; j++)
+        edgestart[i] = eavlGetShapeEdges(cellNodeConnectivity.shapetype[i],
+                                          edges);
+    }
+    int nslots = eavlExclusiveScan(edgestart, nCells);
+    edgestart[nCells] = nslots;
+
+    vector<int> lo(nslots), hi(nslots);
+    int nnodes = 0;
+#pragma omp parallel
+    {
+        int localnnodes = 0;
+#pragma omp for
+        for (int i=0; i<nCells; i++)
         {
-            eavlEdge edge(el.indices[edges[j][0]],
-                          el.indices[edges[j][1]]);
-            int index = numEdges;
-            if (mapEdgesToEdgeIDs.count(edge) == 0)
-            {
-                mapEdgesToEdgeIDs[edge] = index;
-                numEdges++;
-                edgeNodeConnectivity.shapetype.push_back(EAVL_BEAM);
-                edgeNodeConnectivity.connectivity.push_back(2);
-                edgeNodeConnectivity.connectivity.push_back(edge.a);
-                edgeNodeConnectivity.connectivity.push_back(edge.b);
-            }
-            else
+            signed char (*edges)[2];
+            int nedges = eavlGetShapeEdges(cellNodeConnectivity.shapetype[i],
+                                           edges);
+            int index = cellNodeConnectivity.mapCellToIndex[i] + 1;
+            for (int j=0; j<nedges; j++)
             {
-                index = mapEdgesToEdgeIDs[edge];
+                int p0 = cellNodeConnectivity.connectivity[index + edges[j][0]];
+                int p1 = cellNodeConnectivity.connectivity[index + edges[j][1]];
+                int s = edgestart[i] + j;
+                lo[s] = (p0 < p1) ? p0 : p1;
+                hi[s] = (p0 < p1) ? p1 : p0;
+                if (hi[s] >= localnnodes)
+                    localnnodes = hi[s] + 1;
             }
-            cellEdgeConnectivity.connectivity.push_back(index);
+        }
+#pragma omp critical
+        {
+            if (localnnodes > nnodes)
+                nnodes = localnnodes;
         }
     }
 
-    cellEdgeConnectivity.CreateReverseIndex();
-    edgeNodeConnectivity.CreateReverseIndex();
+    vector<int> first, id;
+    numEdges = eavlFindFirstOccurrences(nslots, nnodes, lo,
+                                        eavlEdgeKey(nslots ? &hi[0] : NULL),
+                                        first, id);
+
+    // cell->edge: the edge count of each cell followed by its edge ids
+    cellEdgeConnectivity.shapetype.resize(nCells);
+    cellEdgeConnectivity.connectivity.resize(nslots + nCells);
+    cellEdgeConnectivity.mapCellToIndex.resize(nCells);
+#pragma omp parallel for
+    for (int i=0; i<nCells; i++)
+    {
+        int index = edgestart[i] + i;
+        cellEdgeConnectivity.shapetype[i] = cellNodeConnectivity.shapetype[i];
+        cellEdgeConnectivity.mapCellToIndex[i] = index;
+        cellEdgeConnectivity.connectivity[index] = edgestart[i+1] - edgestart[i];
+        for (int s=edgestart[i]; s<edgestart[i+1]; s++)
+            cellEdgeConnectivity.connectivity[++index] = id[first[s]];
+    }
+
+    // edge->node: a beam for each edge, from its first occurrence
+    edgeNodeConnectivity.shapetype.resize(numEdges);
+    edgeNodeConnectivity.connectivity.resize(3 * numEdges);
+    edgeNodeConnectivity.mapCellToIndex.resize(numEdges);
+#pragma omp parallel for
+    for (int s=0; s<nslots; s++)
+    {
+        if (first[s] != s)
+            continue;
+        int e = id[s];
+        edgeNodeConnectivity.shapetype[e] = EAVL_BEAM;
+        edgeNodeConnectivity.mapCellToIndex[e] = 3 * e;
+        edgeNodeConnectivity.connectivity[3*e + 0] = 2;
+        edgeNodeConnectivity.connectivity[3*e + 1] = lo[s];
+        edgeNodeConnectivity.connectivity[3*e + 2] = hi[s];
+    }
 
     //debug
     //cout << "--- CELL EDGE CONNECTIVITY =\n";
@@ -151,13 +386,6 @@ class eavlFace
         return false;
     }
     eavlFace() { }
-    eavlFace(const eavlFace &f) : n(f.n), a(f.a), b(f.b), c(f.c)
-    {
-        ids[0] = f.ids[0];
-        ids[1] = f.ids[1];
-        ids[2] = f.ids[2];
-        ids[3] = f.ids[3];
-    }
     eavlFace(int x, int y, int z)
     {
         n = 3;
@@ -231,108 +459,132 @@ void eavlCellSetExplicit::BuildFaceConnectivity()
     if (numFaces >= 0)
         return; // already done!
 
-    numFaces = 0;
-
-    map<eavlFace,int> mapFacesToFaceIDs; ///<\todo: horribly inefficient
-
-    cellFaceConnectivity.shapetype.clear();
-    cellFaceConnectivity.connectivity.clear();
-    faceNodeConnectivity.shapetype.clear();
-    faceNodeConnectivity.connectivity.clear();
-
     int nCells = GetNumCells();
+
+    // one slot for each face of each cell, triangles first
+    vector<int> facestart(nCells+1);
+#pragma omp parallel for
     for (int i=0; i<nCells; i++)
     {
-        eavlCell el = GetCellNodes(i);
-
-        int ntris = 0;
-        signed char (*tris)[3] = NULL;
-        int nquads = 0;
-        signed char (*quads)[4] = NULL;
-        switch (el.type)
-        {
-          case EAVL_HEX:
-            nquads = 6;
-            quads = eavlHexQuadFaces;
-            break;
-          case EAVL_VOXEL:
-            nquads = 6;
-            quads = eavlVoxQuadFaces;
-            break;
-          case EAVL_TET:
-            ntris = 4;
-            tris = eavlTetTriangleFaces;
-            break;
-          case EAVL_PYRAMID:
-            ntris = 4;
-            tris = eavlPyramidTriangleFaces;
-            nquads = 1;
-            quads = eavlPyramidQuadFaces;
-            break;
-          case EAVL_WEDGE:
-            ntris = 2;
-            tris = eavlWedgeTriangleFaces;
-            nquads = 3;
-            quads = eavlWedgeQuadFaces;
-            break;
-          default:
-            break; // do nothing
-        }
+        signed char (*tris)[3];
+        signed char (*quads)[4];
+        int nquads;
+        int ntris = eavlGetShapeFaces(cellNodeConnectivity.shapetype[i],
+                                      tris, nquads, quads);
+        facestart[i] = ntris + nquads;
+    }
+    int nslots = eavlExclusiveScan(facestart, nCells);
+    facestart[nCells] = nslots;
 
-        cellFaceConnectivity.shapetype.push_back(cellNodeConnectivity.shapetype[i]);
-        cellFaceConnectivity.connectivity.push_back(ntris + nquads);
-        for (int f=0; f<ntris; f++)
+    vector<int> fa(nslots), fb(nslots), fc(nslots), cellof(nslots);
+    int nnodes = 0;
+#pragma omp parallel
+    {
+        int localnnodes = 0;
+#pragma omp for
+        for (int i=0; i<nCells; i++)
         {
-            eavlFace face(el.indices[tris[f][0]],
-                          el.indices[tris[f][1]],
-                          el.indices[tris[f][2]]);
-
-            int index = numFaces;
-            if (mapFacesToFaceIDs.count(face) == 0)
+            signed char (*tris)[3];
+            signed char (*quads)[4];
+            int nquads;
+            int ntris = eavlGetShapeFaces(cellNodeConnectivity.shapetype[i],
+                                          tris, nquads, quads);
+            int index = cellNodeConnectivity.mapCellToIndex[i] + 1;
+            for (int f=0; f<ntris+nquads; f++)
             {
-                mapFacesToFaceIDs[face] = index;
-                numFaces++;
-                faceNodeConnectivity.shapetype.push_back(EAVL_TRI);
-                faceNodeConnectivity.connectivity.push_back(3);
-                faceNodeConnectivity.connectivity.push_back(face.ids[0]);
-                faceNodeConnectivity.connectivity.push_back(face.ids[1]);
-                faceNodeConnectivity.connectivity.push_back(face.ids[2]);
+                eavlFace face;
+                if (f < ntris)
+                    face = eavlFace(cellNodeConnectivity.connectivity[index + tris[f][0]],
+                                    cellNodeConnectivity.connectivity[index + tris[f][1]],
+                                    cellNodeConnectivity.connectivity[index + tris[f][2]]);
+                else
+                    face = eavlFace(cellNodeConnectivity.connectivity[index + quads[f-ntris][0]],
+                                    cellNodeConnectivity.connectivity[index + quads[f-ntris][1]],
+                                    cellNodeConnectivity.connectivity[index + quads[f-ntris][2]],
+                                    cellNodeConnectivity.connectivity[index + quads[f-ntris][3]]);
+                int s = facestart[i] + f;
+                fa[s] = face.a;
+                fb[s] = face.b;
+                fc[s] = face.c;
+                cellof[s] = i;
+                if (face.c >= localnnodes)
+                    localnnodes = face.c + 1;
             }
-            else
-            {
-                index = mapFacesToFaceIDs[face];
-            }
-            cellFaceConnectivity.connectivity.push_back(index);
         }
-        for (int f=0; f<nquads; f++)
+#pragma omp critical
         {
-            eavlFace face(el.indices[quads[f][0]],
-                          el.indices[quads[f][1]],
-                          el.indices[quads[f][2]],
-                          el.indices[quads[f][3]]);
+            if (localnnodes > nnodes)
+                nnodes = localnnodes;
+        }
+    }
 
-            int index = numFaces;
-            if (mapFacesToFaceIDs.count(face) == 0)
-            {
-                mapFacesToFaceIDs[face] = index;
-                numFaces++;
-                faceNodeConnectivity.shapetype.push_back(EAVL_QUAD);
-                faceNodeConnectivity.connectivity.push_back(4);
-                faceNodeConnectivity.connectivity.push_back(face.ids[0]);
-                faceNodeConnectivity.connectivity.push_back(face.ids[1]);
-                faceNodeConnectivity.connectivity.push_back(face.ids[2]);
-                faceNodeConnectivity.connectivity.push_back(face.ids[3]);
-            }
-            else
-            {
-                index = mapFacesToFaceIDs[face];
-            }
-            cellFaceConnectivity.connectivity.push_back(index);
+    vector<int> first, id;
+    numFaces = eavlFindFirstOccurrences(nslots, nnodes, fa,
+                                        eavlFaceKey(nslots ? &fb[0] : NULL,
+                                                    nslots ? &fc[0] : NULL),
+                                        first, id);
+
+    // cell->face: the face count of each cell followed by its face ids
+    cellFaceConnectivity.shapetype.resize(nCells);
+    cellFaceConnectivity.connectivity.resize(nslots + nCells);
+    cellFaceConnectivity.mapCellToIndex.resize(nCells);
+#pragma omp parallel for
+    for (int i=0; i<nCells; i++)
+    {
+        int index = facestart[i] + i;
+        cellFaceConnectivity.shapetype[i] = cellNodeConnectivity.shapetype[i];
+        cellFaceConnectivity.mapCellToIndex[i] = index;
+        cellFaceConnectivity.connectivity[index] = facestart[i+1] - facestart[i];
+        for (int s=facestart[i]; s<facestart[i+1]; s++)
+            cellFaceConnectivity.connectivity[++index] = id[first[s]];
+    }
+
+    // face->node: a triangle or quad for each face, with the nodes in
+    // the order of its first occurrence; faces are variable length, so
+    // scan their sizes (in face id order, which is slot order) first
+    vector<int> faceindex(nslots);
+#pragma omp parallel for
+    for (int s=0; s<nslots; s++)
+    {
+        faceindex[s] = 0;
+        if (first[s] == s)
+        {
+            signed char (*tris)[3];
+            signed char (*quads)[4];
+            int nquads;
+            int ntris = eavlGetShapeFaces(cellNodeConnectivity.shapetype[cellof[s]],
+                                          tris, nquads, quads);
+            faceindex[s] = (s - facestart[cellof[s]] < ntris) ? 4 : 5;
         }
     }
+    int nconn = eavlExclusiveScan(faceindex, nslots);
 
-    cellFaceConnectivity.CreateReverseIndex();
-    faceNodeConnectivity.CreateReverseIndex();
+    faceNodeConnectivity.shapetype.resize(numFaces);
+    faceNodeConnectivity.connectivity.resize(nconn);
+    faceNodeConnectivity.mapCellToIndex.resize(numFaces);
+#pragma omp parallel for
+    for (int s=0; s<nslots; s++)
+    {
+        if (first[s] != s)
+            continue;
+        int i = cellof[s];
+        signed char (*tris)[3];
+        signed char (*quads)[4];
+        int nquads;
+        int ntris = eavlGetShapeFaces(cellNodeConnectivity.shapetype[i],
+                                      tris, nquads, quads);
+        int f = s - facestart[i];
+        int npts = (f < ntris) ? 3 : 4;
+        signed char *local = (f < ntris) ? tris[f] : quads[f-ntris];
+        int cellindex = cellNodeConnectivity.mapCellToIndex[i] + 1;
+        int index = faceindex[s];
+        faceNodeConnectivity.shapetype[id[s]] = (npts == 3) ? EAVL_TRI : EAVL_QUAD;
+        faceNodeConnectivity.mapCellToIndex[id[s]] = index;
+        faceNodeConnectivity.connectivity[index] = npts;
+        for (int p=0; p<npts; p++)
+            faceNodeConnectivity.connectivity[index + 1 + p] =
+                cellNodeConnectivity.connectivity[cellindex + local[p]];
+    }
 
     //debug
     //cout << "--- CELL FACE CONNECTIVITY =\n";
@@ -341,55 +593,148 @@ void eavlCellSetExplicit::BuildFaceConnectivity()
     //faceNodeConnectivity.PrintSummary(cout);
 }
 
+//
+// The reverse (node->cell) connectivity is built by counting the cells
+// incident to every node, scanning those counts into offsets, and
+// scattering every cell id into its node's list.  Each list is then
+// sorted, as the scatter positions are claimed in no particular order,
+// so every node lists its cells in increasing order as before.
+//
 void eavlCellSetExplicit::BuildNodeCellConnectivity()
 {
-    nodeCellConnectivity.shapetype.clear();
-    nodeCellConnectivity.connectivity.clear();
+    if (haveNodeCellConnectivity)
+        return; // already done!
 
-    multimap<int,int> cells_of_nodes;
+    int nCells = GetNumCells();
+    int nEntries = cellNodeConnectivity.connectivity.size() - nCells;
+
+    // nodes past the highest one referenced by a cell, up to the
+    // number of points in the data set, get empty lists
+    int nNodes = dataset_numpoints;
+#pragma omp parallel
+    {
+        int localnnodes = 0;
+#pragma omp for
+        for (int i=0; i<nCells; i++)
+        {
+            int index = cellNodeConnectivity.mapCellToIndex[i];
+            int npts = cellNodeConnectivity.connectivity[index];
+            for (int p=0; p<npts; p++)
+            {
+                int node = cellNodeConnectivity.connectivity[index + 1 + p];
+                if (node >= localnnodes)
+                    localnnodes = node + 1;
+            }
+        }
+#pragma omp critical
+        {
+            if (localnnodes > nNodes)
+                nNodes = localnnodes;
+        }
+    }
+
+    nodeCellConnectivity.shapetype.resize(nNodes);
+    nodeCellConnectivity.mapCellToIndex.resize(nNodes);
+    nodeCellConnectivity.connectivity.resize(nNodes + nEntries);
+    if (nNodes == 0)
+    {
+        haveNodeCellConnectivity = true;
+        return;
+    }
 
-    int maxNodeID = 0;
-    int numCells = GetNumCells();
-    for (int cell = 0, cindex = 0; cell < numCells; ++cell)
+    // count: each node's list holds its cell count followed by the cells
+    eavlIntArray sizes("nodecellsizes", 1, nNodes);
+    eavlIntArray starts("nodecellstarts", 1, nNodes);
+    int *size = (int*)sizes.GetHostArray();
+#pragma omp parallel for
+    for (int n=0; n<nNodes; n++)
+        size[n] = 1;
+#pragma omp parallel for
+    for (int i=0; i<nCells; i++)
     {
-        int npts = cellNodeConnectivity.connectivity[cindex++];
-        for (int pt=0; pt<npts; ++pt)
+        int index = cellNodeConnectivity.mapCellToIndex[i];
+        int npts = cellNodeConnectivity.connectivity[index];
+        for (int p=0; p<npts; p++)
         {
-            int index = cellNodeConnectivity.connectivity[cindex++];
-            if (index > maxNodeID)
-                maxNodeID = index;
-            cells_of_nodes.insert(pair<int,int>(index,cell));
+            int node = cellNodeConnectivity.connectivity[index + 1 + p];
+#pragma omp atomic
+            size[node]++;
         }
     }
 
-    int filled_array_to_node = 0;
-    int cur_node_connstart = 0;
-    for (multimap<int,int>::iterator iter = cells_of_nodes.begin();
-         iter != cells_of_nodes.end(); iter++)
+    // scan
+    eavlExecutor::RunOnCPU(new eavlPrefixSumOp_1(&sizes, &starts, false),
+                           "scan node cell counts");
+    int *start = (int*)starts.GetHostArray();
+
+    // size[] becomes the next free spot in each node's list
+#pragma omp parallel for
+    for (int n=0; n<nNodes; n++)
     {
-        int node = iter->first;
-        while (filled_array_to_node <= node)
+        nodeCellConnectivity.shapetype[n] = EAVL_POINT;
+        nodeCellConnectivity.mapCellToIndex[n] = start[n];
+        nodeCellConnectivity.connectivity[start[n]] = size[n] - 1;
+        size[n] = start[n] + 1;
+    }
+
+    // scatter: the entries of cell i start at its connectivity
+    // index less the i+1 point counts which precede them
+    if (nEntries > 0)
+    {
+        eavlIntArray entrycells("nodecellentrycells", 1, nEntries);
+        eavlIntArray entrydests("nodecellentrydests", 1, nEntries);
+        int *entrycell = (int*)entrycells.GetHostArray();
+        int *entrydest = (int*)entrydests.GetHostArray();
+#pragma omp parallel for
+        for (int i=0; i<nCells; i++)
         {
-            // add empty spots to skip nodes not referenced by our cells
-            // but also create an empty one that we can start adding
-            // connectivity items to for ones that are referenced.
-            ++filled_array_to_node;
-            nodeCellConnectivity.shapetype.push_back(EAVL_POINT);
-            cur_node_connstart = nodeCellConnectivity.connectivity.size();
-            nodeCellConnectivity.connectivity.push_back(0);
+            int index = cellNodeConnectivity.mapCellToIndex[i];
+            int npts = cellNodeConnectivity.connectivity[index];
+            int entry = index - i;
+            for (int p=0; p<npts; p++)
+            {
+                int node = cellNodeConnectivity.connectivity[index + 1 + p];
+                int dest;
+#pragma omp atomic capture
+                dest = size[node]++;
+                entrycell[entry + p] = i;
+                entrydest[entry + p] = dest;
+            }
         }
-        int cell = iter->second;
-        nodeCellConnectivity.connectivity.push_back(cell);
-        ++nodeCellConnectivity.connectivity[cur_node_connstart];
+
+        eavlIntArray conn(eavlArray::HOST,
+                          &nodeCellConnectivity.connectivity[0],
+                          "nodecellconnectivity", 1, nNodes + nEntries);
+        eavlExecutor::RunOnCPU(new_eavlScatterOp(eavlOpArgs(&entrycells),
+                                                 eavlOpArgs(&conn),
+                                                 eavlOpArgs(&entrydests)),
+                               "scatter node cells");
     }
-    while (filled_array_to_node < dataset_numpoints)
+
+    // order each node's cells; most lists are short, so insertion sort
+    // those, but a node shared by many cells (e.g. the apex of a fan)
+    // must not cost quadratic time
+#pragma omp parallel for schedule(dynamic,256)
+    for (int n=0; n<nNodes; n++)
     {
-        // add empty spots for tail nodes not referenced by our cells
-        ++filled_array_to_node;
-        nodeCellConnectivity.shapetype.push_back(EAVL_POINT);
-        cur_node_connstart = nodeCellConnectivity.connectivity.size();
-        nodeCellConnectivity.connectivity.push_back(0);
+        int *begin = &nodeCellConnectivity.connectivity[start[n] + 1];
+        int *end   = &nodeCellConnectivity.connectivity[0] + size[n];
+        if (end - begin < 32)
+        {
+            for (int *i = begin+1; i < end; i++)
+            {
+                int cell = *i;
+                int *j = i;
+                for ( ; j > begin && cell < *(j-1); j--)
+                    *j = *(j-1);
+                *j = cell;
+            }
+        }
+        else
+        {
+            std::sort(begin, end);
+        }
     }
 
-    nodeCellConnectivity.CreateReverseIndex();
+    haveNodeCellConnectivity = true;
 }
@@ -7,6 +7,7 @@
 #include "eavlArray.h"
 #include "eavlException.h"
 #include "eavlExplicitConnectivity.h"
+#include "eavlPackedConnectivity.h"
 
 // ****************************************************************************
 // Class:  eavlCellSetExplicit
@@ -22,6 +23,20 @@
 //   Jeremy Meredith, Fri Oct 19 16:54:36 EDT 2012
 //   Added reverse connectivity (i.e. get cells attached to a node).
 //
+//   agent, October 17, 2026
+//   Added GetEdgeNodes.
+//
+//   agent, October 17, 2026
+//   Once a topology is packed, release its explicit connectivity and
+//   only rebuild it if it is asked for again.  Added GetElement.
+//
+//   agent, October 17, 2026
+//   Renew the modification stamp when the connectivity is replaced.
+//
+//   agent, October 17, 2026
+//   Keep the explicit form of a topology once GetConnectivity has handed
+//   out a reference to it, rather than releasing it under the caller.
+//
 // ****************************************************************************
 
 class eavlCellSetExplicit : public eavlCellSet
@@ -41,24 +56,112 @@ class eavlCellSetExplicit : public eavlCellSet
 
     int numEdges;
     int numFaces;
+    bool haveNodeCellConnectivity;
+
+    /// compact copies of the connectivity for the topology map ops,
+    /// one for each eavlTopology, packed on demand; once a topology is
+    /// packed its explicit connectivity above is released, unless
+    /// GetConnectivity has handed out a reference to it, and it is only
+    /// unpacked again if GetConnectivity asks for it
+    eavlPackedConnectivity packedConnectivity[EAVL_FACES_OF_CELLS+1];
+    bool                   havePackedConnectivity[EAVL_FACES_OF_CELLS+1];
+    bool                   releasedConnectivity[EAVL_FACES_OF_CELLS+1];
+    bool                   referencedConnectivity[EAVL_FACES_OF_CELLS+1];
 
     void BuildEdgeConnectivity();
     void BuildFaceConnectivity();
     void BuildNodeCellConnectivity();
+    void BuildConnectivity(eavlTopology topology);
+    void SerializeConnectivity(eavlStream &s, eavlTopology topology) const;
+    const eavlExplicitConnectivity &
+    ExplicitConnectivity(eavlTopology topology) const
+    {
+        switch (topology)
+        {
+          case EAVL_NODES_OF_CELLS: return cellNodeConnectivity;
+          case EAVL_CELLS_OF_NODES: return nodeCellConnectivity;
+          case EAVL_NODES_OF_EDGES: return edgeNodeConnectivity;
+          case EAVL_NODES_OF_FACES: return faceNodeConnectivity;
+          case EAVL_EDGES_OF_CELLS: return cellEdgeConnectivity;
+          case EAVL_FACES_OF_CELLS: return cellFaceConnectivity;
+        }
+        THROW(eavlException,"unexpected topology type in ExplicitConnectivity");
+    }
+    eavlExplicitConnectivity &ExplicitConnectivity(eavlTopology topology)
+    {
+        const eavlCellSetExplicit *self = this;
+        return const_cast<eavlExplicitConnectivity&>(
+                                      self->ExplicitConnectivity(topology));
+    }
+    /// The explicit form of a topology, built or unpacked if need be,
+    /// without counting as a reference handed out.
+    eavlExplicitConnectivity &UnpackedConnectivity(eavlTopology topology)
+    {
+        BuildConnectivity(topology);
+        eavlExplicitConnectivity &conn = ExplicitConnectivity(topology);
+        if (releasedConnectivity[topology])
+        {
+            packedConnectivity[topology].Unpack(conn);
+            releasedConnectivity[topology] = false;
+        }
+        return conn;
+    }
+    void ReleaseConnectivity(eavlTopology topology)
+    {
+        ExplicitConnectivity(topology).Release();
+        releasedConnectivity[topology] = true;
+    }
+    void InvalidatePackedConnectivity()
+    {
+        for (int t=0; t<=EAVL_FACES_OF_CELLS; t++)
+        {
+            havePackedConnectivity[t] = false;
+            releasedConnectivity[t] = false;
+        }
+    }
+    void ForgetConnectivityReferences()
+    {
+        for (int t=0; t<=EAVL_FACES_OF_CELLS; t++)
+            referencedConnectivity[t] = false;
+    }
   public:
-    eavlCellSetExplicit() : eavlCellSet("", 0) {}
+    eavlCellSetExplicit()
+        : eavlCellSet("", 0),
+          numEdges(-1),
+          numFaces(-1),
+          haveNodeCellConnectivity(false)
+    {
+        InvalidatePackedConnectivity();
+        ForgetConnectivityReferences();
+    }
     eavlCellSetExplicit(const string &n, int d)
         : eavlCellSet(n,d),
           numEdges(-1),
-          numFaces(-1)
+          numFaces(-1),
+          haveNodeCellConnectivity(false)
     {
+        InvalidatePackedConnectivity();
+        ForgetConnectivityReferences();
     }
     virtual string className() const {return "eavlCellSetExplicit";}
     virtual eavlStream& serialize(eavlStream &s) const;
     virtual eavlStream& deserialize(eavlStream &s);
-    virtual int GetNumCells() { return cellNodeConnectivity.shapetype.size(); }
-    virtual int GetNumEdges() { BuildEdgeConnectivity(); return numEdges; }
-    virtual int GetNumFaces() { BuildFaceConnectivity(); return numFaces; }
+    virtual int GetNumCells()
+    {
+        if (releasedConnectivity[EAVL_NODES_OF_CELLS])
+            return packedConnectivity[EAVL_NODES_OF_CELLS].GetNumElements();
+        return cellNodeConnectivity.shapetype.size();
+    }
+    virtual int GetNumEdges()
+    {
+        BuildConnectivity(EAVL_NODES_OF_EDGES);
+        return numEdges;
+    }
+    virtual int GetNumFaces()
+    {
+        BuildConnectivity(EAVL_NODES_OF_FACES);
+        return numFaces;
+    }
     virtual void PrintSummary(ostream &out)
     {
         out << "    eavlCellSetExplicit:\n";
@@ -67,7 +170,16 @@ class eavlCellSetExplicit : public eavlCellSet
         out << "        dimensionality = "<<dimensionality<<endl;
         out << "        nCells = "<<GetNumCells()<<endl;
         out << "        cellNodeConnectivity =\n";
-        cellNodeConnectivity.PrintSummary(out);
+        if (releasedConnectivity[EAVL_NODES_OF_CELLS])
+        {
+            eavlExplicitConnectivity conn;
+            packedConnectivity[EAVL_NODES_OF_CELLS].Unpack(conn);
+            conn.PrintSummary(out);
+        }
+        else
+        {
+            cellNodeConnectivity.PrintSummary(out);
+        }
         //out << "        nodeCellConnectivity =\n";
         //nodeCellConnectivity.PrintSummary(out);
     }
@@ -77,91 +189,99 @@ class eavlCellSetExplicit : public eavlCellSet
         cellNodeConnectivity.CreateReverseIndex();
         numEdges = -1;
         numFaces = -1;
+        haveNodeCellConnectivity = false;
+        InvalidatePackedConnectivity();
+        Modified();
     }
+    virtual void SetDSNumPoints(int n)
+    {
+        // the node->cell connectivity has an entry for every point
+        if (n != dataset_numpoints)
+        {
+            haveNodeCellConnectivity = false;
+            havePackedConnectivity[EAVL_CELLS_OF_NODES] = false;
+            releasedConnectivity[EAVL_CELLS_OF_NODES] = false;
+        }
+        eavlCellSet::SetDSNumPoints(n);
+    }
+    /// The explicit connectivity of a topology.  The reference stays
+    /// valid for the life of the cell set: once one has been handed out,
+    /// packing the topology no longer releases its explicit form.
     eavlExplicitConnectivity &GetConnectivity(eavlTopology topology)
     {
         ///\todo: this should return a *const* ref, except then we can't send
         /// it to the GPU because that required modified the conn device ptr.
-        switch (topology)
+        referencedConnectivity[topology] = true;
+        return UnpackedConnectivity(topology);
+    }
+    /// The same connectivity as GetConnectivity, in the compact form
+    /// the topology map ops read.  The explicit form is released once
+    /// this is packed, unless GetConnectivity has handed it out.
+    eavlPackedConnectivity &GetPackedConnectivity(eavlTopology topology)
+    {
+        if (!havePackedConnectivity[topology])
         {
-          case EAVL_NODES_OF_CELLS:
-            return cellNodeConnectivity;
-
-          case EAVL_CELLS_OF_NODES:
-            BuildNodeCellConnectivity();
-            return nodeCellConnectivity;
-
-          case EAVL_NODES_OF_EDGES:
-            BuildEdgeConnectivity();
-            return edgeNodeConnectivity;
-
-          case EAVL_NODES_OF_FACES:
-            BuildFaceConnectivity();
-            return faceNodeConnectivity;
-
-          case EAVL_EDGES_OF_CELLS:
-            BuildEdgeConnectivity();
-            return cellEdgeConnectivity;
-
-          case EAVL_FACES_OF_CELLS:
-            BuildFaceConnectivity();
-            return cellFaceConnectivity;
+            packedConnectivity[topology].Pack(UnpackedConnectivity(topology));
+            havePackedConnectivity[topology] = true;
+            if (!referencedConnectivity[topology])
+                ReleaseConnectivity(topology);
         }
-        THROW(eavlException,"unexpected topology type in GetConnectivity");
+        return packedConnectivity[topology];
     }
-    virtual eavlCell GetCellNodes(int i)
+    /// Element i of a topology, read from whichever of the explicit or
+    /// packed forms is kept, without unpacking.
+    eavlCell GetElement(eavlTopology topology, int i)
     {
+        BuildConnectivity(topology);
         eavlCell cell;
-        int index = cellNodeConnectivity.mapCellToIndex[i];
-        cell.type = (eavlCellShape)cellNodeConnectivity.shapetype[i];
-        cell.numIndices = cellNodeConnectivity.connectivity[index];
-        for (int n=0; n<cell.numIndices; n++)
-            cell.indices[n] = cellNodeConnectivity.connectivity[index + 1 + n];
+        if (releasedConnectivity[topology])
+        {
+            eavlPackedConnectivity &packed = packedConnectivity[topology];
+            if (packed.IsHomogeneous())
+                cell.type = eavlCellShape(
+                    eavlHomogeneousConnectivity(packed, eavlArray::HOST).
+                        GetElementComponents(i, cell.numIndices, cell.indices));
+            else
+                cell.type = eavlCellShape(
+                    eavlMixedConnectivity(packed, eavlArray::HOST).
+                        GetElementComponents(i, cell.numIndices, cell.indices));
+        }
+        else
+        {
+            cell.type = eavlCellShape(ExplicitConnectivity(topology).
+                        GetElementComponents(i, cell.numIndices, cell.indices));
+        }
         return cell;
     }
+    virtual eavlCell GetCellNodes(int i)
+    {
+        return GetElement(EAVL_NODES_OF_CELLS, i);
+    }
     virtual eavlCell GetNodeCells(int i)
     {
-        BuildNodeCellConnectivity();
-        eavlCell cell;
-        int index = nodeCellConnectivity.mapCellToIndex[i];
-        cell.type = (eavlCellShape)nodeCellConnectivity.shapetype[i];
-        cell.numIndices = nodeCellConnectivity.connectivity[index];
-        for (int n=0; n<cell.numIndices; n++)
-            cell.indices[n] = nodeCellConnectivity.connectivity[index + 1 + n];
-        return cell;
+        return GetElement(EAVL_CELLS_OF_NODES, i);
     }
     virtual eavlCell GetCellEdges(int i)
     {
-        BuildEdgeConnectivity();
-        eavlCell cell;
-        int index = cellEdgeConnectivity.mapCellToIndex[i];
-        cell.type = (eavlCellShape)cellEdgeConnectivity.shapetype[i];
-        cell.numIndices = cellEdgeConnectivity.connectivity[index];
-        for (int n=0; n<cell.numIndices; n++)
-            cell.indices[n] = cellEdgeConnectivity.connectivity[index + 1 + n];
-        return cell;
+        return GetElement(EAVL_EDGES_OF_CELLS, i);
+    }
+    virtual eavlCell GetEdgeNodes(int i)
+    {
+        return GetElement(EAVL_NODES_OF_EDGES, i);
     }
     virtual eavlCell GetCellFaces(int i)
     {
-        BuildFaceConnectivity();
-        eavlCell cell;
-        int index = cellFaceConnectivity.mapCellToIndex[i];
-        cell.type = (eavlCellShape)cellFaceConnectivity.shapetype[i];
-        cell.numIndices = cellFaceConnectivity.connectivity[index];
-        for (int n=0; n<cell.numIndices; n++)
-            cell.indices[n] = cellFaceConnectivity.connectivity[index + 1 + n];
-        return cell;
+        return GetElement(EAVL_FACES_OF_CELLS, i);
     }
     virtual long long GetMemoryUsage()
     {
         long long mem = 0;
-        mem += sizeof(vector<eavlCellShape>);
-        mem += cellNodeConnectivity.shapetype.size() * sizeof(eavlCellShape);
-        mem += sizeof(vector<int>);
-        mem += cellNodeConnectivity.connectivity.size() * sizeof(int);
-        mem += sizeof(vector<int>);
-        mem += cellNodeConnectivity.mapCellToIndex.size() * sizeof(int);
-        ///\todo: update this (e.g. with edge, face connectivity)
+        for (int t=0; t<=EAVL_FACES_OF_CELLS; t++)
+        {
+            mem += ExplicitConnectivity(eavlTopology(t)).GetMemoryUsage();
+            if (havePackedConnectivity[t])
+                mem += packedConnectivity[t].GetMemoryUsage();
+        }
         return mem + eavlCellSet::GetMemoryUsage();
     }
 };
@@ -171,19 +291,38 @@ inline eavlStream& eavlCellSetExplicit::serialize(eavlStream &s) const
     s << className();
     eavlCellSet::serialize(s);
     s << numEdges<<numFaces;
-    cellNodeConnectivity.serialize(s);
-    nodeCellConnectivity.serialize(s);
-    cellEdgeConnectivity.serialize(s);
-    edgeNodeConnectivity.serialize(s);
-    cellFaceConnectivity.serialize(s);
-    faceNodeConnectivity.serialize(s);
+    SerializeConnectivity(s, EAVL_NODES_OF_CELLS);
+    SerializeConnectivity(s, EAVL_CELLS_OF_NODES);
+    SerializeConnectivity(s, EAVL_EDGES_OF_CELLS);
+    SerializeConnectivity(s, EAVL_NODES_OF_EDGES);
+    SerializeConnectivity(s, EAVL_FACES_OF_CELLS);
+    SerializeConnectivity(s, EAVL_NODES_OF_FACES);
     return s;
 }
 
+// released topologies are written in the explicit form they had
+inline void
+eavlCellSetExplicit::SerializeConnectivity(eavlStream &s,
+                                           eavlTopology topology) const
+{
+    if (releasedConnectivity[topology])
+    {
+        eavlExplicitConnectivity conn;
+        packedConnectivity[topology].Unpack(conn);
+        conn.serialize(s);
+    }
+    else
+    {
+        ExplicitConnectivity(topology).serialize(s);
+    }
+}
+
 inline eavlStream& eavlCellSetExplicit::deserialize(eavlStream &s)
 {
     eavlCellSet::deserialize(s);
     s >> numEdges >> numFaces;
+    haveNodeCellConnectivity = false;
+    InvalidatePackedConnectivity();
     cellNodeConnectivity.deserialize(s);
     nodeCellConnectivity.deserialize(s);
     cellEdgeConnectivity.deserialize(s);
@@ -22,6 +22,10 @@
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    February 15, 2011
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Hold a reference to the parent, so it outlives the subset.
+//
 // ****************************************************************************
 
 
@@ -36,6 +40,11 @@ class eavlCellSetSubset : public eavlCellSet
         : eavlCellSet(string("subset_of_")+p->GetName(), p->GetDimensionality()),
           parent(p)
     {
+        parent->AddReference();
+    }
+    virtual ~eavlCellSetSubset()
+    {
+        parent->Release();
     }
 
     virtual string className() const {return "eavlCellSetSubset";}
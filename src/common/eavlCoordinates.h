@@ -5,9 +5,12 @@
 #include "eavlField.h"
 #include "eavlLogicalStructure.h"
 #include "eavlException.h"
+#include "eavlReferenceCounted.h"
 
 
-class eavlCoordinateAxis
+// reference counted, so a new coordinate system can share some of the axes
+// of the one it replaces
+class eavlCoordinateAxis : public eavlReferenceCounted
 {
   public:
     virtual ~eavlCoordinateAxis()
@@ -185,8 +188,15 @@ class eavlCoordinateAxisRegular : public eavlCoordinateAxis
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    February 17, 2012
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Made reference counted, so several data sets can share one.
+//
+//   agent, October 17, 2026
+//   Hold a reference to each axis, so coordinate systems can share them.
+//
 // ****************************************************************************
-class eavlCoordinates
+class eavlCoordinates : public eavlReferenceCounted
 {
   protected:
     vector<eavlCoordinateAxis*> axes;
@@ -213,7 +223,10 @@ class eavlCoordinates
     virtual ~eavlCoordinates()
     {
         for (unsigned int i=0; i<axes.size(); ++i)
-            delete axes[i];
+        {
+            if (axes[i])
+                axes[i]->Release();
+        }
     }
     
     virtual string className() const {return "eavlCoordinates";}
@@ -230,13 +243,15 @@ class eavlCoordinates
     {
 	size_t sz;
 	s >> sz;
+	for (size_t i = 0; i < axes.size(); i++)
+	    SetAxis(i, NULL);
 	axes.resize(sz);
 	
 	string nm;
 	for (size_t i = 0; i < sz; i++)
 	{
 	    s >> nm;
-	    axes[i] = eavlCoordinateAxis::CreateObjFromName(nm);
+	    SetAxis(i, eavlCoordinateAxis::CreateObjFromName(nm));
 	    axes[i]->deserialize(s);
 	}
 	s >> indexMods >> indexDivs;
@@ -244,10 +259,14 @@ class eavlCoordinates
     }
     static eavlCoordinates* CreateObjFromName(const string &nm);
 
+    /// Takes a reference to the new axis, which may be shared with
+    /// another coordinate system, and releases the old one.
     void SetAxis(int i, eavlCoordinateAxis *a)
     {
+        if (a)
+            a->AddReference();
         if (axes[i])
-            delete axes[i];
+            axes[i]->Release();
         axes[i] = a;
     }
     eavlCoordinateAxis *GetAxis(int i)
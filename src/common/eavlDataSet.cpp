@@ -2,6 +2,7 @@
 #include "eavlDataSet.h"
 #include "eavlCellSetAllStructured.h"
 #include "eavlException.h"
+#include "eavlImplicitArray.h"
 
 
 eavlStream& eavlDataSet::serialize(eavlStream &s) const
@@ -36,6 +37,7 @@ eavlStream& eavlDataSet::deserialize(eavlStream &s)
 {
     string nm;
     size_t sz;
+    InvalidatePointCache();
     s >> nm;
     s >> npoints;
     s >> sz;
@@ -55,6 +57,7 @@ eavlStream& eavlDataSet::deserialize(eavlStream &s)
     {
 	s >> nm;
 	cellsets[i] = eavlCellSet::CreateObjFromName(nm);
+	cellsets[i]->AddReference();
 	cellsets[i]->deserialize(s);
     }
     s >> sz;
@@ -63,6 +66,7 @@ eavlStream& eavlDataSet::deserialize(eavlStream &s)
     {
 	s >> nm;
 	coordinateSystems[i] = eavlCoordinates::CreateObjFromName(nm);
+	coordinateSystems[i]->AddReference();
 	coordinateSystems[i]->deserialize(s);
     }
 
@@ -72,6 +76,7 @@ eavlStream& eavlDataSet::deserialize(eavlStream &s)
     {
 	s >> nm;
 	logicalStructure = eavlLogicalStructure::CreateObjFromName(nm);
+	logicalStructure->AddReference();
 	logicalStructure->deserialize(s);
     }
 	
@@ -193,6 +198,99 @@ AddRectilinearMesh(eavlDataSet *data,
     return meshIndex;
 }
 
+// ****************************************************************************
+// Function:  AddUniformMesh
+//
+// Purpose:
+///  Add a uniform mesh, and optional cellsets to a data set.  It is laid
+///  out as a rectilinear mesh, but each axis is an eavlUniformArray
+///  computed from the origin and spacing, so no coordinates are stored.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+
+int
+AddUniformMesh(eavlDataSet *data,
+               const int dims[3],
+               const double origin[3],
+               const double spacing[3],
+               const vector<string> &coordinateNames,
+               bool addCellSet,
+               string cellSetName)
+{
+    if (data->GetNumCoordinateSystems() != 0)
+        THROW(eavlException,"Error: multiple meshes not supported!");
+    if (coordinateNames.size() != 3)
+        THROW(eavlException,"Error: a uniform mesh needs three coordinateNames");
+
+    int dimension = 0;
+    int ldims[3];
+    int npoints = 1;
+    for (int d = 0; d < 3; d++)
+    {
+        if (dims[d] > 1)
+        {
+            npoints *= dims[d];
+            ldims[dimension] = dims[d];
+            dimension++;
+        }
+    }
+    data->SetNumPoints(npoints);
+
+    eavlRegularStructure reg;
+    if (dimension == 1)
+        reg.SetNodeDimension1D(ldims[0]);
+    else if (dimension == 2)
+        reg.SetNodeDimension2D(ldims[0],ldims[1]);
+    else if (dimension == 3)
+        reg.SetNodeDimension3D(ldims[0],ldims[1],ldims[2]);
+    else
+        THROW(eavlException,"unxpected number of dimensions");
+
+    eavlLogicalStructureRegular *log =
+        new eavlLogicalStructureRegular(dimension, reg);
+    eavlCoordinatesCartesian *coords =
+        new eavlCoordinatesCartesian(log,
+                                     eavlCoordinatesCartesian::X,
+                                     eavlCoordinatesCartesian::Y,
+                                     eavlCoordinatesCartesian::Z);
+
+    int ldim = 0;
+    for (int d = 0; d < 3; d++)
+    {
+        eavlUniformArray<float> *c =
+            new eavlUniformArray<float>(coordinateNames[d], 1,
+                                        &dims[d], &origin[d], &spacing[d]);
+        eavlField *cField = NULL;
+        if (dims[d] > 1)
+        {
+            cField = new eavlField(1, c, eavlField::ASSOC_LOGICALDIM, ldim);
+            ldim++;
+        }
+        else
+            cField = new eavlField(1, c, eavlField::ASSOC_WHOLEMESH);
+        data->AddField(cField);
+
+        coords->SetAxis(d, new eavlCoordinateAxisField(coordinateNames[d]));
+    }
+
+    data->AddCoordinateSystem(coords);
+    int meshIndex = data->GetNumCoordinateSystems()-1;
+    data->SetLogicalStructure(log);
+
+    if (addCellSet)
+    {
+        eavlCellSetAllStructured *cellset =
+            new eavlCellSetAllStructured(cellSetName, reg);
+        data->AddCellSet(cellset);
+    }
+
+    return meshIndex;
+}
+
 // ****************************************************************************
 // Function:  AddCurvilinearMesh
 //
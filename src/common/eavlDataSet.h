@@ -25,10 +25,31 @@
 ///       eavlCoordinates, but I'm not sure what I think of that.
 ///       Maybe better: these are now simply single-valued FIELDS,
 ///       with an association to the whole-mesh? 
+///   The Cartesian point locations for a coordinate system can be
+///   read all at once with GetPoints, or kept on the data set with
+///   GetCachedPoints, which recomputes them when the coordinates change.
+///   The data set holds a reference to each of its cell sets, coordinate
+///   systems and logical structure, and its fields to their arrays, so
+///   these can be shared with other data sets; see CreateShallowCopy.
 //
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    February 15, 2011
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Added the point cache.
+//
+//   agent, October 17, 2026
+//   Reference the parts instead of owning them, and made
+//   CreateShallowCopy share them safely.
+//
+//   agent, October 17, 2026
+//   Check the point cache against the coordinate arrays' modification
+//   stamps, stop reading it in GetPoint, and added GetPoints.
+//
+//   agent, October 17, 2026
+//   Release the coordinate system SetCoordinateSystem replaces.
+//
 // ****************************************************************************
 class eavlDataSet
 {
@@ -39,6 +60,42 @@ class eavlDataSet
     vector<eavlCellSet*>         cellsets;
     vector<eavlCoordinates*>     coordinateSystems;
     eavlLogicalStructure        *logicalStructure;
+    struct PointCache
+    {
+        vector<double>        points;
+        vector<unsigned long> stamps;    ///< of the axes' arrays
+        vector<float>         transform; ///< of the coordinate system, if any
+    };
+    vector<PointCache>           pointCache; ///< per coordinate system
+
+    // what a coordinate system's points depend on besides the number of
+    // points and the logical structure: the arrays its axes read (found
+    // the same way the axes find them), and any transform
+    void GetPointCacheKey(eavlCoordinates *cs, vector<unsigned long> &stamps,
+                          vector<float> &transform)
+    {
+        for (int a=0; a<cs->GetDimension(); ++a)
+        {
+            eavlCoordinateAxisField *axis =
+                dynamic_cast<eavlCoordinateAxisField*>(cs->GetAxis(a));
+            if (!axis)
+                continue;
+            unsigned long stamp = 0;
+            for (unsigned int f=0; f<fields.size(); ++f)
+            {
+                if (fields[f]->GetArray()->GetName() == axis->GetFieldName())
+                    stamp = fields[f]->GetArray()->GetModificationStamp();
+            }
+            stamps.push_back(stamp);
+        }
+        eavlCoordinatesCartesianWithTransform *tcs =
+            dynamic_cast<eavlCoordinatesCartesianWithTransform*>(cs);
+        if (tcs)
+        {
+            eavlMatrix4x4 m = tcs->GetTransform();
+            transform.assign(&m.m[0][0], &m.m[0][0] + 16);
+        }
+    }
 
   public:
     eavlDataSet()
@@ -86,12 +143,12 @@ class eavlDataSet
     {
         discreteCoordinates.clear();
         if (logicalStructure)
-            delete logicalStructure;
+            logicalStructure->Release();
         logicalStructure = NULL;
         for (unsigned int i=0; i<cellsets.size(); ++i)
         {
             if (cellsets[i])
-                delete cellsets[i];
+                cellsets[i]->Release();
         }
         cellsets.clear();
         for (unsigned int i=0; i<fields.size(); ++i)
@@ -103,20 +160,32 @@ class eavlDataSet
         for (unsigned int i=0; i<coordinateSystems.size(); ++i)
         {
             if (coordinateSystems[i])
-                delete coordinateSystems[i];
+                coordinateSystems[i]->Release();
         }
         coordinateSystems.clear();
         npoints = 0;
+        InvalidatePointCache();
     }
+    /// Returns a new data set sharing this one's cell sets, coordinate
+    /// systems, logical structure and field arrays, without copying
+    /// their values.  The copy has fields of its own, so fields may be
+    /// added to either data set without affecting the other, and either
+    /// may be deleted first.  The shared parts themselves should not be
+    /// changed in place through one data set unless the change is meant
+    /// for both.
     eavlDataSet *CreateShallowCopy()
     {
         eavlDataSet *data = new eavlDataSet;
         data->npoints             = npoints;
         data->discreteCoordinates = discreteCoordinates;
-        data->fields              = fields;
-        data->cellsets            = cellsets;
-        data->coordinateSystems   = coordinateSystems;
-        data->logicalStructure    = logicalStructure;
+        if (logicalStructure)
+            data->SetLogicalStructure(logicalStructure);
+        for (unsigned int i=0; i<coordinateSystems.size(); ++i)
+            data->AddCoordinateSystem(coordinateSystems[i]);
+        for (unsigned int i=0; i<cellsets.size(); ++i)
+            data->AddCellSet(cellsets[i]);
+        for (unsigned int i=0; i<fields.size(); ++i)
+            data->AddField(new eavlField(fields[i]));
         return data;
     }
     
@@ -128,6 +197,7 @@ class eavlDataSet
     void SetNumPoints(int n)
     {
         npoints = n;
+        InvalidatePointCache();
         for (unsigned int i=0; i<cellsets.size(); i++)
         {
             cellsets[i]->SetDSNumPoints(npoints);
@@ -144,6 +214,85 @@ class eavlDataSet
             GetCartesianPoint(i,c,logicalStructure,fields);
     }
 
+    /// Fills pts with the Cartesian location of every point as x,y,z
+    /// triples, copied from the cache if it is current (see
+    /// GetCachedPoints) and otherwise computed without keeping them.
+    void GetPoints(vector<double> &pts, int whichCoordSystem=0)
+    {
+        if (whichCoordSystem < 0 ||
+            whichCoordSystem >= (int)coordinateSystems.size())
+            THROW(eavlException,"Asked for points from a nonexistent coordinate system");
+        if (npoints <= 0)
+        {
+            pts.clear();
+            return;
+        }
+
+        eavlCoordinates *cs = coordinateSystems[whichCoordSystem];
+        if (whichCoordSystem < (int)pointCache.size() &&
+            !pointCache[whichCoordSystem].points.empty())
+        {
+            PointCache &cache = pointCache[whichCoordSystem];
+            vector<unsigned long> stamps;
+            vector<float> transform;
+            GetPointCacheKey(cs, stamps, transform);
+            if (stamps == cache.stamps && transform == cache.transform)
+            {
+                pts = cache.points;
+                return;
+            }
+        }
+
+        pts.resize(3*npoints);
+        for (int i=0; i<npoints; ++i)
+        {
+            for (int c=0; c<3; ++c)
+                pts[3*i+c] = cs->GetCartesianPoint(i,c,logicalStructure,
+                                                   fields);
+        }
+    }
+
+    /// Returns the Cartesian location of every point as x,y,z triples,
+    /// kept on the data set (at 24 bytes per point) until
+    /// InvalidatePointCache, for callers reading them repeatedly.  They
+    /// are recomputed when the number of points, the logical structure,
+    /// the coordinate system, its transform or the values of the arrays
+    /// its axes read have changed since.  The pointer is valid until
+    /// the next call.
+    const double *GetCachedPoints(int whichCoordSystem=0)
+    {
+        if (whichCoordSystem < 0 ||
+            whichCoordSystem >= (int)coordinateSystems.size())
+            THROW(eavlException,"Asked for points from a nonexistent coordinate system");
+        if (npoints <= 0)
+            return NULL;
+
+        if ((int)pointCache.size() <= whichCoordSystem)
+            pointCache.resize(whichCoordSystem+1);
+        PointCache &cache = pointCache[whichCoordSystem];
+        vector<unsigned long> stamps;
+        vector<float> transform;
+        GetPointCacheKey(coordinateSystems[whichCoordSystem],
+                         stamps, transform);
+        if (cache.points.empty() ||
+            stamps != cache.stamps || transform != cache.transform)
+        {
+            vector<double>().swap(cache.points);
+            vector<double> pts;
+            GetPoints(pts, whichCoordSystem);
+            cache.points.swap(pts);
+            cache.stamps.swap(stamps);
+            cache.transform.swap(transform);
+        }
+        return &cache.points[0];
+    }
+
+    /// Drops the cached points, freeing their memory.
+    void InvalidatePointCache()
+    {
+        pointCache.clear();
+    }
+
     long long GetMemoryUsage()
     {
         long long mem = 0;
@@ -155,6 +304,10 @@ class eavlDataSet
 
         mem += sizeof(eavlLogicalStructure*);
 
+        mem += sizeof(vector<PointCache>);
+        for (size_t i=0; i<pointCache.size(); i++)
+            mem += pointCache[i].points.size() * sizeof(double);
+
         mem += sizeof(vector<eavlCoordinates*>);
         mem += coordinateSystems.size() * sizeof(eavlCoordinates*);
         for (size_t i=0; i<coordinateSystems.size(); i++)
@@ -187,7 +340,12 @@ class eavlDataSet
 
     void SetLogicalStructure(eavlLogicalStructure *log)
     {
+        if (log)
+            log->AddReference();
+        if (logicalStructure)
+            logicalStructure->Release();
         logicalStructure = log;
+        InvalidatePointCache();
     }
 
     int GetNumCoordinateSystems()
@@ -202,12 +360,18 @@ class eavlDataSet
 
     void AddCoordinateSystem(eavlCoordinates *cs)
     {
+        cs->AddReference();
         coordinateSystems.push_back(cs);
     }
 
+    /// Replaces a coordinate system, releasing the old one.  The new one
+    /// may share some of its axes, as it holds references to them.
     void SetCoordinateSystem(int index, eavlCoordinates *cs)
     {
+        cs->AddReference();
+        coordinateSystems[index]->Release();
         coordinateSystems[index] = cs;
+        InvalidatePointCache();
     }
 
     virtual int GetNumCellSets()
@@ -253,6 +417,7 @@ class eavlDataSet
     
     void AddCellSet(eavlCellSet *c)
     {
+        c->AddReference();
         cellsets.push_back(c);
         c->SetDSNumPoints(npoints);
     }
@@ -355,6 +520,14 @@ AddRectilinearMesh(eavlDataSet *data,
                    const vector<string> &coordinateNames,
                    bool addCellSet, string cellSetName="");
 
+int
+AddUniformMesh(eavlDataSet *data,
+               const int dims[3],
+               const double origin[3],
+               const double spacing[3],
+               const vector<string> &coordinateNames,
+               bool addCellSet, string cellSetName="");
+
 int
 AddCurvilinearMesh(eavlDataSet *data,
                    int dims[3],
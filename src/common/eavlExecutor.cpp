@@ -1,29 +1,298 @@
 // Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
 #include "eavlExecutor.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+// fused element-wise operations are run in chunks of this many items,
+// small enough that the intermediate arrays stay in cache between stages
+#define EAVL_FUSED_CHUNK_SIZE 8192
 
 eavlExecutor::ExecutionMode eavlExecutor::executionMode = PreferGPU;
 eavlExecutor *eavlExecutor::instance = NULL;
 
+static double
+eavlWallTime()
+{
+#if defined(_WIN32)
+    struct _timeb t;
+    _ftime(&t);
+    return double(t.time) + double(t.millitm) / 1.e3;
+#else
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return double(t.tv_sec) + double(t.tv_usec) / 1.e6;
+#endif
+}
+
+// move the arrays an operation (or stage) uses to the host, reading the
+// inputs with the const accessor so they keep their cached ranges, and
+// marking the outputs as written
+static void
+eavlUseArraysOnHost(const vector<eavlOperationArray> &inputs,
+                    const vector<eavlOperationArray> &outputs)
+{
+    for (unsigned int a=0; a<inputs.size(); a++)
+        inputs[a].array->GetConstHostArray();
+    for (unsigned int a=0; a<outputs.size(); a++)
+        outputs[a].array->GetHostArray();
+}
+
+// mark the arrays an operation writes as written, since it may be
+// handed them through the const accessors (see eavlOpDispatch)
+static void
+eavlMarkOutputsWritten(const vector<eavlOperationArray> &outputs)
+{
+    for (unsigned int a=0; a<outputs.size(); a++)
+        outputs[a].array->InvalidateRanges();
+}
+
+// one operation in the plan, or a group of operations fused together
+struct eavlExecutor::Stage
+{
+    vector<int>                ops;
+    string                     name;
+    bool                       known;
+    vector<eavlOperationArray> inputs;
+    vector<eavlOperationArray> outputs;
+    eavlCellSet               *cells;
+    int                        length;
+    int                        level;
+    CPUSettings                settings;
+};
+
+// the stages of a plan, and the levels they run in on the CPU
+struct eavlExecutor::Schedule
+{
+    vector<Stage>        stages;
+    vector<vector<int> > levels;
+    vector<int>          lengths; ///< each operation's length when scheduled
+    vector<pair<eavlArray*,eavlArray*> > aliases; ///< arrays sharing values when scheduled
+};
+
+// runs ranges of one operation's work items on the thread pool
+struct eavlExecutor::RangeBody : public eavlThreadPool::Body
+{
+    eavlOperation                    *op;
+    const vector<eavlOperationArray> &inputs;
+    const vector<eavlOperationArray> &outputs;
+    RangeBody(eavlOperation *o, const vector<eavlOperationArray> &in,
+              const vector<eavlOperationArray> &out)
+        : op(o), inputs(in), outputs(out)
+    {
+    }
+    virtual void operator()(int begin, int end)
+    {
+        op->GoCPURange(begin, end);
+    }
+    // nothing may be moved to the host or built on demand once ranges
+    // of items are running at the same time
+    virtual void Prepare()
+    {
+        eavlUseArraysOnHost(inputs, outputs);
+        op->PrepareCPURange();
+    }
+};
+
+// runs ranges of a fused stage's work items on the thread pool, one
+// cache-sized chunk at a time through every operation
+struct eavlExecutor::FusedStageBody : public eavlThreadPool::Body
+{
+    const vector<eavlOperation *> &ops;
+    const Stage                   &stage;
+    FusedStageBody(const vector<eavlOperation *> &o, const Stage &s)
+        : ops(o), stage(s)
+    {
+    }
+    virtual void operator()(int begin, int end)
+    {
+        for (int b = begin; b < end; b += EAVL_FUSED_CHUNK_SIZE)
+        {
+            int e = std::min(end, b + EAVL_FUSED_CHUNK_SIZE);
+            for (unsigned int o=0; o<stage.ops.size(); o++)
+                ops[stage.ops[o]]->GoCPURange(b, e);
+        }
+    }
+};
+
+
+eavlPlan::eavlPlan() : schedule(NULL)
+{
+}
+
+eavlPlan::~eavlPlan()
+{
+    Clear();
+}
+
+void
+eavlPlan::Clear()
+{
+    for (unsigned int i=0; i<ops.size(); i++)
+        delete ops[i];
+    ops.clear();
+    opnames.clear();
+    opsettings.clear();
+    delete schedule;
+    schedule = NULL;
+}
+
+
+eavlExecutor::eavlExecutor()
+    : cpuBackend(OpenMPBackend), cpuGrainSize(0),
+      profiling(false), profileStart(0)
+{
+    const char *backend = getenv("EAVLCPUBACKEND");
+    if (backend && string(backend) == "openmp")
+        cpuBackend = OpenMPBackend;
+    else if (backend && string(backend) == "threadpool")
+        cpuBackend = ThreadPoolBackend;
+    const char *grainsize = getenv("EAVLGRAINSIZE");
+    if (grainsize && atoi(grainsize) > 0)
+        cpuGrainSize = atoi(grainsize);
+
+    const char *prefix = getenv("EAVLPROFILE");
+    if (prefix && prefix[0])
+    {
+        profileFilePrefix = prefix;
+        real_SetProfiling(true);
+        atexit(WriteProfileAtExit);
+    }
+}
+
 
 void
 eavlExecutor::real_Go()
 {
+    Schedule *schedule = NULL;
+    try
+    {
+        Run(plan, opnames, opsettings, schedule);
+    }
+    catch (...)
+    {
+        delete schedule;
+        throw;
+    }
+    delete schedule;
+
     for (unsigned int i=0; i<plan.size(); i++)
+        delete plan[i];
+
+    plan.clear();
+    opnames.clear();
+    opsettings.clear();
+}
+
+
+void
+eavlExecutor::real_Capture(eavlPlan &p)
+{
+    p.ops.insert(p.ops.end(), plan.begin(), plan.end());
+    p.opnames.insert(p.opnames.end(), opnames.begin(), opnames.end());
+    p.opsettings.insert(p.opsettings.end(), opsettings.begin(), opsettings.end());
+    delete p.schedule;
+    p.schedule = NULL;
+
+    plan.clear();
+    opnames.clear();
+    opsettings.clear();
+}
+
+
+void
+eavlExecutor::real_Go(eavlPlan &p)
+{
+    Run(p.ops, p.opnames, p.opsettings, p.schedule);
+}
+
+
+void
+eavlExecutor::Run(const vector<eavlOperation *> &ops,
+                  const vector<string> &names,
+                  const vector<CPUSettings> &settings, Schedule *&schedule)
+{
+#ifdef HAVE_CUDA
+    if (executionMode == ForceCPU)
+        GoScheduledCPU(ops, names, settings, schedule);
+    else
+        GoInOrder(ops, names, settings);
+#else
+    if (!ops.empty() && executionMode == ForceGPU)
+        THROW(eavlException, "GPU support was not compiled in.");
+    GoScheduledCPU(ops, names, settings, schedule);
+#endif
+}
+
+
+void
+eavlExecutor::real_AddOperation(eavlOperation *op, const std::string &name,
+                                const CPUSettings &settings)
+{
+    plan.push_back(op);
+    opnames.push_back(name);
+    opsettings.push_back(settings);
+}
+
+
+void
+eavlExecutor::real_RunOnCPU(eavlOperation *op, const std::string &name)
+{
+    double t0 = profiling ? eavlWallTime() : 0;
+    CPUSettings settings;
+    try
+    {
+        RunOperationCPU(op, settings);
+    }
+    catch (...)
+    {
+        delete op;
+        throw;
+    }
+    if (profiling)
+    {
+        int nthreads = GetNumberOfThreads(settings);
+        vector<eavlOperationArray> inputs, outputs;
+        bool known = op->GetArrays(inputs, outputs);
+        // this may be called from operations running concurrently
+#pragma omp critical(eavlExecutorProfile)
+        AddProfileRecord(name, "CPU", 1, nthreads, 0, known,
+                         inputs, outputs, t0, eavlWallTime());
+    }
+    delete op;
+}
+
+
+void
+eavlExecutor::GoInOrder(const vector<eavlOperation *> &ops,
+                        const vector<string> &names,
+                        const vector<CPUSettings> &settings)
+{
+    for (unsigned int i=0; i<ops.size(); i++)
     {
-        //cerr << "Executing "<<opnames[i]<<endl;
+        //cerr << "Executing "<<names[i]<<endl;
         int th = eavlTimer::Start();
+        double t0 = profiling ? eavlWallTime() : 0;
+        const char *path = (executionMode == ForceCPU) ? "CPU" : "GPU";
 #ifdef HAVE_CUDA
+        if (executionMode != ForceCPU)
+        {
+            vector<eavlOperationArray> inputs, outputs;
+            ops[i]->GetArrays(inputs, outputs);
+            eavlMarkOutputsWritten(outputs);
+        }
         switch (executionMode)
         {
           case PreferGPU:
             try {
-                plan[i]->GoGPU();
+                ops[i]->GoGPU();
             }
             catch (eavlException &e)
             {
                 cerr << "Warning: failed GPU, trying CPU, error was "<<e.GetErrorText()<<"\n";
+                path = "CPU";
                 try {
-                    plan[i]->GoCPU();
+                    RunOperationCPU(ops[i], settings[i]);
                 }
                 catch (eavlException &e2)
                 {
@@ -34,18 +303,19 @@ eavlExecutor::real_Go()
             }
             break;
           case ForceGPU:
-            plan[i]->GoGPU();
+            ops[i]->GoGPU();
             break;
           case ForceCPU:
-            plan[i]->GoCPU();
+            RunOperationCPU(ops[i], settings[i]);
             break;
         }
 #else
+        path = "CPU";
         switch (executionMode)
         {
           case PreferGPU:
             try {
-                plan[i]->GoCPU();
+                RunOperationCPU(ops[i], settings[i]);
             }
             catch (eavlException &e)
             {
@@ -56,24 +326,658 @@ eavlExecutor::real_Go()
           case ForceGPU:
             THROW(eavlException, "GPU support was not compiled in.");
           case ForceCPU:
-            plan[i]->GoCPU();
+            RunOperationCPU(ops[i], settings[i]);
             break;
         }
 #endif
-        eavlTimer::Stop(th, opnames[i]);
+        if (profiling)
+        {
+            int nthreads = GetNumberOfThreads(settings[i]);
+#ifdef HAVE_CUDA
+            if (string(path) == "GPU")
+            {
+                cudaThreadSynchronize();
+                nthreads = 0;
+            }
+#endif
+            vector<eavlOperationArray> inputs, outputs;
+            bool known = ops[i]->GetArrays(inputs, outputs);
+            AddProfileRecord(names[i], path, 1, nthreads, 0,
+                             known, inputs, outputs, t0, eavlWallTime());
+        }
+        eavlTimer::Stop(th, names[i]);
     }
+}
 
-    for (unsigned int i=0; i<plan.size(); i++)
-        delete plan[i];
 
-    plan.clear();
-    opnames.clear();
+void
+eavlExecutor::GoScheduledCPU(const vector<eavlOperation *> &ops,
+                             const vector<string> &names,
+                             const vector<CPUSettings> &settings,
+                             Schedule *&schedule)
+{
+    if (!schedule || !IsCurrent(ops, *schedule))
+    {
+        delete schedule;
+        schedule = new Schedule;
+        BuildSchedule(ops, names, settings, *schedule);
+    }
+
+    for (unsigned int l=0; l<schedule->levels.size(); l++)
+        RunLevelCPU(ops, schedule->stages, schedule->levels[l]);
 }
 
 
+// true if the operations still have the lengths they were scheduled
+// with, so the same ones can be fused, and the same arrays share values
+bool
+eavlExecutor::IsCurrent(const vector<eavlOperation *> &ops,
+                        const Schedule &schedule)
+{
+    if (schedule.lengths.size() != ops.size())
+        return false;
+    for (unsigned int i=0; i<ops.size(); i++)
+    {
+        if (schedule.lengths[i] != ops[i]->GetElementwiseLength())
+            return false;
+    }
+    vector<pair<eavlArray*,eavlArray*> > aliases;
+    FindAliases(ops, aliases);
+    return aliases == schedule.aliases;
+}
+
+// true if two different arrays share some of their host values
+static bool
+SharesHostValues(const eavlArray *a, const eavlArray *b)
+{
+    const char *abegin, *aend, *bbegin, *bend;
+    a->GetHostStorage(abegin, aend);
+    b->GetHostStorage(bbegin, bend);
+    return abegin && bbegin && abegin < bend && bbegin < aend;
+}
+
+// the pairs of different arrays the operations use which share values
 void
-eavlExecutor::real_AddOperation(eavlOperation *op, const std::string &name)
+eavlExecutor::FindAliases(const vector<eavlOperation *> &ops,
+                          vector<pair<eavlArray*,eavlArray*> > &aliases)
 {
-    plan.push_back(op);
-    opnames.push_back(name);
+    vector<eavlArray*> arrays;
+    for (unsigned int i=0; i<ops.size(); i++)
+    {
+        vector<eavlOperationArray> inputs, outputs;
+        if (!ops[i]->GetArrays(inputs, outputs))
+            continue;
+        for (unsigned int a=0; a<inputs.size(); a++)
+            arrays.push_back(inputs[a].array);
+        for (unsigned int a=0; a<outputs.size(); a++)
+            arrays.push_back(outputs[a].array);
+    }
+    std::sort(arrays.begin(), arrays.end());
+    arrays.erase(std::unique(arrays.begin(), arrays.end()), arrays.end());
+
+    for (unsigned int i=0; i<arrays.size(); i++)
+    {
+        for (unsigned int j=i+1; j<arrays.size(); j++)
+        {
+            if (SharesHostValues(arrays[i], arrays[j]))
+                aliases.push_back(std::make_pair(arrays[i], arrays[j]));
+        }
+    }
+}
+
+
+void
+eavlExecutor::BuildSchedule(const vector<eavlOperation *> &ops,
+                            const vector<string> &names,
+                            const vector<CPUSettings> &settings,
+                            Schedule &schedule)
+{
+    // gather up what each operation touches, fusing each one with
+    // the stage before it where possible
+    FindAliases(ops, schedule.aliases);
+    vector<Stage> &stages = schedule.stages;
+    for (unsigned int i=0; i<ops.size(); i++)
+    {
+        Stage s;
+        s.ops.push_back(i);
+        s.name = names[i];
+        s.known = ops[i]->GetArrays(s.inputs, s.outputs);
+        s.cells = ops[i]->GetCellSet();
+        s.length = s.known ? ops[i]->GetElementwiseLength() : -1;
+        s.level = 0;
+        s.settings = settings[i];
+        schedule.lengths.push_back(ops[i]->GetElementwiseLength());
+
+        if (!stages.empty() && CanFuse(stages.back(), s))
+        {
+            Stage &prev = stages.back();
+            prev.ops.push_back(i);
+            prev.name += " + " + s.name;
+            prev.inputs.insert(prev.inputs.end(),
+                               s.inputs.begin(), s.inputs.end());
+            prev.outputs.insert(prev.outputs.end(),
+                                s.outputs.begin(), s.outputs.end());
+        }
+        else
+        {
+            stages.push_back(s);
+        }
+    }
+
+    // each stage runs one level after the latest stage it depends on
+    int nlevels = 0;
+    for (unsigned int j=0; j<stages.size(); j++)
+    {
+        for (unsigned int i=0; i<j; i++)
+        {
+            if (stages[i].level >= stages[j].level &&
+                Conflict(stages[i], stages[j]))
+                stages[j].level = stages[i].level + 1;
+        }
+        nlevels = std::max(nlevels, stages[j].level + 1);
+    }
+
+    schedule.levels.resize(nlevels);
+    for (unsigned int j=0; j<stages.size(); j++)
+        schedule.levels[stages[j].level].push_back(j);
+}
+
+
+void
+eavlExecutor::RunLevelCPU(const vector<eavlOperation *> &ops,
+                          vector<Stage> &stages, const vector<int> &level)
+{
+    int nthreads = 1;
+#ifdef HAVE_OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    int nstages = level.size();
+
+    // stages on the thread pool each use all of its threads in turn
+    bool concurrent = (nstages > 1 && nthreads > 1);
+    for (int j=0; j<nstages; j++)
+    {
+        if (GetBackend(stages[level[j]].settings) != OpenMPBackend)
+            concurrent = false;
+    }
+
+    if (!concurrent)
+    {
+        for (int j=0; j<nstages; j++)
+        {
+            Stage &s = stages[level[j]];
+            int th = eavlTimer::Start();
+            double t0 = profiling ? eavlWallTime() : 0;
+            try
+            {
+                RunStageCPU(ops, s);
+            }
+            catch (const eavlException &e)
+            {
+                HandleCPUError(e);
+            }
+            if (profiling)
+            {
+                AddProfileRecord(s.name, "CPU", s.ops.size(),
+                                 GetNumberOfThreads(s.settings), 0,
+                                 s.known, s.inputs, s.outputs,
+                                 t0, eavlWallTime());
+            }
+            eavlTimer::Stop(th, s.name);
+        }
+        return;
+    }
+
+#ifdef HAVE_OPENMP
+    // make sure nothing needs moving to the host once we're
+    // running stages at the same time
+    for (int j=0; j<nstages; j++)
+    {
+        Stage &s = stages[level[j]];
+        eavlUseArraysOnHost(s.inputs, s.outputs);
+    }
+
+    // split the threads across the independent stages; each one gets
+    // its own share of threads for its own parallel loops
+    int nouter = std::min(nstages, nthreads);
+    int ninner = std::max(1, nthreads / nouter);
+    vector<double> starts(nstages, 0.), ends(nstages, 0.);
+    vector<int> lanes(nstages, 0);
+    vector<int> failed(nstages, 0);
+    vector<eavlException> errors(nstages);
+
+    int oldlevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(std::max(oldlevels, 2));
+#pragma omp parallel for num_threads(nouter) schedule(dynamic,1)
+    for (int j=0; j<nstages; j++)
+    {
+        omp_set_num_threads(ninner);
+        lanes[j] = omp_get_thread_num();
+        starts[j] = eavlWallTime();
+        try
+        {
+            RunStageCPU(ops, stages[level[j]]);
+        }
+        catch (const eavlException &e)
+        {
+            failed[j] = 1;
+            errors[j] = e;
+        }
+        ends[j] = eavlWallTime();
+    }
+    omp_set_max_active_levels(oldlevels);
+
+    for (int j=0; j<nstages; j++)
+    {
+        Stage &s = stages[level[j]];
+        eavlTimer::Insert(s.name, ends[j] - starts[j]);
+        if (profiling)
+        {
+            AddProfileRecord(s.name, "CPU", s.ops.size(), ninner, lanes[j],
+                             s.known, s.inputs, s.outputs,
+                             starts[j], ends[j]);
+        }
+        if (failed[j])
+            HandleCPUError(errors[j]);
+    }
+#endif
+}
+
+
+void
+eavlExecutor::RunStageCPU(const vector<eavlOperation *> &ops, Stage &stage)
+{
+    if (stage.ops.size() == 1)
+    {
+        RunOperationCPU(ops[stage.ops[0]], stage.settings);
+        return;
+    }
+
+    // fused stage: run every operation over one chunk of items before
+    // moving on to the next chunk
+    eavlUseArraysOnHost(stage.inputs, stage.outputs);
+
+    int n = stage.length;
+    if (GetBackend(stage.settings) == ThreadPoolBackend)
+    {
+        FusedStageBody body(ops, stage);
+        int grainsize = GetGrainSize(stage.settings);
+        eavlThreadPool::ParallelFor(n, grainsize > 0 ? grainsize : EAVL_FUSED_CHUNK_SIZE,
+                                    body);
+        return;
+    }
+
+    int nops = stage.ops.size();
+    int nchunks = (n + EAVL_FUSED_CHUNK_SIZE - 1) / EAVL_FUSED_CHUNK_SIZE;
+    bool failed = false;
+    eavlException error;
+#pragma omp parallel for schedule(dynamic)
+    for (int c=0; c<nchunks; c++)
+    {
+        int begin = c * EAVL_FUSED_CHUNK_SIZE;
+        int end = std::min(n, begin + EAVL_FUSED_CHUNK_SIZE);
+        try
+        {
+            for (int o=0; o<nops; o++)
+                ops[stage.ops[o]]->GoCPURange(begin, end);
+        }
+        catch (const eavlException &e)
+        {
+#pragma omp critical
+            {
+                failed = true;
+                error = e;
+            }
+        }
+    }
+    if (failed)
+        throw error;
+}
+
+
+void
+eavlExecutor::RunOperationCPU(eavlOperation *op, const CPUSettings &settings)
+{
+    vector<eavlOperationArray> inputs, outputs;
+    op->GetArrays(inputs, outputs);
+    eavlMarkOutputsWritten(outputs);
+
+    int n = -1;
+    if (GetBackend(settings) == ThreadPoolBackend)
+        n = op->GetCPURangeLength();
+    if (n < 0)
+    {
+        op->cpuLoops.threadPool = (GetBackend(settings) == ThreadPoolBackend);
+        op->cpuLoops.grainSize = GetGrainSize(settings);
+        op->GoCPU();
+        return;
+    }
+
+    RangeBody body(op, inputs, outputs);
+    eavlThreadPool::ParallelFor(n, GetGrainSize(settings), body);
+}
+
+
+eavlExecutor::CPUBackend
+eavlExecutor::GetBackend(const CPUSettings &settings)
+{
+    return (settings.backend == DefaultCPUBackend) ? cpuBackend
+                                                   : settings.backend;
+}
+
+
+int
+eavlExecutor::GetGrainSize(const CPUSettings &settings)
+{
+    return (settings.grainSize > 0) ? settings.grainSize : cpuGrainSize;
+}
+
+
+int
+eavlExecutor::GetNumberOfThreads(const CPUSettings &settings)
+{
+    if (GetBackend(settings) == ThreadPoolBackend)
+        return eavlThreadPool::GetNumberOfThreads();
+    int nthreads = 1;
+#ifdef HAVE_OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    return nthreads;
+}
+
+
+void
+eavlExecutor::HandleCPUError(const eavlException &e)
+{
+    if (executionMode != PreferGPU)
+        throw e;
+
+    cerr << "Error: no GPU implementation, and CPU op failed\n";
+    cerr << "   CPU error was: " << e.GetErrorText() << endl;
+}
+
+
+void
+eavlExecutor::real_SetProfiling(bool on)
+{
+    if (on && !profiling && profile.empty())
+        profileStart = eavlWallTime();
+    profiling = on;
+}
+
+
+void
+eavlExecutor::real_ClearProfile()
+{
+    profile.clear();
+    profileStart = eavlWallTime();
+}
+
+
+// the number of values an access can reach through its indexer
+static long long
+ReachableValues(const eavlOperationArray &a)
+{
+    long long nvalues = (long long)a.array->GetNumberOfTuples() *
+                        a.array->GetNumberOfComponents();
+    if (a.indexer.mul <= 0 || nvalues <= a.indexer.add)
+        return 0;
+    long long n = (nvalues - a.indexer.add + a.indexer.mul - 1) /
+                  a.indexer.mul;
+    if (a.indexer.mod < n)
+        n = a.indexer.mod;
+    return n;
+}
+
+// Every value an operation can reach through one of its indexers is
+// counted as touched once; the item count is the largest of these.
+void
+eavlExecutor::AddProfileRecord(const string &name, const char *path,
+                               int nops, int threads, int lane, bool known,
+                               const vector<eavlOperationArray> &inputs,
+                               const vector<eavlOperationArray> &outputs,
+                               double start, double end)
+{
+    ProfileRecord r;
+    r.name = name;
+    r.path = path;
+    r.nops = nops;
+    r.threads = threads;
+    r.lane = lane;
+    r.items = -1;
+    r.bytesRead = -1;
+    r.bytesWritten = -1;
+    if (known)
+    {
+        r.items = 0;
+        r.bytesRead = 0;
+        r.bytesWritten = 0;
+        for (unsigned int i=0; i<inputs.size(); i++)
+        {
+            long long n = ReachableValues(inputs[i]);
+            r.items = std::max(r.items, n);
+            r.bytesRead += n * inputs[i].array->GetBasicTypeSize();
+        }
+        for (unsigned int i=0; i<outputs.size(); i++)
+        {
+            long long n = ReachableValues(outputs[i]);
+            r.items = std::max(r.items, n);
+            r.bytesWritten += n * outputs[i].array->GetBasicTypeSize();
+        }
+    }
+    r.start = start - profileStart;
+    r.duration = end - start;
+    profile.push_back(r);
+}
+
+
+static string
+JSONEscape(const string &str)
+{
+    ostringstream out;
+    for (size_t i=0; i<str.length(); i++)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    return out.str();
+}
+
+static string
+CSVEscape(const string &str)
+{
+    string out = "\"";
+    for (size_t i=0; i<str.length(); i++)
+    {
+        if (str[i] == '"')
+            out += '"';
+        out += str[i];
+    }
+    return out + "\"";
+}
+
+
+void
+eavlExecutor::real_WriteProfileTrace(ostream &out)
+{
+    out << "{\"traceEvents\":[\n";
+    for (unsigned int i=0; i<profile.size(); i++)
+    {
+        const ProfileRecord &r = profile[i];
+        out << "{\"name\":\"" << JSONEscape(r.name) << "\""
+            << ",\"cat\":\"" << r.path << "\""
+            << ",\"ph\":\"X\""
+            << ",\"ts\":" << (long long)(r.start * 1.e6)
+            << ",\"dur\":" << (long long)(r.duration * 1.e6)
+            << ",\"pid\":0"
+            << ",\"tid\":" << r.lane
+            << ",\"args\":{\"operations\":" << r.nops
+            << ",\"threads\":" << r.threads;
+        if (r.items >= 0)
+        {
+            out << ",\"items\":" << r.items
+                << ",\"bytes read\":" << r.bytesRead
+                << ",\"bytes written\":" << r.bytesWritten;
+        }
+        out << "}}" << (i+1 < profile.size() ? ",\n" : "\n");
+    }
+    out << "],\n\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+void
+eavlExecutor::real_WriteProfileSummary(ostream &out)
+{
+    // combine every run of the same operation on the same path
+    vector<ProfileRecord> totals;
+    vector<int> calls;
+    for (unsigned int i=0; i<profile.size(); i++)
+    {
+        const ProfileRecord &r = profile[i];
+        unsigned int j = 0;
+        while (j < totals.size() &&
+               (totals[j].name != r.name || totals[j].path != r.path))
+            j++;
+        if (j == totals.size())
+        {
+            totals.push_back(r);
+            calls.push_back(1);
+            continue;
+        }
+        ProfileRecord &t = totals[j];
+        calls[j]++;
+        t.threads = std::max(t.threads, r.threads);
+        t.duration += r.duration;
+        if (t.items < 0 || r.items < 0)
+        {
+            t.items = t.bytesRead = t.bytesWritten = -1;
+        }
+        else
+        {
+            t.items += r.items;
+            t.bytesRead += r.bytesRead;
+            t.bytesWritten += r.bytesWritten;
+        }
+    }
+
+    out << "operation,path,calls,threads,items,bytes_read,bytes_written,"
+        << "total_seconds,mean_seconds,GB_per_second\n";
+    for (unsigned int j=0; j<totals.size(); j++)
+    {
+        const ProfileRecord &t = totals[j];
+        out << CSVEscape(t.name) << "," << t.path << "," << calls[j] << ","
+            << t.threads << ",";
+        if (t.items >= 0)
+            out << t.items << "," << t.bytesRead << "," << t.bytesWritten;
+        else
+            out << ",,";
+        out << "," << t.duration << "," << t.duration / calls[j] << ",";
+        if (t.items >= 0 && t.duration > 0)
+            out << double(t.bytesRead + t.bytesWritten) / t.duration / 1.e9;
+        out << "\n";
+    }
+}
+
+
+void
+eavlExecutor::WriteProfileAtExit()
+{
+    if (!instance || instance->profileFilePrefix.empty())
+        return;
+
+    string prefix = instance->profileFilePrefix;
+    ofstream trace((prefix + ".json").c_str());
+    instance->real_WriteProfileTrace(trace);
+    ofstream summary((prefix + ".csv").c_str());
+    instance->real_WriteProfileSummary(summary);
+}
+
+
+// two accesses to an array from the same work item hit the same value,
+// and no other work item's accesses do
+static bool
+SameElement(const eavlOperationArray &a, const eavlOperationArray &b, int n)
+{
+    return a.indexer.div == 1 && b.indexer.div == 1 &&
+           a.indexer.mod >= n && b.indexer.mod >= n &&
+           a.indexer.mul == b.indexer.mul &&
+           a.indexer.add == b.indexer.add &&
+           a.indexer.mul != 0;
+}
+
+// two accesses to an array never hit the same value (e.g. they
+// are different components of a multi-component array)
+static bool
+DisjointElements(const eavlOperationArray &a, const eavlOperationArray &b,
+                 int n)
+{
+    return a.indexer.div == 1 && b.indexer.div == 1 &&
+           a.indexer.mod >= n && b.indexer.mod >= n &&
+           a.indexer.mul == b.indexer.mul &&
+           a.indexer.add != b.indexer.add &&
+           a.indexer.add >= 0 && a.indexer.add < a.indexer.mul &&
+           b.indexer.add >= 0 && b.indexer.add < b.indexer.mul;
+}
+
+// true if an access in 'b' may touch a value written by 'writes' or
+// read by 'reads'; if 'n' is non-negative, accesses from operations
+// over n items which only meet within the same work item are allowed
+// (for the same array; different arrays sharing values always meet)
+static bool
+Overlaps(const vector<eavlOperationArray> &writes,
+         const vector<eavlOperationArray> &reads,
+         const vector<eavlOperationArray> &b, int n)
+{
+    for (unsigned int i=0; i<b.size(); i++)
+    {
+        for (int pass=0; pass<2; pass++)
+        {
+            const vector<eavlOperationArray> &a = pass ? reads : writes;
+            for (unsigned int j=0; j<a.size(); j++)
+            {
+                if (a[j].array == b[i].array ?
+                    (n < 0 || (!SameElement(a[j], b[i], n) &&
+                               !DisjointElements(a[j], b[i], n))) :
+                    SharesHostValues(a[j].array, b[i].array))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+eavlExecutor::CanFuse(const Stage &stage, const Stage &next)
+{
+    if (!stage.known || !next.known ||
+        stage.length <= 0 || next.length != stage.length)
+        return false;
+    if (stage.settings.backend != next.settings.backend ||
+        stage.settings.grainSize != next.settings.grainSize)
+        return false;
+
+    // the next operation may read what the stage wrote, and write what
+    // it read or wrote, only if both touch the same element per item
+    vector<eavlOperationArray> none;
+    int n = stage.length;
+    return !Overlaps(stage.outputs, none, next.inputs, n) &&
+           !Overlaps(stage.outputs, stage.inputs, next.outputs, n);
+}
+
+bool
+eavlExecutor::Conflict(const Stage &a, const Stage &b)
+{
+    if (!a.known || !b.known)
+        return true;
+    if (a.cells && a.cells == b.cells)
+        return true;
+
+    vector<eavlOperationArray> none;
+    return Overlaps(a.outputs, none, b.inputs, -1) ||
+           Overlaps(a.outputs, a.inputs, b.outputs, -1);
 }
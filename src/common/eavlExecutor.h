@@ -6,14 +6,68 @@
 // Class:  eavlExecutor
 //
 // Purpose:
-///   Execute a sequence of eavlOperations.  For now, this is simplistic,
-///   but eventually could incorporate heterogeneous and overlapped
-///   execution, or other types of intelligence.  When it executes a plan,
+///   Execute a sequence of eavlOperations.  When it executes a plan,
 ///   it can also take other actions (like collecting detailed timing).
+///
+///   On the CPU, the plan is treated as a graph of dependencies between
+///   operations, using the arrays each operation reads and writes.
+///   Consecutive element-wise operations (like maps) which touch their
+///   shared arrays at the same locations are fused into a single pass,
+///   run in cache-sized chunks, and operations which don't depend on each
+///   other are run concurrently, splitting the available threads between
+///   them.  Different arrays sharing host values (see
+///   eavlArray::GetHostStorage) are treated as the same array wherever
+///   they meet, so they are never fused or run concurrently.  Operations
+///   which can't describe their arrays are run in the order they were
+///   added, after everything before them and before everything after
+///   them.  On the GPU, the plan is run in order.
+///
+///   With profiling on, every operation (or fused group of them) that
+///   runs is recorded with its wall time, the path that ran it, the
+///   number of threads available to it, and an estimate of its item
+///   count and bytes read and written, taken from the arrays it uses.
+///   These can be written as a Chrome trace (for chrome://tracing) or
+///   as a CSV summary with the achieved bandwidth of each operation.
+///   Setting the EAVLPROFILE environment variable to a file name prefix
+///   turns on profiling and writes <prefix>.json and <prefix>.csv at
+///   exit.
+///
+///   The operations added since the last Go() can also be captured
+///   into an eavlPlan instead, to be run any number of times.
+///
+///   CPU loops run on one of two backends.  With OpenMP, each operation
+///   runs its own parallel loops.  With the thread pool, operations
+///   which implement GoCPURange are split into chunks of the grain size
+///   and run on eavlThreadPool's persistent threads, which steal chunks
+///   from each other, so small operations avoid the cost of starting a
+///   parallel region and uneven ones stay balanced.  Scans, reductions,
+///   gathers and scatters run their own loops on the pool's threads.
+///   Other operations run their own OpenMP loops on either backend.
+///   The backend and grain size can be set for the whole process, or
+///   for a single operation as it is added.  The default backend is
+///   OpenMP (which runs serially when it was not compiled in);
+///   setting the EAVLCPUBACKEND environment variable to "openmp" or
+///   "threadpool" overrides it, and EAVLGRAINSIZE sets the grain size.
 //
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern, Rob Sisneros
 // Creation:    August 29, 2011
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Added Capture and Go for reusable plans, keeping the CPU schedule
+//   worked out for a plan between runs.
+//
+//   agent, October 17, 2026
+//   Added the thread pool CPU backend, selected per process or per
+//   operation, with a tunable grain size.
+//
+//   agent, October 17, 2026
+//   Run the scans, reductions, gathers, scatters and topology map ops
+//   on the thread pool, and keep OpenMP as the default backend.
+//
+//   agent, October 17, 2026
+//   Treat different arrays sharing host values as conflicting.
+//
 // ****************************************************************************
 
 #include "STL.h"
@@ -21,9 +75,13 @@
 #include "eavlConfig.h"
 #include "eavlException.h"
 #include "eavlTimer.h"
+#include "eavlThreadPool.h"
+
+class eavlPlan;
 
 class eavlExecutor
 {
+    friend class eavlPlan;
   public:
     enum ExecutionMode
     {
@@ -31,6 +89,25 @@ class eavlExecutor
         ForceGPU,
         ForceCPU
     };
+    enum CPUBackend
+    {
+        DefaultCPUBackend,  ///< the process's backend (for the process, OpenMP)
+        OpenMPBackend,
+        ThreadPoolBackend
+    };
+    struct ProfileRecord
+    {
+        string    name;         ///< operation name(s), fused ones joined by " + "
+        string    path;         ///< "CPU" or "GPU", whichever actually ran
+        int       nops;         ///< number of operations fused together
+        int       threads;      ///< CPU threads available (0 on the GPU)
+        int       lane;         ///< which of the concurrently running stages
+        long long items;        ///< estimated work items, or -1 if unknown
+        long long bytesRead;    ///< estimated bytes read, or -1 if unknown
+        long long bytesWritten; ///< estimated bytes written, or -1 if unknown
+        double    start;        ///< seconds since profiling was started
+        double    duration;     ///< seconds
+    };
   public:
     static void SetExecutionMode(ExecutionMode em)
     {
@@ -40,6 +117,24 @@ class eavlExecutor
     {
         return Instance()->executionMode;
     }
+    static void SetCPUBackend(CPUBackend b)
+    {
+        Instance()->cpuBackend = (b == DefaultCPUBackend) ? OpenMPBackend : b;
+    }
+    static CPUBackend GetCPUBackend()
+    {
+        return Instance()->cpuBackend;
+    }
+    /// Set the number of work items in each chunk the thread pool runs,
+    /// or 0 (the default) to choose one from the number of items.
+    static void SetCPUGrainSize(int grainsize)
+    {
+        Instance()->cpuGrainSize = (grainsize > 0) ? grainsize : 0;
+    }
+    static int GetCPUGrainSize()
+    {
+        return Instance()->cpuGrainSize;
+    }
     static void Go()
     {
         Instance()->real_Go();
@@ -47,25 +142,190 @@ class eavlExecutor
     static void AddOperation(eavlOperation *op,
                              const std::string &name)
     {
-        Instance()->real_AddOperation(op,name);
+        Instance()->real_AddOperation(op,name,CPUSettings(DefaultCPUBackend,0));
+    }
+    /// Add an operation which runs on the given CPU backend, and on the
+    /// thread pool, in chunks of the given grain size (if positive).
+    static void AddOperation(eavlOperation *op,
+                             const std::string &name,
+                             CPUBackend backend, int grainsize = 0)
+    {
+        Instance()->real_AddOperation(op,name,CPUSettings(backend,grainsize));
+    }
+    /// Move the operations added since the last Go() to the end of a
+    /// plan, instead of running them.
+    static void Capture(eavlPlan &plan)
+    {
+        Instance()->real_Capture(plan);
+    }
+    /// Run a plan's operations, keeping them for the next run.
+    static void Go(eavlPlan &plan)
+    {
+        Instance()->real_Go(plan);
+    }
+    /// Run a single operation on the CPU right away, outside of the
+    /// plan (which may be executing at the time), then delete it.  This
+    /// is for data built on demand, like connectivity an operation in
+    /// the plan asks for.
+    static void RunOnCPU(eavlOperation *op,
+                         const std::string &name)
+    {
+        Instance()->real_RunOnCPU(op,name);
+    }
+
+    static void SetProfiling(bool on)
+    {
+        Instance()->real_SetProfiling(on);
+    }
+    static bool GetProfiling()
+    {
+        return Instance()->profiling;
+    }
+    static void ClearProfile()
+    {
+        Instance()->real_ClearProfile();
+    }
+    static const vector<ProfileRecord> &GetProfile()
+    {
+        return Instance()->profile;
+    }
+    static void WriteProfileTrace(ostream &out)
+    {
+        Instance()->real_WriteProfileTrace(out);
+    }
+    static void WriteProfileSummary(ostream &out)
+    {
+        Instance()->real_WriteProfileSummary(out);
     }
 
 
   protected:
+    struct CPUSettings
+    {
+        CPUBackend backend;
+        int        grainSize;
+        CPUSettings(CPUBackend b = DefaultCPUBackend, int g = 0)
+            : backend(b), grainSize(g) { }
+    };
+
     static eavlExecutor *Instance()
     {
         if (!instance)
             instance = new eavlExecutor;
         return instance;
     }
+    eavlExecutor();
     void real_Go();
-    void real_AddOperation(eavlOperation *op, const std::string &name);
-    
+    void real_AddOperation(eavlOperation *op, const std::string &name,
+                           const CPUSettings &settings);
+    void real_Capture(eavlPlan &plan);
+    void real_Go(eavlPlan &plan);
+    void real_RunOnCPU(eavlOperation *op, const std::string &name);
+    void real_SetProfiling(bool on);
+    void real_ClearProfile();
+    void real_WriteProfileTrace(ostream &out);
+    void real_WriteProfileSummary(ostream &out);
+    void AddProfileRecord(const string &name, const char *path,
+                          int nops, int threads, int lane, bool known,
+                          const vector<eavlOperationArray> &inputs,
+                          const vector<eavlOperationArray> &outputs,
+                          double start, double end);
+    static void WriteProfileAtExit();
+
+    struct Stage;
+    struct Schedule;
+    struct RangeBody;
+    struct FusedStageBody;
+    void Run(const vector<eavlOperation *> &ops,
+             const vector<string> &names,
+             const vector<CPUSettings> &settings, Schedule *&schedule);
+    void GoInOrder(const vector<eavlOperation *> &ops,
+                   const vector<string> &names,
+                   const vector<CPUSettings> &settings);
+    void GoScheduledCPU(const vector<eavlOperation *> &ops,
+                        const vector<string> &names,
+                        const vector<CPUSettings> &settings,
+                        Schedule *&schedule);
+    static bool IsCurrent(const vector<eavlOperation *> &ops,
+                          const Schedule &schedule);
+    static void FindAliases(const vector<eavlOperation *> &ops,
+                            vector<pair<eavlArray*,eavlArray*> > &aliases);
+    static void BuildSchedule(const vector<eavlOperation *> &ops,
+                              const vector<string> &names,
+                              const vector<CPUSettings> &settings,
+                              Schedule &schedule);
+    void RunLevelCPU(const vector<eavlOperation *> &ops,
+                     vector<Stage> &stages, const vector<int> &level);
+    void RunStageCPU(const vector<eavlOperation *> &ops, Stage &stage);
+    void RunOperationCPU(eavlOperation *op, const CPUSettings &settings);
+    CPUBackend GetBackend(const CPUSettings &settings);
+    int GetGrainSize(const CPUSettings &settings);
+    int GetNumberOfThreads(const CPUSettings &settings);
+    void HandleCPUError(const eavlException &e);
+    static bool CanFuse(const Stage &stage, const Stage &next);
+    static bool Conflict(const Stage &a, const Stage &b);
+
   protected:
     static eavlExecutor    *instance;
     static ExecutionMode    executionMode;
+    CPUBackend              cpuBackend;
+    int                     cpuGrainSize;
     vector<eavlOperation *> plan;
     vector<string>          opnames;
+    vector<CPUSettings>     opsettings;
+    bool                    profiling;
+    double                  profileStart;
+    vector<ProfileRecord>   profile;
+    string                  profileFilePrefix;
+};
+
+// ****************************************************************************
+// Class:  eavlPlan
+//
+// Purpose:
+///   A sequence of operations captured from eavlExecutor, which can be
+///   run again and again.  The operations stay bound to the arrays and
+///   cell sets they were created with, so to run a plan over new data,
+///   capture it over arrays which stay put and change what they hold
+///   (e.g. with eavlArray::ShareHostArray, which costs no copy).  The
+///   CPU schedule (which operations are fused together, and which can
+///   run at the same time) is worked out on the first run and kept; it
+///   is only worked out again if an operation's length changes, e.g.
+///   because one of its arrays was resized, or if different arrays
+///   start or stop sharing their host values.
+///
+///   The plan owns its operations, and deletes them when it is cleared
+///   or destroyed.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class eavlPlan
+{
+    friend class eavlExecutor;
+  protected:
+    vector<eavlOperation *>  ops;
+    vector<string>           opnames;
+    vector<eavlExecutor::CPUSettings> opsettings;
+    eavlExecutor::Schedule  *schedule;
+  public:
+    eavlPlan();
+    ~eavlPlan();
+    void Clear();
+    bool IsEmpty() const
+    {
+        return ops.empty();
+    }
+    int GetNumOperations() const
+    {
+        return ops.size();
+    }
+  private:
+    // the operations would be deleted twice
+    eavlPlan(const eavlPlan&);
+    void operator=(const eavlPlan&);
 };
 
 #endif
@@ -36,6 +36,9 @@ struct eavlExplicitConnectivity_device
 // Creation:    July 25, 2012
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added Release and GetMemoryUsage.
+//
 // ****************************************************************************
 struct eavlExplicitConnectivity
 {
@@ -151,6 +154,19 @@ struct eavlExplicitConnectivity
 
         mapCellToIndex.clear();
     }
+    /// Frees the arrays; the connectivity is empty afterwards.
+    EAVL_HOSTONLY void Release()
+    {
+        shapetype.release();
+        connectivity.release();
+        mapCellToIndex.release();
+    }
+    EAVL_HOSTONLY long long GetMemoryUsage() const
+    {
+        return (long long)shapetype.size() * sizeof(int) +
+               (long long)connectivity.size() * sizeof(int) +
+               (long long)mapCellToIndex.size() * sizeof(int);
+    }
     EAVL_HOSTONLY void PrintSummary(ostream &out) const
     {
         out << "        shapetype["<<shapetype.size()<<"] = ";
@@ -11,11 +11,19 @@
 //
 // Purpose:
 ///   An array associated with a mesh.  It may be associated with the
-///   cells, points, or the whole mesh.
+///   cells, points, or the whole mesh.  The field holds a reference to
+///   its array, which it may share with other fields, e.g. those of a
+///   shallow copy of its data set, or an unchanged field passed through
+///   to a filter's output.
 //
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    March  1, 2011
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Reference the array rather than owning it, and added a constructor
+//   which shares another field's array.
+//
 // ****************************************************************************
 
 ///\todo: add more about higher-order and where e.g. shared face vals are stored
@@ -58,6 +66,8 @@ class eavlField
           assoc_logicaldim(assoc_value),
           array(a)
     {
+        if (array)
+            array->AddReference();
         if (assoc == ASSOC_LOGICALDIM && assoc_value < 0)
             THROW(eavlException,"Need a nonnegative dim index for logical dim association");
         if (assoc == ASSOC_CELL_SET)
@@ -72,6 +82,8 @@ class eavlField
           assoc_cellset_name(assoc_value),
           array(a)
     {
+        if (array)
+            array->AddReference();
     }
     eavlField(eavlField *f,
               eavlArray *a)
@@ -81,10 +93,24 @@ class eavlField
           assoc_logicaldim(f->assoc_logicaldim),
           array(a)
     {
+        if (array)
+            array->AddReference();
+    }
+    /// A field with the same association as f, sharing its array.
+    eavlField(eavlField *f)
+        : order(f->order),
+          association(f->association),
+          assoc_cellset_name(f->assoc_cellset_name),
+          assoc_logicaldim(f->assoc_logicaldim),
+          array(f->array)
+    {
+        if (array)
+            array->AddReference();
     }
     virtual ~eavlField()
     {
-        delete array;
+        if (array)
+            array->Release();
     }
     virtual string className() const {return "eavlField";}
     virtual eavlStream& serialize(eavlStream &s) const
@@ -100,7 +126,10 @@ class eavlField
 	s >> nm >> order >> association >> assoc_logicaldim;
 	s >> assoc_cellset_name >> assoc_logicaldim;
 	s >> nm;
+	if (array)
+	    array->Release();
 	array = eavlArray::CreateObjFromName(nm);
+	array->AddReference();
 	array->deserialize(s);
 	return s;
     }
@@ -3,6 +3,7 @@
 #include "eavlFlatArray.h"
 
 template<> const char *eavlFlatArray<int>::GetBasicType() const {return "int";}
+template<> const char *eavlFlatArray<unsigned char>::GetBasicType() const {return "unsigned char";}
 
 template <class T> eavlFlatArray<T> *
 eavlFlatArray<T>::CreateObjFromName(const string &nm)
@@ -13,6 +14,8 @@ eavlFlatArray<T>::CreateObjFromName(const string &nm)
 	return new eavlFlatArray<float>();
     if (nm == "eavlFlatArray<bool>")
 	return new eavlFlatArray<bool>();
+    if (nm == "eavlFlatArray<unsigned char>")
+	return new eavlFlatArray<unsigned char>();
     else
 	throw;
 }
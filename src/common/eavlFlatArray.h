@@ -35,6 +35,9 @@
 // Creation:    July 26, 2012
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added release.
+//
 // ****************************************************************************
 template <class T>
 class eavlFlatArray
@@ -146,6 +149,27 @@ class eavlFlatArray
 #endif
         length = 0;
     }
+    /// Empties the array and, unlike clear, frees its memory.
+    EAVL_HOSTONLY void release()
+    {
+        if (!copied)
+        {
+            if (host)
+                delete[] host;
+#ifdef HAVE_CUDA
+            if (device)
+                cudaFree(device);
+#endif
+        }
+        host = NULL;
+#ifdef HAVE_CUDA
+        device = NULL;
+#endif
+        length = 0;
+        capacity = 0;
+        state = LAST_MODIFIED_HOST;
+        copied = false;
+    }
 
     EAVL_HOSTONLY void reserve(long long newcap)
     {
@@ -0,0 +1,616 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_IMPLICIT_ARRAY_H
+#define EAVL_IMPLICIT_ARRAY_H
+
+#include "eavlArray.h"
+
+template <class T> inline const char *eavlImplicitBasicType();
+template <> inline const char *eavlImplicitBasicType<int>()   { return "int"; }
+template <> inline const char *eavlImplicitBasicType<byte>()  { return "byte"; }
+template <> inline const char *eavlImplicitBasicType<float>() { return "float"; }
+
+// ****************************************************************************
+// Class:  eavlImplicitArray
+//
+// Purpose:
+///   Base class for arrays whose values are computed from a few
+///   parameters instead of being stored, such as a constant, a counting
+///   sequence or the node coordinates of a uniform grid.  They can't be
+///   written, resized or shared: GetHostArray and GetCUDAArray throw.
+///   Their values can be read with GetComponentAsDouble, and operations
+///   passed an eavlIndexable of the subclass itself (not the eavlArray
+///   base class) compute them on the fly in their kernels from the
+///   subclass's portal, a small struct of the parameters whose
+///   operator[] takes the same flat (tuple*ncomponents + component)
+///   index as a raw array.  Code that needs raw values, such as an
+///   operation handed one through the eavlArray base class, gets them
+///   from GetConstHostArray and GetConstCUDAArray, which expand them
+///   into a stored copy on first use and keep it.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class eavlImplicitArray : public eavlArray
+{
+  protected:
+    int        ntuples;
+    eavlArray *expanded; ///< the stored copy, made on first use
+    eavlArray *Expanded()
+    {
+        if (!expanded)
+        {
+            expanded = Create(name, ncomponents, ntuples);
+            for (int i=0; i<ntuples; ++i)
+                for (int c=0; c<ncomponents; ++c)
+                    expanded->SetComponentFromDouble(i, c,
+                                                     GetComponentAsDouble(i, c));
+        }
+        return expanded;
+    }
+  public:
+    eavlImplicitArray(const string &n, int nc, int nt)
+        : eavlArray(n, nc), ntuples(nt), expanded(NULL)
+    {
+    }
+    virtual ~eavlImplicitArray()
+    {
+        delete expanded;
+    }
+    virtual void SetNumberOfTuples(int)
+    {
+        THROW(eavlException, "Cannot resize an implicit array");
+    }
+    virtual int GetNumberOfTuples() const
+    {
+        return ntuples;
+    }
+    virtual void SetComponentFromDouble(int, int, double)
+    {
+        THROW(eavlException, "Cannot write to an implicit array");
+    }
+    virtual void *GetHostArray()
+    {
+        THROW(eavlException, "Cannot write to an implicit array");
+    }
+    virtual const void *GetConstHostArray()
+    {
+        return Expanded()->GetConstHostArray();
+    }
+#ifdef HAVE_CUDA
+    virtual void *GetCUDAArray()
+    {
+        THROW(eavlException, "Cannot write to an implicit array");
+    }
+    virtual const void *GetConstCUDAArray()
+    {
+        return Expanded()->GetConstCUDAArray();
+    }
+#endif
+    virtual void ShareHostArray(eavlArray *)
+    {
+        THROW(eavlException, "Cannot share values with an implicit array");
+    }
+    virtual void MarkAsDirty(Location)
+    {
+    }
+    virtual eavlStream& serialize(eavlStream &s) const
+    {
+        s << className();
+        eavlArray::serialize(s);
+        s << ntuples;
+        return s;
+    }
+    virtual eavlStream& deserialize(eavlStream &s)
+    {
+        eavlArray::deserialize(s);
+        s >> ntuples;
+        delete expanded;
+        expanded = NULL;
+        return s;
+    }
+    virtual long long GetMemoryUsage()
+    {
+        long long mem = sizeof(int) + sizeof(eavlArray*);
+        if (expanded)
+            mem += expanded->GetMemoryUsage();
+        return mem + eavlArray::GetMemoryUsage();
+    }
+};
+
+// the smallest magnitude in [lo,hi]
+inline double eavlImplicitMinAbs(double lo, double hi)
+{
+    if (lo <= 0 && hi >= 0)
+        return 0;
+    return std::min(fabs(lo), fabs(hi));
+}
+
+// ****************************************************************************
+// Class:  eavlConstantArray
+//
+// Purpose:
+///   An implicit array of nt tuples whose every component is one value.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlConstantPortal
+{
+    typedef T type;
+    T value;
+    EAVL_HOSTDEVICE T operator[](int) const
+    {
+        return value;
+    }
+};
+
+template <class T>
+class eavlConstantArray : public eavlImplicitArray
+{
+  public:
+    typedef T type;
+    typedef eavlConstantPortal<T> portal_type;
+  protected:
+    T value;
+    virtual void ComputeRanges()
+    {
+        componentMins.assign(ncomponents, ntuples > 0 ? double(value) : +DBL_MAX);
+        componentMaxs.assign(ncomponents, ntuples > 0 ? double(value) : -DBL_MAX);
+        magnitudeMin = ntuples > 0 ? fabs(double(value)) * sqrt(double(ncomponents)) : +DBL_MAX;
+        magnitudeMax = ntuples > 0 ? magnitudeMin : 0;
+    }
+  public:
+    eavlConstantArray(const string &n, T v = T(), int nt = 0, int nc = 1)
+        : eavlImplicitArray(n, nc, nt), value(v)
+    {
+    }
+    virtual string className() const {return string("eavlConstantArray<")+GetBasicType()+">";}
+    virtual eavlStream& serialize(eavlStream &s) const
+    {
+        eavlImplicitArray::serialize(s);
+        s << value;
+        return s;
+    }
+    virtual eavlStream& deserialize(eavlStream &s)
+    {
+        eavlImplicitArray::deserialize(s);
+        s >> value;
+        return s;
+    }
+    virtual eavlArray *Create(const string &n, int nc = 1, int nt = 0)
+    {
+        return new eavlConcreteArray<T>(n, nc, nt);
+    }
+    virtual const char *GetBasicType() const
+    {
+        return eavlImplicitBasicType<T>();
+    }
+    virtual int GetBasicTypeSize() const
+    {
+        return sizeof(T);
+    }
+    virtual double GetComponentAsDouble(int, int)
+    {
+        return value;
+    }
+    T GetValue(int) const
+    {
+        return value;
+    }
+    portal_type GetPortal(Location) const
+    {
+        portal_type p;
+        p.value = value;
+        return p;
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlCountingArray
+//
+// Purpose:
+///   An implicit array of the nt single-component values start,
+///   start+step, start+2*step, ...; by default the indices 0..nt-1.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlCountingPortal
+{
+    typedef T type;
+    T start;
+    T step;
+    EAVL_HOSTDEVICE T operator[](int i) const
+    {
+        return start + step * T(i);
+    }
+};
+
+template <class T>
+class eavlCountingArray : public eavlImplicitArray
+{
+  public:
+    typedef T type;
+    typedef eavlCountingPortal<T> portal_type;
+  protected:
+    T start;
+    T step;
+    virtual void ComputeRanges()
+    {
+        componentMins.assign(1, +DBL_MAX);
+        componentMaxs.assign(1, -DBL_MAX);
+        magnitudeMin = +DBL_MAX;
+        magnitudeMax = 0;
+        if (ntuples <= 0)
+            return;
+        double first = GetValue(0);
+        double last = GetValue(ntuples-1);
+        componentMins[0] = std::min(first, last);
+        componentMaxs[0] = std::max(first, last);
+        magnitudeMax = std::max(fabs(first), fabs(last));
+        // the value nearest zero, if the sequence crosses it
+        magnitudeMin = std::min(fabs(first), fabs(last));
+        if (componentMins[0] < 0 && componentMaxs[0] > 0 && step != T(0))
+        {
+            int k = int(-double(start) / double(step));
+            for (int j=std::max(k-1,0); j<=std::min(k+1,ntuples-1); ++j)
+                magnitudeMin = std::min(magnitudeMin, fabs(double(GetValue(j))));
+        }
+    }
+  public:
+    eavlCountingArray(const string &n, int nt = 0, T s = T(0), T st = T(1))
+        : eavlImplicitArray(n, 1, nt), start(s), step(st)
+    {
+    }
+    virtual string className() const {return string("eavlCountingArray<")+GetBasicType()+">";}
+    virtual eavlStream& serialize(eavlStream &s) const
+    {
+        eavlImplicitArray::serialize(s);
+        s << start << step;
+        return s;
+    }
+    virtual eavlStream& deserialize(eavlStream &s)
+    {
+        eavlImplicitArray::deserialize(s);
+        s >> start >> step;
+        return s;
+    }
+    virtual eavlArray *Create(const string &n, int nc = 1, int nt = 0)
+    {
+        return new eavlConcreteArray<T>(n, nc, nt);
+    }
+    virtual const char *GetBasicType() const
+    {
+        return eavlImplicitBasicType<T>();
+    }
+    virtual int GetBasicTypeSize() const
+    {
+        return sizeof(T);
+    }
+    virtual double GetComponentAsDouble(int i, int)
+    {
+        return GetValue(i);
+    }
+    T GetValue(int i) const
+    {
+        return start + step * T(i);
+    }
+    portal_type GetPortal(Location) const
+    {
+        portal_type p;
+        p.start = start;
+        p.step = step;
+        return p;
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlUniformArray
+//
+// Purpose:
+///   An implicit array of the node coordinates of a uniform grid of
+///   dims[0] x ... x dims[ndims-1] nodes (i varying fastest), with one
+///   component per dimension: component c of a node is origin[c] plus
+///   spacing[c] times its logical index along c.  A one-dimensional one
+///   is a uniformly spaced axis.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlUniformPortal
+{
+    typedef T type;
+    int    ndims;
+    int    dims[3];
+    double origin[3];
+    double spacing[3];
+    EAVL_HOSTDEVICE T operator[](int index) const
+    {
+        int node = index / ndims;
+        int c = index % ndims;
+        int logical = (c == 0) ? node % dims[0] :
+                      (c == 1) ? (node / dims[0]) % dims[1] :
+                                 node / (dims[0] * dims[1]);
+        return T(origin[c] + spacing[c] * double(logical));
+    }
+};
+
+template <class T>
+class eavlUniformArray : public eavlImplicitArray
+{
+  public:
+    typedef T type;
+    typedef eavlUniformPortal<T> portal_type;
+  protected:
+    portal_type uniform;
+    virtual void ComputeRanges()
+    {
+        componentMins.assign(ncomponents, +DBL_MAX);
+        componentMaxs.assign(ncomponents, -DBL_MAX);
+        magnitudeMin = +DBL_MAX;
+        magnitudeMax = 0;
+        if (ntuples <= 0)
+            return;
+        // the components are independent, so the magnitude is smallest
+        // (largest) with each component at its smallest (largest) size
+        double mag2min = 0, mag2max = 0;
+        for (int c=0; c<ncomponents; ++c)
+        {
+            double first = T(uniform.origin[c]);
+            double last = T(uniform.origin[c] + uniform.spacing[c] *
+                            double(uniform.dims[c] - 1));
+            componentMins[c] = std::min(first, last);
+            componentMaxs[c] = std::max(first, last);
+            double minabs = std::min(fabs(first), fabs(last));
+            if (componentMins[c] < 0 && componentMaxs[c] > 0)
+            {
+                int k = int(-uniform.origin[c] / uniform.spacing[c]);
+                for (int j=std::max(k-1,0); j<=std::min(k+1,uniform.dims[c]-1); ++j)
+                    minabs = std::min(minabs, fabs(double(T(uniform.origin[c] + uniform.spacing[c] * double(j)))));
+            }
+            double maxabs = std::max(fabs(first), fabs(last));
+            mag2min += minabs * minabs;
+            mag2max += maxabs * maxabs;
+        }
+        magnitudeMin = sqrt(mag2min);
+        magnitudeMax = sqrt(mag2max);
+    }
+  public:
+    eavlUniformArray(const string &n, int ndims = 1,
+                     const int *dims = NULL,
+                     const double *origin = NULL,
+                     const double *spacing = NULL)
+        : eavlImplicitArray(n, ndims, 0)
+    {
+        if (ndims < 1 || ndims > 3)
+            THROW(eavlException, "A uniform array needs 1 to 3 dimensions");
+        uniform.ndims = ndims;
+        ntuples = 1;
+        for (int c=0; c<3; ++c)
+        {
+            uniform.dims[c]    = (c < ndims && dims) ? dims[c] : 1;
+            uniform.origin[c]  = (c < ndims && origin) ? origin[c] : 0.;
+            uniform.spacing[c] = (c < ndims && spacing) ? spacing[c] : 1.;
+            ntuples *= uniform.dims[c];
+        }
+    }
+    virtual string className() const {return string("eavlUniformArray<")+GetBasicType()+">";}
+    virtual eavlStream& serialize(eavlStream &s) const
+    {
+        eavlImplicitArray::serialize(s);
+        s << uniform.ndims;
+        for (int c=0; c<3; ++c)
+            s << uniform.dims[c] << uniform.origin[c] << uniform.spacing[c];
+        return s;
+    }
+    virtual eavlStream& deserialize(eavlStream &s)
+    {
+        eavlImplicitArray::deserialize(s);
+        s >> uniform.ndims;
+        for (int c=0; c<3; ++c)
+            s >> uniform.dims[c] >> uniform.origin[c] >> uniform.spacing[c];
+        return s;
+    }
+    virtual eavlArray *Create(const string &n, int nc = 1, int nt = 0)
+    {
+        return new eavlConcreteArray<T>(n, nc, nt);
+    }
+    virtual const char *GetBasicType() const
+    {
+        return eavlImplicitBasicType<T>();
+    }
+    virtual int GetBasicTypeSize() const
+    {
+        return sizeof(T);
+    }
+    virtual double GetComponentAsDouble(int i, int c)
+    {
+        return uniform[i*ncomponents + c];
+    }
+    portal_type GetPortal(Location) const
+    {
+        return uniform;
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlCartesianProductArray
+//
+// Purpose:
+///   An implicit array of the node coordinates of a rectilinear grid,
+///   the Cartesian product of two or three axis arrays (i varying
+///   fastest), with one component per axis.  Only the axes are stored:
+///   the constructor copies the first component of each given array.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlCartesianProductPortal
+{
+    typedef T type;
+    int      ndims;
+    int      dims[3];
+    const T *axes[3];
+    EAVL_HOSTDEVICE T operator[](int index) const
+    {
+        int node = index / ndims;
+        int c = index % ndims;
+        int logical = (c == 0) ? node % dims[0] :
+                      (c == 1) ? (node / dims[0]) % dims[1] :
+                                 node / (dims[0] * dims[1]);
+        return axes[c][logical];
+    }
+};
+
+template <class T>
+class eavlCartesianProductArray : public eavlImplicitArray
+{
+  public:
+    typedef T type;
+    typedef eavlCartesianProductPortal<T> portal_type;
+  protected:
+    eavlConcreteArray<T> *axes[3];
+    void SetAxes(eavlArray *x, eavlArray *y, eavlArray *z)
+    {
+        eavlArray *in[3] = {x, y, z};
+        ntuples = 1;
+        for (int c=0; c<ncomponents; ++c)
+        {
+            int n = in[c]->GetNumberOfTuples();
+            axes[c] = new eavlConcreteArray<T>(in[c]->GetName(), 1, n);
+            for (int i=0; i<n; ++i)
+                axes[c]->SetValue(i, T(in[c]->GetComponentAsDouble(i,0)));
+            ntuples *= n;
+        }
+    }
+    virtual void ComputeRanges()
+    {
+        componentMins.assign(ncomponents, +DBL_MAX);
+        componentMaxs.assign(ncomponents, -DBL_MAX);
+        magnitudeMin = +DBL_MAX;
+        magnitudeMax = 0;
+        if (ntuples <= 0)
+            return;
+        // as for uniform arrays, the components are independent
+        double mag2min = 0, mag2max = 0;
+        for (int c=0; c<ncomponents; ++c)
+        {
+            double mn = axes[c]->GetComponentMin(0);
+            double mx = axes[c]->GetComponentMax(0);
+            double minabs = +DBL_MAX;
+            int n = axes[c]->GetNumberOfTuples();
+            for (int i=0; i<n; ++i)
+                minabs = std::min(minabs, fabs(double(axes[c]->GetValue(i))));
+            componentMins[c] = mn;
+            componentMaxs[c] = mx;
+            double maxabs = std::max(fabs(mn), fabs(mx));
+            mag2min += minabs * minabs;
+            mag2max += maxabs * maxabs;
+        }
+        magnitudeMin = sqrt(mag2min);
+        magnitudeMax = sqrt(mag2max);
+    }
+  public:
+    eavlCartesianProductArray(const string &n)
+        : eavlImplicitArray(n, 0, 0)
+    {
+        axes[0] = axes[1] = axes[2] = NULL;
+    }
+    eavlCartesianProductArray(const string &n,
+                              eavlArray *x, eavlArray *y, eavlArray *z = NULL)
+        : eavlImplicitArray(n, z ? 3 : 2, 0)
+    {
+        axes[0] = axes[1] = axes[2] = NULL;
+        SetAxes(x, y, z);
+    }
+    virtual ~eavlCartesianProductArray()
+    {
+        for (int c=0; c<3; ++c)
+            delete axes[c];
+    }
+    virtual string className() const {return string("eavlCartesianProductArray<")+GetBasicType()+">";}
+    virtual eavlStream& serialize(eavlStream &s) const
+    {
+        eavlImplicitArray::serialize(s);
+        for (int c=0; c<ncomponents; ++c)
+            axes[c]->serialize(s);
+        return s;
+    }
+    virtual eavlStream& deserialize(eavlStream &s)
+    {
+        eavlImplicitArray::deserialize(s);
+        for (int c=0; c<3; ++c)
+        {
+            delete axes[c];
+            axes[c] = NULL;
+        }
+        string nm;
+        for (int c=0; c<ncomponents; ++c)
+        {
+            s >> nm;
+            axes[c] = new eavlConcreteArray<T>("");
+            axes[c]->deserialize(s);
+        }
+        return s;
+    }
+    virtual eavlArray *Create(const string &n, int nc = 1, int nt = 0)
+    {
+        return new eavlConcreteArray<T>(n, nc, nt);
+    }
+    virtual const char *GetBasicType() const
+    {
+        return eavlImplicitBasicType<T>();
+    }
+    virtual int GetBasicTypeSize() const
+    {
+        return sizeof(T);
+    }
+    virtual double GetComponentAsDouble(int i, int c)
+    {
+        int ni = axes[0]->GetNumberOfTuples();
+        int nj = axes[1]->GetNumberOfTuples();
+        int logical = (c == 0) ? i % ni :
+                      (c == 1) ? (i / ni) % nj :
+                                 i / (ni * nj);
+        return axes[c]->GetValue(logical);
+    }
+    eavlConcreteArray<T> *GetAxis(int c)
+    {
+        return axes[c];
+    }
+    portal_type GetPortal(Location loc)
+    {
+        portal_type p;
+        p.ndims = ncomponents;
+        for (int c=0; c<3; ++c)
+        {
+            p.dims[c] = (c < ncomponents) ? axes[c]->GetNumberOfTuples() : 1;
+            p.axes[c] = (c < ncomponents) ?
+                (const T*)axes[c]->GetConstRawPointer(loc) : NULL;
+        }
+        return p;
+    }
+    virtual long long GetMemoryUsage()
+    {
+        long long mem = eavlImplicitArray::GetMemoryUsage();
+        for (int c=0; c<ncomponents; ++c)
+            mem += axes[c]->GetMemoryUsage();
+        return mem;
+    }
+};
+
+#endif
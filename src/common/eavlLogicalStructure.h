@@ -4,6 +4,7 @@
 
 #include "STL.h"
 #include "eavlSerialize.h"
+#include "eavlReferenceCounted.h"
 
 // ****************************************************************************
 // Class:  eavlLogicalStructure
@@ -16,8 +17,12 @@
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    March  1, 2011
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Made reference counted, so several data sets can share one.
+//
 // ****************************************************************************
-class eavlLogicalStructure
+class eavlLogicalStructure : public eavlReferenceCounted
 {
   protected:
     int logicalDimension;
@@ -0,0 +1,91 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavlMappedFile.h"
+#include "eavlException.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+eavlMappedFile::eavlMappedFile(const string &fn, size_t offset, size_t len,
+                               Mode m)
+    : filename(fn), mode(m), length(len), base(NULL), baselength(0), data(NULL)
+{
+#if defined(_WIN32)
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (!fp)
+        THROW(eavlException, string("Could not open file ")+filename);
+    if (length > 0)
+    {
+        base = malloc(length);
+        if (!base ||
+            fseek(fp, (long)offset, SEEK_SET) != 0 ||
+            fread(base, 1, length, fp) != length)
+        {
+            fclose(fp);
+            free(base);
+            THROW(eavlException, string("Could not read ")+filename);
+        }
+        baselength = length;
+        data = (char*)base;
+    }
+    fclose(fp);
+    // a heap copy is always safe to write
+    mode = COPYONWRITE;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        THROW(eavlException, string("Could not open file ")+filename);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < offset + length)
+    {
+        close(fd);
+        THROW(eavlException, string("File is too short to map: ")+filename);
+    }
+
+    // an empty region can't be mapped, but it needs no storage anyway
+    if (length > 0)
+    {
+        size_t pagesize = (size_t)sysconf(_SC_PAGESIZE);
+        size_t start = offset - offset % pagesize;
+        baselength = length + (offset - start);
+        if (mode == READONLY)
+            base = mmap(NULL, baselength, PROT_READ, MAP_SHARED,
+                        fd, (off_t)start);
+        else
+            base = mmap(NULL, baselength, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        fd, (off_t)start);
+        if (base == MAP_FAILED)
+        {
+            int err = errno;
+            close(fd);
+            base = NULL;
+            THROW(eavlException, string("Could not map ")+filename+": "+
+                                 strerror(err));
+        }
+        data = (char*)base + (offset - start);
+    }
+
+    // the mapping holds its own reference to the file
+    close(fd);
+#endif
+}
+
+eavlMappedFile::~eavlMappedFile()
+{
+#if defined(_WIN32)
+    free(base);
+#else
+    if (base)
+        munmap(base, baselength);
+#endif
+}
@@ -0,0 +1,60 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_MAPPED_FILE_H
+#define EAVL_MAPPED_FILE_H
+
+#include "STL.h"
+
+// ****************************************************************************
+// Class:  eavlMappedFile
+//
+// Purpose:
+///   A region of a file mapped into memory.  The offset need not be
+///   page aligned; the mapping is widened to the enclosing pages and
+///   GetData() points at the first requested byte.
+///
+///   A READONLY mapping is shared with the page cache and may not be
+///   written.  A COPYONWRITE mapping is private: it may be written,
+///   and the pages which are written are copied, but the file itself
+///   never changes.  Either way, pages are only read from the file
+///   when they are first touched.
+///
+///   On platforms without mmap, the region is read into heap memory
+///   instead, which behaves like a COPYONWRITE mapping.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class eavlMappedFile
+{
+  public:
+    enum Mode
+    {
+        READONLY,
+        COPYONWRITE
+    };
+  protected:
+    string  filename;
+    Mode    mode;
+    size_t  length;
+    void   *base;
+    size_t  baselength;
+    char   *data;
+  public:
+    eavlMappedFile(const string &filename, size_t offset, size_t length,
+                   Mode mode);
+    ~eavlMappedFile();
+
+    const string &GetFileName() const { return filename; }
+    Mode          GetMode() const     { return mode; }
+    bool          IsWritable() const  { return mode == COPYONWRITE; }
+    size_t        GetLength() const   { return length; }
+    void         *GetData()           { return data; }
+
+  private:
+    eavlMappedFile(const eavlMappedFile&);
+    void operator=(const eavlMappedFile&);
+};
+
+#endif
@@ -194,17 +194,6 @@ struct eavlArrayWithLinearIndex
 };
 
 
-// ****************************************************************************
-// Class:  eavlOperation
-//
-// Purpose:
-///
-//
-// Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern, Rob Sisneros
-// Creation:    September 2, 2011
-//
-// ****************************************************************************
-
 // Note:
 //    These functors are more complex than they need to be for most usage.
 //    However, as these are provided for arbitrary use, they need to be
@@ -282,7 +271,7 @@ struct eavlMulFunctor
     template<class HT>
     EAVL_FUNCTOR T operator()(const refcons<HT,nulltype> &args) { return T(args.first); }
 
-    T identity() { return 0; }
+    T identity() { return 1; }
 };
 
 template<class T>
@@ -370,14 +359,166 @@ struct DummyFunctor
 };
 
 
+// ****************************************************************************
+// Class:  eavlOperationArray
+//
+// Purpose:
+///   Describes one array read or written by an operation, along with the
+///   indexer the operation uses to reach it.  The executor uses these to
+///   find the dependencies between the operations in a plan.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlOperationArray
+{
+    eavlArray        *array;
+    eavlArrayIndexer  indexer;
+    eavlOperationArray(eavlArray *a, const eavlArrayIndexer &i)
+        : array(a), indexer(i)
+    {
+    }
+};
+
+// add every array in a tuple of eavlIndexables to a list
+inline void eavlAddOperationArrays(const nulltype &,
+                                   vector<eavlOperationArray> &)
+{
+}
+
+template <class HT, class TT>
+inline void eavlAddOperationArrays(const cons<HT,TT> &args,
+                                   vector<eavlOperationArray> &arrays)
+{
+    arrays.push_back(eavlOperationArray(args.first.array,
+                                        args.first.indexer));
+    eavlAddOperationArrays(args.rest, arrays);
+}
+
+template <class HT>
+inline void eavlAddOperationArrays(const cons<HT,nulltype> &args,
+                                   vector<eavlOperationArray> &arrays)
+{
+    arrays.push_back(eavlOperationArray(args.first.array,
+                                        args.first.indexer));
+}
+
+inline void eavlAddOperationArrays(const eavlArrayWithLinearIndex &a,
+                                   vector<eavlOperationArray> &arrays)
+{
+    arrays.push_back(eavlOperationArray(a.array,
+                                        eavlArrayIndexer(a.div, a.mod,
+                                                         a.mul, a.add)));
+}
+
+class eavlCellSet;
+
+// how an operation which runs its own CPU loops (rather than ranges of
+// work items run by the executor) should run them
+struct eavlCPULoops
+{
+    bool threadPool; ///< run them on eavlThreadPool instead of OpenMP
+    int  grainSize;  ///< the thread pool's grain size, or 0 to choose one
+    eavlCPULoops() : threadPool(false), grainSize(0)
+    {
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlOperation
+//
+// Purpose:
+///   Base class for the operations executed by eavlExecutor.  Beyond
+///   the CPU and GPU implementations, an operation can describe the
+///   arrays it reads and writes (and the cell set whose connectivity it
+///   uses) so the executor can find operations which are independent of
+///   each other.  An element-wise operation, where work item i touches
+///   its arrays only at indexer.index(i), can also run any sub-range of
+///   its items, which allows the executor to fuse consecutive
+///   element-wise operations into a single pass over the data.
+//
+// Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern, Rob Sisneros
+// Creation:    September 2, 2011
+//
+// Modifications:
+//   agent, October 17, 2026
+//   The executor marks the outputs from GetArrays as written.
+//
+//   agent, October 17, 2026
+//   Added cpuLoops, which operations with loops of their own use to run
+//   them on the executor's thread pool.
+//
+// ****************************************************************************
 class eavlOperation 
 {
     friend class eavlExecutor;
   public:
     virtual ~eavlOperation() { }
   protected:
+    /// Set by the executor before GoCPU is called.
+    eavlCPULoops cpuLoops;
+
     virtual void GoCPU() = 0;
     virtual void GoGPU() = 0;
+
+    /// Fill in the arrays this operation reads and writes.  Returning
+    /// false (the default) means they are unknown, and the executor
+    /// will not reorder anything around this operation.  The executor
+    /// also marks the outputs as written before running it, since
+    /// eavlOpDispatch hands kernels every array through the read-only
+    /// accessors; an operation which returns false must do that itself
+    /// (e.g. by getting its outputs' values with GetHostArray).
+    virtual bool GetArrays(vector<eavlOperationArray> &,
+                           vector<eavlOperationArray> &)
+    {
+        return false;
+    }
+    /// The cell set whose connectivity this operation uses, if any.
+    /// (Connectivity is built on demand, so two operations using the
+    /// same cell set are never run at the same time.)
+    virtual eavlCellSet *GetCellSet()
+    {
+        return NULL;
+    }
+    /// For element-wise operations, the number of work items; for all
+    /// other operations, -1.
+    virtual int GetElementwiseLength()
+    {
+        return -1;
+    }
+    /// Run work items [begin,end) of an element-wise operation serially
+    /// on the CPU.
+    virtual void GoCPURange(int, int)
+    {
+        THROW(eavlException,"This operation can't run on a sub-range of items.");
+    }
+    /// For operations whose work items can be run in independent ranges
+    /// with GoCPURange (which every element-wise operation can), the
+    /// number of work items; for all other operations, -1.  Unlike
+    /// element-wise operations, these may not be fused with others.
+    virtual int GetCPURangeLength()
+    {
+        return GetElementwiseLength();
+    }
+    /// Called once before ranges of work items are run at the same time,
+    /// to build anything they share on demand (e.g. connectivity).
+    virtual void PrepareCPURange()
+    {
+    }
+};
+
+// the structure passed to a kernel which runs work items [begin,n)
+// of an operation with a structure of its own (e.g. connectivity)
+template <class S>
+struct eavlRangeStructure
+{
+    S   &structure;
+    int  begin;
+    eavlRangeStructure(S &s, int b) : structure(s), begin(b)
+    {
+    }
 };
 
 #endif
@@ -0,0 +1,274 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_PACKED_CONNECTIVITY_H
+#define EAVL_PACKED_CONNECTIVITY_H
+
+#include "eavlArray.h"
+#include "eavlFlatArray.h"
+#include "eavlExplicitConnectivity.h"
+
+// ****************************************************************************
+// Class:  eavlPackedConnectivity
+//
+// Purpose:
+///   A compact (CSR) form of an eavlExplicitConnectivity.  Each element
+///   has a byte for its shape, the ids of all elements are packed
+///   without their counts, and an offsets array (with one more entry
+///   than there are elements) gives where each element's ids start.
+///   When every element has the same shape and number of ids, as in an
+///   all-tet or all-hex mesh, the shapes and offsets are implicit and
+///   only the ids are stored.
+///
+///   Kernels don't read this directly; they read one of the two views,
+///   eavlMixedConnectivity or eavlHomogeneousConnectivity, which hold
+///   raw host or device pointers, so each kernel is compiled for the
+///   layout it runs on.
+///
+///   eavlCellSetExplicit keeps only this form of a topology once it
+///   has been packed, and uses Unpack to rebuild the explicit form if
+///   it is asked for again.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlPackedConnectivity
+{
+    int nelements;
+    int shape; ///< the shape of every element if homogeneous, else -1
+    int nids;  ///< the ids in every element if homogeneous, else -1
+    eavlFlatArray<unsigned char> shapetype; ///< empty if homogeneous
+    eavlFlatArray<int>           offsets;   ///< empty if homogeneous
+    eavlFlatArray<int>           ids;
+
+    eavlPackedConnectivity() : nelements(0), shape(-1), nids(-1)
+    {
+    }
+    bool IsHomogeneous() const
+    {
+        return shape >= 0;
+    }
+    int GetNumElements() const
+    {
+        return nelements;
+    }
+    EAVL_HOSTONLY void Pack(eavlExplicitConnectivity &e)
+    {
+        int n = e.shapetype.size();
+        if ((int)e.mapCellToIndex.size() != n)
+            e.CreateReverseIndex();
+        int nconn = e.connectivity.size();
+
+        int shape0 = (n > 0) ? e.shapetype[0] : -1;
+        int nids0  = (n > 0) ? e.connectivity[0] : -1;
+        int mixed = 0;
+#pragma omp parallel for reduction(+:mixed)
+        for (int i=0; i<n; i++)
+        {
+            if (e.shapetype[i] != shape0 ||
+                e.connectivity[e.mapCellToIndex[i]] != nids0)
+                mixed++;
+        }
+
+        nelements = n;
+        ids.resize(nconn - n);
+        if (n > 0 && mixed == 0)
+        {
+            shape = shape0;
+            nids = nids0;
+            shapetype.clear();
+            offsets.clear();
+        }
+        else
+        {
+            shape = -1;
+            nids = -1;
+            shapetype.resize(n);
+            offsets.resize(n+1);
+            offsets[n] = nconn - n;
+        }
+
+        // the ids of element i start at its index in the explicit
+        // connectivity, less the i+1 counts which precede them
+        bool homogeneous = IsHomogeneous();
+#pragma omp parallel for
+        for (int i=0; i<n; i++)
+        {
+            int index = e.mapCellToIndex[i];
+            int npts = e.connectivity[index];
+            int start = index - i;
+            if (!homogeneous)
+            {
+                shapetype[i] = (unsigned char)e.shapetype[i];
+                offsets[i] = start;
+            }
+            for (int p=0; p<npts; p++)
+                ids[start + p] = e.connectivity[index + 1 + p];
+        }
+    }
+    /// Rebuilds the explicit connectivity this was packed from.  The
+    /// packed arrays are only ever written on the host, so this reads
+    /// the host copies.
+    EAVL_HOSTONLY void Unpack(eavlExplicitConnectivity &e) const
+    {
+        int n = nelements;
+        int nconn = ids.size() + n;
+        e.shapetype.resize(n);
+        e.connectivity.resize(nconn);
+        e.mapCellToIndex.resize(n);
+
+        bool homogeneous = IsHomogeneous();
+#pragma omp parallel for
+        for (int i=0; i<n; i++)
+        {
+            int start = homogeneous ? i * nids : offsets[i];
+            int npts = homogeneous ? nids : offsets[i+1] - start;
+            int index = start + i;
+            e.shapetype[i] = homogeneous ? shape : int(shapetype[i]);
+            e.mapCellToIndex[i] = index;
+            e.connectivity[index] = npts;
+            for (int p=0; p<npts; p++)
+                e.connectivity[index + 1 + p] = ids[start + p];
+        }
+    }
+#ifdef HAVE_CUDA
+    EAVL_HOSTONLY void NeedOnDevice()
+    {
+        shapetype.NeedOnDevice();
+        offsets.NeedOnDevice();
+        ids.NeedOnDevice();
+    }
+    EAVL_HOSTONLY void NeedOnHost()
+    {
+        shapetype.NeedOnHost();
+        offsets.NeedOnHost();
+        ids.NeedOnHost();
+    }
+#endif
+    EAVL_HOSTONLY long long GetMemoryUsage() const
+    {
+        return (long long)shapetype.size() * sizeof(unsigned char) +
+               (long long)offsets.size() * sizeof(int) +
+               (long long)ids.size() * sizeof(int);
+    }
+    EAVL_HOSTONLY void PrintSummary(ostream &out) const
+    {
+        out << "        nelements = "<<nelements<<endl;
+        if (IsHomogeneous())
+        {
+            out << "        shape = "<<shape<<endl;
+            out << "        nids = "<<nids<<endl;
+        }
+        else
+        {
+            out << "        offsets["<<offsets.size()<<"] = ";
+            PrintVectorSummary(out, offsets);
+            out << endl;
+        }
+        out << "        ids["<<ids.size()<<"] = ";
+        PrintVectorSummary(out, ids);
+        out << endl;
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlMixedConnectivity
+//
+// Purpose:
+///   A view of an eavlPackedConnectivity with explicit shapes and
+///   offsets, on the host or the device, for use in kernels.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlMixedConnectivity
+{
+    const unsigned char *shapetype;
+    const int           *offsets;
+    const int           *ids;
+
+    eavlMixedConnectivity(eavlPackedConnectivity &c, eavlArray::Location loc)
+    {
+        if (loc == eavlArray::DEVICE)
+        {
+#ifdef HAVE_CUDA
+            c.NeedOnDevice();
+            shapetype = c.shapetype.device;
+            offsets   = c.offsets.device;
+            ids       = c.ids.device;
+            return;
+#else
+            THROW(eavlException,"CUDA not available");
+#endif
+        }
+        shapetype = c.shapetype.host;
+        offsets   = c.offsets.host;
+        ids       = c.ids.host;
+    }
+    EAVL_HOSTDEVICE int GetShapeType(int index) const
+    {
+        return shapetype[index];
+    }
+    EAVL_HOSTDEVICE int GetElementComponents(int index, int &npts, int *pts) const
+    {
+        int start = offsets[index];
+        npts = offsets[index+1] - start;
+        for (int i=0; i<npts; ++i)
+            pts[i] = ids[start + i];
+        return shapetype[index];
+    }
+};
+
+// ****************************************************************************
+// Class:  eavlHomogeneousConnectivity
+//
+// Purpose:
+///   A view of an eavlPackedConnectivity whose elements all have the
+///   same shape and number of ids, on the host or the device, for use
+///   in kernels.  Element i's ids start at i*nids, so there is no
+///   offset to look up first.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlHomogeneousConnectivity
+{
+    int        shape;
+    int        nids;
+    const int *ids;
+
+    eavlHomogeneousConnectivity(eavlPackedConnectivity &c,
+                                eavlArray::Location loc)
+        : shape(c.shape), nids(c.nids)
+    {
+        if (loc == eavlArray::DEVICE)
+        {
+#ifdef HAVE_CUDA
+            c.NeedOnDevice();
+            ids = c.ids.device;
+            return;
+#else
+            THROW(eavlException,"CUDA not available");
+#endif
+        }
+        ids = c.ids.host;
+    }
+    EAVL_HOSTDEVICE int GetShapeType(int) const
+    {
+        return shape;
+    }
+    EAVL_HOSTDEVICE int GetElementComponents(int index, int &npts, int *pts) const
+    {
+        const int *el = ids + index * nids;
+        npts = nids;
+        for (int i=0; i<nids; ++i)
+            pts[i] = el[i];
+        return shape;
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_REFERENCE_COUNTED_H
+#define EAVL_REFERENCE_COUNTED_H
+
+// ****************************************************************************
+// Class:  eavlReferenceCounted
+//
+// Purpose:
+///   Base class for parts of a data set which may be shared between
+///   several owners, such as an array shared by the fields of a data set
+///   and of its shallow copy.  Each owner calls AddReference when it
+///   takes the object and Release when it is done with it, and the last
+///   Release deletes it.  An object nobody has taken a reference to can
+///   still be deleted directly, so code which only uses one temporarily
+///   needn't change.  The count is not thread-safe: take and release
+///   references outside of parallel regions.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class eavlReferenceCounted
+{
+  private:
+    int referenceCount;
+  public:
+    eavlReferenceCounted() : referenceCount(0)
+    {
+    }
+    // a copy is a new object, with no owners yet
+    eavlReferenceCounted(const eavlReferenceCounted &) : referenceCount(0)
+    {
+    }
+    eavlReferenceCounted &operator=(const eavlReferenceCounted &)
+    {
+        return *this;
+    }
+    virtual ~eavlReferenceCounted()
+    {
+    }
+    void AddReference()
+    {
+        ++referenceCount;
+    }
+    void Release()
+    {
+        if (--referenceCount <= 0)
+            delete this;
+    }
+    int GetReferenceCount() const
+    {
+        return referenceCount;
+    }
+};
+
+#endif
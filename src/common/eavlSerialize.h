@@ -5,11 +5,35 @@
 #include "STL.h"
 #include <string.h>
 
+// ****************************************************************************
+// Class:  eavlStream
+//
+// Purpose:
+///   A binary stream for serializing eavl objects.  When reading, the
+///   stream may also be given the name of the file it reads from; array
+///   values are then mapped from that file rather than read into heap
+///   memory (copy-on-write unless told otherwise, so arrays stay writable).
+//
+// Modifications:
+//   agent, October 17, 2026
+//   Added the optional file to map array values from.
+//
+// ****************************************************************************
 class eavlStream : public std::basic_iostream<char, std::char_traits<char> >
 {
+protected:
+    string mapfile;
+    bool   mapcopyonwrite;
 public:
-    eavlStream(ostream &os) : std::basic_iostream<char, std::char_traits<char> >(os.rdbuf()) {}
-    eavlStream(istream &is) : std::basic_iostream<char, std::char_traits<char> >(is.rdbuf()) {}
+    eavlStream(ostream &os) : std::basic_iostream<char, std::char_traits<char> >(os.rdbuf()), mapcopyonwrite(true) {}
+    eavlStream(istream &is) : std::basic_iostream<char, std::char_traits<char> >(is.rdbuf()), mapcopyonwrite(true) {}
+    eavlStream(istream &is, const string &filename, bool copyonwrite = true)
+        : std::basic_iostream<char, std::char_traits<char> >(is.rdbuf()),
+          mapfile(filename), mapcopyonwrite(copyonwrite) {}
+
+    bool          CanMap() const           { return !mapfile.empty(); }
+    const string &GetMapFileName() const   { return mapfile; }
+    bool          GetMapCopyOnWrite() const { return mapcopyonwrite; }
 };
 
 template <class T>
@@ -0,0 +1,383 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavlThreadPool.h"
+#include "eavlConfig.h"
+#include "eavlException.h"
+
+#include <stdlib.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+// with an automatic grain size, each thread starts with about this many
+// chunks, so there is something left to steal from a thread which is
+// behind ...
+#define EAVL_THREAD_POOL_CHUNKS_PER_THREAD 8
+// ... but chunks are never smaller than this many items, so that taking
+// one costs little compared to running it
+#define EAVL_THREAD_POOL_MIN_GRAIN 1024
+
+#if !defined(_WIN32)
+
+static int
+eavlDefaultNumberOfThreads()
+{
+    const char *nthreads = getenv("EAVLNUMTHREADS");
+    if (nthreads && atoi(nthreads) > 0)
+        return atoi(nthreads);
+#if defined(HAVE_OPENMP)
+    return omp_get_max_threads();
+#elif defined(_SC_NPROCESSORS_ONLN)
+    int n = int(sysconf(_SC_NPROCESSORS_ONLN));
+    return (n > 0) ? n : 1;
+#else
+    return 1;
+#endif
+}
+
+// the chunks [next,end) a thread has left to run
+struct eavlThreadPoolQueue
+{
+    pthread_mutex_t lock;
+    int             next;
+    int             end;
+    char            pad[64]; ///< keeps each queue's lock on its own cache line
+};
+
+struct eavlThreadPoolState
+{
+    int                  nthreads; ///< including the calling thread
+    vector<pthread_t>    threads;
+    eavlThreadPoolQueue *queues;
+
+    pthread_mutex_t      busy;     ///< held while a loop is running
+    pthread_mutex_t      lock;     ///< guards everything below
+    pthread_cond_t       start;
+    pthread_cond_t       done;
+    int                  generation;
+    int                  nactive;
+    bool                 quit;
+
+    eavlThreadPool::Body *body;
+    int                  n;
+    int                  grainsize;
+    bool                 failed;
+    eavlException        error;
+};
+
+struct eavlThreadPoolWorker
+{
+    eavlThreadPoolState *state;
+    int                  id;
+    int                  generation;
+};
+
+static eavlThreadPoolState *pool = NULL;
+static pthread_once_t poolOnce = PTHREAD_ONCE_INIT;
+
+static void
+eavlCreateThreadPoolQueues(eavlThreadPoolState *s)
+{
+    s->queues = new eavlThreadPoolQueue[s->nthreads];
+    for (int t=0; t<s->nthreads; t++)
+    {
+        pthread_mutex_init(&s->queues[t].lock, NULL);
+        s->queues[t].next = 0;
+        s->queues[t].end = 0;
+    }
+}
+
+static void
+eavlDestroyThreadPoolQueues(eavlThreadPoolState *s)
+{
+    for (int t=0; t<s->nthreads; t++)
+        pthread_mutex_destroy(&s->queues[t].lock);
+    delete[] s->queues;
+    s->queues = NULL;
+}
+
+static void
+eavlCreateThreadPool()
+{
+    eavlThreadPoolState *s = new eavlThreadPoolState;
+    s->nthreads = eavlDefaultNumberOfThreads();
+    eavlCreateThreadPoolQueues(s);
+    pthread_mutex_init(&s->busy, NULL);
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->start, NULL);
+    pthread_cond_init(&s->done, NULL);
+    s->generation = 0;
+    s->nactive = 0;
+    s->quit = false;
+    s->body = NULL;
+    s->n = 0;
+    s->grainsize = 1;
+    s->failed = false;
+    pool = s;
+}
+
+static eavlThreadPoolState *
+eavlGetThreadPool()
+{
+    pthread_once(&poolOnce, eavlCreateThreadPool);
+    return pool;
+}
+
+// take the back half of the chunks another thread has left, and make
+// them this thread's own; false if there were none anywhere
+static bool
+eavlStealChunks(eavlThreadPoolState *s, int id)
+{
+    for (int k=1; k<s->nthreads; k++)
+    {
+        eavlThreadPoolQueue &victim = s->queues[(id + k) % s->nthreads];
+        int from = 0, to = 0;
+        pthread_mutex_lock(&victim.lock);
+        int left = victim.end - victim.next;
+        if (left > 0)
+        {
+            to = victim.end;
+            from = to - (left + 1) / 2;
+            victim.end = from;
+        }
+        pthread_mutex_unlock(&victim.lock);
+
+        if (to > from)
+        {
+            eavlThreadPoolQueue &own = s->queues[id];
+            pthread_mutex_lock(&own.lock);
+            own.next = from;
+            own.end = to;
+            pthread_mutex_unlock(&own.lock);
+            return true;
+        }
+    }
+    return false;
+}
+
+// run this thread's chunks, then steal more until there are none left
+static void
+eavlRunChunks(eavlThreadPoolState *s, int id)
+{
+    eavlThreadPoolQueue &own = s->queues[id];
+    while (true)
+    {
+        int chunk = -1;
+        pthread_mutex_lock(&own.lock);
+        if (own.next < own.end)
+            chunk = own.next++;
+        pthread_mutex_unlock(&own.lock);
+
+        if (chunk < 0)
+        {
+            if (!eavlStealChunks(s, id))
+                return;
+            continue;
+        }
+
+        int begin = chunk * s->grainsize;
+        int end = (s->n - begin > s->grainsize) ? begin + s->grainsize : s->n;
+        try
+        {
+            (*s->body)(begin, end);
+        }
+        catch (const eavlException &e)
+        {
+            pthread_mutex_lock(&s->lock);
+            if (!s->failed)
+            {
+                s->failed = true;
+                s->error = e;
+            }
+            pthread_mutex_unlock(&s->lock);
+        }
+        catch (...)
+        {
+            pthread_mutex_lock(&s->lock);
+            if (!s->failed)
+            {
+                s->failed = true;
+                s->error = eavlException("Unknown error in a thread pool loop.");
+            }
+            pthread_mutex_unlock(&s->lock);
+        }
+    }
+}
+
+static void *
+eavlThreadPoolMain(void *arg)
+{
+    eavlThreadPoolWorker *worker = (eavlThreadPoolWorker*)arg;
+    eavlThreadPoolState *s = worker->state;
+    int id = worker->id;
+    int seen = worker->generation;
+    delete worker;
+
+    pthread_mutex_lock(&s->lock);
+    while (true)
+    {
+        while (s->generation == seen && !s->quit)
+            pthread_cond_wait(&s->start, &s->lock);
+        if (s->quit)
+            break;
+        seen = s->generation;
+        pthread_mutex_unlock(&s->lock);
+
+        eavlRunChunks(s, id);
+
+        pthread_mutex_lock(&s->lock);
+        if (--s->nactive == 0)
+            pthread_cond_signal(&s->done);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+// (called with the pool busy)
+static void
+eavlStartThreads(eavlThreadPoolState *s)
+{
+    for (int t=1; t<s->nthreads; t++)
+    {
+        eavlThreadPoolWorker *worker = new eavlThreadPoolWorker;
+        worker->state = s;
+        worker->id = t;
+        worker->generation = s->generation;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, eavlThreadPoolMain, worker) != 0)
+        {
+            // run with the threads we did get
+            delete worker;
+            eavlDestroyThreadPoolQueues(s);
+            s->nthreads = t;
+            eavlCreateThreadPoolQueues(s);
+            break;
+        }
+        s->threads.push_back(thread);
+    }
+}
+
+// (called with the pool busy)
+static void
+eavlStopThreads(eavlThreadPoolState *s)
+{
+    pthread_mutex_lock(&s->lock);
+    s->quit = true;
+    pthread_cond_broadcast(&s->start);
+    pthread_mutex_unlock(&s->lock);
+    for (unsigned int t=0; t<s->threads.size(); t++)
+        pthread_join(s->threads[t], NULL);
+    s->threads.clear();
+    s->quit = false;
+}
+
+#endif
+
+
+void
+eavlThreadPool::ParallelFor(int n, int grainsize, Body &body)
+{
+    if (n <= 0)
+        return;
+
+#if !defined(_WIN32)
+    eavlThreadPoolState *s = eavlGetThreadPool();
+    if (grainsize <= 0)
+    {
+        grainsize = n / (s->nthreads * EAVL_THREAD_POOL_CHUNKS_PER_THREAD);
+        if (grainsize < EAVL_THREAD_POOL_MIN_GRAIN)
+            grainsize = EAVL_THREAD_POOL_MIN_GRAIN;
+    }
+    int nchunks = (n - 1) / grainsize + 1;
+
+    if (nchunks > 1 && pthread_mutex_trylock(&s->busy) == 0)
+    {
+        if (s->nthreads > 1)
+        {
+            try
+            {
+                body.Prepare();
+            }
+            catch (...)
+            {
+                pthread_mutex_unlock(&s->busy);
+                throw;
+            }
+
+            if ((int)s->threads.size() != s->nthreads - 1)
+                eavlStartThreads(s);
+
+            // deal out a contiguous run of chunks to each thread
+            int nthreads = s->nthreads;
+            for (int t=0; t<nthreads; t++)
+            {
+                s->queues[t].next = int((long long)nchunks * t / nthreads);
+                s->queues[t].end = int((long long)nchunks * (t+1) / nthreads);
+            }
+
+            pthread_mutex_lock(&s->lock);
+            s->body = &body;
+            s->n = n;
+            s->grainsize = grainsize;
+            s->failed = false;
+            s->nactive = nthreads - 1;
+            s->generation++;
+            pthread_cond_broadcast(&s->start);
+            pthread_mutex_unlock(&s->lock);
+
+            eavlRunChunks(s, 0);
+
+            pthread_mutex_lock(&s->lock);
+            while (s->nactive > 0)
+                pthread_cond_wait(&s->done, &s->lock);
+            bool failed = s->failed;
+            eavlException error = s->error;
+            s->body = NULL;
+            pthread_mutex_unlock(&s->lock);
+            pthread_mutex_unlock(&s->busy);
+
+            if (failed)
+                throw error;
+            return;
+        }
+        pthread_mutex_unlock(&s->busy);
+    }
+#endif
+
+    body(0, n);
+}
+
+
+void
+eavlThreadPool::SetNumberOfThreads(int n)
+{
+#if !defined(_WIN32)
+    if (n < 1)
+        n = 1;
+    eavlThreadPoolState *s = eavlGetThreadPool();
+    pthread_mutex_lock(&s->busy);
+    if (n != s->nthreads)
+    {
+        eavlStopThreads(s);
+        eavlDestroyThreadPoolQueues(s);
+        s->nthreads = n;
+        eavlCreateThreadPoolQueues(s);
+    }
+    pthread_mutex_unlock(&s->busy);
+#endif
+}
+
+
+int
+eavlThreadPool::GetNumberOfThreads()
+{
+#if !defined(_WIN32)
+    return eavlGetThreadPool()->nthreads;
+#else
+    return 1;
+#endif
+}
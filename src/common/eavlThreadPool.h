@@ -0,0 +1,65 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_THREAD_POOL_H
+#define EAVL_THREAD_POOL_H
+
+#include "STL.h"
+
+// ****************************************************************************
+// Class:  eavlThreadPool
+//
+// Purpose:
+///   A persistent pool of CPU threads which runs loops over work items,
+///   balancing them by work stealing.  ParallelFor splits the items into
+///   chunks of the grain size and deals a contiguous run of chunks to
+///   each thread (the calling thread is one of them).  A thread which
+///   runs out of chunks steals the back half of what another thread has
+///   left, so items of uneven cost are balanced without every chunk
+///   being handed out from one shared counter.  The threads sleep
+///   between loops instead of being created and joined for each one,
+///   and a loop with a single chunk runs in the calling thread without
+///   waking them at all.
+///
+///   A loop started while the pool is running another (from inside a
+///   loop body, or from another thread) runs serially in the thread
+///   which started it.  An eavlException thrown by the loop body is
+///   thrown again by ParallelFor once every thread has stopped; the
+///   chunks which were not yet run when it was thrown still are.
+///
+///   The pool has as many threads as the EAVLNUMTHREADS environment
+///   variable gives, or else as OpenMP would use, or as there are
+///   processors if built without OpenMP.  On platforms without pthreads,
+///   every loop runs serially.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class eavlThreadPool
+{
+  public:
+    /// The body of a loop, which runs work items [begin,end).  It is
+    /// called from several threads at once.
+    class Body
+    {
+      public:
+        virtual ~Body() { }
+        virtual void operator()(int begin, int end) = 0;
+        /// Called in the calling thread before the items are run by
+        /// several threads, but not when they all run in that thread.
+        virtual void Prepare() { }
+    };
+
+    /// Run items [0,n) of a loop in chunks of grainsize items, or if
+    /// grainsize is not positive, in chunks of a size chosen to give
+    /// each thread several of them to start with.
+    static void ParallelFor(int n, int grainsize, Body &body);
+
+    /// Change the number of threads (including the calling thread) used
+    /// by the loops started after this.  This may not be called from a
+    /// loop body.
+    static void SetNumberOfThreads(int n);
+    static int  GetNumberOfThreads();
+};
+
+#endif
@@ -28,12 +28,13 @@ eavlPNMExporter::ConvertAndExport(ostream &out, int w, int h, eavlFloatArray *ar
     double value;
 
 
-    max = min = array->GetComponentAsDouble(0, 0);
+    eavlStridedView<const float> values = array->GetView();
+    max = min = values(0, 0);
 
     for(int i = 0; i < ntuples; i++)
         for(int j = 0; j < ncomponents; j++)
         {
-            value = array->GetComponentAsDouble(i, j);
+            value = values(i, j);
             if(value > max)
                 max = value;
             else if(value < min)
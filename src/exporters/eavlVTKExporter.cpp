@@ -5,6 +5,28 @@
 
 #include <iostream>
 
+// writes ncomp values of each of the first ntuples tuples, each one
+// followed by the separator
+struct WriteValuesFunctor
+{
+    ostream &out;
+    int ntuples, ncomp;
+    const char *sep;
+    WriteValuesFunctor(ostream &o, int nt, int nc, const char *s)
+        : out(o), ntuples(nt), ncomp(nc), sep(s)
+    {
+    }
+    template <class V>
+    void operator()(const V &vals)
+    {
+        for (int i = 0; i < ntuples; i++)
+        {
+            for (int j = 0; j < ncomp; j++)
+                out << double(vals(i,j)) << sep;
+        }
+    }
+};
+
 void
 eavlVTKExporter::Export(ostream &out)
 {
@@ -122,8 +144,8 @@ eavlVTKExporter::ExportRectilinearCoords(ostream &out)
         else if (f->GetAssociation() == eavlField::ASSOC_LOGICALDIM &&
                  f->GetAssocLogicalDim() == axis)
         {
-            for (int i=0; i<n; ++i)
-                out << arr->GetComponentAsDouble(i, 0) << " ";
+            WriteValuesFunctor write(out, n, 1, " ");
+            eavlDispatchView(arr, write, 0);
             out << endl;
         }
     }
@@ -232,11 +254,8 @@ eavlVTKExporter::ExportGlobalFields(ostream &out)
                 out<<"FIELD FieldData "<<count<<endl;
             wrote_global_field_header = true;
             out<<data->GetField(f)->GetArray()->GetName()<<" "<<ncomp<<" "<<ntuples<<" float"<<endl;
-            for (int i = 0; i < ntuples; i++)
-            {
-                for (int j = 0; j < ncomp; j++)
-                    out<<data->GetField(f)->GetArray()->GetComponentAsDouble(i,j)<<endl;
-            }
+            WriteValuesFunctor write(out, ntuples, ncomp, "\n");
+            eavlDispatchView(data->GetField(f)->GetArray(), write);
         }
     }
 }
@@ -261,11 +280,8 @@ eavlVTKExporter::ExportFields(ostream &out)
             wrote_point_header = true;
             out<<"SCALARS "<<data->GetField(f)->GetArray()->GetName()<<" float "<< ncomp<<endl;
             out<<"LOOKUP_TABLE default"<<endl;
-            for (int i = 0; i < ntuples; i++)
-            {
-                for (int j = 0; j < ncomp; j++)
-                    out<<data->GetField(f)->GetArray()->GetComponentAsDouble(i,j)<<endl;
-            }
+            WriteValuesFunctor write(out, ntuples, ncomp, "\n");
+            eavlDispatchView(data->GetField(f)->GetArray(), write);
         }
     }
 
@@ -290,11 +306,8 @@ eavlVTKExporter::ExportFields(ostream &out)
             wrote_cell_header = true;
             out<<"SCALARS "<<data->GetField(f)->GetArray()->GetName()<<" float "<< ncomp<<endl;
             out<<"LOOKUP_TABLE default"<<endl;
-            for (int i = 0; i < ntuples; i++)
-            {
-                for (int j = 0; j < ncomp; j++)
-                    out<<data->GetField(f)->GetArray()->GetComponentAsDouble(i,j)<<endl;
-            }
+            WriteValuesFunctor write(out, ntuples, ncomp, "\n");
+            eavlDispatchView(data->GetField(f)->GetArray(), write);
         }
     }
 }
@@ -2,10 +2,174 @@
 #include "eavl2DGraphLayoutForceMutator.h"
 #include "eavlCellSetExplicit.h"
 
+#include <algorithm>
+
 #ifdef _WIN32
  #define random rand
 #endif
 
+// quadtree cells with at most this many vertices aren't split
+#define GRAPH_LAYOUT_LEAF_SIZE 8
+// and cells this deep never are, so coincident vertices end the split
+#define GRAPH_LAYOUT_MAX_DEPTH 32
+
+// ****************************************************************************
+// Class:  GraphLayoutQuadtree
+//
+// Purpose:
+///   A quadtree over the vertex positions, with the number of vertices
+///   and their center of mass in each cell, for approximating the
+///   repulsive force on a vertex from the vertices far away from it.
+///   Each cell's vertices are a contiguous range of the order array.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class GraphLayoutQuadtree
+{
+  protected:
+    struct Node
+    {
+        float x0, y0, size;   ///< the cell's square
+        float cx, cy;         ///< center of mass of its vertices
+        int   begin, end;     ///< its vertices in order
+        int   children[4];    ///< or -1 where a quadrant is empty
+    };
+
+    struct Below
+    {
+        const float *v;
+        float split;
+        Below(const float *v_, float s) : v(v_), split(s) { }
+        bool operator()(int i) const { return v[i] < split; }
+    };
+
+    const float *x, *y;
+    vector<int>  order;
+    vector<Node> nodes;
+
+    int Build(float x0, float y0, float size, int begin, int end, int depth)
+    {
+        Node node;
+        node.x0 = x0;
+        node.y0 = y0;
+        node.size = size;
+        node.begin = begin;
+        node.end = end;
+        double sx = 0, sy = 0;
+        for (int i=begin; i<end; i++)
+        {
+            sx += x[order[i]];
+            sy += y[order[i]];
+        }
+        node.cx = sx / (end - begin);
+        node.cy = sy / (end - begin);
+        for (int q=0; q<4; q++)
+            node.children[q] = -1;
+
+        int index = nodes.size();
+        nodes.push_back(node);
+        if (end - begin <= GRAPH_LAYOUT_LEAF_SIZE ||
+            depth >= GRAPH_LAYOUT_MAX_DEPTH)
+            return index;
+
+        // split into the lower and upper halves in y, then each in x
+        float half = size / 2;
+        int bounds[5];
+        bounds[0] = begin;
+        bounds[4] = end;
+        vector<int>::iterator o = order.begin();
+        bounds[2] = std::partition(o+begin, o+end, Below(y, y0+half)) - o;
+        bounds[1] = std::partition(o+begin, o+bounds[2], Below(x, x0+half)) - o;
+        bounds[3] = std::partition(o+bounds[2], o+end, Below(x, x0+half)) - o;
+        for (int q=0; q<4; q++)
+        {
+            if (bounds[q] == bounds[q+1])
+                continue;
+            int child = Build(x0 + ((q & 1) ? half : 0),
+                              y0 + ((q & 2) ? half : 0),
+                              half, bounds[q], bounds[q+1], depth+1);
+            nodes[index].children[q] = child;
+        }
+        return index;
+    }
+  public:
+    GraphLayoutQuadtree(const float *x_, const float *y_, int n) : x(x_), y(y_)
+    {
+        order.resize(n);
+        if (n == 0)
+            return;
+        float xmin = x[0], xmax = x[0], ymin = y[0], ymax = y[0];
+        for (int i=0; i<n; i++)
+        {
+            order[i] = i;
+            xmin = std::min(xmin, x[i]);
+            xmax = std::max(xmax, x[i]);
+            ymin = std::min(ymin, y[i]);
+            ymax = std::max(ymax, y[i]);
+        }
+        // pad the square a little so the largest values are inside it
+        float size = std::max(xmax - xmin, ymax - ymin);
+        size = size * 1.001f + 1.e-6f;
+        Build(xmin, ymin, size, 0, n, 0);
+    }
+    /// The repulsive force (scaled by 1/k^2) on vertex i, summing the
+    /// vertices of a cell as one body at its center of mass where the
+    /// cell's size over the distance is below theta.
+    void Force(int i, float theta, float &fx, float &fy) const
+    {
+        fx = fy = 0;
+        if (nodes.empty())
+            return;
+        float ix = x[i];
+        float iy = y[i];
+        float theta2 = theta * theta;
+        int stack[4*GRAPH_LAYOUT_MAX_DEPTH + 4];
+        int nstack = 0;
+        stack[nstack++] = 0;
+        while (nstack > 0)
+        {
+            const Node &node = nodes[stack[--nstack]];
+            float dx = ix - node.cx;
+            float dy = iy - node.cy;
+            float len2 = dx*dx + dy*dy;
+            bool inside = (ix >= node.x0 && ix < node.x0 + node.size &&
+                           iy >= node.y0 && iy < node.y0 + node.size);
+            if (!inside && node.size * node.size < theta2 * len2)
+            {
+                float count = node.end - node.begin;
+                fx += count * dx / len2;
+                fy += count * dy / len2;
+                continue;
+            }
+            bool leaf = true;
+            for (int q=0; q<4; q++)
+            {
+                if (node.children[q] >= 0)
+                {
+                    stack[nstack++] = node.children[q];
+                    leaf = false;
+                }
+            }
+            if (!leaf)
+                continue;
+            for (int o=node.begin; o<node.end; o++)
+            {
+                int j = order[o];
+                if (j == i)
+                    continue;
+                float jdx = ix - x[j];
+                float jdy = iy - y[j];
+                float jlen2 = jdx*jdx + jdy*jdy;
+                fx += jdx / jlen2;
+                fy += jdy / jlen2;
+            }
+        }
+    }
+};
+
 eavl2DGraphLayoutForceMutator::eavl2DGraphLayoutForceMutator()
 {
     niter = 100;
@@ -13,6 +177,7 @@ eavl2DGraphLayoutForceMutator::eavl2DGraphLayoutForceMutator()
     finaldist = 0.005;
     areaconstant = 1.0;
     gravityconstant = 0.3;
+    openingangle = 0.5;
 }
 
 void
@@ -74,12 +239,42 @@ eavl2DGraphLayoutForceMutator::Execute()
     }
 #endif
 
+    //
+    // each vertex's neighbors along the edges, so the attractive forces
+    // on the vertices can be summed independently
+    //
+    int ncells = cs->GetNumCells();
+    vector<int> nbrstart(npts+1, 0);
+    for (int c=0; c<ncells; ++c)
+    {
+        eavlCell cell = cs->GetCellNodes(c);
+        if (cell.numIndices != 2)
+            continue;
+        nbrstart[cell.indices[0]+1]++;
+        nbrstart[cell.indices[1]+1]++;
+    }
+    for (int i=0; i<npts; ++i)
+        nbrstart[i+1] += nbrstart[i];
+    vector<int> nbrs(nbrstart[npts]);
+    vector<int> nbrfill(nbrstart.begin(), nbrstart.end()-1);
+    for (int c=0; c<ncells; ++c)
+    {
+        eavlCell cell = cs->GetCellNodes(c);
+        if (cell.numIndices != 2)
+            continue;
+        nbrs[nbrfill[cell.indices[0]]++] = cell.indices[1];
+        nbrs[nbrfill[cell.indices[1]]++] = cell.indices[0];
+    }
+
     //
     // do the force-directed layout in 2D
     //
 
+    float *px = (float*)x->GetHostArray();
+    float *py = (float*)y->GetHostArray();
     float k = sqrt(areaconstant / npts);
     float k2 = k*k;
+    float theta = openingangle;
     vector<float> vx(npts, 0);
     vector<float> vy(npts, 0);
     double distchange = finaldist / startdist;
@@ -89,109 +284,75 @@ eavl2DGraphLayoutForceMutator::Execute()
         // cooling schedule determines current maxdist
         float maxdist = startdist * pow(distdelta, iter);
 
-        // init vels to 0
-        for (int i=0; i<npts; ++i)
-        {
-            vx[i] = 0;
-            vy[i] = 0;
-        }
-        
-#if 1
-        // repulsive force
+        GraphLayoutQuadtree *tree = NULL;
+        if (theta > 0)
+            tree = new GraphLayoutQuadtree(px, py, npts);
+
+#pragma omp parallel for schedule(dynamic,256)
         for (int i=0; i<npts; ++i)
         {
-            float ix = x->GetValue(i);
-            float iy = y->GetValue(i);
-            for (int j=i+1; j<npts; ++j)
+            float ix = px[i];
+            float iy = py[i];
+
+            // repulsive force
+            ///\todo: if dx==dy==0, assume some small random displacement
+            float frx = 0, fry = 0;
+            if (tree)
             {
-                float dx = ix - x->GetValue(j);
-                float dy = iy - y->GetValue(j);
-                ///\todo: if dx==dy==0, assume some small random displacement
+                tree->Force(i, theta, frx, fry);
+            }
+            else
+            {
+                for (int j=0; j<npts; ++j)
+                {
+                    if (j == i)
+                        continue;
+                    float dx = ix - px[j];
+                    float dy = iy - py[j];
+                    // i.e. the unit direction times k*k/len
+                    float len2 = dx*dx + dy*dy;
+                    frx += dx / len2;
+                    fry += dy / len2;
+                }
+            }
+            float fx = frx * k2;
+            float fy = fry * k2;
 
-                /*
+            // attractive force, the unit direction times len*len/k
+            for (int n=nbrstart[i]; n<nbrstart[i+1]; ++n)
+            {
+                int j = nbrs[n];
+                float dx = ix - px[j];
+                float dy = iy - py[j];
                 float len = sqrt(dx*dx + dy*dy);
-                float udx = dx/len;
-                float udy = dy/len;
-
-                float frx = udx * (k*k / len);
-                float fry = udy * (k*k / len);
-                */
-                // same equation, just more efficient via simplification
-                float len2 = dx*dx + dy*dy;
-                float frx = dx * k2 / len2;
-                float fry = dy * k2 / len2;
-
-                vx[i] += frx;
-                vy[i] += fry;
-
-                vx[j] -= frx;
-                vy[j] -= fry;
+                fx -= dx * len / k;
+                fy -= dy * len / k;
             }
-        }
-#endif
 
-        // attractive force
-        for (int c=0; c<cs->GetNumCells(); ++c)
-        {
-            eavlCell cell = cs->GetCellNodes(c);
-            if (cell.numIndices != 2)
-                continue;
-            int i = cell.indices[0];
-            int j = cell.indices[1];
+            // attract to center to keep trees from escaping forest;
+            // this is the unit direction times gravity*len/k
+            fx -= gravityconstant * ix / k;
+            fy -= gravityconstant * iy / k;
 
-            float dx = x->GetValue(i) - x->GetValue(j);
-            float dy = y->GetValue(i) - y->GetValue(j);
-            ///\todo: if dx==dy==0, assume some small random displacement
-            float len = sqrt(dx*dx + dy*dy);
-            float udx = dx/len;
-            float udy = dy/len;
-
-            float fax = udx * (len*len / k);
-            float fay = udy * (len*len / k);
-            vx[i] -= fax;
-            vy[i] -= fay;
-
-            vx[j] += fax;
-            vy[j] += fay;
-           
-        }
-
-#if 1
-        // attract to center to keep trees from escaping forest
-        for (int i=0; i<npts; ++i)
-        {
-            float dx = x->GetValue(i);
-            float dy = y->GetValue(i);
-            if (dx == 0 && dy == 0)
-                continue;
-
-            float len = sqrt(dx*dx + dy*dy);
-            float udx = dx/len;
-            float udy = dy/len;
-
-            float fcx = gravityconstant * udx * len / k;
-            float fcy = gravityconstant * udy * len / k;
-            vx[i] -= fcx;
-            vy[i] -= fcy;
-        }
-#endif
-
-        // clamp any distance to current maxdist (defined by cooling schedule)
-        for (int i=0; i<npts; ++i)
-        {
-            float len = sqrt(vx[i]*vx[i] + vy[i]*vy[i]);
+            // clamp any distance to current maxdist (defined by cooling
+            // schedule)
+            float len = sqrt(fx*fx + fy*fy);
             if (len > maxdist)
             {
-                vx[i] = maxdist * vx[i] / len;
-                vy[i] = maxdist * vy[i] / len;
+                fx = maxdist * fx / len;
+                fy = maxdist * fy / len;
             }
+            vx[i] = fx;
+            vy[i] = fy;
         }
+        delete tree;
 
         // update point locations
+#pragma omp parallel for
         for (int i=0; i<npts; ++i)
         {
-            x->SetValue(i, x->GetValue(i) + vx[i]);
-            y->SetValue(i, y->GetValue(i) + vy[i]);
+            px[i] += vx[i];
+            py[i] += vy[i];
         }
     }
 }
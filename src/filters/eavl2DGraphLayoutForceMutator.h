@@ -31,10 +31,23 @@
 ///
 ///  This version of the algorithm is only 2D, and overwrites or
 ///  adds a 2D Cartesian coordinate system.
+///
+///  The repulsive forces are approximated Barnes-Hut style: the
+///  vertices are put in a quadtree each iteration, and a quadtree cell
+///  which is small enough compared to its distance from a vertex (its
+///  width over the distance is below the opening angle) pushes on that
+///  vertex as one body at its center of mass.  An opening angle of 0
+///  computes every pair exactly.  The forces on each vertex are summed
+///  in parallel.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    May 28, 2013
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Approximate the repulsive forces with a quadtree, and compute the
+//   forces on the vertices in parallel.
+//
 // ****************************************************************************
 class eavl2DGraphLayoutForceMutator : public eavlMutator
 {
@@ -45,6 +58,7 @@ class eavl2DGraphLayoutForceMutator : public eavlMutator
     double finaldist;
     double areaconstant;
     double gravityconstant;
+    double openingangle;
   public:
     eavl2DGraphLayoutForceMutator();
     void SetCellSet(const string &name)
@@ -71,6 +85,13 @@ class eavl2DGraphLayoutForceMutator : public eavlMutator
     {
         gravityconstant = g;
     }
+    /// The Barnes-Hut opening angle; smaller is more accurate and
+    /// slower, and 0 computes the repulsive forces exactly.  (0.5 by
+    /// default.)
+    void SetOpeningAngle(double theta)
+    {
+        openingangle = theta;
+    }
 
     virtual void Execute();
 };
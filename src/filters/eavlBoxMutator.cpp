@@ -22,6 +22,8 @@ eavlBoxMutator::Execute()
     vector<int> newcells;
     int in_ncells = inCells->GetNumCells();
     eavlExplicitConnectivity conn;
+    vector<double> pts;
+    dataset->GetPoints(pts);
     for (int i=0; i<in_ncells; i++)
     {
         eavlCell cell = inCells->GetCellNodes(i);
@@ -30,7 +32,7 @@ eavlBoxMutator::Execute()
         {
             if (dim >= 1)
             {
-                double x = dataset->GetPoint(cell.indices[j], 0);
+                double x = pts[3*cell.indices[j]+0];
                 if (x < xmin || x > xmax)
                 {
                     match = false;
@@ -39,7 +41,7 @@ eavlBoxMutator::Execute()
             }
             if (dim >= 2)
             {
-                double y = dataset->GetPoint(cell.indices[j], 1);
+                double y = pts[3*cell.indices[j]+1];
                 if (y < ymin || y > ymax)
                 {
                     match = false;
@@ -48,7 +50,7 @@ eavlBoxMutator::Execute()
             }
             if (dim >= 3)
             {
-                double z = dataset->GetPoint(cell.indices[j], 2);
+                double z = pts[3*cell.indices[j]+2];
                 if (z < zmin || z > zmax)
                 {
                     match = false;
@@ -82,12 +84,8 @@ eavlBoxMutator::Execute()
             eavlFloatArray *a = new eavlFloatArray(
                                  string("subset_of_")+f->GetArray()->GetName(),
                                  numcomp, numnewcells);
-            for (unsigned int j=0; j < numnewcells; j++)
-            {
-                int e = newcells[j];
-                for (int k=0; k<numcomp; ++k)
-                    a->SetComponentFromDouble(j,k, f->GetArray()->GetComponentAsDouble(e,k));
-            }
+            if (numnewcells > 0)
+                eavlGatherTuples(f->GetArray(), &newcells[0], a);
 
             eavlField *newfield = new eavlField(f->GetOrder(), a,
                                                 eavlField::ASSOC_CELL_SET,
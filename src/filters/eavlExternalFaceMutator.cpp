@@ -34,12 +34,14 @@ eavlExternalFaceMutator::Execute()
         }
     }
 
-    int n_ext = 0;
+    // the cell each external face came from
+    vector<int> extCell;
     for (int i=0; i<nf; i++)
     {
         if (faceCount[i] == 1)
-            n_ext++;
+            extCell.push_back(faceCell[i]);
     }
+    int n_ext = extCell.size();
 
     
     ///\todo: UGH: I don't like this ugly logic here.
@@ -112,19 +114,8 @@ eavlExternalFaceMutator::Execute()
                 new eavlFloatArray(/*string("extface_of_") + */
                                    inArray->GetName(), nc);
             outArray->SetNumberOfTuples(n);
-            int outindex = 0;
-            for (int i=0; i<nf; i++)
-            {
-                if (faceCount[i] == 1)
-                {
-                    for (int c=0; c<nc; c++)
-                    {
-                        outArray->SetComponentFromDouble(outindex, c,
-                                inArray->GetComponentAsDouble(faceCell[i],c));
-                    }
-                    outindex++;
-                }
-            }
+            if (n > 0)
+                eavlGatherTuples(inArray, &extCell[0], outArray);
             eavlField *outField = new eavlField(0, outArray,
                                                 eavlField::ASSOC_CELL_SET,
                                                 outCells->GetName());            
@@ -3,6 +3,7 @@
 
 #include "eavlExecutor.h"
 #include "eavlCellSetExplicit.h"
+#include "eavlCellSetAllStructured.h"
 #include "eavlDestinationTopologyPackedMapOp.h"
 #include "eavlCombinedTopologyPackedMapOp.h"
 #include "eavlCoordinates.h"
@@ -19,8 +20,11 @@
 #include "eavlException.h"
 
 #include "eavlNewIsoTables.h"
+#include "eavlIsosurfaceIndex.h"
 #include "eavlTimer.h"
 
+#include <algorithm>
+
 class HiLoToCaseFunctor
 {
   public:
@@ -361,8 +365,635 @@ class Iso1DLookupPoints
 };
 
 
+// ****************************************************************************
+// Class:  IsoFlyingEdges
+//
+// Purpose:
+///   Isosurfaces a 3D structured grid without enumerating its edges.
+///   The grid's edges are taken as rows: a row of x-edges for each
+///   (j,k) row of nodes, and a row of y- or z-edges leaving each (j,k)
+///   row of nodes.  Rows are processed independently, in parallel:
+///    1) count the intersected edges in each edge row, and the
+///       triangles generated by each row of cells
+///    2) scan the counts to find where each row's output starts
+///    3) for each edge row, record the end nodes and interpolation
+///       weight of each intersected edge
+///    4) for each cell row, generate triangles; sweeping along the
+///       row while counting the intersected edges passed so far in
+///       the row's eight neighboring edge rows gives each cell edge's
+///       output point
+///   Only per-row counts and offsets are stored.  Rows of x-, then y-,
+///   then z-edges are in the order of the grid's global edge ids, so
+///   output points and triangles are numbered exactly as in the
+///   general algorithm.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class IsoFlyingEdges
+{
+  public:
+    int xn, yn, zn;
+    int xc, yc, zc;
+    float target;
+
+    // outputs
+    int noutpts;
+    int noutgeom;
+    eavlIntArray   *ptnode0;
+    eavlIntArray   *ptnode1;
+    eavlFloatArray *alpha;
+    eavlIntArray   *tricell;
+    eavlExplicitConnectivity *conn;
+
+    IsoFlyingEdges(eavlRegularStructure &reg, float tgt,
+                   eavlExplicitConnectivity *c)
+        : xn(reg.nodeDims[0]), yn(reg.nodeDims[1]), zn(reg.nodeDims[2]),
+          xc(reg.cellDims[0]), yc(reg.cellDims[1]), zc(reg.cellDims[2]),
+          target(tgt), noutpts(0), noutgeom(0),
+          ptnode0(NULL), ptnode1(NULL), alpha(NULL), tricell(NULL), conn(c)
+    {
+    }
+
+    // exclusive scan, returning the total
+    static int Scan(eavlIntArray *counts, eavlIntArray *starts,
+                    const char *name)
+    {
+        int n = counts->GetNumberOfTuples();
+        if (n == 0)
+            return 0;
+        eavlExecutor::RunOnCPU(new eavlPrefixSumOp_1(counts, starts, false),
+                               name);
+        return starts->GetValue(n-1) + counts->GetValue(n-1);
+    }
+
+    template <class V>
+    void operator()(const V &vals)
+    {
+        const int xyn = xn * yn;
+        const int nxrows = yn * zn;
+        const int nyrows = yc * zn;
+        const int nzrows = yn * zc;
+        const int nedgerows = nxrows + nyrows + nzrows;
+        const int ncellrows = yc * zc;
+        const byte *tricount = eavlVoxIsoTriCount->host;
+        const int  *tristart = eavlVoxIsoTriStart->host;
+        const byte *trigeom  = eavlVoxIsoTriGeom->host;
+
+        //
+        // count
+        //
+        int th_count = eavlTimer::Start();
+        eavlIntArray rowcounts("isorowcounts", 1, nedgerows);
+        eavlIntArray rowstarts("isorowstarts", 1, nedgerows);
+        eavlIntArray cellrowcounts("isocellrowcounts", 1, ncellrows);
+        eavlIntArray cellrowstarts("isocellrowstarts", 1, ncellrows);
+        int *rowcount = (int*)rowcounts.GetHostArray();
+        int *cellrowcount = (int*)cellrowcounts.GetHostArray();
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<nedgerows; r++)
+        {
+            int count = 0;
+            if (r < nxrows)
+            {
+                int base = r * xn;
+                bool h0 = float(vals[base]) < target;
+                for (int i=0; i<xc; i++)
+                {
+                    bool h1 = float(vals[base+i+1]) < target;
+                    count += (h0 != h1);
+                    h0 = h1;
+                }
+            }
+            else
+            {
+                int base, step;
+                if (r < nxrows + nyrows)
+                {
+                    int yr = r - nxrows;
+                    base = ((yr / yc) * yn + (yr % yc)) * xn;
+                    step = xn;
+                }
+                else
+                {
+                    base = (r - nxrows - nyrows) * xn;
+                    step = xyn;
+                }
+                for (int i=0; i<xn; i++)
+                    count += ((float(vals[base+i]) < target) !=
+                              (float(vals[base+step+i]) < target));
+            }
+            rowcount[r] = count;
+        }
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<ncellrows; r++)
+        {
+            int b00 = ((r / yc) * yn + (r % yc)) * xn;
+            int b10 = b00 + xn;
+            int b01 = b00 + xyn;
+            int b11 = b01 + xn;
+            int count = 0;
+            for (int i=0; i<xc; i++)
+            {
+                int caseindex =
+                    ((float(vals[b00+i  ]) < target) << 0) |
+                    ((float(vals[b00+i+1]) < target) << 1) |
+                    ((float(vals[b10+i  ]) < target) << 2) |
+                    ((float(vals[b10+i+1]) < target) << 3) |
+                    ((float(vals[b01+i  ]) < target) << 4) |
+                    ((float(vals[b01+i+1]) < target) << 5) |
+                    ((float(vals[b11+i  ]) < target) << 6) |
+                    ((float(vals[b11+i+1]) < target) << 7);
+                count += tricount[caseindex];
+            }
+            cellrowcount[r] = count;
+        }
+        eavlTimer::Stop(th_count, "flying edges: count edge and cell rows");
+
+        //
+        // scan
+        //
+        noutpts = Scan(&rowcounts, &rowstarts, "scan iso edge row counts");
+        noutgeom = Scan(&cellrowcounts, &cellrowstarts, "scan iso cell row counts");
+        const int *rowstart = (const int*)rowstarts.GetConstHostArray();
+        const int *cellrowstart = (const int*)cellrowstarts.GetConstHostArray();
+
+        //
+        // generate points
+        //
+        int th_points = eavlTimer::Start();
+        ptnode0 = new eavlIntArray("ptnode0", 1, noutpts);
+        ptnode1 = new eavlIntArray("ptnode1", 1, noutpts);
+        alpha = new eavlFloatArray("alpha", 1, noutpts);
+        int *node0 = (int*)ptnode0->GetHostArray();
+        int *node1 = (int*)ptnode1->GetHostArray();
+        float *a = (float*)alpha->GetHostArray();
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<nedgerows; r++)
+        {
+            if (rowcount[r] == 0)
+                continue;
+            int p = rowstart[r];
+            int base, step, nedges;
+            if (r < nxrows)
+            {
+                base = r * xn;
+                step = 1;
+                nedges = xc;
+            }
+            else if (r < nxrows + nyrows)
+            {
+                int yr = r - nxrows;
+                base = ((yr / yc) * yn + (yr % yc)) * xn;
+                step = xn;
+                nedges = xn;
+            }
+            else
+            {
+                base = (r - nxrows - nyrows) * xn;
+                step = xyn;
+                nedges = xn;
+            }
+            for (int i=0; i<nedges; i++)
+            {
+                float v0 = vals[base+i];
+                float v1 = vals[base+i+step];
+                if ((v0 < target) != (v1 < target))
+                {
+                    node0[p] = base+i;
+                    node1[p] = base+i+step;
+                    a[p] = (target - v0) / (v1 - v0);
+                    p++;
+                }
+            }
+        }
+        eavlTimer::Stop(th_points, "flying edges: generate points");
+
+        //
+        // generate triangles
+        //
+        int th_tris = eavlTimer::Start();
+        tricell = new eavlIntArray("tricell", 1, noutgeom);
+        int *cell = (int*)tricell->GetHostArray();
+        conn->shapetype.resize(noutgeom);
+        conn->connectivity.resize(4*noutgeom);
+        int *shapes = noutgeom ? &(conn->shapetype[0]) : NULL;
+        int *ids = noutgeom ? &(conn->connectivity[0]) : NULL;
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<ncellrows; r++)
+        {
+            if (cellrowcount[r] == 0)
+                continue;
+            int j = r % yc;
+            int k = r / yc;
+            int b00 = (k * yn + j) * xn;
+            int b10 = b00 + xn;
+            int b01 = b00 + xyn;
+            int b11 = b01 + xn;
+
+            // the next output point in each neighboring edge row
+            int px0 = rowstart[k*yn + j];
+            int px1 = rowstart[k*yn + j+1];
+            int px2 = rowstart[(k+1)*yn + j];
+            int px3 = rowstart[(k+1)*yn + j+1];
+            int py0 = rowstart[nxrows + k*yc + j];
+            int py1 = rowstart[nxrows + (k+1)*yc + j];
+            int pz0 = rowstart[nxrows + nyrows + k*yn + j];
+            int pz1 = rowstart[nxrows + nyrows + k*yn + j+1];
+
+            int t = cellrowstart[r];
+            for (int i=0; i<xc; i++)
+            {
+                int h0 = float(vals[b00+i  ]) < target;
+                int h1 = float(vals[b00+i+1]) < target;
+                int h2 = float(vals[b10+i  ]) < target;
+                int h3 = float(vals[b10+i+1]) < target;
+                int h4 = float(vals[b01+i  ]) < target;
+                int h5 = float(vals[b01+i+1]) < target;
+                int h6 = float(vals[b11+i  ]) < target;
+                int h7 = float(vals[b11+i+1]) < target;
+                int caseindex = h0 | (h1<<1) | (h2<<2) | (h3<<3) |
+                                (h4<<4) | (h5<<5) | (h6<<6) | (h7<<7);
+                int y0 = (h0 != h2), y1 = (h4 != h6);
+                int z0 = (h0 != h4), z1 = (h2 != h6);
+
+                int ntris = tricount[caseindex];
+                if (ntris > 0)
+                {
+                    // output point of each local voxel edge, in the
+                    // order of eavlRegularStructure::GetCellEdges
+                    int edgept[12] = {px0, py0 + y0, px1, py0,
+                                      px2, py1 + y1, px3, py1,
+                                      pz0, pz0 + z0, pz1, pz1 + z1};
+                    const byte *geom = trigeom + tristart[caseindex];
+                    int cellindex = (k * yc + j) * xc + i;
+                    for (int s=0; s<ntris; s++, t++, geom+=3)
+                    {
+                        shapes[t] = EAVL_TRI;
+                        ids[4*t+0] = 3;
+                        ids[4*t+1] = edgept[geom[0]];
+                        ids[4*t+2] = edgept[geom[1]];
+                        ids[4*t+3] = edgept[geom[2]];
+                        cell[t] = cellindex;
+                    }
+                }
+
+                px0 += (h0 != h1);
+                px1 += (h2 != h3);
+                px2 += (h4 != h5);
+                px3 += (h6 != h7);
+                py0 += y0;
+                py1 += y1;
+                pz0 += z0;
+                pz1 += z1;
+            }
+        }
+        eavlTimer::Stop(th_tris, "flying edges: generate triangles");
+    }
+};
+
+// the triangle table of a 3D cell shape; false for other shapes
+static inline bool IsoTriTables(int shape, const byte *&count,
+                                const int *&start, const byte *&geom)
+{
+    switch (shape)
+    {
+      case EAVL_TET:
+        count = eavlTetIsoTriCount->host;
+        start = eavlTetIsoTriStart->host;
+        geom  = eavlTetIsoTriGeom->host;
+        return true;
+      case EAVL_PYRAMID:
+        count = eavlPyrIsoTriCount->host;
+        start = eavlPyrIsoTriStart->host;
+        geom  = eavlPyrIsoTriGeom->host;
+        return true;
+      case EAVL_WEDGE:
+        count = eavlWdgIsoTriCount->host;
+        start = eavlWdgIsoTriStart->host;
+        geom  = eavlWdgIsoTriGeom->host;
+        return true;
+      case EAVL_HEX:
+        count = eavlHexIsoTriCount->host;
+        start = eavlHexIsoTriStart->host;
+        geom  = eavlHexIsoTriGeom->host;
+        return true;
+      case EAVL_VOXEL:
+        count = eavlVoxIsoTriCount->host;
+        start = eavlVoxIsoTriStart->host;
+        geom  = eavlVoxIsoTriGeom->host;
+        return true;
+    }
+    return false;
+}
+
+// ****************************************************************************
+// Class:  IsoCellRanges
+//
+// Purpose:
+///   Isosurfaces the cells in a list of ranges of cell ids, at one or
+///   more isovalues, on the host.  Each range's triangles are counted,
+///   the counts are scanned, and each range then writes its triangles
+///   at its offset.  The cells' node values are read once, and every
+///   isovalue is classified from them, so all the levels come from
+///   one pass over the input.  Triangles are in cell order, and then
+///   level order within a cell.
+///
+///   The output points are the distinct (level, global edge) pairs of
+///   the triangles, in order.  With one isovalue, since every
+///   intersected edge is an edge of some triangle, this numbers the
+///   output exactly as the general algorithm does.  All the work is in
+///   proportion to the number of cells in the ranges.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class IsoCellRanges
+{
+  public:
+    eavlCellSet *cells;
+    const vector<int> &first;
+    const vector<int> &end;
+    const vector<float> &targets;
+
+    // outputs
+    int noutpts;
+    int noutgeom;
+    eavlIntArray   *ptnode0;
+    eavlIntArray   *ptnode1;
+    eavlFloatArray *alpha;
+    eavlIntArray   *tricell;
+    eavlIntArray   *trilevel;
+    eavlExplicitConnectivity *conn;
+
+    IsoCellRanges(eavlCellSet *c, const vector<int> &f, const vector<int> &e,
+                  const vector<float> &tgts, eavlExplicitConnectivity *cn)
+        : cells(c), first(f), end(e), targets(tgts),
+          noutpts(0), noutgeom(0),
+          ptnode0(NULL), ptnode1(NULL), alpha(NULL),
+          tricell(NULL), trilevel(NULL), conn(cn)
+    {
+    }
+
+    static int CaseIndex(int n, const float *v, float target)
+    {
+        int caseindex = 0;
+        for (int i=n-1; i>=0; --i)
+            caseindex = 2*caseindex + (v[i] < target);
+        return caseindex;
+    }
+
+    template <class V>
+    void operator()(const V &vals)
+    {
+        int nranges = first.size();
+        int nlevels = targets.size();
+
+        // the lazily built edge connectivity must exist before the
+        // parallel loops look at it
+        long long nedges = cells->GetNumEdges();
+
+        //
+        // count
+        //
+        int th_count = eavlTimer::Start();
+        vector<int> rangestart(nranges+1, 0);
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<nranges; r++)
+        {
+            int count = 0;
+            for (int c=first[r]; c<end[r]; c++)
+            {
+                eavlCell cell = cells->GetCellNodes(c);
+                const byte *tricount;
+                const int *tristart;
+                const byte *trigeom;
+                if (!IsoTriTables(cell.type, tricount, tristart, trigeom))
+                    continue;
+                float v[12];
+                for (int n=0; n<cell.numIndices; n++)
+                    v[n] = vals[cell.indices[n]];
+                for (int l=0; l<nlevels; l++)
+                    count += tricount[CaseIndex(cell.numIndices, v, targets[l])];
+            }
+            rangestart[r] = count;
+        }
+        for (int r=0; r<nranges; r++)
+        {
+            int count = rangestart[r];
+            rangestart[r] = noutgeom;
+            noutgeom += count;
+        }
+        rangestart[nranges] = noutgeom;
+        eavlTimer::Stop(th_count, "host: count triangles");
+
+        //
+        // generate triangles as (level, global edge) keys
+        //
+        int th_tris = eavlTimer::Start();
+        vector<long long> trikeys(3*noutgeom);
+        tricell = new eavlIntArray("tricell", 1, noutgeom);
+        trilevel = new eavlIntArray("isolevel", 1, noutgeom);
+        int *cellids = (int*)tricell->GetHostArray();
+        int *levels = (int*)trilevel->GetHostArray();
+#pragma omp parallel for schedule(dynamic,16)
+        for (int r=0; r<nranges; r++)
+        {
+            if (rangestart[r] == rangestart[r+1])
+                continue;
+            int t = rangestart[r];
+            for (int c=first[r]; c<end[r]; c++)
+            {
+                eavlCell cell = cells->GetCellNodes(c);
+                const byte *tricount;
+                const int *tristart;
+                const byte *trigeom;
+                if (!IsoTriTables(cell.type, tricount, tristart, trigeom))
+                    continue;
+                float v[12];
+                for (int n=0; n<cell.numIndices; n++)
+                    v[n] = vals[cell.indices[n]];
+                bool haveedges = false;
+                eavlCell edges;
+                for (int l=0; l<nlevels; l++)
+                {
+                    int caseindex = CaseIndex(cell.numIndices, v, targets[l]);
+                    int ntris = tricount[caseindex];
+                    if (ntris == 0)
+                        continue;
+                    if (!haveedges)
+                    {
+                        edges = cells->GetCellEdges(c);
+                        haveedges = true;
+                    }
+                    long long base = l * nedges;
+                    const byte *geom = trigeom + tristart[caseindex];
+                    for (int s=0; s<ntris; s++, t++, geom+=3)
+                    {
+                        trikeys[3*t+0] = base + edges.indices[geom[0]];
+                        trikeys[3*t+1] = base + edges.indices[geom[1]];
+                        trikeys[3*t+2] = base + edges.indices[geom[2]];
+                        cellids[t] = c;
+                        levels[t] = l;
+                    }
+                }
+            }
+        }
+        eavlTimer::Stop(th_tris, "host: generate triangles");
+
+        //
+        // the distinct keys are the output points
+        //
+        int th_points = eavlTimer::Start();
+        vector<long long> ptkeys(trikeys);
+        std::sort(ptkeys.begin(), ptkeys.end());
+        ptkeys.erase(std::unique(ptkeys.begin(), ptkeys.end()),
+                     ptkeys.end());
+        noutpts = ptkeys.size();
+
+        ptnode0 = new eavlIntArray("ptnode0", 1, noutpts);
+        ptnode1 = new eavlIntArray("ptnode1", 1, noutpts);
+        alpha = new eavlFloatArray("alpha", 1, noutpts);
+        int *node0 = (int*)ptnode0->GetHostArray();
+        int *node1 = (int*)ptnode1->GetHostArray();
+        float *a = (float*)alpha->GetHostArray();
+#pragma omp parallel for
+        for (int p=0; p<noutpts; p++)
+        {
+            float target = targets[ptkeys[p] / nedges];
+            eavlCell edge = cells->GetEdgeNodes(ptkeys[p] % nedges);
+            float v0 = vals[edge.indices[0]];
+            float v1 = vals[edge.indices[1]];
+            node0[p] = edge.indices[0];
+            node1[p] = edge.indices[1];
+            a[p] = (target - v0) / (v1 - v0);
+        }
+
+        conn->shapetype.resize(noutgeom);
+        conn->connectivity.resize(4*noutgeom);
+        int *shapes = noutgeom ? &(conn->shapetype[0]) : NULL;
+        int *ids = noutgeom ? &(conn->connectivity[0]) : NULL;
+        const long long *sorted = noutpts ? &ptkeys[0] : NULL;
+#pragma omp parallel for
+        for (int t=0; t<noutgeom; t++)
+        {
+            shapes[t] = EAVL_TRI;
+            ids[4*t] = 3;
+            for (int k=0; k<3; k++)
+                ids[4*t+1+k] = std::lower_bound(sorted, sorted + noutpts,
+                                                trikeys[3*t+k]) - sorted;
+        }
+        eavlTimer::Stop(th_points, "host: generate points");
+    }
+};
+
+// interpolates a nodal array at the output points
+struct IsoInterpolateFunctor
+{
+    const int *node0;
+    const int *node1;
+    const float *alpha;
+    int n;
+    eavlArray *out;
+    IsoInterpolateFunctor(const int *n0, const int *n1, const float *a,
+                          int count, eavlArray *o)
+        : node0(n0), node1(n1), alpha(a), n(count), out(o)
+    {
+    }
+    template <class T>
+    void operator()(const eavlStridedView<const T> &in)
+    {
+        eavlStridedView<T> result =
+            dynamic_cast<eavlConcreteArray<T>*>(out)->GetViewWritable();
+#pragma omp parallel for
+        for (int p=0; p<n; p++)
+        {
+            float a = in[node0[p]];
+            float b = in[node1[p]];
+            result[p] = a + alpha[p]*(b-a);
+        }
+    }
+    void operator()(const eavlGenericView &in)
+    {
+        for (int p=0; p<n; p++)
+        {
+            double a = in[node0[p]];
+            double b = in[node1[p]];
+            out->SetComponentFromDouble(p, 0, a + alpha[p]*(b-a));
+        }
+    }
+};
+
+// interpolates a float coordinate axis at the output points
+static void IsoInterpolateAxis(eavlIndexable<eavlArray> axis,
+                               const int *node0, const int *node1,
+                               const float *alpha, int n,
+                               eavlFloatArray *out)
+{
+    const float *in = (const float*)axis.array->GetConstHostArray();
+    float *result = (float*)out->GetHostArray();
+#pragma omp parallel for
+    for (int p=0; p<n; p++)
+    {
+        float a = in[axis.indexer.index(node0[p])];
+        float b = in[axis.indexer.index(node1[p])];
+        result[p] = a + alpha[p]*(b-a);
+    }
+}
+
+static void AddIsoCoordinates(eavlDataSet *output, int spatialdim,
+                              eavlFloatArray *newx,
+                              eavlFloatArray *newy,
+                              eavlFloatArray *newz)
+{
+    if (spatialdim == 1)
+    {
+        eavlCoordinatesCartesian *newcoordsys = 
+            new eavlCoordinatesCartesian(NULL,
+                                         eavlCoordinatesCartesian::X);
+        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
+        output->AddCoordinateSystem(newcoordsys);
+        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
+    }
+    else if (spatialdim == 2)
+    {
+        eavlCoordinatesCartesian *newcoordsys = 
+            new eavlCoordinatesCartesian(NULL,
+                                         eavlCoordinatesCartesian::X,
+                                         eavlCoordinatesCartesian::Y);
+        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
+        newcoordsys->SetAxis(1, new eavlCoordinateAxisField("newy", 0));
+        output->AddCoordinateSystem(newcoordsys);
+        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
+        output->AddField(new eavlField(1, newy, eavlField::ASSOC_POINTS));
+    }
+    else if (spatialdim == 3)
+    {
+        eavlCoordinatesCartesian *newcoordsys = 
+            new eavlCoordinatesCartesian(NULL,
+                                         eavlCoordinatesCartesian::X,
+                                         eavlCoordinatesCartesian::Y,
+                                         eavlCoordinatesCartesian::Z);
+        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
+        newcoordsys->SetAxis(1, new eavlCoordinateAxisField("newy", 0));
+        newcoordsys->SetAxis(2, new eavlCoordinateAxisField("newz", 0));
+        output->AddCoordinateSystem(newcoordsys);
+        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
+        output->AddField(new eavlField(1, newy, eavlField::ASSOC_POINTS));
+        output->AddField(new eavlField(1, newz, eavlField::ASSOC_POINTS));
+    }
+}
+
+
 eavlIsosurfaceFilter::eavlIsosurfaceFilter()
 {
+    useFlyingEdges = true;
+    useIndex = false;
+    index = NULL;
     hiloArray = NULL;
     caseArray = NULL;
     numoutArray = NULL;
@@ -371,26 +1002,57 @@ eavlIsosurfaceFilter::eavlIsosurfaceFilter()
     edgeInclArray = NULL;
     outpointindexArray = NULL;
     totaloutpts = NULL;
+    plan = NULL;
+    planField = NULL;
+    planCells = NULL;
+    planCellsStamp = 0;
+    planDimension = planNumPoints = planNumCells = planNumEdges = 0;
+    planValue = 0;
 }
 
 eavlIsosurfaceFilter::~eavlIsosurfaceFilter()
 {
-    if (hiloArray)
-        delete hiloArray;
-    if (caseArray)
-        delete caseArray;
-    if (numoutArray)
-        delete numoutArray;
-    if (outindexArray)
-        delete outindexArray;
-    if (totalout)
-        delete totalout;
-    if (edgeInclArray)
-        delete edgeInclArray;
-    if (outpointindexArray)
-        delete outpointindexArray;
-    if (totaloutpts)
-        delete totaloutpts;
+    ClearPlan();
+    if (index)
+        delete index;
+}
+
+void
+eavlIsosurfaceFilter::SetInput(eavlDataSet *ds)
+{
+    // the plan's operations refer to the old input's cell set
+    if (ds != input)
+        ClearPlan();
+    eavlFilter::SetInput(ds);
+}
+
+void
+eavlIsosurfaceFilter::ClearPlan()
+{
+    // the plan's operations use the arrays, so they go first
+    delete plan;
+    plan = NULL;
+    delete planField;
+    planField = NULL;
+    planCells = NULL;
+    planCellsStamp = 0;
+
+    delete hiloArray;
+    hiloArray = NULL;
+    delete caseArray;
+    caseArray = NULL;
+    delete numoutArray;
+    numoutArray = NULL;
+    delete outindexArray;
+    outindexArray = NULL;
+    delete totalout;
+    totalout = NULL;
+    delete edgeInclArray;
+    edgeInclArray = NULL;
+    delete outpointindexArray;
+    outpointindexArray = NULL;
+    delete totaloutpts;
+    totaloutpts = NULL;
 }
 
 void
@@ -419,25 +1081,85 @@ eavlIsosurfaceFilter::Execute()
     eavlCoordinates *coordsys = input->GetCoordinateSystem(0);
     int spatialdim = coordsys->GetDimension();
 
+    eavlCellSetAllStructured *structCells =
+        dynamic_cast<eavlCellSetAllStructured*>(inCells);
+    bool hostcells = (dimension == 3 && HasFloatCoordinates(spatialdim) &&
+                      (structCells ||
+                       dynamic_cast<eavlCellSetExplicit*>(inCells)));
+#ifdef HAVE_CUDA
+    // the host algorithms are only preferred when running on the host
+    bool onhost = hostcells &&
+        (eavlExecutor::GetExecutionMode() == eavlExecutor::ForceCPU);
+#else
+    bool onhost = hostcells;
+#endif
+    if (!values.empty())
+    {
+        if (!hostcells)
+            THROW(eavlException,"Multiple isovalues are only supported for "
+                  "3D structured and explicit cell sets with float coordinates");
+        eavlTimer::Stop(th_init, "initialization");
+        vector<float> targets(values.begin(), values.end());
+        ExecuteOnCellRanges(inCells, inCellSetIndex, inField, spatialdim,
+                            targets, true);
+        eavlTimer::Dump(std::cout);
+        return;
+    }
+    if (onhost && useIndex)
+    {
+        eavlTimer::Stop(th_init, "initialization");
+        ExecuteOnCellRanges(inCells, inCellSetIndex, inField, spatialdim,
+                            vector<float>(1, float(value)), false);
+        eavlTimer::Dump(std::cout);
+        return;
+    }
+    if (onhost && useFlyingEdges && structCells)
+    {
+        eavlTimer::Stop(th_init, "initialization");
+        ExecuteFlyingEdges(structCells, inCellSetIndex, inField, spatialdim);
+        eavlTimer::Dump(std::cout);
+        return;
+    }
+
     //
-    // allocate internal storage arrays
+    // The steps up to counting the output only depend on the mesh, the
+    // field's type and the isovalue, so they're captured into a plan
+    // and kept, along with the scratch arrays they fill (which are sized
+    // for the mesh), for the next execution.  That one only has to point
+    // the plan's field array at the current field's values.
     //
-    if (!hiloArray)
+    eavlArray *inArray = inField->GetArray();
+    int nedges = inCells->GetNumEdges();
+    bool reuse = (plan &&
+                  planCells == inCells &&
+                  planCellsStamp == inCells->GetModificationStamp() &&
+                  planDimension == dimension &&
+                  planNumPoints == npts &&
+                  planNumCells == ncells &&
+                  planNumEdges == nedges &&
+                  planValue == value &&
+                  string(planField->GetBasicType()) == inArray->GetBasicType() &&
+                  planField->GetNumberOfComponents() ==
+                                          inArray->GetNumberOfComponents());
+    if (!reuse)
+    {
+        ClearPlan();
+
+        //
+        // allocate internal storage arrays
+        //
         hiloArray = new eavlByteArray("hilo", 1, npts);
-    if (!caseArray)
         caseArray = new eavlByteArray("isocase", 1, ncells);
-    if (!numoutArray)
         numoutArray = new eavlIntArray("numout", 1, ncells);
-    if (!outindexArray)
         outindexArray = new eavlIntArray("outindex", 1, ncells);
-    if (!totalout)
         totalout = new eavlIntArray("totalout", 1, 1);
-    if (!edgeInclArray)
-        edgeInclArray = new eavlIntArray("edgeIncl", 1, inCells->GetNumEdges());
-    if (!outpointindexArray)
-        outpointindexArray = new eavlIntArray("outpointindex", 1, inCells->GetNumEdges());
-    if (!totaloutpts)
+        edgeInclArray = new eavlIntArray("edgeIncl", 1, nedges);
+        outpointindexArray = new eavlIntArray("outpointindex", 1, nedges);
         totaloutpts = new eavlIntArray("totaloutpts", 1, 1);
+        planField = inArray->Create("isofield",
+                                    inArray->GetNumberOfComponents());
+    }
+    planField->ShareHostArray(inArray);
 
 
     //
@@ -447,111 +1169,124 @@ eavlIsosurfaceFilter::Execute()
     output->AddCellSet(outCellSet);
     eavlTimer::Stop(th_init, "initialization");
 
-    //
-    // do isosurface
-    //
-
-    // map scalars to above/below (hi/lo) booleans
-    eavlExecutor::AddOperation(
-        new_eavlMapOp(eavlOpArgs(inField->GetArray()),
-                      eavlOpArgs(hiloArray),
-                      eavlLessThanConstFunctor<float>(value)),
-        "generate hi/lo boolean");
-
-    // map the cell nodes' hi/lo as a bitfield, i.e. into a case index
-    eavlExecutor::AddOperation(
-        new_eavlSourceTopologyMapOp(inCells,
-                                    EAVL_NODES_OF_CELLS,
-                                    eavlOpArgs(hiloArray),
-                                    eavlOpArgs(caseArray),
-                                    HiLoToCaseFunctor()),
-        "generate case index per cell");
-
-    // look up case index in the table to get output counts
-    ///\todo: we need a "EAVL_CELLS" equivalent here; we don't care
-    /// what "from" topo type, just that we want the mapping for cells.
-    if (dimension == 3)
-    {
-        eavlExecutor::AddOperation(
-            new_eavlInfoTopologyMapOp(inCells,
-                                  EAVL_NODES_OF_CELLS,
-                                  eavlOpArgs(caseArray),
-                                  eavlOpArgs(numoutArray),
-                                  Iso3DLookupCounts(eavlTetIsoTriCount,
-                                                    eavlPyrIsoTriCount,
-                                                    eavlWdgIsoTriCount,
-                                                    eavlHexIsoTriCount,
-                                                    eavlVoxIsoTriCount)),
-        "look up output tris per cell case");
-    }
-    else if (dimension == 2)
+    if (!reuse)
     {
+        //
+        // do isosurface
+        //
+
+        // map scalars to above/below (hi/lo) booleans
         eavlExecutor::AddOperation(
-             new_eavlInfoTopologyMapOp(inCells,
-                                  EAVL_NODES_OF_CELLS,
-                                  eavlOpArgs(caseArray),
-                                  eavlOpArgs(numoutArray),
-                                  Iso2DLookupCounts(eavlTriIsoLineCount,
-                                                    eavlQuadIsoLineCount,
-                                                    eavlPixelIsoLineCount)),
-        "look up output lines per cell case");
-    }
-    else // (dimension == 1)
-    {
+            new_eavlMapOp(eavlOpArgs(planField),
+                          eavlOpArgs(hiloArray),
+                          eavlLessThanConstFunctor<float>(value)),
+            "generate hi/lo boolean");
+
+        // map the cell nodes' hi/lo as a bitfield, i.e. into a case index
         eavlExecutor::AddOperation(
-             new_eavlInfoTopologyMapOp(inCells,
-                                  EAVL_NODES_OF_CELLS,
-                                  eavlOpArgs(caseArray),
-                                  eavlOpArgs(numoutArray),
-                                  Iso1DLookupCounts()),
-        "look up output points per cell case");
-    }
+            new_eavlSourceTopologyMapOp(inCells,
+                                        EAVL_NODES_OF_CELLS,
+                                        eavlOpArgs(hiloArray),
+                                        eavlOpArgs(caseArray),
+                                        HiLoToCaseFunctor()),
+            "generate case index per cell");
+
+        // look up case index in the table to get output counts
+        ///\todo: we need a "EAVL_CELLS" equivalent here; we don't care
+        /// what "from" topo type, just that we want the mapping for cells.
+        if (dimension == 3)
+        {
+            eavlExecutor::AddOperation(
+                new_eavlInfoTopologyMapOp(inCells,
+                                      EAVL_NODES_OF_CELLS,
+                                      eavlOpArgs(caseArray),
+                                      eavlOpArgs(numoutArray),
+                                      Iso3DLookupCounts(eavlTetIsoTriCount,
+                                                        eavlPyrIsoTriCount,
+                                                        eavlWdgIsoTriCount,
+                                                        eavlHexIsoTriCount,
+                                                        eavlVoxIsoTriCount)),
+            "look up output tris per cell case");
+        }
+        else if (dimension == 2)
+        {
+            eavlExecutor::AddOperation(
+                 new_eavlInfoTopologyMapOp(inCells,
+                                      EAVL_NODES_OF_CELLS,
+                                      eavlOpArgs(caseArray),
+                                      eavlOpArgs(numoutArray),
+                                      Iso2DLookupCounts(eavlTriIsoLineCount,
+                                                        eavlQuadIsoLineCount,
+                                                        eavlPixelIsoLineCount)),
+            "look up output lines per cell case");
+        }
+        else // (dimension == 1)
+        {
+            eavlExecutor::AddOperation(
+                 new_eavlInfoTopologyMapOp(inCells,
+                                      EAVL_NODES_OF_CELLS,
+                                      eavlOpArgs(caseArray),
+                                      eavlOpArgs(numoutArray),
+                                      Iso1DLookupCounts()),
+            "look up output points per cell case");
+        }
 
-    // exclusive scan output counts to get output index
-    eavlExecutor::AddOperation(
-        new eavlPrefixSumOp_1(numoutArray,
-                              outindexArray,
-                              false),
-        "scan to generate starting out geom index");
+        // exclusive scan output counts to get output index
+        eavlExecutor::AddOperation(
+            new eavlPrefixSumOp_1(numoutArray,
+                                  outindexArray,
+                                  false),
+            "scan to generate starting out geom index");
 
 
-    // count overall geometry
-    eavlExecutor::AddOperation(
-        new eavlReduceOp_1<eavlAddFunctor<int> >
-            (numoutArray,
-             totalout,
-             eavlAddFunctor<int>()),
-        "sumreduce to count output geom");
+        // count overall geometry
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<int> >
+                (numoutArray,
+                 totalout,
+                 eavlAddFunctor<int>()),
+            "sumreduce to count output geom");
 
-    // figure out which edges we'll need in the end (not-equal hi-lo)
+        // figure out which edges we'll need in the end (not-equal hi-lo)
 
-    ///\todo: if this int array is changed to a byte array, the prefix sum a little later fails.
-    /// I would expect it to throw an error (array types don't match because we're putting
-    /// the scan result into an int array), but I'm just getting a segfault?
-    eavlExecutor::AddOperation(
-        new_eavlSourceTopologyMapOp(inCells,
-                              EAVL_NODES_OF_EDGES,
-                              eavlOpArgs(hiloArray),
-                              eavlOpArgs(edgeInclArray),
-                              FirstTwoItemsDifferFunctor()),
-        "flag edges that have differing hi/lo as they will generate pts in output");
-    //for (int i=0; i<inCells->GetNumEdges(); i++) {if (edgeInclArray->GetValue(i)) cerr << "USES EDGE: "<<i<<endl;}
-
-    // generate output-point-to-input-edge map
-    // exclusive scan output edge inclusion (i.e. count) to get output index
-    eavlExecutor::AddOperation(new eavlPrefixSumOp_1(edgeInclArray,
-                                                     outpointindexArray,
-                                                     false),
-                               "scan edge flags to find starting output point index for each input edge");
-    //for (int i=0; i<inCells->GetNumEdges(); i++) {if (edgeInclArray->GetValue(i)) cerr << "EDGE #: "<<i<<" is at index "<<outpointindexArray->GetValue(i)<<endl;}
-
-    // sum reduction to count edges
-    eavlExecutor::AddOperation(
-        new eavlReduceOp_1<eavlAddFunctor<int> >
-            (edgeInclArray,
-             totaloutpts,
-             eavlAddFunctor<int>()),
-        "sumreduce to count output pts (from edges)");
+        ///\todo: if this int array is changed to a byte array, the prefix sum a little later fails.
+        /// I would expect it to throw an error (array types don't match because we're putting
+        /// the scan result into an int array), but I'm just getting a segfault?
+        eavlExecutor::AddOperation(
+            new_eavlSourceTopologyMapOp(inCells,
+                                  EAVL_NODES_OF_EDGES,
+                                  eavlOpArgs(hiloArray),
+                                  eavlOpArgs(edgeInclArray),
+                                  FirstTwoItemsDifferFunctor()),
+            "flag edges that have differing hi/lo as they will generate pts in output");
+        //for (int i=0; i<inCells->GetNumEdges(); i++) {if (edgeInclArray->GetValue(i)) cerr << "USES EDGE: "<<i<<endl;}
+
+        // generate output-point-to-input-edge map
+        // exclusive scan output edge inclusion (i.e. count) to get output index
+        eavlExecutor::AddOperation(new eavlPrefixSumOp_1(edgeInclArray,
+                                                         outpointindexArray,
+                                                         false),
+                                   "scan edge flags to find starting output point index for each input edge");
+        //for (int i=0; i<inCells->GetNumEdges(); i++) {if (edgeInclArray->GetValue(i)) cerr << "EDGE #: "<<i<<" is at index "<<outpointindexArray->GetValue(i)<<endl;}
+
+        // sum reduction to count edges
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<int> >
+                (edgeInclArray,
+                 totaloutpts,
+                 eavlAddFunctor<int>()),
+            "sumreduce to count output pts (from edges)");
+
+        plan = new eavlPlan;
+        eavlExecutor::Capture(*plan);
+        planCells = inCells;
+        planCellsStamp = inCells->GetModificationStamp();
+        planDimension = dimension;
+        planNumPoints = npts;
+        planNumCells = ncells;
+        planNumEdges = nedges;
+        planValue = value;
+    }
 
     //
     // We can now execute the plan up to the point, and then
@@ -559,7 +1294,7 @@ eavlIsosurfaceFilter::Execute()
     // That lets us create some final arrays and resize them,
     // then execute the final stage.
     //
-    eavlExecutor::Go();
+    eavlExecutor::Go(*plan);
     int noutgeom = totalout->GetValue(0);
     int noutpts = totaloutpts->GetValue(0);
     //cerr << "TOTAL GEOMETRY = "<<noutgeom<<endl;
@@ -819,43 +1554,7 @@ eavlIsosurfaceFilter::Execute()
     // finalize output mesh
     //
     output->SetNumPoints(noutpts);
-
-    if (spatialdim == 1)
-    {
-        eavlCoordinatesCartesian *newcoordsys = 
-            new eavlCoordinatesCartesian(NULL,
-                                         eavlCoordinatesCartesian::X);
-        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
-        output->AddCoordinateSystem(newcoordsys);
-        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
-    }
-    else if (spatialdim == 2)
-    {
-        eavlCoordinatesCartesian *newcoordsys = 
-            new eavlCoordinatesCartesian(NULL,
-                                         eavlCoordinatesCartesian::X,
-                                         eavlCoordinatesCartesian::Y);
-        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
-        newcoordsys->SetAxis(1, new eavlCoordinateAxisField("newy", 0));
-        output->AddCoordinateSystem(newcoordsys);
-        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
-        output->AddField(new eavlField(1, newy, eavlField::ASSOC_POINTS));
-    }
-    else if (spatialdim == 3)
-    {
-        eavlCoordinatesCartesian *newcoordsys = 
-            new eavlCoordinatesCartesian(NULL,
-                                         eavlCoordinatesCartesian::X,
-                                         eavlCoordinatesCartesian::Y,
-                                         eavlCoordinatesCartesian::Z);
-        newcoordsys->SetAxis(0, new eavlCoordinateAxisField("newx", 0));
-        newcoordsys->SetAxis(1, new eavlCoordinateAxisField("newy", 0));
-        newcoordsys->SetAxis(2, new eavlCoordinateAxisField("newz", 0));
-        output->AddCoordinateSystem(newcoordsys);
-        output->AddField(new eavlField(1, newx, eavlField::ASSOC_POINTS));
-        output->AddField(new eavlField(1, newy, eavlField::ASSOC_POINTS));
-        output->AddField(new eavlField(1, newz, eavlField::ASSOC_POINTS));
-    }
+    AddIsoCoordinates(output, spatialdim, newx, newy, newz);
 
     //
     // Finish it!
@@ -954,3 +1653,178 @@ eavlIsosurfaceFilter::Execute()
     eavlTimer::Dump(std::cout);
     //eavlTimer::Resume();
 }
+
+bool
+eavlIsosurfaceFilter::HasFloatCoordinates(int spatialdim)
+{
+    for (int d=0; d<spatialdim; d++)
+    {
+        if (!dynamic_cast<eavlFloatArray*>(input->GetIndexableAxis(d).array))
+            return false;
+    }
+    return true;
+}
+
+void
+eavlIsosurfaceFilter::ExecuteFlyingEdges(eavlCellSetAllStructured *inCells,
+                                         int inCellSetIndex,
+                                         eavlField *inField, int spatialdim)
+{
+    eavlCellSetExplicit *outCellSet = new eavlCellSetExplicit("iso", 2);
+    output->AddCellSet(outCellSet);
+
+    eavlExplicitConnectivity conn;
+    IsoFlyingEdges fe(inCells->GetRegularStructure(), value, &conn);
+    eavlDispatchView(inField->GetArray(), fe, 0);
+
+    FinishHostOutput(outCellSet, inCellSetIndex, spatialdim, fe.noutpts,
+                     fe.ptnode0, fe.ptnode1, fe.alpha, fe.tricell, conn);
+}
+
+void
+eavlIsosurfaceFilter::ExecuteOnCellRanges(eavlCellSet *inCells,
+                                          int inCellSetIndex,
+                                          eavlField *inField, int spatialdim,
+                                          const vector<float> &targets,
+                                          bool addlevels)
+{
+    eavlCellSetExplicit *outCellSet = new eavlCellSetExplicit("iso", 2);
+    output->AddCellSet(outCellSet);
+
+    // with the index, only the bricks which can contain some isovalue;
+    // otherwise all the cells, split up for load balancing
+    int th_ranges = eavlTimer::Start();
+    vector<int> first, end;
+    if (useIndex)
+    {
+        if (!index)
+            index = new eavlIsosurfaceIndex;
+        index->Update(inCells, inField->GetArray());
+        vector<int> bricks, levelbricks;
+        for (size_t l=0; l<targets.size(); l++)
+        {
+            index->FindBricks(targets[l], levelbricks);
+            bricks.insert(bricks.end(), levelbricks.begin(), levelbricks.end());
+        }
+        std::sort(bricks.begin(), bricks.end());
+        bricks.erase(std::unique(bricks.begin(), bricks.end()), bricks.end());
+        for (size_t b=0; b<bricks.size(); b++)
+        {
+            first.push_back(index->GetBrickFirstCell(bricks[b]));
+            end.push_back(index->GetBrickEndCell(bricks[b]));
+        }
+    }
+    else
+    {
+        const int rangesize = 64;
+        int ncells = inCells->GetNumCells();
+        for (int c=0; c<ncells; c+=rangesize)
+        {
+            first.push_back(c);
+            end.push_back((c+rangesize < ncells) ? c+rangesize : ncells);
+        }
+    }
+    eavlTimer::Stop(th_ranges, "find candidate cells");
+
+    eavlExplicitConnectivity conn;
+    IsoCellRanges extract(inCells, first, end, targets, &conn);
+    eavlDispatchView(inField->GetArray(), extract, 0);
+
+    FinishHostOutput(outCellSet, inCellSetIndex, spatialdim, extract.noutpts,
+                     extract.ptnode0, extract.ptnode1, extract.alpha,
+                     extract.tricell, conn);
+    if (addlevels)
+        output->AddField(new eavlField(1, extract.trilevel,
+                                       eavlField::ASSOC_CELL_SET, "iso"));
+    else
+        delete extract.trilevel;
+}
+
+void
+eavlIsosurfaceFilter::FinishHostOutput(eavlCellSetExplicit *outCellSet,
+                                       int inCellSetIndex, int spatialdim,
+                                       int noutpts,
+                                       eavlIntArray *ptnode0,
+                                       eavlIntArray *ptnode1,
+                                       eavlFloatArray *alpha,
+                                       eavlIntArray *tricell,
+                                       eavlExplicitConnectivity &conn)
+{
+    int noutgeom = tricell->GetNumberOfTuples();
+    const int *node0 = (const int*)ptnode0->GetConstHostArray();
+    const int *node1 = (const int*)ptnode1->GetConstHostArray();
+    const float *weight = (const float*)alpha->GetConstHostArray();
+
+    // interpolate the point vars and gather the cell vars
+    eavlCoordinates *coordsys = input->GetCoordinateSystem(0);
+    for (int i=0; i<input->GetNumFields(); i++)
+    {
+        eavlField *f = input->GetField(i);
+        eavlArray *a = f->GetArray();
+
+        // we do the coordinate fields separately
+        if (coordsys->IsCoordinateAxisField(a->GetName()))
+            continue;
+
+        if (f->GetArray()->GetNumberOfComponents() != 1)
+        {
+            ///\todo: currently only handle point and cell scalar fields
+            continue;
+        }
+
+        if (f->GetAssociation() == eavlField::ASSOC_POINTS)
+        {
+            eavlArray *outArr = a->Create(a->GetName(), 1, noutpts);
+            IsoInterpolateFunctor interp(node0, node1, weight,
+                                         noutpts, outArr);
+            eavlDispatchView(a, interp, 0);
+            output->AddField(new eavlField(1, outArr, eavlField::ASSOC_POINTS));
+        }
+        else if (f->GetAssociation() == eavlField::ASSOC_CELL_SET &&
+                 f->GetAssocCellSet() == input->GetCellSet(inCellSetIndex)->GetName())
+        {
+            eavlArray *outArr = a->Create(a->GetName(), 1, noutgeom);
+            if (noutgeom > 0)
+            {
+                if (dynamic_cast<eavlByteArray*>(a))
+                {
+                    const int *cell = (const int*)tricell->GetConstHostArray();
+                    eavlByteArray *out = (eavlByteArray*)outArr;
+                    eavlByteArray *in = (eavlByteArray*)a;
+                    for (int t=0; t<noutgeom; t++)
+                        out->SetValue(t, in->GetValue(cell[t]));
+                }
+                else
+                {
+                    eavlExecutor::RunOnCPU(new_eavlGatherOp(eavlOpArgs(a),
+                                                            eavlOpArgs(outArr),
+                                                            eavlOpArgs(tricell)),
+                                           "gather cell field");
+                }
+            }
+            output->AddField(
+                new eavlField(1, outArr, eavlField::ASSOC_CELL_SET, "iso"));
+        }
+    }
+
+    // interpolate the coordinates
+    output->SetNumPoints(noutpts);
+    eavlFloatArray *newaxes[3] = {NULL, NULL, NULL};
+    const char *newaxisnames[3] = {"newx", "newy", "newz"};
+    for (int d=0; d<spatialdim && d<3; d++)
+    {
+        newaxes[d] = new eavlFloatArray(newaxisnames[d], 1, noutpts);
+        IsoInterpolateAxis(input->GetIndexableAxis(d, coordsys),
+                           node0, node1, weight, noutpts, newaxes[d]);
+    }
+    AddIsoCoordinates(output, spatialdim, newaxes[0], newaxes[1], newaxes[2]);
+
+    int th_create_revindex = eavlTimer::Start();
+    outCellSet->SetCellNodeConnectivity(conn);
+    eavlTimer::Stop(th_create_revindex, "create reverse index for connectivity");
+
+    delete ptnode0;
+    delete ptnode1;
+    delete alpha;
+    delete tricell;
+}
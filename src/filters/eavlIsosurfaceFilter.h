@@ -8,15 +8,54 @@
 #include "eavlFilter.h"
 #include "eavlArray.h"
 
+class eavlCellSetAllStructured;
+class eavlCellSetExplicit;
+class eavlIsosurfaceIndex;
+class eavlPlan;
+struct eavlExplicitConnectivity;
+
 // ****************************************************************************
 // Class:  eavlIsosurfaceFilter
 //
 // Purpose:
 ///  Generate a triangle-mesh isosurface from volumetric elements.
+///  3D structured grids are isosurfaced on the host with a flying
+///  edges algorithm, which needs no per-edge arrays; its output is
+///  identical to the general algorithm's.  When sweeping the isovalue
+///  over one field, an eavlIsosurfaceIndex can be kept between
+///  executions so that only the candidate cells are visited.
+///  Otherwise, the steps which count the output are captured into an
+///  eavlPlan with scratch arrays sized for the mesh, and kept for the
+///  next execution on the same input over the same, unmodified cell
+///  set, isovalue and type of field, as when isosurfacing each timestep
+///  of a time series whose field is updated in place.
 //
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern
 // Creation:    February 3, 2012
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Added the flying edges path for structured grids.
+//
+//   agent, October 17, 2026
+//   Added the indexed path, which visits only the cells an index of
+//   the field's value ranges finds for the isovalue.
+//
+//   agent, October 17, 2026
+//   Added SetIsoValues, to extract several levels in one pass.
+//
+//   agent, October 17, 2026
+//   Keep the plan for counting the output, and its scratch arrays, for
+//   the next execution, and size them for the current mesh when it
+//   changes.
+//
+//   agent, October 17, 2026
+//   Added GetIndex.
+//
+//   agent, October 17, 2026
+//   Reuse the plan only for the cell set's current modification stamp,
+//   and clear it when the input changes.
+//
 // ****************************************************************************
 class eavlIsosurfaceFilter : public eavlFilter
 {
@@ -24,6 +63,7 @@ class eavlIsosurfaceFilter : public eavlFilter
     string fieldname;
     string cellsetname;
     double value;
+    vector<double> values;
 
     eavlByteArray *hiloArray;
     eavlByteArray *caseArray;
@@ -34,9 +74,43 @@ class eavlIsosurfaceFilter : public eavlFilter
     eavlIntArray *outpointindexArray;
     eavlIntArray *totaloutpts;
 
+    eavlPlan *plan;
+    eavlArray *planField;   ///< the plan's input, sharing the field's values
+    eavlCellSet *planCells;
+    unsigned long planCellsStamp;
+    int planDimension;
+    int planNumPoints;
+    int planNumCells;
+    int planNumEdges;
+    double planValue;
+
+    bool useFlyingEdges;
+    bool useIndex;
+    eavlIsosurfaceIndex *index;
+
+    void ClearPlan();
+    bool HasFloatCoordinates(int spatialdim);
+    void ExecuteFlyingEdges(eavlCellSetAllStructured *inCells,
+                            int inCellSetIndex,
+                            eavlField *inField, int spatialdim);
+    void ExecuteOnCellRanges(eavlCellSet *inCells,
+                             int inCellSetIndex,
+                             eavlField *inField, int spatialdim,
+                             const vector<float> &targets,
+                             bool addlevels);
+    void FinishHostOutput(eavlCellSetExplicit *outCellSet,
+                          int inCellSetIndex, int spatialdim,
+                          int noutpts,
+                          eavlIntArray *ptnode0,
+                          eavlIntArray *ptnode1,
+                          eavlFloatArray *alpha,
+                          eavlIntArray *tricell,
+                          eavlExplicitConnectivity &conn);
+
   public:
     eavlIsosurfaceFilter();
     virtual ~eavlIsosurfaceFilter();
+    virtual void SetInput(eavlDataSet *ds);
     void SetField(const string &name)
     {
         fieldname = name;
@@ -48,6 +122,36 @@ class eavlIsosurfaceFilter : public eavlFilter
     void SetIsoValue(double val)
     {
         value = val;
+        values.clear();
+    }
+    /// Extract an isosurface at each of several values in one pass over
+    /// the input, for 3D structured and explicit cell sets.  The output
+    /// is one cell set, with an "isolevel" cell field giving the index
+    /// in vals of the isovalue each triangle came from.  Points are not
+    /// shared between levels.
+    void SetIsoValues(const vector<double> &vals)
+    {
+        values = vals;
+    }
+    /// Use the flying edges algorithm for 3D structured grids, when
+    /// running on the host.  (On by default.)
+    void SetUseFlyingEdges(bool fe)
+    {
+        useFlyingEdges = fe;
+    }
+    /// Visit only the candidate cells found by an index of the field's
+    /// value ranges, for 3D structured and explicit cell sets, when
+    /// running on the host.  The index is built by the first execution
+    /// and kept until the field or cell set changes, so this pays off
+    /// when sweeping the isovalue.  (Off by default.)
+    void SetUseIndex(bool ui)
+    {
+        useIndex = ui;
+    }
+    /// The index kept by indexed executions, or NULL before the first.
+    const eavlIsosurfaceIndex *GetIndex() const
+    {
+        return index;
     }
     
     virtual void Execute();
@@ -0,0 +1,232 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavlIsosurfaceIndex.h"
+#include "eavlException.h"
+
+#include <algorithm>
+
+// NaN values are never below an isovalue, so treat them as +infinity
+static inline float IndexValue(float v)
+{
+    return (v != v) ? HUGE_VAL : v;
+}
+
+// the range of the values over the nodes of each brick of cells
+struct IsoBrickRangeFunctor
+{
+    eavlCellSet *cells;
+    int ncells;
+    int bricksize;
+    float *brickmin;
+    float *brickmax;
+    IsoBrickRangeFunctor(eavlCellSet *c, int bs, float *bmin, float *bmax)
+        : cells(c), ncells(c->GetNumCells()), bricksize(bs),
+          brickmin(bmin), brickmax(bmax)
+    {
+    }
+    template <class V>
+    void operator()(const V &vals)
+    {
+        int nbricks = (ncells + bricksize - 1) / bricksize;
+#pragma omp parallel for schedule(dynamic,16)
+        for (int b=0; b<nbricks; b++)
+        {
+            float lo = +HUGE_VAL;
+            float hi = -HUGE_VAL;
+            int end = (b+1) * bricksize;
+            if (end > ncells)
+                end = ncells;
+            for (int c=b*bricksize; c<end; c++)
+            {
+                eavlCell cell = cells->GetCellNodes(c);
+                for (int n=0; n<cell.numIndices; n++)
+                {
+                    float v = IndexValue(vals[cell.indices[n]]);
+                    if (v < lo)
+                        lo = v;
+                    if (v > hi)
+                        hi = v;
+                }
+            }
+            brickmin[b] = lo;
+            brickmax[b] = hi;
+        }
+    }
+};
+
+struct IsoBrickMaxBelow
+{
+    const float *max;
+    float c;
+    IsoBrickMaxBelow(const float *m, float c_) : max(m), c(c_) { }
+    bool operator()(int id) const { return max[id] < c; }
+};
+
+struct IsoBrickMinNotAbove
+{
+    const float *min;
+    float c;
+    IsoBrickMinNotAbove(const float *m, float c_) : min(m), c(c_) { }
+    bool operator()(int id) const { return !(min[id] > c); }
+};
+
+struct IsoBrickLessMin
+{
+    const float *min;
+    IsoBrickLessMin(const float *m) : min(m) { }
+    bool operator()(int a, int b) const { return min[a] < min[b]; }
+};
+
+struct IsoBrickGreaterMax
+{
+    const float *max;
+    IsoBrickGreaterMax(const float *m) : max(m) { }
+    bool operator()(int a, int b) const { return max[a] > max[b]; }
+};
+
+eavlIsosurfaceIndex::eavlIsosurfaceIndex(int bs)
+    : cells(NULL), array(NULL), ncells(0), npoints(0), stamp(0), cellsStamp(0),
+      bricksize(bs),
+      nbuilds(0)
+{
+    if (bricksize < 1)
+        THROW(eavlException,"Isosurface index brick size must be positive");
+}
+
+void
+eavlIsosurfaceIndex::Clear()
+{
+    cells = NULL;
+    array = NULL;
+    ncells = 0;
+    npoints = 0;
+    stamp = 0;
+    cellsStamp = 0;
+    brickmin.clear();
+    brickmax.clear();
+    nodes.clear();
+    bymin.clear();
+    bymax.clear();
+}
+
+bool
+eavlIsosurfaceIndex::IsCurrent(eavlCellSet *c, eavlArray *a)
+{
+    return (c == cells && a == array &&
+            c->GetNumCells() == ncells &&
+            c->GetModificationStamp() == cellsStamp &&
+            a->GetNumberOfTuples() == npoints &&
+            a->GetModificationStamp() == stamp);
+}
+
+void
+eavlIsosurfaceIndex::Build(eavlCellSet *c, eavlArray *a)
+{
+    Clear();
+
+    int nbricks = (c->GetNumCells() + bricksize - 1) / bricksize;
+    brickmin.resize(nbricks);
+    brickmax.resize(nbricks);
+    if (nbricks > 0)
+    {
+        IsoBrickRangeFunctor range(c, bricksize, &brickmin[0], &brickmax[0]);
+        eavlDispatchView(a, range, 0);
+    }
+
+    // bricks with no values can never contain an isovalue
+    vector<int> ids;
+    ids.reserve(nbricks);
+    for (int b=0; b<nbricks; b++)
+    {
+        if (brickmin[b] <= brickmax[b])
+            ids.push_back(b);
+    }
+    bymin.reserve(ids.size());
+    bymax.reserve(ids.size());
+    BuildTree(ids, 0, ids.size());
+
+    cells = c;
+    array = a;
+    ncells = c->GetNumCells();
+    npoints = a->GetNumberOfTuples();
+    stamp = a->GetModificationStamp();
+    cellsStamp = c->GetModificationStamp();
+    nbuilds++;
+}
+
+int
+eavlIsosurfaceIndex::BuildTree(vector<int> &ids, int begin, int end)
+{
+    if (begin == end)
+        return -1;
+
+    // centering on the median brick minimum guarantees the node gets
+    // at least that brick, and each child at most half of them
+    const float *mins = &brickmin[0];
+    const float *maxs = &brickmax[0];
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid,
+                     ids.begin() + end, IsoBrickLessMin(mins));
+    float center = mins[ids[mid]];
+
+    // [begin,here) is entirely below the center, [here,right) contains
+    // it, and [right,end) is entirely above it
+    int here = std::partition(ids.begin() + begin, ids.begin() + end,
+                              IsoBrickMaxBelow(maxs, center)) - ids.begin();
+    int right = std::partition(ids.begin() + here, ids.begin() + end,
+                               IsoBrickMinNotAbove(mins, center)) - ids.begin();
+
+    Node node;
+    node.center = center;
+    node.begin = bymin.size();
+    node.end = node.begin + (right - here);
+    bymin.insert(bymin.end(), ids.begin() + here, ids.begin() + right);
+    bymax.insert(bymax.end(), ids.begin() + here, ids.begin() + right);
+    std::sort(bymin.begin() + node.begin, bymin.end(), IsoBrickLessMin(mins));
+    std::sort(bymax.begin() + node.begin, bymax.end(), IsoBrickGreaterMax(maxs));
+
+    int index = nodes.size();
+    nodes.push_back(node);
+    int left = BuildTree(ids, begin, here);
+    nodes[index].left = left;
+    int rightchild = BuildTree(ids, right, end);
+    nodes[index].right = rightchild;
+    return index;
+}
+
+void
+eavlIsosurfaceIndex::FindBricks(float value, vector<int> &bricks) const
+{
+    bricks.clear();
+    if (nodes.empty())
+        return;
+
+    // a brick contains the value if min < value <= max
+    int n = 0;
+    while (n >= 0)
+    {
+        const Node &node = nodes[n];
+        if (value <= node.center)
+        {
+            // every brick here has max >= center >= value
+            for (int i=node.begin; i<node.end; i++)
+            {
+                if (!(brickmin[bymin[i]] < value))
+                    break;
+                bricks.push_back(bymin[i]);
+            }
+            n = node.left;
+        }
+        else
+        {
+            // every brick here has min <= center < value
+            for (int i=node.begin; i<node.end; i++)
+            {
+                if (!(brickmax[bymax[i]] >= value))
+                    break;
+                bricks.push_back(bymax[i]);
+            }
+            n = node.right;
+        }
+    }
+    std::sort(bricks.begin(), bricks.end());
+}
@@ -0,0 +1,97 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_ISOSURFACE_INDEX_H
+#define EAVL_ISOSURFACE_INDEX_H
+
+#include "STL.h"
+#include "eavlArray.h"
+#include "eavlCellSet.h"
+
+// ****************************************************************************
+// Class:  eavlIsosurfaceIndex
+//
+// Purpose:
+///   An index of which cells of a cell set a nodal field's isosurfaces
+///   can pass through.  The cells are grouped into bricks of
+///   consecutive cell ids (rows of cells, on a structured grid), and
+///   the range of field values over each brick's nodes is put in an
+///   interval tree.  Finding the bricks containing an isovalue then
+///   costs time in proportion to the number found, not the number of
+///   cells.
+///
+///   A brick is found for an isovalue if some node of it is below the
+///   isovalue and another is not, matching the hi/lo test the
+///   isosurface filter uses.  (NaN values are never below, so they
+///   count as +infinity here.)
+///
+///   The index remembers which cell set and field array it was built
+///   from, and their modification stamps, so it can tell when the
+///   cells or the field have changed and it needs to be rebuilt.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+//   agent, October 17, 2026
+//   Count the builds, so callers can tell whether Update rebuilt it.
+//
+//   agent, October 17, 2026
+//   Also check the cell set's modification stamp.
+//
+// ****************************************************************************
+class eavlIsosurfaceIndex
+{
+  protected:
+    struct Node
+    {
+        float center;
+        int   left, right;  ///< child nodes, or -1
+        int   begin, end;   ///< this node's bricks in bymin and bymax
+    };
+
+    eavlCellSet   *cells;
+    eavlArray     *array;
+    int            ncells;
+    int            npoints;
+    unsigned long  stamp;
+    unsigned long  cellsStamp;
+    int            bricksize;
+    int            nbuilds;
+
+    vector<float>  brickmin;
+    vector<float>  brickmax;
+    vector<Node>   nodes;
+    vector<int>    bymin; ///< brick ids, by increasing min within a node
+    vector<int>    bymax; ///< brick ids, by decreasing max within a node
+
+    int  BuildTree(vector<int> &ids, int begin, int end);
+  public:
+    eavlIsosurfaceIndex(int bricksize = 64);
+
+    /// True if the index was built from this cell set and (the first
+    /// component of) this array, and neither has changed since.
+    bool IsCurrent(eavlCellSet *cells, eavlArray *array);
+    void Build(eavlCellSet *cells, eavlArray *array);
+    /// Builds the index, unless it's already current.
+    void Update(eavlCellSet *cells, eavlArray *array)
+    {
+        if (!IsCurrent(cells, array))
+            Build(cells, array);
+    }
+    void Clear();
+
+    /// The number of times the index has been built.
+    int  GetNumBuilds() const { return nbuilds; }
+    int  GetBrickSize() const { return bricksize; }
+    int  GetNumBricks() const { return brickmin.size(); }
+    int  GetBrickFirstCell(int b) const { return b * bricksize; }
+    int  GetBrickEndCell(int b) const
+    {
+        int end = (b+1) * bricksize;
+        return (end < ncells) ? end : ncells;
+    }
+    /// Fills bricks with the ids, in increasing order, of the bricks
+    /// which may contain the given isovalue.
+    void FindBricks(float value, vector<int> &bricks) const;
+};
+
+#endif
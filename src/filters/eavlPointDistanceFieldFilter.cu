@@ -9,6 +9,142 @@
 #include "eavlCoordinates.h"
 #include <algorithm>
 
+// k-d tree nodes with at most this many points aren't split
+#define DISTANCE_KDTREE_LEAF_SIZE 8
+
+// ****************************************************************************
+// Class:  DistanceKdTree
+//
+// Purpose:
+///   A k-d tree over a set of points (in 1, 2 or 3 dimensions, stored
+///   as x,y,z triples), for finding the distance from a location to the
+///   nearest of them.  Each node splits its points at the median along
+///   the axis of their widest extent, and each node's points are a
+///   contiguous range of the order array.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+class DistanceKdTree
+{
+  protected:
+    struct Node
+    {
+        int    begin, end;   ///< its points in order
+        int    axis;
+        double split;
+        int    left, right;  ///< or -1 for a leaf
+    };
+
+    struct LessOnAxis
+    {
+        const double *pts;
+        int axis;
+        LessOnAxis(const double *p, int a) : pts(p), axis(a) { }
+        bool operator()(int a, int b) const
+        {
+            return pts[3*a+axis] < pts[3*b+axis];
+        }
+    };
+
+    int           dim;
+    const double *pts;
+    vector<int>   order;
+    vector<Node>  nodes;
+
+    int Build(int begin, int end)
+    {
+        Node node;
+        node.begin = begin;
+        node.end = end;
+        node.axis = 0;
+        node.split = 0;
+        node.left = node.right = -1;
+        int index = nodes.size();
+        nodes.push_back(node);
+        if (end - begin <= DISTANCE_KDTREE_LEAF_SIZE)
+            return index;
+
+        double lo[3], hi[3];
+        for (int a=0; a<dim; a++)
+            lo[a] = hi[a] = pts[3*order[begin]+a];
+        for (int i=begin+1; i<end; i++)
+        {
+            for (int a=0; a<dim; a++)
+            {
+                lo[a] = std::min(lo[a], pts[3*order[i]+a]);
+                hi[a] = std::max(hi[a], pts[3*order[i]+a]);
+            }
+        }
+        int axis = 0;
+        for (int a=1; a<dim; a++)
+        {
+            if (hi[a] - lo[a] > hi[axis] - lo[axis])
+                axis = a;
+        }
+
+        int mid = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid,
+                         order.begin() + end, LessOnAxis(pts, axis));
+        nodes[index].axis = axis;
+        nodes[index].split = pts[3*order[mid]+axis];
+        int left = Build(begin, mid);
+        nodes[index].left = left;
+        int right = Build(mid, end);
+        nodes[index].right = right;
+        return index;
+    }
+
+    void Search(int n, const double *q, double &best2) const
+    {
+        const Node &node = nodes[n];
+        if (node.left < 0)
+        {
+            for (int i=node.begin; i<node.end; i++)
+            {
+                const double *p = &pts[3*order[i]];
+                double dx = p[0] - q[0];
+                double dy = p[1] - q[1];
+                double dz = p[2] - q[2];
+                double d2 = dx*dx + dy*dy + dz*dz;
+                if (best2 < 0 || d2 < best2)
+                    best2 = d2;
+            }
+            return;
+        }
+
+        // the points left of the split are at or below it, and the ones
+        // right of it are at or above it
+        double d = q[node.axis] - node.split;
+        int nearer = (d < 0) ? node.left : node.right;
+        int farther = (d < 0) ? node.right : node.left;
+        Search(nearer, q, best2);
+        if (best2 < 0 || d*d < best2)
+            Search(farther, q, best2);
+    }
+  public:
+    DistanceKdTree(int d, const double *p, int n) : dim(d), pts(p)
+    {
+        order.resize(n);
+        for (int i=0; i<n; i++)
+            order[i] = i;
+        if (n > 0)
+            Build(0, n);
+    }
+    /// The distance from q to the nearest point, or -1 if there are
+    /// none.
+    double Nearest(const double *q) const
+    {
+        if (nodes.empty())
+            return -1;
+        double best2 = -1;
+        Search(0, q, best2);
+        return sqrt(best2);
+    }
+};
+
 eavlPointDistanceFieldFilter::eavlPointDistanceFieldFilter()
 {
     exact = false;
@@ -152,45 +288,44 @@ void eavlPointDistanceFieldFilter::Execute()
     for (int i=0; i<npts; ++i)
         cp->SetValue(i, -1);
 
+    // the input points, with the coordinates past our dimension 0
+    int ninput = input->GetNumPoints();
+    vector<double> points;
+    input->GetPoints(points);
+    for (int p=0; p<ninput; ++p)
+    {
+        for (int c=dim; c<3; ++c)
+            points[3*p+c] = 0.;
+    }
+
+    float *distvals = (float*)dist->GetHostArray();
+    int *cpvals = (int*)cp->GetHostArray();
+    const float *xvals = (const float*)x->GetConstHostArray();
+    const float *yvals = y ? (const float*)y->GetConstHostArray() : NULL;
+    const float *zvals = z ? (const float*)z->GetConstHostArray() : NULL;
+
     if (exact)
     {
         //
-        // We were asked to create the "exact" results.
-        // This is a naive, slow, O(n*m) algorithm.
-        // (where n = num input points and m = num output mesh nodes)
+        // We were asked to create the "exact" results.  The input
+        // points go in a k-d tree, and each output mesh node finds its
+        // nearest point in roughly O(log n) time, in parallel.
+        // (where n = num input points)
         //
-        for (int k=0; k<nk; ++k)
+        DistanceKdTree tree(dim, ninput ? &points[0] : NULL, ninput);
+#pragma omp parallel for schedule(dynamic,1)
+        for (int row=0; row<nj*nk; ++row)
         {
-            for (int j=0; j<nj; ++j)
+            int j = row % nj;
+            int k = row / nj;
+            for (int i=0; i<ni; ++i)
             {
-                for (int i=0; i<ni; ++i)
-                {
-                    const int myindex = i + j*ni + k*ni*nj;
-                    const float myx = x->GetValue(i);
-                    const float myy = y ? y->GetValue(j) : 0;
-                    const float myz = z ? z->GetValue(k) : 0;
-                    float old_dist = dist->GetValue(myindex);
-                    for (int p=0; p<input->GetNumPoints(); ++p)
-                    {
-                        double px=0,py=0,pz=0;
-                        px = input->GetPoint(p, 0);
-                        if (dim>=2)
-                            py = input->GetPoint(p, 1);
-                        if (dim>=3)
-                            pz = input->GetPoint(p, 2);
-
-                        double dx = px - myx;
-                        double dy = py - myy;
-                        double dz = pz - myz;
-                        double new_dist = sqrt(dx*dx + dy*dy + dz*dz);
-
-                        if (old_dist < 0 || new_dist < old_dist)
-                        {
-                            dist->SetValue(myindex, new_dist);
-                            old_dist = new_dist;
-                        }
-                    }
-                }
+                const int myindex = i + j*ni + k*ni*nj;
+                double q[3];
+                q[0] = xvals[i];
+                q[1] = yvals ? yvals[j] : 0;
+                q[2] = zvals ? zvals[k] : 0;
+                distvals[myindex] = tree.Nearest(q);
             }
         }
     }
@@ -214,14 +349,11 @@ void eavlPointDistanceFieldFilter::Execute()
         // Step through input points tag neighboring mesh points with
         // their location and starting distance
         //
-        for (int p=0; p<input->GetNumPoints(); ++p)
+        for (int p=0; p<ninput; ++p)
         {
-            double px=0,py=0,pz=0;
-            px = input->GetPoint(p, 0);
-            if (dim>=2)
-                py = input->GetPoint(p, 1);
-            if (dim>=3)
-                pz = input->GetPoint(p, 2);
+            double px = points[3*p+0];
+            double py = points[3*p+1];
+            double pz = points[3*p+2];
 
             double ix = double(ni) * (px - xmin) / double(xmax - xmin);
             double iy = double(nj) * (py - ymin) / double(ymax - ymin);
@@ -239,20 +371,20 @@ void eavlPointDistanceFieldFilter::Execute()
                         int cx = (ix<=0) ? 0 : (ix >= ni-1) ? ni-1 : iix;
                         int cy = (iy<=0) ? 0 : (iy >= nj-1) ? nj-1 : iiy;
                         int cz = (iz<=0) ? 0 : (iz >= nk-1) ? nk-1 : iiz;
-                        double xx = x->GetValue(cx);
-                        double yy = y ? y->GetValue(cy) : 0;
-                        double zz = z ? z->GetValue(cz) : 0;
+                        double xx = xvals[cx];
+                        double yy = yvals ? yvals[cy] : 0;
+                        double zz = zvals ? zvals[cz] : 0;
                         double dx = px-xx;
                         double dy = py-yy;
                         double dz = pz-zz;
                         double new_dist = sqrt(dx*dx + dy*dy + dz*dz);
                         int index = cx + cy*ni + cz*ni*nj;
-                        float old_dist = dist->GetValue(index);
+                        float old_dist = distvals[index];
 
                         if (old_dist < 0 || new_dist < old_dist)
                         {
-                            cp->SetValue(index, p);
-                            dist->SetValue(index, new_dist);
+                            cpvals[index] = p;
+                            distvals[index] = new_dist;
                         }
                     }
                 }
@@ -273,65 +405,59 @@ void eavlPointDistanceFieldFilter::Execute()
         // expanding the exact answer one more grid cell away from the 
         // source points.
         //
+        // Each sweep only carries values along its own axis, so the
+        // lines of nodes along that axis are swept in parallel.
+        //
+        int dims[3] = {ni, nj, nk};
+        int strides[3] = {1, ni, ni*nj};
         for (int iter=0; iter<niter; ++iter)
         {
             for (int direction = -1 ; direction <= 1; direction += 2)
             {
                 for (int axis = 0; axis < dim ; ++axis)
                 {
-                    for (int kk=0; kk<nk; ++kk)
+                    // the other two axes, which number the lines
+                    int a1 = (axis == 0) ? 1 : 0;
+                    int a2 = (axis == 2) ? 1 : 2;
+                    int n = dims[axis];
+                    int stride = strides[axis];
+                    int nlines = dims[a1] * dims[a2];
+#pragma omp parallel for schedule(dynamic,16)
+                    for (int line=0; line<nlines; ++line)
                     {
-                        for (int jj=0; jj<nj; ++jj)
+                        int ijk[3];
+                        ijk[a1] = line % dims[a1];
+                        ijk[a2] = line / dims[a1];
+                        for (int t=1; t<n; ++t)
                         {
-                            for (int ii=0; ii<ni; ++ii)
+                            ijk[axis] = (direction > 0) ? n-1-t : t;
+                            const int i = ijk[0], j = ijk[1], k = ijk[2];
+
+                            const int myindex = i + j*ni + k*ni*nj;
+                            const float myx = xvals[i];
+                            const float myy = yvals ? yvals[j] : 0;
+                            const float myz = zvals ? zvals[k] : 0;
+                            float old_dist = distvals[myindex];
+
+                            // the previous node in the sweep direction
+                            int srcindex = myindex + direction * stride;
+                            int src_cp = cpvals[srcindex];
+                            if (src_cp < 0)
+                                continue;
+
+                            double px = points[3*src_cp+0];
+                            double py = points[3*src_cp+1];
+                            double pz = points[3*src_cp+2];
+
+                            double dx = px - myx;
+                            double dy = py - myy;
+                            double dz = pz - myz;
+                            double new_dist = sqrt(dx*dx + dy*dy + dz*dz);
+
+                            if (old_dist < 0 || new_dist < old_dist)
                             {
-                                int i = (axis==0 && direction>0) ? ni-1-ii : ii;
-                                int j = (axis==1 && direction>0) ? nj-1-jj : jj;
-                                int k = (axis==2 && direction>0) ? nk-1-kk : kk;
-
-                                const int myindex = i + j*ni + k*ni*nj;
-                                const float myx = x->GetValue(i);
-                                const float myy = y ? y->GetValue(j) : 0;
-                                const float myz = z ? z->GetValue(k) : 0;
-                                float old_dist = dist->GetValue(myindex);
-
-                                int srcindex = myindex;
-                                if (axis == 0)
-                                    srcindex += direction * 1;
-                                else if (axis == 1)
-                                    srcindex += direction * ni;
-                                else // (axis == 2)
-                                    srcindex += direction * ni*nj;
-
-                                // We're being lazy with this check; we're allowing
-                                // it to wrap around the boundary in a nonsensical way.
-                                // But since the algorithm is conservative, no
-                                // harm done except wasted computation.
-                                if (srcindex < 0 || srcindex >= npts)
-                                    continue;
-
-                                int src_cp = cp->GetValue(srcindex);
-                                if (src_cp < 0)
-                                    continue;
-                            
-                                double px=0,py=0,pz=0;
-                                px = input->GetPoint(src_cp, 0);
-                                if (dim>=2)
-                                    py = input->GetPoint(src_cp, 1);
-                                if (dim>=3)
-                                    pz = input->GetPoint(src_cp, 2);
-
-                                double dx = px - myx;
-                                double dy = py - myy;
-                                double dz = pz - myz;
-                                double new_dist = sqrt(dx*dx + dy*dy + dz*dz);
-
-                                if (old_dist < 0 || new_dist < old_dist)
-                                {
-                                    cp->SetValue(myindex, src_cp);
-                                    dist->SetValue(myindex, new_dist);
-                                    old_dist = new_dist;
-                                }
+                                cpvals[myindex] = src_cp;
+                                distvals[myindex] = new_dist;
                             }
                         }
                     }
@@ -9,11 +9,20 @@
 //
 // Purpose:
 ///   Find the distance field for a set of point locations.
+///   The exact mode finds each node's nearest point with a k-d tree
+///   over the input points; the approximate mode seeds the nodes
+///   around each point and sweeps their nearest points along each
+///   axis.  Both run in parallel over the output nodes.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    November 18, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Search a k-d tree for exact distances instead of visiting every
+//   point from every node, and sweep independent lines in parallel in
+//   the approximate mode.
+//
 // ****************************************************************************
 class eavlPointDistanceFieldFilter : public eavlFilter
 {
@@ -4,18 +4,7 @@
 #include "eavlException.h"
 #include "eavlExecutor.h"
 #include "eavlCellSetAllStructured.h"
-#include "eavlReduceOp_1.h"
-#include "eavlMapOp.h"
-
-struct InRange
-{
-    float lo, hi;
-    InRange(float l, float h) : lo(l), hi(h) { }
-    EAVL_FUNCTOR int operator()(float val)
-    {
-        return (val >= lo) && (val < hi);
-    }
-};
+#include "eavlHistogramOp.h"
 
 eavlScalarBinFilter::eavlScalarBinFilter()
 {
@@ -29,50 +18,28 @@ void eavlScalarBinFilter::Execute()
     if (array->GetNumberOfComponents() != 1)
         THROW(eavlException, "expected single-component field");
 
-    eavlArray *minval = array->Create("minval", 1, 1);
-    eavlArray *maxval = array->Create("maxval", 1, 1);
-
-    eavlExecutor::AddOperation(
-        new eavlReduceOp_1<eavlMinFunctor<float> >
-        (array, minval, eavlMinFunctor<float>()), "find min");
+    // one fused pass finds both the min and max, and a second
+    // pass counts every bin at once
+    eavlFloatArray *range = new eavlFloatArray("range", 1, 2);
+    eavlIntArray *bincounts = new eavlIntArray("bincounts", 1, nbins);
 
     eavlExecutor::AddOperation(
-        new eavlReduceOp_1<eavlMaxFunctor<float> >
-        (array, maxval, eavlMaxFunctor<float>()), "find max");
-
+        new_eavlHistogramOp(eavlOpArgs(array), bincounts, range, true),
+        "find range and count values in each bin");
     eavlExecutor::Go();
 
-    int n = array->GetNumberOfTuples();
-
-    float fmin = minval->GetComponentAsDouble(0,0);
-    float fmax = maxval->GetComponentAsDouble(0,0);
-    float fsize = fmax - fmin;
-
+    // use the same cutoffs as the binning itself
+    eavlUniformBinFunctor binner(range->GetValue(0), range->GetValue(1), nbins);
     eavlFloatArray *cutoffs = new eavlFloatArray("cutoffs", 1, nbins+1);
     for (int i = 0; i <= nbins; ++i)
-        cutoffs->SetValue(i,  fmin + fsize * float(i) / float(nbins));
+        cutoffs->SetValue(i, binner.cutoff(i));
 
     eavlFloatArray *counts = new eavlFloatArray("counts", 1, nbins);
-    eavlIntArray *inrange = new eavlIntArray("inrange", 1, n);
-    eavlIntArray *tmpcount = new eavlIntArray("tmpcount", 1, 1);
+    for (int bin = 0; bin < nbins; ++bin)
+        counts->SetValue(bin, bincounts->GetValue(bin));
 
-    for (int bin = 0; bin<nbins; ++bin)
-    {
-        float lo = cutoffs->GetValue(bin);
-        if (bin == 0)
-            lo = -FLT_MAX;
-        float hi = cutoffs->GetValue(bin+1);
-        if (bin == nbins-1)
-            hi = FLT_MAX;
-        eavlExecutor::AddOperation(new_eavlMapOp(eavlOpArgs(array),
-                                                 eavlOpArgs(inrange),
-                                                 InRange(lo, hi)),
-                                   "test if in range");
-        eavlExecutor::AddOperation(new eavlReduceOp_1<eavlAddFunctor<int> >
-               (inrange, tmpcount, eavlAddFunctor<int>()), "count in range");
-        eavlExecutor::Go();
-        counts->SetValue(bin, tmpcount->GetValue(0));
-    }
+    delete range;
+    delete bincounts;
 
     // create the output data set
     output->SetNumPoints(nbins+1);
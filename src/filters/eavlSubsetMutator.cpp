@@ -3,6 +3,27 @@
 #include "eavlCellSetSubset.h"
 #include "eavlException.h"
 
+// selects the cells whose value is in range
+struct SubsetFunctor
+{
+    double minval, maxval;
+    int ncells;
+    vector<int> &subset;
+    SubsetFunctor(double mn, double mx, int n, vector<int> &s)
+        : minval(mn), maxval(mx), ncells(n), subset(s)
+    {
+    }
+    template <class V>
+    void operator()(const V &vals)
+    {
+        for (int i=0; i<ncells; i++)
+        {
+            double val = vals[i];
+            if (val >= minval && val <= maxval)
+                subset.push_back(i);
+        }
+    }
+};
 
 eavlSubsetMutator::eavlSubsetMutator()
 {
@@ -31,40 +52,32 @@ eavlSubsetMutator::Execute()
     eavlCellSetSubset *subset = new eavlCellSetSubset(inCells);
 
     subset->subset.clear();
-    int in_ncells = inCells->GetNumCells();
-    for (int i=0; i<in_ncells; i++)
-    {
-        if (inArray->GetComponentAsDouble(i,0) >= minval &&
-            inArray->GetComponentAsDouble(i,0) <= maxval)
-        {
-            subset->subset.push_back(i);
-        }            
-    }
+    SubsetFunctor select(minval, maxval, inCells->GetNumCells(),
+                         subset->subset);
+    eavlDispatchView(inArray, select, 0);
 
     //int new_cell_index = dataset->GetNumCellSets();
     dataset->AddCellSet(subset);
 	
+    // the subset shares the data set's points, so point fields apply to
+    // it unchanged; only the input cell set's fields need subsetting
 	int numDatasetFields = dataset->GetNumFields();
     for (int i=0; i<numDatasetFields; i++)
     {
         eavlField *f = dataset->GetField(i);
-        if(fieldAssociation == eavlField::ASSOC_POINTS ||
-			(inField->GetAssociation() == eavlField::ASSOC_CELL_SET &&
-    	     inField->GetAssocCellSet() == dataset->GetCellSet(inCellSetIndex)->GetName()))
+        if (f->GetAssociation() == eavlField::ASSOC_CELL_SET &&
+            f->GetAssocCellSet() == inCells->GetName())
     	{
             eavlFloatArray *a = new eavlFloatArray(
                                  string("subset_of_")+f->GetArray()->GetName(),
                                  f->GetArray()->GetNumberOfComponents());
             int sub_ncells = subset->GetNumCells();
             a->SetNumberOfTuples(sub_ncells);
-            for (int j=0; j < sub_ncells; j++)
-            {
-                int e = subset->subset[j];
-                a->SetComponentFromDouble(j,0, f->GetArray()->GetComponentAsDouble(e,0));
-            }
+            if (sub_ncells > 0)
+                eavlGatherTuples(f->GetArray(), &subset->subset[0], a);
 
             eavlField *newfield = new eavlField(f->GetOrder(), a,
-                                                fieldAssociation,
+                                                eavlField::ASSOC_CELL_SET,
                                                 subset->GetName());
             dataset->AddField(newfield);
         }
@@ -12,12 +12,18 @@
 //
 // Purpose:
 ///   Add a subseted cell set to an existing data set
-///   as well as stripped copies of the vars.
+///   as well as stripped copies of the cell vars.  Point vars are
+///   left alone, since the subset shares the data set's points.
 ///   Note: this version creates a subset cell set referencing the original.
 //
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern, James Kress
 // Creation:    April 13, 2012
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Stopped gathering point fields by cell index; only the input cell
+//   set's fields are copied for the subset.
+//
 // ****************************************************************************
 class eavlSubsetMutator : public eavlMutator
 {
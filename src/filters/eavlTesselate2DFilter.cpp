@@ -17,14 +17,15 @@ static float Legendre(int i, float x)
     return -999999999;
 }
 
-static float EvalLegendre(float scale, float xx, float yy, eavlArray *arr, int index)
+template <class V>
+static float EvalLegendre(float scale, float xx, float yy, const V &arr, int index)
 {
     float sum = 0;
     for (int i=0; i<3; i++)
     {
         for (int j=0; j<3; j++)
         {
-            float v = arr->GetComponentAsDouble(index, i*3 + j) * Legendre(i, xx) * Legendre(j, yy);
+            float v = double(arr(index, i*3 + j)) * Legendre(i, xx) * Legendre(j, yy);
             //cerr << "i="<<i<<" j="<<j<<" val="<<v<<endl;
             sum += v;
         }
@@ -35,6 +36,111 @@ static float EvalLegendre(float scale, float xx, float yy, eavlArray *arr, int i
     return sum * scale*scale;
 }
 
+// what the tesselation of one input cell needs to know to fill in
+// the values of its new points
+struct TesselatedCell
+{
+    eavlCell cell;
+    int nedges;
+    signed char (*edges)[2];
+    float legendre_scale;
+    int centroid_point_index;
+};
+
+// fills in the new points of a nodal array: a copy of the old points,
+// the average of the cell's points at each centroid, and the average
+// of the edge's points at each edge midpoint
+struct TesselateNodalFunctor
+{
+    const vector<TesselatedCell> &cells;
+    int npoints;
+    eavlStridedView<float> out;
+    TesselateNodalFunctor(const vector<TesselatedCell> &c, int np,
+                          eavlStridedView<float> o)
+        : cells(c), npoints(np), out(o)
+    {
+    }
+    template <class V>
+    void operator()(const V &in)
+    {
+        int nc = in.stride;
+        for (int c=0; c<nc; c++)
+            for (int p=0; p<npoints; p++)
+                out(p,c) = in(p,c);
+
+        int ncells = cells.size();
+        for (int e=0; e<ncells; e++)
+        {
+            const TesselatedCell &tc = cells[e];
+            const eavlCell &cell = tc.cell;
+            int centroid_point_index = tc.centroid_point_index;
+            for (int c=0; c<nc; c++)
+            {
+                double value = 0;
+                for (int j=0; j<cell.numIndices; j++)
+                    value += in(cell.indices[j], c);
+                value /= double(cell.numIndices);
+                out(centroid_point_index, c) = value;
+            }
+
+            for (int j=0; j<tc.nedges; j++)
+            {
+                int p0 = cell.indices[tc.edges[j][0]];
+                int p1 = cell.indices[tc.edges[j][1]];
+                for (int c=0; c<nc; c++)
+                {
+                    double value = (double(in(p0, c)) + double(in(p1, c))) / 2.;
+                    out(centroid_point_index + 1 + j, c) = value;
+                }
+            }
+        }
+    }
+};
+
+// evaluates 3x3 legendre coefficients of each cell at its centroid,
+// its edge midpoints, and its nodes
+struct TesselateLegendreFunctor
+{
+    const vector<TesselatedCell> &cells;
+    eavlStridedView<float> out;
+    TesselateLegendreFunctor(const vector<TesselatedCell> &c,
+                             eavlStridedView<float> o)
+        : cells(c), out(o)
+    {
+    }
+    template <class V>
+    void operator()(const V &in)
+    {
+        int ncells = cells.size();
+        for (int e=0; e<ncells; e++)
+        {
+            const TesselatedCell &tc = cells[e];
+            const eavlCell &cell = tc.cell;
+            float scale = tc.legendre_scale;
+            int new_point_index = tc.centroid_point_index;
+            signed char (*edges)[2] = tc.edges;
+
+            // note: the xx,yy values range from -1 to +1
+            //       it must be a quadrilateral cell
+            //       and the centroid is at 0,0
+            out[new_point_index] = EvalLegendre(scale, 0, 0, in, e);
+
+            // note: we're assuming a particular edge ordering
+            out[new_point_index + 1] = EvalLegendre(scale, 0, -1, in, e);
+            out[new_point_index + 2] = EvalLegendre(scale, +1, 0, in, e);
+            out[new_point_index + 3] = EvalLegendre(scale, 0, +1, in, e);
+            out[new_point_index + 4] = EvalLegendre(scale, -1, 0, in, e);
+
+            // at the nodes, too
+            // note: inefficient in the general case since we may have
+            // shared nodes, but it's not too bad
+            out[cell.indices[edges[0][0]]] = EvalLegendre(scale, -1, -1, in, e);
+            out[cell.indices[edges[1][0]]] = EvalLegendre(scale, +1, -1, in, e);
+            out[cell.indices[edges[2][0]]] = EvalLegendre(scale, +1, +1, in, e);
+            out[cell.indices[edges[3][0]]] = EvalLegendre(scale, -1, +1, in, e);
+        }
+    }
+};
 
 eavlTesselate2DFilter::eavlTesselate2DFilter()
 {
@@ -84,7 +190,7 @@ eavlTesselate2DFilter::Execute()
     //
     // tesselate high-order cell arrays and fields to single-component nodal scalars
     //
-    vector<pair<eavlArray*,eavlArray*> > legendre3x3_arrays;
+    vector<pair<eavlArray*,eavlFloatArray*> > legendre3x3_arrays;
     for (int i=0; i<input->GetNumFields(); i++)
     {
         if (input->GetField(i)->GetAssociation() == eavlField::ASSOC_CELL_SET &&
@@ -94,7 +200,7 @@ eavlTesselate2DFilter::Execute()
             eavlFloatArray *arr = new eavlFloatArray(input->GetField(i)->GetArray()->GetName(),
                                                        1); // single-component, now
             arr->SetNumberOfTuples(output->GetNumPoints());
-            legendre3x3_arrays.push_back(pair<eavlArray*,eavlArray*>(input->GetField(i)->GetArray(), arr));
+            legendre3x3_arrays.push_back(pair<eavlArray*,eavlFloatArray*>(input->GetField(i)->GetArray(), arr));
 
             eavlField *f = new eavlField(1, arr, eavlField::ASSOC_POINTS);
             output->AddField(f);
@@ -104,7 +210,7 @@ eavlTesselate2DFilter::Execute()
     //
     // create nodal arrays and fields
     //
-    vector<pair<eavlArray*,eavlArray*> > nodal_arrays;
+    vector<pair<eavlArray*,eavlFloatArray*> > nodal_arrays;
     for (int i=0; i<input->GetNumFields(); i++)
     {
         if (input->GetField(i)->GetAssociation() == eavlField::ASSOC_POINTS &&
@@ -113,7 +219,7 @@ eavlTesselate2DFilter::Execute()
             eavlFloatArray *arr = new eavlFloatArray(input->GetField(i)->GetArray()->GetName(),
                                                        input->GetField(i)->GetArray()->GetNumberOfComponents());
             arr->SetNumberOfTuples(output->GetNumPoints());
-            nodal_arrays.push_back(pair<eavlArray*,eavlArray*>(input->GetField(i)->GetArray(), arr));
+            nodal_arrays.push_back(pair<eavlArray*,eavlFloatArray*>(input->GetField(i)->GetArray(), arr));
 
             eavlField *f = new eavlField(input->GetField(i)->GetOrder(), arr,
                                          eavlField::ASSOC_POINTS);
@@ -122,31 +228,25 @@ eavlTesselate2DFilter::Execute()
     }
 
     //
-    // copy old points and point values
+    // copy old points
     //
     coords->SetNumberOfTuples(output->GetNumPoints());
+    eavlStridedView<float> outcoords = coords->GetViewWritable();
+    vector<double> pts;
+    input->GetPoints(pts);
     for (int i=0; i<input->GetNumPoints(); i++)
     {
-        double x = input->GetPoint(i, 0);
-        double y = input->GetPoint(i, 1);
-        double z = input->GetPoint(i, 2);
-        coords->SetComponentFromDouble(i, 0, x);
-        coords->SetComponentFromDouble(i, 1, y);
-        coords->SetComponentFromDouble(i, 2, z);
-    }
-    for (size_t j=0; j<nodal_arrays.size(); j++)
-    {
-        int nc = nodal_arrays[j].first->GetNumberOfComponents();
-        for (int c=0; c<nc; c++)
-            for (int p=0; p<input->GetNumPoints(); p++)
-                nodal_arrays[j].second->SetComponentFromDouble(p, c,
-                            nodal_arrays[j].first->GetComponentAsDouble(p,c));
+        outcoords(i,0) = pts[3*i+0];
+        outcoords(i,1) = pts[3*i+1];
+        outcoords(i,2) = pts[3*i+2];
     }
 
     //
     // do the tesselation:
-    // create new cells and new points
+    // create new cells and new points; the values of the new points
+    // are filled in afterwards, one array at a time
     //
+    vector<TesselatedCell> tesselated(in_ncells);
     eavlExplicitConnectivity conn;
     int new_point_index = input->GetNumPoints();
     for (int e=0; e<in_ncells; e++)
@@ -189,12 +289,15 @@ eavlTesselate2DFilter::Execute()
             THROW(eavlException,"Don't know what to do with this shape\n");
         }
 
+        if (nedges != 4 && !legendre3x3_arrays.empty())
+            THROW(eavlException,"We've got 3x3 legendre arrays for non-quadrilateral cells?!");
+
         ///\todo: not a great way to calculate scale; maybe doing it
         ///       in the MADNESS reader is a better idea.
-        float cell_size_a = fabs(input->GetPoint(cell.indices[1], 0) -
-                                 input->GetPoint(cell.indices[0], 0));
-        float cell_size_b = fabs(input->GetPoint(cell.indices[1], 1) -
-                                 input->GetPoint(cell.indices[0], 1));
+        float cell_size_a = fabs(pts[3*cell.indices[1]+0] -
+                                 pts[3*cell.indices[0]+0]);
+        float cell_size_b = fabs(pts[3*cell.indices[1]+1] -
+                                 pts[3*cell.indices[0]+1]);
         float cell_size = (cell_size_a > cell_size_b) ? cell_size_a : cell_size_b;
         float legendre_scale = sqrt(1. / cell_size);
         //cerr << "legendre_scale = "<<legendre_scale<<endl;
@@ -204,128 +307,48 @@ eavlTesselate2DFilter::Execute()
         //
         int centroid_point_index = new_point_index;
 
+        TesselatedCell &tc = tesselated[e];
+        tc.cell = cell;
+        tc.nedges = nedges;
+        tc.edges = edges;
+        tc.legendre_scale = legendre_scale;
+        tc.centroid_point_index = centroid_point_index;
+
         // do the coordinates
         double x = 0;
         double y = 0;
         double z = 0;
         for (int j=0; j<cell.numIndices; j++)
         {
-            x += input->GetPoint(cell.indices[j], 0);
-            y += input->GetPoint(cell.indices[j], 1);
-            z += input->GetPoint(cell.indices[j], 2);
+            x += pts[3*cell.indices[j]+0];
+            y += pts[3*cell.indices[j]+1];
+            z += pts[3*cell.indices[j]+2];
         }
         x /= double(cell.numIndices);
         y /= double(cell.numIndices);
         z /= double(cell.numIndices);
-        coords->SetComponentFromDouble(new_point_index, 0, x);
-        coords->SetComponentFromDouble(new_point_index, 1, y);
-        coords->SetComponentFromDouble(new_point_index, 2, z);
-
-        // do the nodal arrays
-        for (size_t k=0; k<nodal_arrays.size(); k++)
-        {
-            int nc = nodal_arrays[k].first->GetNumberOfComponents();
-            for (int c=0; c<nc; c++)
-            {
-                double value = 0;
-                for (int j=0; j<cell.numIndices; j++)
-                    value += nodal_arrays[k].first->GetComponentAsDouble(cell.indices[j], c);
-                value /= double(cell.numIndices);
-
-                nodal_arrays[k].second->SetComponentFromDouble(new_point_index,
-                                                               c, value);
-            }
-        }
-
-        // tesselate the high-order ones at this centroid
-        // note: the xx,yy values range from -1 to +1
-        //       it must be a quadrilateral cell
-        //       and the centroid is at 0,0
-        for (size_t k=0; k<legendre3x3_arrays.size(); k++)
-        {
-            if (nedges != 4)
-                THROW(eavlException,"We've got 3x3 legendre arrays for non-quadrilateral cells?!");
-            eavlArray *inarr = legendre3x3_arrays[k].first;
-            eavlArray *outarr = legendre3x3_arrays[k].second;
-            float value = EvalLegendre(legendre_scale, 0, 0, inarr, e);
-            outarr->SetComponentFromDouble(new_point_index, 0, value);
-        }
+        outcoords(new_point_index, 0) = x;
+        outcoords(new_point_index, 1) = y;
+        outcoords(new_point_index, 2) = z;
 
         //
         // create new points midway along each edge
         //
-
-        // coordinates
-        new_point_index = centroid_point_index + 1;// note: reset 'new_point_index'
+        new_point_index = centroid_point_index + 1;
         for (int j=0; j<nedges; j++)
         {
-            double x = (input->GetPoint(cell.indices[edges[j][0]], 0) + 
-                        input->GetPoint(cell.indices[edges[j][1]], 0)) / 2.;
-            double y = (input->GetPoint(cell.indices[edges[j][0]], 1) + 
-                        input->GetPoint(cell.indices[edges[j][1]], 1)) / 2.;
-            double z = (input->GetPoint(cell.indices[edges[j][0]], 2) + 
-                        input->GetPoint(cell.indices[edges[j][1]], 2)) / 2.;
-            coords->SetComponentFromDouble(new_point_index, 0, x);
-            coords->SetComponentFromDouble(new_point_index, 1, y);
-            coords->SetComponentFromDouble(new_point_index, 2, z);
+            double x = (pts[3*cell.indices[edges[j][0]]+0] + 
+                        pts[3*cell.indices[edges[j][1]]+0]) / 2.;
+            double y = (pts[3*cell.indices[edges[j][0]]+1] + 
+                        pts[3*cell.indices[edges[j][1]]+1]) / 2.;
+            double z = (pts[3*cell.indices[edges[j][0]]+2] + 
+                        pts[3*cell.indices[edges[j][1]]+2]) / 2.;
+            outcoords(new_point_index, 0) = x;
+            outcoords(new_point_index, 1) = y;
+            outcoords(new_point_index, 2) = z;
             new_point_index++;
         }
 
-        // nodal arrays
-        for (size_t k=0; k<nodal_arrays.size(); k++)
-        {
-            new_point_index = centroid_point_index + 1;// note: reset 'new_point_index'
-            int nc = nodal_arrays[k].first->GetNumberOfComponents();
-            for (int j=0; j<nedges; j++)
-            {
-                for (int c=0; c<nc; c++)
-                {
-                    double value = (nodal_arrays[k].first->GetComponentAsDouble(cell.indices[edges[j][0]], c) +
-                                    nodal_arrays[k].first->GetComponentAsDouble(cell.indices[edges[j][1]], c)) / 2.;
-                                    
-                    nodal_arrays[k].second->SetComponentFromDouble(new_point_index,
-                                                                   c, value);
-                }
-                new_point_index++;
-            }
-        }
-
-        // tesselate legendre3x3 arrays at the edges
-        for (size_t k=0; k<legendre3x3_arrays.size(); k++)
-        {
-            new_point_index = centroid_point_index + 1;// note: reset 'new_point_index'
-            eavlArray *inarr = legendre3x3_arrays[k].first;
-            eavlArray *outarr = legendre3x3_arrays[k].second;
-            // note: we're assuming a particular edge ordering
-            float value0 = EvalLegendre(legendre_scale, 0, -1, inarr, e);
-            float value1 = EvalLegendre(legendre_scale, +1, 0, inarr, e);
-            float value2 = EvalLegendre(legendre_scale, 0, +1, inarr, e);
-            float value3 = EvalLegendre(legendre_scale, -1, 0, inarr, e);
-            outarr->SetComponentFromDouble(new_point_index + 0, 0, value0);
-            outarr->SetComponentFromDouble(new_point_index + 1, 0, value1);
-            outarr->SetComponentFromDouble(new_point_index + 2, 0, value2);
-            outarr->SetComponentFromDouble(new_point_index + 3, 0, value3);
-            new_point_index += 4;
-        }
-
-        // tesselate legendre3x3 arrays at the nodes, too
-        // note: inefficient in the general case since we may have
-        // shared nodes, but it's not too bad
-        for (size_t k=0; k<legendre3x3_arrays.size(); k++)
-        {
-            eavlArray *inarr = legendre3x3_arrays[k].first;
-            eavlArray *outarr = legendre3x3_arrays[k].second;
-            // note: we're assuming a particular edge ordering again
-            float value0 = EvalLegendre(legendre_scale, -1, -1, inarr, e);
-            float value1 = EvalLegendre(legendre_scale, +1, -1, inarr, e);
-            float value2 = EvalLegendre(legendre_scale, +1, +1, inarr, e);
-            float value3 = EvalLegendre(legendre_scale, -1, +1, inarr, e);
-            outarr->SetComponentFromDouble(cell.indices[edges[0][0]], 0, value0);
-            outarr->SetComponentFromDouble(cell.indices[edges[1][0]], 0, value1);
-            outarr->SetComponentFromDouble(cell.indices[edges[2][0]], 0, value2);
-            outarr->SetComponentFromDouble(cell.indices[edges[3][0]], 0, value3);
-        }
-
         // create the cells for each
         for (int j=0; j<nedges; j++)
         {
@@ -337,6 +360,24 @@ eavlTesselate2DFilter::Execute()
             conn.connectivity.push_back(centroid_point_index + 1 + (j+1)%nedges);
         }
     }
+
+    //
+    // fill in the values of the old and new points, with one typed
+    // loop over the cells per array
+    //
+    for (size_t k=0; k<nodal_arrays.size(); k++)
+    {
+        TesselateNodalFunctor tesselate(tesselated, input->GetNumPoints(),
+                                        nodal_arrays[k].second->GetViewWritable());
+        eavlDispatchView(nodal_arrays[k].first, tesselate);
+    }
+    for (size_t k=0; k<legendre3x3_arrays.size(); k++)
+    {
+        TesselateLegendreFunctor tesselate(tesselated,
+                                           legendre3x3_arrays[k].second->GetViewWritable());
+        eavlDispatchView(legendre3x3_arrays[k].first, tesselate);
+    }
+
     outCellSet->SetCellNodeConnectivity(conn);
 
     eavlCoordinatesCartesian *coordsys =
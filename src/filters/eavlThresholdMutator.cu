@@ -0,0 +1,322 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavlThresholdMutator.h"
+#include "eavlCellSetExplicit.h"
+#include "eavlCellSetAllStructured.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlCompactOp.h"
+#include "eavlGatherOp.h"
+#include "eavlMapOp.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlReduceOp_1.h"
+#include "eavlSourceTopologyMapOp.h"
+
+struct ThresholdInRangeFunctor
+{
+    double minval, maxval;
+    ThresholdInRangeFunctor(double mn, double mx) : minval(mn), maxval(mx) { }
+    EAVL_FUNCTOR int operator()(double x)
+    {
+        return (x >= minval && x <= maxval) ? 1 : 0;
+    }
+};
+
+// a cell is selected if all (or some) of its nodes are; either way,
+// it needs its node count plus one entries in the output connectivity
+struct ThresholdNodesToCellFunctor
+{
+    bool all_points_required;
+    ThresholdNodesToCellFunctor(bool all) : all_points_required(all) { }
+    template <class IN>
+    EAVL_FUNCTOR tuple<int,int> operator()(int shapeType, int n, int ids[],
+                                           const IN nodeflags)
+    {
+        int count = 0;
+        for (int i=0; i<n; i++)
+            count += collect(ids[i], nodeflags);
+        int selected = all_points_required ? (count == n) : (count > 0);
+        return tuple<int,int>(selected, n + 1);
+    }
+};
+
+// the node values aren't used; only the cell's node count is
+struct ThresholdCellSizeFunctor
+{
+    template <class IN>
+    EAVL_FUNCTOR int operator()(int shapeType, int n, int ids[], const IN)
+    {
+        return n + 1;
+    }
+};
+
+// a float copy of one component, for value types the ops don't dispatch
+struct ThresholdCopyComponentFunctor
+{
+    eavlStridedView<float> out;
+    ThresholdCopyComponentFunctor(eavlStridedView<float> o) : out(o) { }
+    template <class V>
+    void operator()(const V &in)
+    {
+        for (int i=0; i<out.size(); i++)
+            out[i] = in[i];
+    }
+};
+
+// a cell field, and its values on the kept cells
+struct ThresholdFieldGather
+{
+    eavlField *field;
+    eavlArray *out;
+    bool       onhost;
+};
+
+static bool OpsCanDispatch(eavlArray *a)
+{
+    return dynamic_cast<eavlFloatArray*>(a) || dynamic_cast<eavlIntArray*>(a);
+}
+
+// the topology map ops only walk explicit and structured cell sets;
+// others, such as subsets, are flagged one cell at a time on the host
+static void FlagCellsOnHost(eavlCellSet *cells, eavlArray *values,
+                            bool cellvalues, double minval, double maxval,
+                            bool all_points_required,
+                            eavlIntArray *cellflags, eavlIntArray *cellsizes)
+{
+    int ncells = cells->GetNumCells();
+    for (int i=0; i<ncells; i++)
+    {
+        eavlCell cell = cells->GetCellNodes(i);
+        int selected;
+        if (cellvalues)
+        {
+            double val = values->GetComponentAsDouble(i,0);
+            selected = (val >= minval && val <= maxval) ? 1 : 0;
+        }
+        else
+        {
+            int count = 0;
+            for (int j=0; j<cell.numIndices; j++)
+            {
+                double val = values->GetComponentAsDouble(cell.indices[j],0);
+                if (val >= minval && val <= maxval)
+                    count++;
+            }
+            selected = all_points_required ? (count == cell.numIndices)
+                                           : (count > 0);
+        }
+        cellflags->SetValue(i, selected);
+        cellsizes->SetValue(i, cell.numIndices + 1);
+    }
+}
+
+eavlThresholdMutator::eavlThresholdMutator()
+{
+    minval = -FLT_MAX;
+    minval = +FLT_MAX;
+    all_points_required = false;
+}
+
+
+void
+eavlThresholdMutator::Execute()
+{
+    int inCellSetIndex = dataset->GetCellSetIndex(cellsetname);
+    eavlCellSet *inCells = dataset->GetCellSet(cellsetname);
+
+    eavlField   *inField = dataset->GetField(fieldname);
+
+    eavlField::Association fieldAssociation = inField->GetAssociation();
+    if (fieldAssociation != eavlField::ASSOC_POINTS &&
+        (inField->GetAssociation() != eavlField::ASSOC_CELL_SET ||
+         inField->GetAssocCellSet() != dataset->GetCellSet(inCellSetIndex)->GetName()))
+    {
+        THROW(eavlException,"Field for subset didn't match cell set.");
+    }
+
+    bool topologyOps = dynamic_cast<eavlCellSetExplicit*>(inCells) ||
+                       dynamic_cast<eavlCellSetAllStructured*>(inCells);
+
+    eavlArray *inArray = inField->GetArray();
+    eavlFloatArray *converted = NULL;
+    if (topologyOps && !OpsCanDispatch(inArray))
+    {
+        converted = new eavlFloatArray("threshold_values", 1,
+                                       inArray->GetNumberOfTuples());
+        ThresholdCopyComponentFunctor copy(converted->GetViewWritable());
+        eavlDispatchView(inArray, copy, 0);
+        inArray = converted;
+    }
+
+    int in_ncells = inCells->GetNumCells();
+    eavlIntArray *cellflags  = new eavlIntArray("threshold_cellflags", 1, in_ncells);
+    eavlIntArray *cellsizes  = new eavlIntArray("threshold_cellsizes", 1, in_ncells);
+    eavlIntArray *totalcells = new eavlIntArray("threshold_totalcells", 1, 1);
+    eavlIntArray *nodeflags  = NULL;
+
+    //
+    // map: flag the cells to keep, and count their connectivity
+    //
+    if (!topologyOps)
+    {
+        FlagCellsOnHost(inCells, inArray,
+                        fieldAssociation == eavlField::ASSOC_CELL_SET,
+                        minval, maxval, all_points_required,
+                        cellflags, cellsizes);
+    }
+    else if (fieldAssociation == eavlField::ASSOC_CELL_SET)
+    {
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(make_indexable(inArray, 0)),
+                          eavlOpArgs(cellflags),
+                          ThresholdInRangeFunctor(minval, maxval)),
+            "flag cells with values in range");
+        eavlExecutor::AddOperation(
+            new_eavlSourceTopologyMapOp(inCells,
+                                        EAVL_NODES_OF_CELLS,
+                                        eavlOpArgs(cellflags),
+                                        eavlOpArgs(cellsizes),
+                                        ThresholdCellSizeFunctor()),
+            "count connectivity per cell");
+    }
+    else // (fieldAssociation == eavlField::ASSOC_POINTS)
+    {
+        nodeflags = new eavlIntArray("threshold_nodeflags", 1,
+                                     inArray->GetNumberOfTuples());
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(make_indexable(inArray, 0)),
+                          eavlOpArgs(nodeflags),
+                          ThresholdInRangeFunctor(minval, maxval)),
+            "flag nodes with values in range");
+        eavlExecutor::AddOperation(
+            new_eavlSourceTopologyMapOp(inCells,
+                                        EAVL_NODES_OF_CELLS,
+                                        eavlOpArgs(nodeflags),
+                                        eavlOpArgs(cellflags, cellsizes),
+                                        ThresholdNodesToCellFunctor(all_points_required)),
+            "flag cells with nodes in range, and count connectivity per cell");
+    }
+
+    //
+    // compact: the input cell and connectivity count of each kept cell,
+    // and how many there are
+    //
+    eavlIntArray *newcells   = new eavlIntArray("threshold_newcells", 1, in_ncells);
+    eavlIntArray *newsizes   = new eavlIntArray("threshold_newsizes", 1, in_ncells);
+    eavlExecutor::AddOperation(
+        new_eavlCompactOp(eavlOpArgs(cellflags),
+                          eavlOpArgs(cellsizes),
+                          eavlOpArgs(newsizes),
+                          totalcells, newcells),
+        "compact kept cells and their connectivity counts");
+    eavlExecutor::Go();
+
+    int numnewcells = totalcells->GetValue(0);
+    newcells->SetNumberOfTuples(numnewcells);
+    newsizes->SetNumberOfTuples(numnewcells);
+
+    eavlIntArray *newstarts  = new eavlIntArray("threshold_newstarts", 1, numnewcells);
+    eavlIntArray *totalconn  = new eavlIntArray("threshold_totalconn", 1, 1);
+    if (numnewcells > 0)
+    {
+        eavlExecutor::AddOperation(
+            new eavlPrefixSumOp_1(newsizes, newstarts, false),
+            "scan connectivity counts to find output connectivity index");
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<int> >(newsizes,
+                                                     totalconn,
+                                                     eavlAddFunctor<int>()),
+            "sumreduce to count output connectivity");
+    }
+
+    //
+    // gather: the cell fields on the kept cells
+    //
+    vector<ThresholdFieldGather> gathers;
+    for (int i=0; i<dataset->GetNumFields(); i++)
+    {
+        eavlField *f = dataset->GetField(i);
+        if (f->GetAssociation() == eavlField::ASSOC_CELL_SET &&
+            f->GetAssocCellSet() == dataset->GetCellSet(inCellSetIndex)->GetName())
+        {
+            eavlArray *fa = f->GetArray();
+            int numcomp = fa->GetNumberOfComponents();
+            string name = string("subset_of_")+fa->GetName();
+            ThresholdFieldGather g;
+            g.field = f;
+            g.onhost = !OpsCanDispatch(fa);
+            eavlArray *a;
+            if (!g.onhost)
+            {
+                a = fa->Create(name, numcomp, numnewcells);
+                for (int c=0; c<numcomp && numnewcells>0; ++c)
+                {
+                    eavlExecutor::AddOperation(
+                        new_eavlGatherOp(eavlOpArgs(make_indexable(fa, c)),
+                                         eavlOpArgs(make_indexable(a, c)),
+                                         eavlOpArgs(newcells)),
+                        "gather cell field");
+                }
+            }
+            else
+            {
+                a = new eavlFloatArray(name, numcomp, numnewcells);
+            }
+            g.out = a;
+            gathers.push_back(g);
+        }
+    }
+    eavlExecutor::Go();
+
+    //
+    // copy the kept cells' connectivity to their output positions
+    //
+    eavlExplicitConnectivity conn;
+    if (numnewcells > 0)
+    {
+        conn.shapetype.resize(numnewcells);
+        conn.connectivity.resize(totalconn->GetValue(0));
+        const int *newcell = (const int*)newcells->GetConstHostArray();
+        const int *newstart = (const int*)newstarts->GetConstHostArray();
+#pragma omp parallel for if (topologyOps)
+        for (int j=0; j<numnewcells; j++)
+        {
+            eavlCell cell = inCells->GetCellNodes(newcell[j]);
+            int start = newstart[j];
+            conn.shapetype[j] = int(cell.type);
+            conn.connectivity[start] = cell.numIndices;
+            for (int k=0; k<cell.numIndices; k++)
+                conn.connectivity[start + 1 + k] = cell.indices[k];
+        }
+    }
+
+    eavlCellSetExplicit *subset = new eavlCellSetExplicit(string("threshold_of_")+inCells->GetName(),
+                                                          inCells->GetDimensionality());
+    subset->SetCellNodeConnectivity(conn);
+
+    //int new_cellset_index = dataset->GetNumCellSets();
+    dataset->AddCellSet(subset);
+
+    // add the gathered fields, finishing any the ops couldn't do
+    for (size_t i=0; i<gathers.size(); i++)
+    {
+        eavlField *f = gathers[i].field;
+        if (gathers[i].onhost && numnewcells > 0)
+            eavlGatherTuples(f->GetArray(),
+                             (const int*)newcells->GetConstHostArray(),
+                             (eavlFloatArray*)gathers[i].out);
+        eavlField *newfield = new eavlField(f->GetOrder(), gathers[i].out,
+                                            eavlField::ASSOC_CELL_SET,
+                                            subset->GetName());
+        dataset->AddField(newfield);
+    }
+
+    delete converted;
+    delete cellflags;
+    delete cellsizes;
+    delete totalcells;
+    delete nodeflags;
+    delete newcells;
+    delete newsizes;
+    delete newstarts;
+    delete totalconn;
+}
@@ -18,6 +18,11 @@
 // Programmer:  Jeremy Meredith, Dave Pugmire, Sean Ahern, James Kress
 // Creation:    April 13, 2012
 //
+// Modifications:
+//   agent, October 17, 2026
+//   Select cells and gather fields with data-parallel operations.  Cell
+//   sets the topology map ops can't walk are still flagged on the host.
+//
 // ****************************************************************************
 class eavlThresholdMutator : public eavlMutator
 {
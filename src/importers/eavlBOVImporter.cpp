@@ -84,37 +84,26 @@ eavlBOVImporter::GetMesh(const string&, int chunk)
         dz += 1;
     }
 
-    vector<vector<double> > coords;
     vector<string> coordNames;
-
-    coords.resize(3);
     coordNames.resize(3);
     coordNames[0] = "XDir";
     coordNames[1] = "YDir";
     coordNames[2] = "ZDir";
 
-    coords[0].resize(dx);
-    for (int i = 0; i < dx; i++)
-        coords[0][i] = x_start + i * (x_stop-x_start) / (dx-1);
-    coords[0][dx-1] = x_stop;
-
-    coords[1].resize(dy);
-    for (int i = 0; i < dy; i++)
-        coords[1][i] = y_start + i * (y_stop-y_start) / (dy-1);
-    coords[1][dy-1] = y_stop;
-
-    coords[2].resize(dz);
-    for (int i = 0 ; i < dz ; i++)
-        coords[2][i] = z_start + i * (z_stop-z_start) / (dz-1);
-    coords[2][dz-1] = z_stop;
+    int dims[3] = {dx, dy, dz};
+    double origin[3] = {x_start, y_start, z_start};
+    double stop[3] = {x_stop, y_stop, z_stop};
+    double spacing[3];
+    for (int d = 0; d < 3; d++)
+        spacing[d] = (dims[d] > 1) ? (stop[d]-origin[d]) / (dims[d]-1) : 1.;
 
     eavlDataSet *data = new eavlDataSet;
-    AddRectilinearMesh(data, coords, coordNames, true, "E");
+    AddUniformMesh(data, dims, origin, spacing, coordNames, true, "E");
     return data;
 }
 
 template<class T> static eavlFloatArray *
-CopyValues(string nm, T *buff, int nTups, int nComps)
+CopyValues(string nm, T *buff, int nTups, int nComps, bool swapBytes)
 {
     eavlFloatArray *arr = new eavlFloatArray(nm, nComps);
     arr->SetNumberOfTuples(nTups);
@@ -122,7 +111,16 @@ CopyValues(string nm, T *buff, int nTups, int nComps)
     for (int i = 0; i < nComps; i++)
     {
         for (int j = 0; j < nTups; j++, idx++)
-            arr->SetComponentFromDouble(j, i, (double)(buff[idx]));
+        {
+            T v = buff[idx];
+            if (swapBytes)
+            {
+                char *b = reinterpret_cast<char*>(&v);
+                for (size_t k = 0; k < sizeof(T)/2; k++)
+                    std::swap(b[k], b[sizeof(T)-1-k]);
+            }
+            arr->SetComponentFromDouble(j, i, (double)v);
+        }
     }
 
     return arr;
@@ -136,9 +134,24 @@ eavlBOVImporter::GetField(const string &var, const string &mesh, int chunk)
 
     int nTuples = brickSize[0]*brickSize[1]*brickSize[2];
 
+    // a single component of native floats is already laid out the way
+    // an eavlFloatArray stores it, so map the file instead of reading it;
+    // it's copy-on-write, so the array can still be modified
+    if (!gzipped && !swapBytes && dataT == FLOAT && numComponents == 1)
+    {
+        eavlFloatArray *arr = new eavlFloatArray(fileName, 0,
+                                                 eavlMappedFile::COPYONWRITE,
+                                                 var, 1, nTuples);
+        if (nodalCentering)
+            return new eavlField(1, arr, eavlField::ASSOC_POINTS);
+        else
+            return new eavlField(1, arr, eavlField::ASSOC_CELL_SET, "E");
+    }
+
     size_t typeSz = SizeOfDataType();
     size_t sz = nTuples*numComponents*typeSz;
-    void *buff = new void*[sz];
+    vector<char> buffer(sz);
+    void *buff = sz > 0 ? &buffer[0] : NULL;
     if (gzipped)
     {
 #ifdef HAVE_ZLIB
@@ -154,26 +167,25 @@ eavlBOVImporter::GetField(const string &var, const string &mesh, int chunk)
     else
     {
         FILE *fp = fopen(fileName.c_str(), "rb");
+        if (!fp)
+            THROW(eavlException,"error opening "+fileName);
         size_t nread = fread(buff, 1, sz, fp);
         fclose(fp);
         if (nread != sz)
             THROW(eavlException,"error reading "+fileName);
     }
 
-    if (swapBytes)
-        cerr<<"SWAP BYTES NOT SUPPORTED. But it still seems to work... ????"<<endl;
-
     eavlArray *arr;
     if (dataT == FLOAT)
-        arr = CopyValues(var, (float *)buff, nTuples, numComponents);
+        arr = CopyValues(var, (float *)buff, nTuples, numComponents, swapBytes);
     else if (dataT == DOUBLE)
-        arr = CopyValues(var, (double *)buff, nTuples, numComponents);
+        arr = CopyValues(var, (double *)buff, nTuples, numComponents, swapBytes);
     else if (dataT == INT)
-        arr = CopyValues(var, (int *)buff, nTuples, numComponents);
+        arr = CopyValues(var, (int *)buff, nTuples, numComponents, swapBytes);
     else if (dataT == SHORT)
-        arr = CopyValues(var, (short *)buff, nTuples, numComponents);
+        arr = CopyValues(var, (short *)buff, nTuples, numComponents, swapBytes);
     else if (dataT == BYTE)
-        arr = CopyValues(var, (unsigned char *)buff, nTuples, numComponents);
+        arr = CopyValues(var, (unsigned char *)buff, nTuples, numComponents, swapBytes);
     else
         THROW(eavlException, "Unknown data type in BOV file");
 
@@ -238,7 +250,16 @@ eavlBOVImporter::ReadTOC(const string &fn)
         if (strncmp(buff, key, strlen(key)) == 0)
         {
             string dataFormat = &buff[strlen(key)];
-
+            if (strcasecmp(dataFormat.c_str(), "DOUBLE") == 0)
+                dataT = DOUBLE;
+            else if (strcasecmp(dataFormat.c_str(), "BYTE") == 0)
+                dataT = BYTE;
+            else if (strcasecmp(dataFormat.c_str(), "INT") == 0)
+                dataT = INT;
+            else if (strcasecmp(dataFormat.c_str(), "SHORT") == 0)
+                dataT = SHORT;
+            else
+                dataT = FLOAT;
             continue;
         }
         key = "DATA_COMPONENTS: ";
@@ -271,7 +292,7 @@ eavlBOVImporter::ReadTOC(const string &fn)
         if (strncmp(buff, key, strlen(key)) == 0)
         {
             bool isLittle;
-            if (strcasecmp(&buff[strlen(key)], "little"))
+            if (strcasecmp(&buff[strlen(key)], "little") == 0)
                 isLittle = true;
             else
                 isLittle = false;
@@ -56,21 +56,29 @@ inline void byte_swap_element<8>(char *p)
     p[4] = val;
 }
 
-// oddly, this is already defined.  neat!
-//#define LITTLE_ENDIAN
-
 template <class T>
-inline void byte_swap(vector<T> &v)
+inline void byte_swap(T *v, int n)
 {
-#ifdef LITTLE_ENDIAN
-    int n = v.size();
     for (int e=0; e<n; e++)
     {
         byte_swap_element<sizeof(T)>(reinterpret_cast<char*>(&(v[e])));
     }
-#endif
 }
 
+template <class T>
+inline void byte_swap(vector<T> &v)
+{
+    if (!v.empty())
+        byte_swap(&v[0], v.size());
+}
+
+// VTK binary data is big-endian; true where it has to be swapped
+#ifdef WORDS_BIGENDIAN
+static const bool binary_needs_swap = false;
+#else
+static const bool binary_needs_swap = true;
+#endif
+
 // ----------------------------------------------------------------------------
 // from vtkCellType.h:
 
@@ -225,23 +233,27 @@ bool eavlVTKImporter::GetNextLine()
 }
 
 template <class IT, class OT>
-inline void BinaryReadThenCopyToVector(istream *is, int n, vector<OT> &v)
+inline void BinaryReadThenCopyToVector(istream *is, int n, vector<OT> &v,
+                                       bool swap)
 {
     vector<IT> t(n);
     is->read(reinterpret_cast<char*>(&t[0]), sizeof(IT) * n);
-    byte_swap(t); // meaningless for size 1 types, of course
+    if (swap)
+        byte_swap(t); // meaningless for size 1 types, of course
     for (int i=0; i<n; i++) v[i] = OT(t[i]);
 }
 
 template <class IT>
-inline void BinaryReadThenCopyToArray(istream *is, int nt, int nc, eavlArray *arr)
+inline void BinaryReadThenCopyToArray(istream *is, int nt, int nc, eavlArray *arr,
+                                      bool swap)
 {
     vector<IT> t(nt*nc);
     is->read(reinterpret_cast<char*>(&t[0]), sizeof(IT) * nt*nc);
-    byte_swap(t);
+    if (swap)
+        byte_swap(t);
     for(int i = 0; i < nt; i++)
         for (int j = 0; j < nc; j++)
-            arr->SetComponentFromDouble(i, j, t[i]);
+            arr->SetComponentFromDouble(i, j, t[i*nc+j]);
 }
 
 void
@@ -258,43 +270,43 @@ eavlVTKImporter::ReadIntoArray(DataType dt, eavlArray *arr)
             THROW(eavlException,"don't know how to support bits in binary files");
 
           case dt_unsigned_char:
-            BinaryReadThenCopyToArray<unsigned char>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<unsigned char>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_char:
-            BinaryReadThenCopyToArray<char>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<char>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_unsigned_short:
-            BinaryReadThenCopyToArray<unsigned short>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<unsigned short>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_short:
-            BinaryReadThenCopyToArray<signed short>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<signed short>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_unsigned_int:
-            BinaryReadThenCopyToArray<unsigned int>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<unsigned int>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_int:
-            BinaryReadThenCopyToArray<signed int>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<signed int>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_unsigned_long:
-            BinaryReadThenCopyToArray<unsigned long>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<unsigned long>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_long:
-            BinaryReadThenCopyToArray<signed long>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<signed long>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_float:
-            BinaryReadThenCopyToArray<float>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<float>(is, nt, nc, arr, swapBinary);
             break;
 
           case dt_double:
-            BinaryReadThenCopyToArray<double>(is, nt, nc, arr);
+            BinaryReadThenCopyToArray<double>(is, nt, nc, arr, swapBinary);
             break;
 
           default:
@@ -316,6 +328,34 @@ eavlVTKImporter::ReadIntoArray(DataType dt, eavlArray *arr)
     }
 }
 
+eavlFloatArray *
+eavlVTKImporter::ReadArray(DataType dt, const string &name, int nc, int nt)
+{
+    // binary floats are mapped straight from the file when they're
+    // aligned in it and need no swapping, as in the BOV importer;
+    // swapping a mapping in place would copy every page of it anyway
+    if (binary && !swapBinary && dt == dt_float &&
+        !filename.empty() && nc*nt > 0)
+    {
+        std::streamoff offset = is->tellg();
+        if (offset >= 0 && offset % sizeof(float) == 0)
+        {
+            eavlFloatArray *arr =
+                new eavlFloatArray(filename, offset,
+                                   eavlMappedFile::COPYONWRITE,
+                                   name, nc, nt);
+            is->seekg(sizeof(float) * nc*nt, ios::cur);
+            is->getline(buff, 4096); // skip the EOL
+            return arr;
+        }
+    }
+
+    eavlFloatArray *arr = new eavlFloatArray(name, nc);
+    arr->SetNumberOfTuples(nt);
+    ReadIntoArray(dt, arr);
+    return arr;
+}
+
 template <class T>
 void
 eavlVTKImporter::ReadIntoVector(int n,DataType dt,vector<T> &v)
@@ -329,43 +369,43 @@ eavlVTKImporter::ReadIntoVector(int n,DataType dt,vector<T> &v)
             THROW(eavlException,"don't know how to support bits in binary files");
 
           case dt_unsigned_char:
-            BinaryReadThenCopyToVector<unsigned char>(is, n, v);
+            BinaryReadThenCopyToVector<unsigned char>(is, n, v, swapBinary);
             break;
 
           case dt_char:
-            BinaryReadThenCopyToVector<char>(is, n, v);
+            BinaryReadThenCopyToVector<char>(is, n, v, swapBinary);
             break;
 
           case dt_unsigned_short:
-            BinaryReadThenCopyToVector<unsigned short>(is, n, v);
+            BinaryReadThenCopyToVector<unsigned short>(is, n, v, swapBinary);
             break;
 
           case dt_short:
-            BinaryReadThenCopyToVector<signed short>(is, n, v);
+            BinaryReadThenCopyToVector<signed short>(is, n, v, swapBinary);
             break;
 
           case dt_unsigned_int:
-            BinaryReadThenCopyToVector<unsigned int>(is, n, v);
+            BinaryReadThenCopyToVector<unsigned int>(is, n, v, swapBinary);
             break;
 
           case dt_int:
-            BinaryReadThenCopyToVector<signed int>(is, n, v);
+            BinaryReadThenCopyToVector<signed int>(is, n, v, swapBinary);
             break;
 
           case dt_unsigned_long:
-            BinaryReadThenCopyToVector<unsigned long>(is, n, v);
+            BinaryReadThenCopyToVector<unsigned long>(is, n, v, swapBinary);
             break;
 
           case dt_long:
-            BinaryReadThenCopyToVector<signed long>(is, n, v);
+            BinaryReadThenCopyToVector<signed long>(is, n, v, swapBinary);
             break;
 
           case dt_float:
-            BinaryReadThenCopyToVector<float>(is, n, v);
+            BinaryReadThenCopyToVector<float>(is, n, v, swapBinary);
             break;
 
           case dt_double:
-            BinaryReadThenCopyToVector<double>(is, n, v);
+            BinaryReadThenCopyToVector<double>(is, n, v, swapBinary);
             break;
 
         }       
@@ -418,7 +458,18 @@ eavlVTKImporter::Print(ostream &out)
 }
 */
 
-eavlVTKImporter::eavlVTKImporter(const string &filename)
+eavlVTKImporter::eavlVTKImporter(const string &fn)
+    : filename(fn), swapBinary(binary_needs_swap)
+{
+    is = new ifstream(filename.c_str(), ios::in);
+    if (is->fail())
+        THROW(eavlException, string("Could not open file ")+filename);
+
+    Import();
+}
+
+eavlVTKImporter::eavlVTKImporter(const string &fn, bool hostByteOrder)
+    : filename(fn), swapBinary(hostByteOrder ? false : binary_needs_swap)
 {
     is = new ifstream(filename.c_str(), ios::in);
     if (is->fail())
@@ -428,6 +479,7 @@ eavlVTKImporter::eavlVTKImporter(const string &filename)
 }
 
 eavlVTKImporter::eavlVTKImporter(const char *data, size_t len)
+    : swapBinary(binary_needs_swap)
 {
     string str(data, len);
     is = new istringstream(str);
@@ -631,14 +683,12 @@ eavlVTKImporter::ParseFieldData(eavlVTKImporter::Location loc)
         *is >> ad;
         toupper(ad);
 
-        eavlFloatArray *arr = new eavlFloatArray(an,ac);
-        arr->SetNumberOfTuples(at);
-        //Changed to ReadIntoArray
+        //Changed to ReadArray
         //int n = arr->GetNumberOfComponents() * arr->GetNumberOfTuples();
         //ReadIntoVector(n, DataTypeFromString(ad), arr->values);
         is->getline(buff, 4096); // skip the EOL
         
-        ReadIntoArray(DataTypeFromString(ad), arr);
+        eavlFloatArray *arr = ReadArray(DataTypeFromString(ad), an, ac, at);
 
         AddArray(arr, loc);
     }
@@ -670,21 +720,20 @@ eavlVTKImporter::ParseScalars(eavlVTKImporter::Location loc)
 
     GetNextLine(); // read and ignore the lookup table
 
-    eavlFloatArray *a = new eavlFloatArray(an,ac);
-
     int ntotalcells = 0;
     for (int i=0; i<data->GetNumCellSets(); i++)
         ntotalcells += data->GetCellSet(i)->GetNumCells();
 
+    int nt;
     if (loc == LOC_CELLS)
-        a->SetNumberOfTuples(ntotalcells);
+        nt = ntotalcells;
     else if (loc == LOC_POINTS)
-        a->SetNumberOfTuples(data->GetNumPoints());
+        nt = data->GetNumPoints();
     else
         THROW(eavlException,"internal error in ParseScalars; loc must be points or cells");
 
     //ReadIntoVector(a->GetNumberOfComponents()*a->GetNumberOfTuples(), DataTypeFromString(ad), a->values);
-    ReadIntoArray(DataTypeFromString(ad), a);
+    eavlFloatArray *a = ReadArray(DataTypeFromString(ad), an, ac, nt);
 
     AddArray(a, loc);
 }
@@ -710,21 +759,20 @@ eavlVTKImporter::ParseVectors(eavlVTKImporter::Location loc)
     toupper(ad);
     ac = 3;
 
-    eavlFloatArray *a = new eavlFloatArray(an,ac);
-
     int ntotalcells = 0;
     for (int i=0; i<data->GetNumCellSets(); i++)
         ntotalcells += data->GetCellSet(i)->GetNumCells();
 
+    int nt;
     if (loc == LOC_CELLS)
-        a->SetNumberOfTuples(ntotalcells);
+        nt = ntotalcells;
     else if (loc == LOC_POINTS)
-        a->SetNumberOfTuples(data->GetNumPoints());
+        nt = data->GetNumPoints();
     else
         THROW(eavlException,"internal error in ParseVectors; loc must be points or cells");
 
     //ReadIntoVector(a->GetNumberOfComponents()*a->GetNumberOfTuples(), DataTypeFromString(ad), a->values);
-    ReadIntoArray(DataTypeFromString(ad), a);
+    eavlFloatArray *a = ReadArray(DataTypeFromString(ad), an, ac, nt);
 
     AddArray(a, loc);
 }
@@ -750,21 +798,20 @@ eavlVTKImporter::ParseNormals(eavlVTKImporter::Location loc)
     toupper(ad);
     ac = 3;
 
-    eavlFloatArray *a = new eavlFloatArray(an,ac);
-
     int ntotalcells = 0;
     for (int i=0; i<data->GetNumCellSets(); i++)
         ntotalcells += data->GetCellSet(i)->GetNumCells();
 
+    int nt;
     if (loc == LOC_CELLS)
-        a->SetNumberOfTuples(ntotalcells);
+        nt = ntotalcells;
     else if (loc == LOC_POINTS)
-        a->SetNumberOfTuples(data->GetNumPoints());
+        nt = data->GetNumPoints();
     else
         THROW(eavlException,"internal error in ParseNormals; loc must be points or cells");
 
     //ReadIntoVector(a->GetNumberOfComponents()*a->GetNumberOfTuples(), DataTypeFromString(ad), a->values);
-    ReadIntoArray(DataTypeFromString(ad), a);
+    eavlFloatArray *a = ReadArray(DataTypeFromString(ad), an, ac, nt);
 
     AddArray(a, loc);
 }
@@ -895,7 +942,40 @@ void
 eavlVTKImporter::Parse_Structured_Points()
 {
     //GetNextLine(); // assume it's read already
-    THROW(eavlException,"Structured points is unsupported\n");
+
+    // DIMENSIONS, ORIGIN and SPACING (or ASPECT_RATIO), in any order
+    int dims[3] = {0, 0, 0};
+    double origin[3] = {0., 0., 0.};
+    double spacing[3] = {1., 1., 1.};
+    bool haveDims = false;
+    for (int line = 0; line < 3; line++)
+    {
+        istringstream sin(buff);
+        string s;
+        sin >> s;
+        if (s == "DIMENSIONS")
+        {
+            sin >> dims[0] >> dims[1] >> dims[2];
+            haveDims = true;
+        }
+        else if (s == "ORIGIN")
+            sin >> origin[0] >> origin[1] >> origin[2];
+        else if (s == "SPACING" || s == "ASPECT_RATIO")
+            sin >> spacing[0] >> spacing[1] >> spacing[2];
+        else
+            THROW(eavlException,string("Expected DIMENSIONS, ORIGIN or SPACING, got ")+s);
+        GetNextLine();
+    }
+    if (!haveDims)
+        THROW(eavlException,"Expected DIMENSIONS");
+
+    vector<string> coordNames;
+    coordNames.push_back("xcoord");
+    coordNames.push_back("ycoord");
+    coordNames.push_back("zcoord");
+
+    AddUniformMesh(data, dims, origin, spacing, coordNames, true,
+                   "StructuredPointsCells");
 }
 
 void
@@ -31,6 +31,10 @@ class eavlVTKImporter : public eavlImporter
     eavlDataSet   *GetMesh(const string &name, int chunk);
     eavlField     *GetField(const string &name, const string &mesh, int chunk);
   protected:
+    /// For files whose binary data is in host byte order rather than
+    /// the big-endian order VTK specifies.
+    eavlVTKImporter(const string &filename, bool hostByteOrder);
+
     enum DataType
     {
         dt_bit,
@@ -57,11 +61,13 @@ class eavlVTKImporter : public eavlImporter
     };
 
     istream *is;
+    string   filename; ///< the file \c is reads, if any, for mapping arrays
     char buff[4096];
     char bufforig[4096];
     enum Location { LOC_DATASET, LOC_CELLS, LOC_POINTS };
     string      comment;
     bool        binary;
+    bool        swapBinary; ///< binary data isn't in host byte order
     DataSetType structure;
 
   protected:
@@ -93,6 +99,7 @@ class eavlVTKImporter : public eavlImporter
     template <class T>
     void ReadIntoVector(int,DataType,vector<T>&);
     void ReadIntoArray(DataType, eavlArray *);
+    eavlFloatArray *ReadArray(DataType, const string &, int, int);
     bool GetNextLine();
   protected:
     vector<int> cell_to_cell_splitmap;
@@ -79,7 +79,7 @@ void callNodeStencilKernel_1_1(int npoints,
                           eavlArray *o0, int o0mul, int o0add,
                           F &functor)
 {
-    i0->GetCUDAArray();
+    i0->GetConstCUDAArray();
     o0->GetCUDAArray();
 
     // run the kernel
@@ -42,6 +42,30 @@ struct eavlCombinedTopologyMapOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+template <class CONN>
+struct eavlCombinedTopologyMapOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN0, class IN1, class OUT>
+    static void call(int end, eavlRangeStructure<CONN> &range,
+                     const IN0 s_inputs, const IN1 d_inputs, OUT outputs, F &functor)
+    {
+        int ids[MAX_LOCAL_TOPOLOGY_IDS];
+        for (int index = range.begin; index < end; ++index)
+        {
+            int nids;
+            int shapeType = range.structure.GetElementComponents(index, nids, ids);
+
+            typename collecttype<IN1>::const_type in_d(collect(index, d_inputs));
+            typename collecttype<OUT>::type out(collect(index, outputs));
+
+            out = functor(shapeType, nids, ids, s_inputs, in_d);
+        }
+    }
+};
+
 #if defined __CUDACC__
 
 template <class F, class IN0, class IN1, class OUT>
@@ -92,11 +116,16 @@ struct eavlCombinedTopologyMapOp_GPU
 ///   Map from one topological element in a mesh to another, with
 ///   input arrays on both the source and destination topology
 ///   and with outputs on the destination topology.
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool).
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  1, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class IS, class ID, class O, class F>
 class eavlCombinedTopologyMapOp : public eavlOperation
@@ -121,8 +150,17 @@ class eavlCombinedTopologyMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-            eavlOpDispatch<eavlCombinedTopologyMapOp_CPU<eavlExplicitConnectivity> >(n, conn, s_inputs, d_inputs, outputs, functor);
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_CPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, d_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_CPU<eavlMixedConnectivity> >(n, mconn, s_inputs, d_inputs, outputs, functor);
+            }
         }
         else if (elStr)
         {
@@ -138,23 +176,18 @@ class eavlCombinedTopologyMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-
-            cerr<<"copying shapetype to device...\n";
-            conn.shapetype.NeedOnDevice();
-            cerr<<"copying connectivity to device...\n";
-            conn.connectivity.NeedOnDevice();
-            cerr<<"copying mapCellToIndex to device...\n";
-            conn.mapCellToIndex.NeedOnDevice();
-
-            eavlOpDispatch<eavlCombinedTopologyMapOp_GPU<eavlExplicitConnectivity> >(n, conn, s_inputs, d_inputs, outputs, functor);
-
-            cerr<<"copying shapetype from device...\n";
-            conn.shapetype.NeedOnHost();
-            cerr<<"copying connectivity from device...\n";
-            conn.connectivity.NeedOnHost();
-            cerr<<"copying mapCellToIndex from device...\n";
-            conn.mapCellToIndex.NeedOnHost();
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_GPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, d_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_GPU<eavlMixedConnectivity> >(n, mconn, s_inputs, d_inputs, outputs, functor);
+            }
+            conn.NeedOnHost();
         }
         else if (elStr)
         {
@@ -165,6 +198,55 @@ class eavlCombinedTopologyMapOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(s_inputs, in);
+        eavlAddOperationArrays(d_inputs, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual eavlCellSet *GetCellSet()
+    {
+        return cells;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void PrepareCPURange()
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        if (elExp)
+            elExp->GetPackedConnectivity(topology);
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        eavlCellSetAllStructured *elStr = dynamic_cast<eavlCellSetAllStructured*>(cells);
+        if (elExp)
+        {
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlHomogeneousConnectivity> range(hconn, begin);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_CPU_Range<eavlHomogeneousConnectivity> >(end, range, s_inputs, d_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlMixedConnectivity> range(mconn, begin);
+                eavlOpDispatch<eavlCombinedTopologyMapOp_CPU_Range<eavlMixedConnectivity> >(end, range, s_inputs, d_inputs, outputs, functor);
+            }
+        }
+        else if (elStr)
+        {
+            eavlRegularConnectivity conn = eavlRegularConnectivity(elStr->GetRegularStructure(),topology);
+            eavlRangeStructure<eavlRegularConnectivity> range(conn, begin);
+            eavlOpDispatch<eavlCombinedTopologyMapOp_CPU_Range<eavlRegularConnectivity> >(end, range, s_inputs, d_inputs, outputs, functor);
+        }
+    }
 };
 
 // helper function for type deduction
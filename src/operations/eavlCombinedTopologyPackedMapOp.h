@@ -47,6 +47,35 @@ struct eavlCombinedTopologyPackedMapOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+template <class CONN>
+struct eavlCombinedTopologyPackedMapOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN0, class IN1, class OUT, class INDEX>
+    static void call(int end, eavlRangeStructure<CONN> &range,
+                     const IN0 s_inputs, const IN1 d_inputs, OUT outputs,
+                     INDEX indices, F &functor)
+    {
+        int *sparseindices = get<0>(indices).array;
+
+        int ids[MAX_LOCAL_TOPOLOGY_IDS]; // these are effectively our src indices
+        for (int denseindex = range.begin; denseindex < end; ++denseindex)
+        {
+            int sparseindex = sparseindices[get<0>(indices).indexer.index(denseindex)];
+
+            int nids;
+            int shapeType = range.structure.GetElementComponents(sparseindex, nids, ids);
+
+            typename collecttype<IN1>::const_type in_d(collect(denseindex, d_inputs));
+            typename collecttype<OUT>::type out(collect(denseindex, outputs));
+
+            out = functor(shapeType, nids, ids, s_inputs, in_d);
+        }
+    }
+};
+
 #if defined __CUDACC__
 
 template <class CONN, class F, class IN0, class IN1, class OUT, class INDEX>
@@ -106,11 +135,16 @@ struct eavlCombinedTopologyPackedMapOp_GPU
 ///   In this packed version of the operation, the inputs on the destination
 ///   topology and the outputs are both compacted, i.e. densely indexed from
 ///   0 to n-1.
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool).
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  2, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class IS, class ID, class O, class INDEX, class F>
 class eavlCombinedTopologyPackedMapOp : public eavlOperation
@@ -136,8 +170,17 @@ class eavlCombinedTopologyPackedMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-            eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU<eavlExplicitConnectivity> >(n, conn, s_inputs, d_inputs, outputs, indices, functor);
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, d_inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU<eavlMixedConnectivity> >(n, mconn, s_inputs, d_inputs, outputs, indices, functor);
+            }
         }
         else if (elStr)
         {
@@ -153,23 +196,18 @@ class eavlCombinedTopologyPackedMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-
-            cerr<<"copying shapetype to device...\n";
-            conn.shapetype.NeedOnDevice();
-            cerr<<"copying connectivity to device...\n";
-            conn.connectivity.NeedOnDevice();
-            cerr<<"copying mapCellToIndex to device...\n";
-            conn.mapCellToIndex.NeedOnDevice();
-
-            eavlOpDispatch<eavlCombinedTopologyPackedMapOp_GPU<eavlExplicitConnectivity> >(n, conn, s_inputs, d_inputs, outputs, indices, functor);
-
-            cerr<<"copying shapetype from device...\n";
-            conn.shapetype.NeedOnHost();
-            cerr<<"copying connectivity from device...\n";
-            conn.connectivity.NeedOnHost();
-            cerr<<"copying mapCellToIndex from device...\n";
-            conn.mapCellToIndex.NeedOnHost();
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_GPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, d_inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_GPU<eavlMixedConnectivity> >(n, mconn, s_inputs, d_inputs, outputs, indices, functor);
+            }
+            conn.NeedOnHost();
         }
         else if (elStr)
         {
@@ -180,6 +218,56 @@ class eavlCombinedTopologyPackedMapOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(s_inputs, in);
+        eavlAddOperationArrays(d_inputs, in);
+        eavlAddOperationArrays(indices, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual eavlCellSet *GetCellSet()
+    {
+        return cells;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void PrepareCPURange()
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        if (elExp)
+            elExp->GetPackedConnectivity(topology);
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        eavlCellSetAllStructured *elStr = dynamic_cast<eavlCellSetAllStructured*>(cells);
+        if (elExp)
+        {
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlHomogeneousConnectivity> range(hconn, begin);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU_Range<eavlHomogeneousConnectivity> >(end, range, s_inputs, d_inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlMixedConnectivity> range(mconn, begin);
+                eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU_Range<eavlMixedConnectivity> >(end, range, s_inputs, d_inputs, outputs, indices, functor);
+            }
+        }
+        else if (elStr)
+        {
+            eavlRegularConnectivity conn = eavlRegularConnectivity(elStr->GetRegularStructure(),topology);
+            eavlRangeStructure<eavlRegularConnectivity> range(conn, begin);
+            eavlOpDispatch<eavlCombinedTopologyPackedMapOp_CPU_Range<eavlRegularConnectivity> >(end, range, s_inputs, d_inputs, outputs, indices, functor);
+        }
+    }
 };
 
 // helper function for type deduction
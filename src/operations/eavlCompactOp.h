@@ -0,0 +1,272 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_COMPACT_OP_H
+#define EAVL_COMPACT_OP_H
+
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlOpDispatch.h"
+#include "eavlOperation.h"
+#include "eavlException.h"
+#include "eavlGatherOp.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlReduceOp_1.h"
+#include "eavlSimpleReverseIndexOp.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN
+
+// below this many flags, the fork/join overhead outweighs the benefit
+#define EAVL_COMPACT_MIN_PARALLEL_VALUES 32768
+
+// where a compaction writes the selected indices (if anywhere), and
+// how many there were
+struct eavlCompactInfo
+{
+    int *indices;
+    int  nout;
+};
+
+// copies the selected values to their output index
+template <class IN, class OUT>
+struct eavlCompactCopyValues
+{
+    const IN inputs;
+    OUT      outputs;
+    eavlCompactCopyValues(const IN i, OUT o) : inputs(i), outputs(o) { }
+    void operator()(int in, int out)
+    {
+        collect(out, outputs).CopyFrom(collect(in, inputs));
+    }
+};
+
+// for a compaction which only finds the selected indices
+struct eavlCompactNoValues
+{
+    void operator()(int, int)
+    {
+    }
+};
+
+// Each thread counts the selected flags in one contiguous chunk, the
+// counts are scanned to give each thread its first output index, and
+// then each thread writes its selected indices and values in order.
+template <class FLAG, class COPY>
+void eavlCompactByFlags(int n, eavlCompactInfo &info, const FLAG &flags,
+                        COPY &copy)
+{
+    int maxthreads = 1;
+#ifdef HAVE_OPENMP
+    maxthreads = omp_get_max_threads();
+#endif
+    vector<int> offsets(maxthreads + 1, 0);
+
+#pragma omp parallel if (n >= EAVL_COMPACT_MIN_PARALLEL_VALUES)
+    {
+        int nthreads = 1;
+        int threadid = 0;
+#ifdef HAVE_OPENMP
+        nthreads = omp_get_num_threads();
+        threadid = omp_get_thread_num();
+#endif
+        int chunksize = (n + nthreads - 1) / nthreads;
+        int start = threadid * chunksize;
+        int end   = start + chunksize;
+        if (start > n)
+            start = n;
+        if (end > n)
+            end = n;
+
+        int nselected = 0;
+        for (int i = start; i < end; ++i)
+        {
+            if (flags.array[flags.indexer.index(i)] != 0)
+                ++nselected;
+        }
+        offsets[threadid+1] = nselected;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            for (int t = 1; t <= nthreads; ++t)
+                offsets[t] += offsets[t-1];
+            info.nout = offsets[nthreads];
+        }
+        // (implicit barrier at the end of the single)
+
+        int j = offsets[threadid];
+        for (int i = start; i < end; ++i)
+        {
+            if (flags.array[flags.indexer.index(i)] != 0)
+            {
+                if (info.indices)
+                    info.indices[j] = i;
+                copy(i, j);
+                ++j;
+            }
+        }
+    }
+}
+
+struct eavlCompactOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class FLAGS, class IN, class OUT>
+    static void call(int n, eavlCompactInfo &info,
+                     const FLAGS flags, const IN inputs, OUT outputs, F&)
+    {
+        eavlCompactCopyValues<IN,OUT> copy(inputs, outputs);
+        eavlCompactByFlags(n, info, flags.first, copy);
+    }
+    template <class F, class FLAGS>
+    static void call(int n, eavlCompactInfo &info,
+                     const FLAGS flags, F&)
+    {
+        eavlCompactNoValues copy;
+        eavlCompactByFlags(n, info, flags.first, copy);
+    }
+};
+
+// dispatch the flags with the values, or alone if there are no values
+template <class K, class S, class FLAGS, class I, class O, class F>
+void eavlCompactDispatch(int n, S &structure, FLAGS flags, I inputs, O outputs,
+                         F &functor)
+{
+    eavlOpDispatch<K>(n, structure, flags, inputs, outputs, functor);
+}
+
+template <class K, class S, class FLAGS, class F>
+void eavlCompactDispatch(int n, S &structure, FLAGS flags, nulltype, nulltype,
+                         F &functor)
+{
+    eavlOpDispatch<K>(n, structure, flags, functor);
+}
+
+#if defined __CUDACC__
+template <class I, class O, class F>
+void eavlCompactGatherGPU(int n, I inputs, O outputs, eavlIntArray *indices,
+                          F &functor)
+{
+    int dummy;
+    eavlOpDispatch<eavlGatherOp_GPU>(n, dummy, inputs, outputs,
+                                     eavlOpArgs(indices), functor);
+}
+
+template <class F>
+void eavlCompactGatherGPU(int, nulltype, nulltype, eavlIntArray *, F &)
+{
+}
+#endif
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlCompactOp
+//
+// Purpose:
+///   A stream compaction (copy_if): for each index whose flag is 1, in
+///   order, copies the input values at that index to the next index of
+///   the outputs, and optionally writes the index itself to an int array
+///   of selected indices.  The number selected is placed in the (int)
+///   count array.  This takes the place of a prefix sum of the flags, a
+///   reduction to count them, a reverse index and a gather; on the host,
+///   it reads the flags twice and writes each output once, without any
+///   temporary arrays.  The outputs must have room for as many values as
+///   might be selected, e.g. the number of flags; they can be shrunk to
+///   the count afterward.  Pass eavlOpArgs() for both the inputs and the
+///   outputs to find only the selected indices.
+///   Example:
+///                flags : [0 1 1 0 1]
+///               inputs : [a b c d e]
+///              outputs : [b c e]
+///              indices : [1 2 4]
+///                count : [3]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class FLAGS, class I, class O>
+class eavlCompactOp : public eavlOperation
+{
+  protected:
+    DummyFunctor functor;
+    FLAGS        flags;
+    I            inputs;
+    O            outputs;
+    eavlArrayWithLinearIndex count;
+    eavlIntArray *indices;
+  public:
+    eavlCompactOp(FLAGS fl, I i, O o, eavlArrayWithLinearIndex c,
+                  eavlIntArray *ind)
+        : flags(fl), inputs(i), outputs(o), count(c), indices(ind)
+    {
+    }
+    virtual void GoCPU()
+    {
+        eavlIntArray *countarray = dynamic_cast<eavlIntArray*>(count.array);
+        if (!countarray)
+            THROW(eavlException,"eavlCompactOp expects an int array for the count.");
+
+        int n = flags.first.length();
+        eavlCompactInfo info;
+        info.indices = indices ? (int*)indices->GetHostArray() : NULL;
+        info.nout = 0;
+        eavlCompactDispatch<eavlCompactOp_CPU>(n, info, flags, inputs, outputs, functor);
+        ((int*)countarray->GetHostArray())[count.add] = info.nout;
+    }
+    virtual void GoGPU()
+    {
+#if defined __CUDACC__
+        // the prefix sum, reduction, reverse index and gather it replaces
+        eavlIntArray *countarray = dynamic_cast<eavlIntArray*>(count.array);
+        eavlIntArray *flagarray = dynamic_cast<eavlIntArray*>(flags.first.array);
+        if (!countarray || !flagarray)
+            THROW(eavlException,"eavlCompactOp expects int arrays for the flags and count.");
+
+        int n = flags.first.length();
+        eavlArrayWithLinearIndex f(flagarray, flags.first.indexer.add);
+        f.div = flags.first.indexer.div;
+        f.mod = flags.first.indexer.mod;
+        f.mul = flags.first.indexer.mul;
+        eavlIntArray offsets("compact_offsets", 1, n);
+        eavlIntArray total("compact_total", 1, 1);
+        eavlPrefixSumOp_1(f, &offsets, false).GoGPU();
+        eavlReduceOp_1<eavlAddFunctor<int> >(f, &total, eavlAddFunctor<int>()).GoGPU();
+        int nout = ((int*)total.GetHostArray())[0];
+
+        eavlIntArray *ind = indices ? indices : new eavlIntArray("compact_indices", 1, n);
+        eavlSimpleReverseIndexOp(f, &offsets, ind).GoGPU();
+        eavlCompactGatherGPU(nout, inputs, outputs, ind, functor);
+        if (ind != indices)
+            delete ind;
+        ((int*)countarray->GetHostArray())[count.add] = nout;
+#else
+        THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
+#endif
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(flags, in);
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(outputs, out);
+        eavlAddOperationArrays(count, out);
+        if (indices)
+            eavlAddOperationArrays(eavlArrayWithLinearIndex(indices), out);
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class FLAGS, class I, class O>
+eavlCompactOp<FLAGS,I,O> *new_eavlCompactOp(FLAGS flags, I i, O o,
+                                            eavlArrayWithLinearIndex count,
+                                            eavlIntArray *indices = NULL)
+{
+    return new eavlCompactOp<FLAGS,I,O>(flags, i, o, count, indices);
+}
+
+#endif
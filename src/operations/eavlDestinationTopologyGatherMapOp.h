@@ -45,6 +45,33 @@ struct eavlDestinationTopologyGatherMapOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+template <class CONN>
+struct eavlDestinationTopologyGatherMapOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT, class INDEX>
+    static void call(int end, eavlRangeStructure<CONN> &range,
+                     const IN inputs, OUT outputs,
+                     INDEX indices, F &functor)
+    {
+        int *sparseindices = get<0>(indices).array;
+
+        int ids[MAX_LOCAL_TOPOLOGY_IDS];
+        for (int denseindex = range.begin; denseindex < end; ++denseindex)
+        {
+            int sparseindex = sparseindices[get<0>(indices).indexer.index(denseindex)];
+
+            int nids;
+            int shapeType = range.structure.GetElementComponents(sparseindex, nids, ids);
+
+            collect(denseindex, outputs) = functor(shapeType, nids, ids,
+                                                   collect(sparseindex, inputs));
+        }
+    }
+};
+
 #if defined __CUDACC__
 
 template <class CONN, class F, class IN, class OUT, class INDEX>
@@ -104,11 +131,16 @@ struct eavlDestinationTopologyGatherMapOp_GPU
 ///   In this gather version of the operation, the inputs (on the destination)
 ///   topology are sparsely indexed and the outputs are compacted, i.e. 
 ///   the outputs are densely indexed 0 to n-1.
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool).
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  1, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class I, class O, class INDEX, class F>
 class eavlDestinationTopologyGatherMapOp : public eavlOperation
@@ -133,8 +165,17 @@ class eavlDestinationTopologyGatherMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-            eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU<eavlExplicitConnectivity> >(n, conn, inputs, outputs, indices, functor);
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU<eavlHomogeneousConnectivity> >(n, hconn, inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU<eavlMixedConnectivity> >(n, mconn, inputs, outputs, indices, functor);
+            }
         }
         else if (elStr)
         {
@@ -150,23 +191,18 @@ class eavlDestinationTopologyGatherMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-
-            cerr<<"copying shapetype to device...\n";
-            conn.shapetype.NeedOnDevice();
-            cerr<<"copying connectivity to device...\n";
-            conn.connectivity.NeedOnDevice();
-            cerr<<"copying mapCellToIndex to device...\n";
-            conn.mapCellToIndex.NeedOnDevice();
-
-            eavlOpDispatch<eavlDestinationTopologyGatherMapOp_GPU<eavlExplicitConnectivity> >(n, conn, inputs, outputs, indices, functor);
-
-            cerr<<"copying shapetype from device...\n";
-            conn.shapetype.NeedOnHost();
-            cerr<<"copying connectivity from device...\n";
-            conn.connectivity.NeedOnHost();
-            cerr<<"copying mapCellToIndex from device...\n";
-            conn.mapCellToIndex.NeedOnHost();
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_GPU<eavlHomogeneousConnectivity> >(n, hconn, inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_GPU<eavlMixedConnectivity> >(n, mconn, inputs, outputs, indices, functor);
+            }
+            conn.NeedOnHost();
         }
         else if (elStr)
         {
@@ -177,6 +213,55 @@ class eavlDestinationTopologyGatherMapOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(indices, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual eavlCellSet *GetCellSet()
+    {
+        return cells;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void PrepareCPURange()
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        if (elExp)
+            elExp->GetPackedConnectivity(topology);
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        eavlCellSetAllStructured *elStr = dynamic_cast<eavlCellSetAllStructured*>(cells);
+        if (elExp)
+        {
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlHomogeneousConnectivity> range(hconn, begin);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU_Range<eavlHomogeneousConnectivity> >(end, range, inputs, outputs, indices, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlMixedConnectivity> range(mconn, begin);
+                eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU_Range<eavlMixedConnectivity> >(end, range, inputs, outputs, indices, functor);
+            }
+        }
+        else if (elStr)
+        {
+            eavlRegularConnectivity conn = eavlRegularConnectivity(elStr->GetRegularStructure(),topology);
+            eavlRangeStructure<eavlRegularConnectivity> range(conn, begin);
+            eavlOpDispatch<eavlDestinationTopologyGatherMapOp_CPU_Range<eavlRegularConnectivity> >(end, range, inputs, outputs, indices, functor);
+        }
+    }
 };
 
 // helper function for type deduction
@@ -23,12 +23,31 @@ struct eavlGatherOp_CPU
                      const IN inputs, OUT outputs,
                      INDEX indices, F&)
     {
-        int *sparseindices = get<0>(indices).array;
-
 #pragma omp parallel for
         for (int denseindex = 0; denseindex < nitems; ++denseindex)
         {
-            int sparseindex = sparseindices[get<0>(indices).indexer.index(denseindex)];
+            int sparseindex = get<0>(indices).array[get<0>(indices).indexer.index(denseindex)];
+            // can't use operator= because it's ambiguous when only
+            // one input and one output array (without a functor that
+            // would force a cast to a known type situation).
+            collect(denseindex, outputs).CopyFrom(collect(sparseindex, inputs));
+        }
+    }
+};
+
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+struct eavlGatherOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT, class INDEX>
+    static void call(int end, int begin,
+                     const IN inputs, OUT outputs,
+                     INDEX indices, F&)
+    {
+        for (int denseindex = begin; denseindex < end; ++denseindex)
+        {
+            int sparseindex = get<0>(indices).array[get<0>(indices).indexer.index(denseindex)];
             // can't use operator= because it's ambiguous when only
             // one input and one output array (without a functor that
             // would force a cast to a known type situation).
@@ -45,13 +64,11 @@ eavlGatherOp_kernel(int nitems,
                     const IN inputs, OUT outputs,
                     INDEX indices)
 {
-    int *sparseindices = get<0>(indices).array;
-
     const int numThreads = blockDim.x * gridDim.x;
     const int threadID   = blockIdx.x * blockDim.x + threadIdx.x;
     for (int denseindex = threadID; denseindex < nitems; denseindex += numThreads)
     {
-        int sparseindex = sparseindices[get<0>(indices).indexer.index(denseindex)];
+        int sparseindex = get<0>(indices).array[get<0>(indices).indexer.index(denseindex)];
         // can't use operator= because it's ambiguous when only
         // one input and one output array (without a functor that
         // would force a cast to a known type situation).
@@ -91,11 +108,19 @@ struct eavlGatherOp_GPU
 ///   A simple gather operation on a single input and output array; copies
 ///   the values specified by the indices array from the source array to
 ///   the destination array.
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool).
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  1, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Index the indices through their indexable, so they may be implicit.
+//
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class I, class O, class INDEX>
 class eavlGatherOp : public eavlOperation
@@ -126,6 +151,22 @@ class eavlGatherOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(indices, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlOpDispatch<eavlGatherOp_CPU_Range>(end, begin, inputs, outputs, indices, functor);
+    }
 };
 
 // helper function for type deduction
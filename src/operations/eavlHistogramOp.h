@@ -0,0 +1,391 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_HISTOGRAM_OP_H
+#define EAVL_HISTOGRAM_OP_H
+
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlOpDispatch.h"
+#include "eavlOperation.h"
+#include "eavlException.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+// ****************************************************************************
+// Class:  eavlUniformBinFunctor
+//
+// Purpose:
+///   Maps a value to one of nbins equally spaced bins between lo and hi.
+///   Values below the first cutoff fall in the first bin, and values
+///   above the last cutoff fall in the last bin.  The cutoffs are computed
+///   as lo + (hi-lo)*i/nbins, except that the last one is hi itself, and
+///   a value v is placed in bin i exactly when cutoff(i) <= v <
+///   cutoff(i+1), so callers computing the cutoffs the same way will
+///   agree with the binning at the bin boundaries.
+///   NaN values are not placed in any bin (returns -1).
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+struct eavlUniformBinFunctor
+{
+    float lo, hi, size;
+    int   nbins;
+    eavlUniformBinFunctor(float l, float h, int n)
+        : lo(l), hi(h), size(h-l), nbins(n)
+    {
+    }
+    EAVL_FUNCTOR float cutoff(int i) const
+    {
+        // lo + size need not round to hi
+        if (i == nbins)
+            return hi;
+        return lo + size * float(i) / float(nbins);
+    }
+    EAVL_FUNCTOR int operator()(float v) const
+    {
+        if (v != v)
+            return -1;
+        int bin = 0;
+        if (size > 0)
+        {
+            float fbin = float(nbins) * (v - lo) / size;
+            if (fbin >= float(nbins))
+                bin = nbins - 1;
+            else if (fbin > 0)
+                bin = int(fbin);
+        }
+        // the estimate can be off by one at the bin boundaries
+        while (bin > 0 && v < cutoff(bin))
+            --bin;
+        while (bin < nbins-1 && v >= cutoff(bin+1))
+            ++bin;
+        return bin;
+    }
+};
+
+#ifndef DOXYGEN
+
+struct eavlHistogramBins
+{
+    int   nbins;
+    int  *counts;
+    eavlHistogramBins(int n, int *c) : nbins(n), counts(c) { }
+};
+
+struct eavlValueRange
+{
+    float minval;
+    float maxval;
+};
+
+struct eavlRangeOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN>
+    static void call(int nitems, eavlValueRange &range,
+                     const IN inputs, F &)
+    {
+        float gmin = +FLT_MAX;
+        float gmax = -FLT_MAX;
+#pragma omp parallel
+        {
+            float lmin = +FLT_MAX;
+            float lmax = -FLT_MAX;
+#pragma omp for nowait
+            for (int index = 0; index < nitems; ++index)
+            {
+                float v = get<0>(collect(index, inputs));
+                if (v < lmin)
+                    lmin = v;
+                if (v > lmax)
+                    lmax = v;
+            }
+#pragma omp critical
+            {
+                if (lmin < gmin)
+                    gmin = lmin;
+                if (lmax > gmax)
+                    gmax = lmax;
+            }
+        }
+        range.minval = gmin;
+        range.maxval = gmax;
+    }
+};
+
+struct eavlHistogramOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN>
+    static void call(int nitems, eavlHistogramBins &bins,
+                     const IN inputs, F &functor)
+    {
+        int nbins = bins.nbins;
+        int *counts = bins.counts;
+        for (int b = 0; b < nbins; ++b)
+            counts[b] = 0;
+
+        // every thread counts into its own private bins, and the
+        // private bins are merged at the end, so no atomics are needed
+#pragma omp parallel
+        {
+            vector<int> localcounts(nbins, 0);
+#pragma omp for nowait
+            for (int index = 0; index < nitems; ++index)
+            {
+                int bin = functor(get<0>(collect(index, inputs)));
+                if (bin >= 0)
+                    ++localcounts[bin];
+            }
+#pragma omp critical
+            {
+                for (int b = 0; b < nbins; ++b)
+                    counts[b] += localcounts[b];
+            }
+        }
+    }
+};
+
+#if defined __CUDACC__
+
+template <class IN>
+__global__ void
+eavlRangeOp_kernel(int nitems, const IN inputs,
+                   float *blockmins, float *blockmaxs)
+{
+    __shared__ float smin[256];
+    __shared__ float smax[256];
+
+    const int numThreads = blockDim.x * gridDim.x;
+    const int threadID   = blockIdx.x * blockDim.x + threadIdx.x;
+    float lmin = +FLT_MAX;
+    float lmax = -FLT_MAX;
+    for (int index = threadID; index < nitems; index += numThreads)
+    {
+        float v = get<0>(collect(index, inputs));
+        lmin = (v < lmin) ? v : lmin;
+        lmax = (v > lmax) ? v : lmax;
+    }
+    smin[threadIdx.x] = lmin;
+    smax[threadIdx.x] = lmax;
+    __syncthreads();
+
+    for (int s = blockDim.x/2; s > 0; s >>= 1)
+    {
+        if (threadIdx.x < s)
+        {
+            float a = smin[threadIdx.x + s];
+            float b = smax[threadIdx.x + s];
+            smin[threadIdx.x] = (a < smin[threadIdx.x]) ? a : smin[threadIdx.x];
+            smax[threadIdx.x] = (b > smax[threadIdx.x]) ? b : smax[threadIdx.x];
+        }
+        __syncthreads();
+    }
+
+    if (threadIdx.x == 0)
+    {
+        blockmins[blockIdx.x] = smin[0];
+        blockmaxs[blockIdx.x] = smax[0];
+    }
+}
+
+struct eavlRangeOp_GPU
+{
+    static inline eavlArray::Location location() { return eavlArray::DEVICE; }
+    template <class F, class IN>
+    static void call(int nitems, eavlValueRange &range,
+                     const IN inputs, F &)
+    {
+        const int numBlocks = 64;
+        const int numThreads = 256;
+
+        float *d_tmp;
+        cudaMalloc((void**)&d_tmp, 2 * numBlocks * sizeof(float));
+        CUDA_CHECK_ERROR();
+
+        eavlRangeOp_kernel<<< numBlocks, numThreads >>>(nitems, inputs,
+                                                       d_tmp,
+                                                       d_tmp + numBlocks);
+        CUDA_CHECK_ERROR();
+
+        float h_tmp[2 * numBlocks];
+        cudaMemcpy(h_tmp, d_tmp, 2 * numBlocks * sizeof(float),
+                   cudaMemcpyDeviceToHost);
+        cudaFree(d_tmp);
+        CUDA_CHECK_ERROR();
+
+        range.minval = +FLT_MAX;
+        range.maxval = -FLT_MAX;
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            if (h_tmp[b] < range.minval)
+                range.minval = h_tmp[b];
+            if (h_tmp[numBlocks + b] > range.maxval)
+                range.maxval = h_tmp[numBlocks + b];
+        }
+    }
+};
+
+template <bool SHARED, class F, class IN>
+__global__ void
+eavlHistogramOp_kernel(int nitems, const IN inputs,
+                       int nbins, int *counts, F functor)
+{
+    extern __shared__ int localcounts[];
+    if (SHARED)
+    {
+        for (int b = threadIdx.x; b < nbins; b += blockDim.x)
+            localcounts[b] = 0;
+        __syncthreads();
+    }
+
+    const int numThreads = blockDim.x * gridDim.x;
+    const int threadID   = blockIdx.x * blockDim.x + threadIdx.x;
+    for (int index = threadID; index < nitems; index += numThreads)
+    {
+        int bin = functor(get<0>(collect(index, inputs)));
+        if (bin >= 0)
+            atomicAdd(SHARED ? &localcounts[bin] : &counts[bin], 1);
+    }
+
+    if (SHARED)
+    {
+        __syncthreads();
+        for (int b = threadIdx.x; b < nbins; b += blockDim.x)
+        {
+            if (localcounts[b] > 0)
+                atomicAdd(&counts[b], localcounts[b]);
+        }
+    }
+}
+
+struct eavlHistogramOp_GPU
+{
+    static inline eavlArray::Location location() { return eavlArray::DEVICE; }
+    template <class F, class IN>
+    static void call(int nitems, eavlHistogramBins &bins,
+                     const IN inputs, F &functor)
+    {
+        int numThreads = 256;
+        dim3 threads(numThreads,   1, 1);
+        dim3 blocks (32,           1, 1);
+
+        cudaMemset(bins.counts, 0, bins.nbins * sizeof(int));
+        CUDA_CHECK_ERROR();
+
+        // privatize the bins per block in shared memory when they fit
+        int sharedbytes = bins.nbins * sizeof(int);
+        if (sharedbytes <= 16384)
+        {
+            eavlHistogramOp_kernel<true><<< blocks, threads, sharedbytes >>>
+                (nitems, inputs, bins.nbins, bins.counts, functor);
+        }
+        else
+        {
+            eavlHistogramOp_kernel<false><<< blocks, threads >>>
+                (nitems, inputs, bins.nbins, bins.counts, functor);
+        }
+        CUDA_CHECK_ERROR();
+    }
+};
+
+#endif
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlHistogramOp
+//
+// Purpose:
+///   Counts the values of a single input array into equally spaced bins,
+///   placing the per-bin counts in an output int array (the number of
+///   tuples in that array is the number of bins).  Every bin is filled
+///   in a single pass over the input using per-thread (or, on the GPU,
+///   per-block) private bins which are merged at the end.
+///
+///   The bin range is given as a two-tuple float array holding the
+///   minimum and maximum.  If findrange is set, the minimum and maximum
+///   are first discovered together in one fused pass and written to
+///   that array; otherwise, its existing contents are used.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class I>
+class eavlHistogramOp : public eavlOperation
+{
+  protected:
+    I               inputs;
+    eavlIntArray   *counts;
+    eavlFloatArray *range;
+    bool            findrange;
+    DummyFunctor    dummy;
+  public:
+    eavlHistogramOp(I i, eavlIntArray *c, eavlFloatArray *r, bool find)
+        : inputs(i), counts(c), range(r), findrange(find)
+    {
+        if (range->GetNumberOfTuples() != 2)
+            THROW(eavlException, "eavlHistogramOp expects a two-value range array");
+    }
+    virtual void GoCPU()
+    {
+        int n = inputs.first.length();
+        int nbins = counts->GetNumberOfTuples();
+        if (findrange)
+        {
+            eavlValueRange r;
+            eavlOpDispatch<eavlRangeOp_CPU>(n, r, inputs, dummy);
+            range->SetValue(0, r.minval);
+            range->SetValue(1, r.maxval);
+        }
+
+        eavlUniformBinFunctor binner(range->GetValue(0), range->GetValue(1),
+                                     nbins);
+        eavlHistogramBins bins(nbins, (int*)counts->GetHostArray());
+        eavlOpDispatch<eavlHistogramOp_CPU>(n, bins, inputs, binner);
+    }
+    virtual void GoGPU()
+    {
+#ifdef HAVE_CUDA
+        int n = inputs.first.length();
+        int nbins = counts->GetNumberOfTuples();
+        if (findrange)
+        {
+            eavlValueRange r;
+            eavlOpDispatch<eavlRangeOp_GPU>(n, r, inputs, dummy);
+            range->SetValue(0, r.minval);
+            range->SetValue(1, r.maxval);
+        }
+
+        eavlUniformBinFunctor binner(range->GetValue(0), range->GetValue(1),
+                                     nbins);
+        eavlHistogramBins bins(nbins, (int*)counts->GetCUDAArray());
+        eavlOpDispatch<eavlHistogramOp_GPU>(n, bins, inputs, binner);
+#else
+        THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
+#endif
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        out.push_back(eavlOperationArray(counts, eavlArrayIndexer()));
+        out.push_back(eavlOperationArray(range, eavlArrayIndexer()));
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class I>
+eavlHistogramOp<I> *new_eavlHistogramOp(I i, eavlIntArray *counts,
+                                        eavlFloatArray *range, bool findrange)
+{
+    return new eavlHistogramOp<I>(i, counts, range, findrange);
+}
+
+#endif
@@ -57,13 +57,43 @@ class eavlIndexable
         // div/mod.  (I'm not sure we could do it accurately
         // even if we wanted to....)
         int nvalues = array->GetNumberOfTuples() * array->GetNumberOfComponents();
-        return int((nvalues - indexer.add) / indexer.mul);
+        return int((nvalues - indexer.add + indexer.mul - 1) / indexer.mul);
     }
     virtual void Print(ostream &)
     {
     }
 };
 
+template <class T> struct eavlImplicitValue;
+
+// ****************************************************************************
+// Class:  eavlImplicitIndexable
+//
+// Purpose:
+///   What an operation's kernel is handed in place of a raw pointer for
+///   an implicit array: the array's portal, by value, whose operator[]
+///   computes the value at a flat index.  Values collected from it are
+///   held by value rather than by reference (see eavlImplicitValue), so
+///   it can only be an input.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class P>
+class eavlImplicitIndexable
+{
+  public:
+    typedef eavlImplicitValue<typename P::type> type;
+    P array;
+    eavlArrayIndexer indexer;
+    eavlImplicitIndexable(const P &p, eavlArrayIndexer ind)
+        : array(p), indexer(ind)
+    {
+    }
+};
+
 template <class T>
 struct make_indexable_class
 {
@@ -32,6 +32,20 @@ struct eavlMapOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor has fused this
+// map with its neighbors and is already running them in parallel chunks
+struct eavlMapOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT>
+    static void call(int end, int begin, const IN inputs, OUT outputs, F &functor)
+    {
+        for (int index = begin; index < end; ++index)
+        {
+            collect(index, outputs) = functor(collect(index, inputs));
+        }
+    }
+};
 
 #if defined __CUDACC__
 
@@ -72,6 +86,8 @@ struct eavlMapOp_GPU
 // Purpose:
 ///   A simple operation which takes one set of input arrays, applies a functor
 ///   to them, and places the results matching locations in the output arrays.
+///   As this is element-wise, the executor may fuse consecutive map
+///   operations into a single pass over the data.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    July 25, 2013
@@ -105,6 +121,21 @@ class eavlMapOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual int GetElementwiseLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlOpDispatch<eavlMapOp_CPU_Range>(end, begin, inputs, outputs, functor);
+    }
 };
 
 // helper function for type deduction
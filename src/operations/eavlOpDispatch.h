@@ -6,6 +6,7 @@
 #include "eavlTuple.h"
 #include "eavlIndexable.h"
 #include "eavlTupleTraits.h"
+#include "eavlImplicitArray.h"
 
 // ****************************************************************************
 // Function:  eavlOpDispatch
@@ -23,13 +24,69 @@
 ///   create a version for the known-at-compile-time base type.  So
 ///   try to pass in concrete eavlArrays when possible to minimize the
 ///   multiplicity of paths needed to be generated.
+///
+///   Implicit arrays have no values to point to; when passed as their
+///   own type, the kernel is handed their portal instead (see
+///   eavlRawIndexable), and computes their values as it reads them.
+///   Passed as the eavlArray base class, they are read from the copy
+///   of their values they expand on first use.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  1, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Hand kernels the portals of implicit arrays.
+//
+//   agent, October 17, 2026
+//   Take raw pointers with the read-only accessors.
+//
+//   agent, October 17, 2026
+//   Read implicit arrays passed as eavlArray from their expanded values.
+//
 // ****************************************************************************
 
+// how an input or output array of type A is handed to a kernel:
+// a raw pointer to its host or device values, by default.  Inputs and
+// outputs look alike here, so every pointer is taken with the read-only
+// accessor, which keeps an input's cached ranges; the executor marks
+// the operation's outputs as written (see eavlOperation::GetArrays).
+template <class A>
+struct eavlRawIndexable
+{
+    typedef eavlIndexable<typename A::type> type;
+    static inline type get(A *a, const eavlArrayIndexer &indexer,
+                           eavlArray::Location loc)
+    {
+        return type((typename A::type*)a->GetConstRawPointer(loc), indexer);
+    }
+};
+
+// and its portal, for an implicit array
+template <class A>
+struct eavlRawImplicitIndexable
+{
+    typedef eavlImplicitIndexable<typename A::portal_type> type;
+    static inline type get(A *a, const eavlArrayIndexer &indexer,
+                           eavlArray::Location loc)
+    {
+        return type(a->GetPortal(loc), indexer);
+    }
+};
+
+template <class T>
+struct eavlRawIndexable<eavlConstantArray<T> >
+    : public eavlRawImplicitIndexable<eavlConstantArray<T> > { };
+template <class T>
+struct eavlRawIndexable<eavlCountingArray<T> >
+    : public eavlRawImplicitIndexable<eavlCountingArray<T> > { };
+template <class T>
+struct eavlRawIndexable<eavlUniformArray<T> >
+    : public eavlRawImplicitIndexable<eavlUniformArray<T> > { };
+template <class T>
+struct eavlRawIndexable<eavlCartesianProductArray<T> >
+    : public eavlRawImplicitIndexable<eavlCartesianProductArray<T> > { };
+
 // utilities for reversing a tuple
 // (the dispatch process reverses the input arrays,
 // so we want to reverse them back before handing
@@ -252,11 +309,10 @@ struct dispatchclassgetrawptr
                    RZ3 ptrs3,
                    F &functor)
     {
-        typedef typename Z0F::type::type rawtype;
-        rawtype *raw = (rawtype*)((K::location()==eavlArray::HOST) ? args0.first.array->GetHostArray() : args0.first.array->GetCUDAArray());
-        typedef cons<eavlIndexable<rawtype>, RZ0> newp;
+        typedef eavlRawIndexable<typename Z0F::type> rawclass;
+        typedef cons<typename rawclass::type, RZ0> newp;
         dispatchclass_dropfirst<N, K, S, Z0F, Z0R, Z1F, Z1R, Z2F, Z2R, Z3F, Z3R, newp, RZ1, RZ2, RZ3, F>
-            ::go(n, structure, args0, args1, args2, args3, newp(eavlIndexable<rawtype>(raw, args0.first.indexer), ptrs0), ptrs1, ptrs2, ptrs3, functor);
+            ::go(n, structure, args0, args1, args2, args3, newp(rawclass::get(args0.first.array, args0.first.indexer, K::location()), ptrs0), ptrs1, ptrs2, ptrs3, functor);
     }
 };
 
@@ -286,18 +342,25 @@ struct dispatchclassgetrawptr<N, K, S, eavlIndexable<eavlArray>, Z0R, Z1F, Z1R,
                    RZ3 ptrs3,
                    F &functor)
     {
-        eavlConcreteArray<int> *ai = dynamic_cast<eavlConcreteArray<int>*>(args0.first.array);
-        eavlConcreteArray<float> *af = dynamic_cast<eavlConcreteArray<float>*>(args0.first.array);
+        // an implicit array is read from its expanded values
+        eavlArray *a = args0.first.array;
+        bool ai = dynamic_cast<eavlConcreteArray<int>*>(a) != NULL;
+        bool af = dynamic_cast<eavlConcreteArray<float>*>(a) != NULL;
+        if (dynamic_cast<eavlImplicitArray*>(a))
+        {
+            ai = (string(a->GetBasicType()) == "int");
+            af = (string(a->GetBasicType()) == "float");
+        }
         if (ai)
         {
-            int *raw = (int*)((K::location()==eavlArray::HOST) ? ai->GetHostArray() : ai->GetCUDAArray());
+            int *raw = (int*)a->GetConstRawPointer(K::location());
             typedef cons<eavlIndexable<int>, RZ0> newp;
             dispatchclass_dropfirst<N, K, S, eavlIndexable<eavlArray>, Z0R, Z1F, Z1R, Z2F, Z2R, Z3F, Z3R, newp, RZ1, RZ2, RZ3, F>
                 ::go(n, structure, args0, args1, args2, args3, newp(eavlIndexable<int>(raw,args0.first.indexer), ptrs0), ptrs1, ptrs2, ptrs3, functor);
         }
         if (af)
         {
-            float *raw = (float*)((K::location()==eavlArray::HOST) ? af->GetHostArray() : af->GetCUDAArray());
+            float *raw = (float*)a->GetConstRawPointer(K::location());
             typedef cons<eavlIndexable<float>,RZ0> newp;
             dispatchclass_dropfirst<N, K, S, eavlIndexable<eavlArray>, Z0R, Z1F, Z1R, Z2F, Z2R, Z3F, Z3R, newp, RZ1, RZ2, RZ3, F>
                 ::go(n, structure, args0, args1, args2, args3, newp(eavlIndexable<float>(raw,args0.first.indexer), ptrs0), ptrs1, ptrs2, ptrs3, functor);
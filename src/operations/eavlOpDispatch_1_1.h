@@ -67,17 +67,17 @@ void eavlDispatch_1_1(int n, eavlArray::Location loc,
 
     if (i0_f)
         eavlDispatch_1_1_stage2<K>(n, loc, structure,
-                                    (float*)i0_f->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                    (float*)i0_f->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                     o0, o0mul, o0add,
                                     functor);
     else if (i0_b)
         eavlDispatch_1_1_stage2<K>(n, loc, structure, 
-                                    (byte*)i0_b->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                    (byte*)i0_b->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                     o0, o0mul, o0add,
                                     functor);
     else if (i0_i)
         eavlDispatch_1_1_stage2<K>(n, loc, structure,
-                                    (int*)i0_i->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                    (int*)i0_i->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                     o0, o0mul, o0add,
                                     functor);
     else
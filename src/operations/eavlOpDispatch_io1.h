@@ -2,6 +2,7 @@
 #ifndef EAVL_OP_DISPATCH_IO1_H
 #define EAVL_OP_DISPATCH_IO1_H
 #include "eavlException.h"
+#include "eavlImplicitArray.h"
 
 // ----------------------------------------------------------------------------
 
@@ -29,9 +30,13 @@ void eavlDispatch_io1(int n, eavlArray::Location loc,
                       eavlArray *o0, int o0mul, int o0add,
                       F &functor)
 {
-    eavlFloatArray  *i0_f = dynamic_cast<eavlFloatArray*>(i0);
-    eavlByteArray   *i0_b = dynamic_cast<eavlByteArray*>(i0);
-    eavlIntArray    *i0_i = dynamic_cast<eavlIntArray*>(i0);
+    // an implicit input is read from its expanded values
+    string implicit;
+    if (dynamic_cast<eavlImplicitArray*>(i0))
+        implicit = i0->GetBasicType();
+    bool i0_f = dynamic_cast<eavlFloatArray*>(i0) || implicit == "float";
+    bool i0_b = dynamic_cast<eavlByteArray*>(i0) || implicit == "byte";
+    bool i0_i = dynamic_cast<eavlIntArray*>(i0) || implicit == "int";
 
     eavlFloatArray  *o0_f = dynamic_cast<eavlFloatArray*>(o0);
     eavlByteArray   *o0_b = dynamic_cast<eavlByteArray*>(o0);
@@ -45,17 +50,17 @@ void eavlDispatch_io1(int n, eavlArray::Location loc,
 
     if (i0_f)
         eavlDispatch_io1_final<K>(n, loc, structure,
-                                  (float*)i0_f->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                  (float*)i0->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                   (float*)o0_f->GetRawPointer(loc), o0mul, o0add,
                                   functor);
     else if (i0_b)
         eavlDispatch_io1_final<K>(n, loc, structure, 
-                                  (byte*)i0_b->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                  (byte*)i0->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                   (byte*)o0_b->GetRawPointer(loc), o0mul, o0add,
                                   functor);
     else if (i0_i)
         eavlDispatch_io1_final<K>(n, loc, structure,
-                                  (int*)i0_i->GetRawPointer(loc), i0div, i0mod, i0mul, i0add,
+                                  (int*)i0->GetConstRawPointer(loc), i0div, i0mod, i0mul, i0add,
                                   (int*)o0_i->GetRawPointer(loc), o0mul, o0add,
                                   functor);
     else
@@ -5,33 +5,233 @@
 #include "eavlOperation.h"
 #include "eavlArray.h"
 #include "eavlOpDispatch_io1.h"
+#include "eavlThreadPool.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
 
 #ifndef DOXYGEN
 
 template <class F,
           class IO0>
-struct cpuPrefixSumOp_1_function
+struct cpuPrefixSumOp_1_serial
 {
     static void call(int n, bool &inclusive,
                      IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
                      IO0 *o0, int o0mul, int o0add,
                      F &functor)
     {
+        // read each input value before writing the output at the same
+        // location, so that this is also safe to call in-place
+        IO0 sum = 0;
         if (inclusive)
         {
-            o0[0*o0mul+o0add] = i0[((0/i0div)%i0mod)*i0mul+i0add];
-            for (int i=1; i<n; ++i)
-                o0[i*o0mul+o0add] = o0[(i-1)*o0mul+o0add] + i0[((i/i0div)%i0mod)*i0mul+i0add];
+            for (int i=0; i<n; ++i)
+            {
+                sum += i0[((i/i0div)%i0mod)*i0mul+i0add];
+                o0[i*o0mul+o0add] = sum;
+            }
         }
         else
         {
-            o0[0*o0mul+o0add] = 0;
-            for (int i=1; i<n; ++i)
-                o0[i*o0mul+o0add] = o0[(i-1)*o0mul+o0add] + i0[(((i-1)/i0div)%i0mod)*i0mul+i0add];
+            for (int i=0; i<n; ++i)
+            {
+                IO0 val = i0[((i/i0div)%i0mod)*i0mul+i0add];
+                o0[i*o0mul+o0add] = sum;
+                sum += val;
+            }
         }
     }
 };
 
+// below this many values, the fork/join overhead outweighs the benefit
+#define EAVL_PREFIX_SUM_MIN_PARALLEL_VALUES 32768
+
+// the number of values each block of a prefix sum on the thread pool
+// holds when no grain size is given
+#define EAVL_PREFIX_SUM_BLOCK_SIZE 16384
+
+// what the host prefix sum is told: whether it is inclusive, and how
+// to run its loops
+struct cpuPrefixSumOp_1_settings
+{
+    bool         inclusive;
+    eavlCPULoops loops;
+    cpuPrefixSumOp_1_settings(bool incl, const eavlCPULoops &l)
+        : inclusive(incl), loops(l)
+    {
+    }
+};
+
+// The two passes of a blocked reduce-then-scan over blocks [begin,end)
+// of the values: the first sums each block b into blocksums[b+1], and
+// the second (once those are scanned) scans each block again starting
+// from blocksums[b].
+template <class IO0>
+struct cpuPrefixSumOp_1_blocks : public eavlThreadPool::Body
+{
+    int n, blocksize;
+    bool inclusive;
+    bool scan;
+    IO0 *i0;
+    int i0div, i0mod, i0mul, i0add;
+    IO0 *o0;
+    int o0mul, o0add;
+    vector<IO0> &blocksums;
+    cpuPrefixSumOp_1_blocks(int n_, int blocksize_, bool inclusive_,
+                            IO0 *i0_, int i0div_, int i0mod_, int i0mul_, int i0add_,
+                            IO0 *o0_, int o0mul_, int o0add_,
+                            vector<IO0> &blocksums_)
+        : n(n_), blocksize(blocksize_), inclusive(inclusive_), scan(false),
+          i0(i0_), i0div(i0div_), i0mod(i0mod_), i0mul(i0mul_), i0add(i0add_),
+          o0(o0_), o0mul(o0mul_), o0add(o0add_), blocksums(blocksums_)
+    {
+    }
+    virtual void operator()(int begin, int end)
+    {
+        for (int b=begin; b<end; ++b)
+        {
+            int start = b * blocksize;
+            int last = (n - start > blocksize) ? start + blocksize : n;
+            if (!scan)
+            {
+                IO0 sum = 0;
+                for (int i=start; i<last; ++i)
+                    sum += i0[((i/i0div)%i0mod)*i0mul+i0add];
+                blocksums[b+1] = sum;
+            }
+            else if (inclusive)
+            {
+                IO0 sum = blocksums[b];
+                for (int i=start; i<last; ++i)
+                {
+                    sum += i0[((i/i0div)%i0mod)*i0mul+i0add];
+                    o0[i*o0mul+o0add] = sum;
+                }
+            }
+            else
+            {
+                IO0 sum = blocksums[b];
+                for (int i=start; i<last; ++i)
+                {
+                    IO0 val = i0[((i/i0div)%i0mod)*i0mul+i0add];
+                    o0[i*o0mul+o0add] = sum;
+                    sum += val;
+                }
+            }
+        }
+    }
+};
+
+template <class F,
+          class IO0>
+struct cpuPrefixSumOp_1_function
+{
+    static void call(int n, cpuPrefixSumOp_1_settings &settings,
+                     IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
+                     IO0 *o0, int o0mul, int o0add,
+                     F &functor)
+    {
+        bool incl = settings.inclusive;
+        if (settings.loops.threadPool)
+        {
+            if (eavlThreadPool::GetNumberOfThreads() < 2 ||
+                n < EAVL_PREFIX_SUM_MIN_PARALLEL_VALUES)
+            {
+                cpuPrefixSumOp_1_serial<F,IO0>::call(n, incl,
+                                                     i0, i0div, i0mod, i0mul, i0add,
+                                                     o0, o0mul, o0add,
+                                                     functor);
+                return;
+            }
+
+            // The same reduce-then-scan as below, but over blocks of a
+            // fixed size, which the pool balances across its threads.
+            int blocksize = (settings.loops.grainSize > 0)
+                              ? settings.loops.grainSize
+                              : EAVL_PREFIX_SUM_BLOCK_SIZE;
+            int nblocks = (n - 1) / blocksize + 1;
+            vector<IO0> blocksums(nblocks + 1, IO0(0));
+            cpuPrefixSumOp_1_blocks<IO0> body(n, blocksize, incl,
+                                              i0, i0div, i0mod, i0mul, i0add,
+                                              o0, o0mul, o0add,
+                                              blocksums);
+            eavlThreadPool::ParallelFor(nblocks, 1, body);
+            for (int b=1; b<=nblocks; ++b)
+                blocksums[b] += blocksums[b-1];
+            body.scan = true;
+            eavlThreadPool::ParallelFor(nblocks, 1, body);
+            return;
+        }
+
+#ifdef HAVE_OPENMP
+        int maxthreads = omp_get_max_threads();
+        if (maxthreads < 2 || n < EAVL_PREFIX_SUM_MIN_PARALLEL_VALUES)
+        {
+            cpuPrefixSumOp_1_serial<F,IO0>::call(n, incl,
+                                                 i0, i0div, i0mod, i0mul, i0add,
+                                                 o0, o0mul, o0add,
+                                                 functor);
+            return;
+        }
+
+        // Blocked reduce-then-scan: each thread sums one contiguous
+        // chunk, the per-chunk sums are scanned serially, and then each
+        // thread scans its chunk again starting from its chunk offset.
+        vector<IO0> chunksums(maxthreads + 1, IO0(0));
+#pragma omp parallel default(none) shared(chunksums,n,incl,i0,i0div,i0mod,i0mul,i0add,o0,o0mul,o0add)
+        {
+            int nthreads = omp_get_num_threads();
+            int threadid = omp_get_thread_num();
+            int chunksize = (n + nthreads - 1) / nthreads;
+            int start = threadid * chunksize;
+            int end   = start + chunksize;
+            if (start > n)
+                start = n;
+            if (end > n)
+                end = n;
+
+            IO0 sum = 0;
+            for (int i=start; i<end; ++i)
+                sum += i0[((i/i0div)%i0mod)*i0mul+i0add];
+            chunksums[threadid+1] = sum;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                for (int t=1; t<=nthreads; ++t)
+                    chunksums[t] += chunksums[t-1];
+            }
+            // (implicit barrier at the end of the single)
+
+            sum = chunksums[threadid];
+            if (incl)
+            {
+                for (int i=start; i<end; ++i)
+                {
+                    sum += i0[((i/i0div)%i0mod)*i0mul+i0add];
+                    o0[i*o0mul+o0add] = sum;
+                }
+            }
+            else
+            {
+                for (int i=start; i<end; ++i)
+                {
+                    IO0 val = i0[((i/i0div)%i0mod)*i0mul+i0add];
+                    o0[i*o0mul+o0add] = sum;
+                    sum += val;
+                }
+            }
+        }
+#else
+        cpuPrefixSumOp_1_serial<F,IO0>::call(n, incl,
+                                             i0, i0div, i0mod, i0mul, i0add,
+                                             o0, o0mul, o0add,
+                                             functor);
+#endif
+    }
+};
+
 
 #if defined __CUDACC__
 
@@ -326,11 +526,18 @@ struct gpuPrefixSumOp_1_function
 // Purpose:
 ///   A standard prefix sum operation, either inclusive or exclusive, on
 ///   a single input array, placing the result in a single output array.
+///   The CPU version uses a blocked reduce-then-scan across threads
+///   when OpenMP is available, or when the executor runs it on its
+///   thread pool.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    April 1, 2012
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Scan blocks of the values on the executor's thread pool when it
+//   runs this.
+//
 // ****************************************************************************
 class eavlPrefixSumOp_1 : public eavlOperation
 {
@@ -352,7 +559,8 @@ class eavlPrefixSumOp_1 : public eavlOperation
         if (n == 0)
             return;
 
-        eavlDispatch_io1<cpuPrefixSumOp_1_function>(n, eavlArray::HOST, inclusive,
+        cpuPrefixSumOp_1_settings settings(inclusive, cpuLoops);
+        eavlDispatch_io1<cpuPrefixSumOp_1_function>(n, eavlArray::HOST, settings,
                      inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
                      outArray0.array, outArray0.mul, outArray0.add,
                      functor);
@@ -372,6 +580,13 @@ class eavlPrefixSumOp_1 : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inArray0, in);
+        eavlAddOperationArrays(outArray0, out);
+        return true;
+    }
 };
 
 #endif
@@ -0,0 +1,177 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_REDUCE_BY_KEY_OP_H
+#define EAVL_REDUCE_BY_KEY_OP_H
+
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlOpDispatch.h"
+#include "eavlOperation.h"
+#include "eavlException.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN
+
+// below this many keys, the fork/join overhead outweighs the benefit
+#define EAVL_REDUCE_BY_KEY_MIN_PARALLEL_VALUES 32768
+
+struct eavlReduceByKeyOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class KEYSIN, class VALSIN, class KEYSOUT, class VALSOUT>
+    static void call(int n, int &nout,
+                     const KEYSIN keysin, const VALSIN valsin,
+                     KEYSOUT keysout, VALSOUT valsout, F &functor)
+    {
+        typedef typename KEYSIN::firsttype::type K;
+        typedef typename VALSIN::firsttype::type V;
+        const K *ki = keysin.first.array;
+        const V *vi = valsin.first.array;
+        eavlArrayIndexer kidx = keysin.first.indexer;
+        eavlArrayIndexer vidx = valsin.first.indexer;
+
+        // Each thread counts the runs which start in its contiguous
+        // chunk, the counts are scanned to give each thread its first
+        // output, and then each thread reduces its runs, following the
+        // last one past the end of its chunk if need be.
+        int maxthreads = 1;
+#ifdef HAVE_OPENMP
+        maxthreads = omp_get_max_threads();
+#endif
+        vector<int> offsets(maxthreads + 1, 0);
+
+#pragma omp parallel if (n >= EAVL_REDUCE_BY_KEY_MIN_PARALLEL_VALUES)
+        {
+            int nthreads = 1;
+            int threadid = 0;
+#ifdef HAVE_OPENMP
+            nthreads = omp_get_num_threads();
+            threadid = omp_get_thread_num();
+#endif
+            int chunksize = (n + nthreads - 1) / nthreads;
+            int start = threadid * chunksize;
+            int end   = start + chunksize;
+            if (start > n)
+                start = n;
+            if (end > n)
+                end = n;
+
+            int nruns = 0;
+            for (int i = start; i < end; ++i)
+            {
+                if (i == 0 || ki[kidx.index(i)] != ki[kidx.index(i-1)])
+                    ++nruns;
+            }
+            offsets[threadid+1] = nruns;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                for (int t = 1; t <= nthreads; ++t)
+                    offsets[t] += offsets[t-1];
+                nout = offsets[nthreads];
+            }
+            // (implicit barrier at the end of the single)
+
+            int j = offsets[threadid];
+            int i = start;
+            // skip the end of a run which started in an earlier chunk
+            while (i > 0 && i < end && ki[kidx.index(i)] == ki[kidx.index(i-1)])
+                ++i;
+            while (i < end)
+            {
+                K key = ki[kidx.index(i)];
+                V sum = vi[vidx.index(i)];
+                for (++i; i < n && ki[kidx.index(i)] == key; ++i)
+                    sum = functor(sum, vi[vidx.index(i)]);
+                get<0>(keysout).array[get<0>(keysout).indexer.index(j)] = key;
+                get<0>(valsout).array[get<0>(valsout).indexer.index(j)] = sum;
+                ++j;
+            }
+        }
+    }
+};
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlReduceByKeyOp
+//
+// Purpose:
+///   Reduces each run of equal consecutive keys in a single key array to
+///   one key, with the reduction of the corresponding values in a single
+///   value array by a 2-input functor, which must be associative.  The
+///   i'th run's key and value are placed at index i of the output arrays,
+///   which must have room for as many runs as there might be, and the
+///   number of runs at the first index of the (int) count array.  The
+///   outputs must not be the inputs.  Keys which are not consecutive are
+///   not combined, so sort them first (e.g. with eavlSortByKeyOp) to
+///   reduce over all equal keys.  There is not yet a GPU version.
+///   Example:
+///               keys   : [1 1 2 3 3 3]
+///               values : [1 2 3 4 5 6]
+///       with eavlAddFunctor,
+///        reduced keys  : [1 2 3]
+///        reduced values: [3 3 15]
+///               count  : [3]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class KI, class VI, class KO, class VO, class F>
+class eavlReduceByKeyOp : public eavlOperation
+{
+  protected:
+    KI           keysin;
+    VI           valsin;
+    KO           keysout;
+    VO           valsout;
+    eavlArrayWithLinearIndex count;
+    F            functor;
+  public:
+    eavlReduceByKeyOp(KI ki, VI vi, KO ko, VO vo,
+                      eavlArrayWithLinearIndex c, F f)
+        : keysin(ki), valsin(vi), keysout(ko), valsout(vo),
+          count(c), functor(f)
+    {
+    }
+    virtual void GoCPU()
+    {
+        eavlIntArray *countarray = dynamic_cast<eavlIntArray*>(count.array);
+        if (!countarray)
+            THROW(eavlException,"eavlReduceByKeyOp expects an int array for the count.");
+
+        int n = keysin.first.length();
+        int nout = 0;
+        eavlOpDispatch<eavlReduceByKeyOp_CPU>(n, nout, keysin, valsin, keysout, valsout, functor);
+        ((int*)countarray->GetHostArray())[count.add] = nout;
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"eavlReduceByKeyOp is not yet implemented on the GPU.");
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(keysin, in);
+        eavlAddOperationArrays(valsin, in);
+        eavlAddOperationArrays(keysout, out);
+        eavlAddOperationArrays(valsout, out);
+        eavlAddOperationArrays(count, out);
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class KI, class VI, class KO, class VO, class F>
+eavlReduceByKeyOp<KI,VI,KO,VO,F> *new_eavlReduceByKeyOp(KI ki, VI vi, KO ko, VO vo,
+                                                        eavlArrayWithLinearIndex c,
+                                                        F f)
+{
+    return new eavlReduceByKeyOp<KI,VI,KO,VO,F>(ki,vi,ko,vo,c,f);
+}
+
+#endif
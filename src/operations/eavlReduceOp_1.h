@@ -6,90 +6,389 @@
 #include "eavlArray.h"
 #include "eavlOpDispatch_io1.h"
 #include "eavlTimer.h"
+#include "eavlThreadPool.h"
 #ifdef HAVE_OPENMP
 #include <omp.h>
 #endif
 
 #ifndef DOXYGEN
 
-#ifdef HAVE_OPENMP
+// reduces the values at indices [begin,end) of i0, which must not be
+// empty.  When the index is just a stride and offset, four independent
+// accumulators run over the contiguous range, so the loop pipelines
+// (and, for unit strides, vectorizes) instead of waiting on one chain.
+template <class F, class IO0>
+inline IO0 cpuReduceOp_1_range(int begin, int end,
+                               const IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
+                               F &functor)
+{
+    if (i0div == 1 && i0mod >= end)
+    {
+        const IO0 *p = i0 + i0add;
+        int s = i0mul;
+        if (end - begin >= 8)
+        {
+            IO0 a0 = p[(begin+0)*s];
+            IO0 a1 = p[(begin+1)*s];
+            IO0 a2 = p[(begin+2)*s];
+            IO0 a3 = p[(begin+3)*s];
+            int i = begin + 4;
+            for ( ; i+4 <= end; i += 4)
+            {
+                a0 = functor(p[(i+0)*s], a0);
+                a1 = functor(p[(i+1)*s], a1);
+                a2 = functor(p[(i+2)*s], a2);
+                a3 = functor(p[(i+3)*s], a3);
+            }
+            for ( ; i < end; ++i)
+                a0 = functor(p[i*s], a0);
+            return functor(functor(a3, a2), functor(a1, a0));
+        }
+        IO0 a = p[begin*s];
+        for (int i=begin+1; i<end; ++i)
+            a = functor(p[i*s], a);
+        return a;
+    }
+
+    IO0 a = i0[((begin / i0div) % i0mod) * i0mul + i0add];
+    for (int i=begin+1; i<end; ++i)
+    {
+        int index_i0 = ((i / i0div) % i0mod) * i0mul + i0add;
+        a = functor(i0[index_i0], a);
+    }
+    return a;
+}
+
+// the number of values each block of a reduction on the thread pool
+// holds when no grain size is given
+#define EAVL_REDUCE_BLOCK_SIZE 16384
+
+// reduces blocks [begin,end) of the input into partial[begin,end)
+template <class F, class IO0>
+struct cpuReduceOp_1_blocks : public eavlThreadPool::Body
+{
+    int n, blocksize;
+    const IO0 *i0;
+    int i0div, i0mod, i0mul, i0add;
+    F &functor;
+    vector<IO0> &partial;
+    cpuReduceOp_1_blocks(int n_, int blocksize_,
+                         const IO0 *i0_, int i0div_, int i0mod_, int i0mul_, int i0add_,
+                         F &functor_, vector<IO0> &partial_)
+        : n(n_), blocksize(blocksize_),
+          i0(i0_), i0div(i0div_), i0mod(i0mod_), i0mul(i0mul_), i0add(i0add_),
+          functor(functor_), partial(partial_)
+    {
+    }
+    virtual void operator()(int begin, int end)
+    {
+        for (int b=begin; b<end; b++)
+        {
+            int last = (n - b*blocksize > blocksize) ? (b+1)*blocksize : n;
+            partial[b] = cpuReduceOp_1_range(b*blocksize, last,
+                                             i0, i0div, i0mod, i0mul, i0add,
+                                             functor);
+        }
+    }
+};
+
+// Each thread reduces its own contiguous chunk of the input, so no two
+// threads share a cache line except at the chunk boundaries.  The
+// chunks' results are then combined in thread order, which keeps the
+// result the same from run to run without any temporary storage.
+// On the thread pool, the chunks are instead blocks of a fixed size
+// (which threads may steal), combined in block order.
 template <class F,
           class IO0>
 struct cpuReduceOp_1_function
 {
-    static void call(int n, int &dummy,
+    static void call(int n, eavlCPULoops &loops,
                      IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
-                     IO0 *o0, int o0mul, int o0add,
+                     IO0 *o0, int, int o0add,
                      F &functor)
     {
         if (n == 0)
         {
-            *o0 = functor.identity();
+            o0[o0add] = functor.identity();
+            return;
+        }
+
+        if (loops.threadPool && n > 10000)
+        {
+            int blocksize = (loops.grainSize > 0) ? loops.grainSize
+                                                  : EAVL_REDUCE_BLOCK_SIZE;
+            int nblocks = (n - 1) / blocksize + 1;
+            vector<IO0> partial(nblocks);
+            cpuReduceOp_1_blocks<F,IO0> body(n, blocksize,
+                                             i0, i0div, i0mod, i0mul, i0add,
+                                             functor, partial);
+            eavlThreadPool::ParallelFor(nblocks, 1, body);
+            IO0 result = partial[0];
+            for (int b=1; b<nblocks; b++)
+                result = functor(partial[b], result);
+            o0[o0add] = result;
             return;
         }
 
-        IO0 *tmp = NULL;
-#pragma omp parallel default(none) shared(cerr,tmp,n,i0,i0div,i0mod,i0mul,i0add,o0,o0mul,o0add,functor)
+        IO0 result = IO0();
+        bool haveresult = false;
+#pragma omp parallel if (n > 10000)
         {
+#ifdef HAVE_OPENMP
             int nthreads = omp_get_num_threads();
             int threadid = omp_get_thread_num();
-#pragma omp single
-            {
-                tmp = new IO0[nthreads];
-                for (int i=0; i<nthreads; i++)
-                {
-                    int index_i0 = ((i / i0div) % i0mod) * i0mul + i0add;
-                    tmp[i] = i0[index_i0];
-                }
-            }
-#pragma omp barrier
-
-            // we might be able to change this to use a omp for directive,
-            // but if so, just do nthreads to n, not strided
-            for (int i=nthreads+threadid; i<n; i+=nthreads)
-            {
-                int index_i0 = ((i / i0div) % i0mod) * i0mul + i0add;
-                tmp[threadid] = functor(i0[index_i0], tmp[threadid]);
-            }
-#pragma omp barrier
+#else
+            int nthreads = 1;
+            int threadid = 0;
+#endif
+            int begin = int((long long)n * threadid / nthreads);
+            int end   = int((long long)n * (threadid+1) / nthreads);
+            IO0 local = IO0();
+            if (end > begin)
+                local = cpuReduceOp_1_range(begin, end,
+                                            i0, i0div, i0mod, i0mul, i0add,
+                                            functor);
 
-#pragma omp single
+#pragma omp for ordered schedule(static,1)
+            for (int t=0; t<nthreads; t++)
             {
-                *o0 = tmp[0];
-                for (int i=1; i<nthreads; i++)
+#pragma omp ordered
+                if (end > begin)
                 {
-                    *o0 = functor(tmp[i],*o0);
+                    result = haveresult ? functor(local, result) : local;
+                    haveresult = true;
                 }
             }
         }
-        delete[] tmp;
+        o0[o0add] = result;
     }
 };
-#else
-template <class F,
+
+// the number of functors in a tuple of them
+template <class FL>
+struct cpuMultiReduceOp_1_count
+{
+    enum values { length = 1 + cpuMultiReduceOp_1_count<typename FL::resttype>::length };
+};
+
+template <>
+struct cpuMultiReduceOp_1_count<nulltype>
+{
+    enum values { length = 0 };
+};
+
+// applies functor k of a tuple to value v and accumulator k
+template <class F, class R, class IO0>
+inline void cpuMultiReduceOp_1_apply(cons<F,R> &functors, IO0 *acc, IO0 v)
+{
+    acc[0] = functors.first(v, acc[0]);
+    cpuMultiReduceOp_1_apply(functors.rest, acc+1, v);
+}
+
+template <class F, class IO0>
+inline void cpuMultiReduceOp_1_apply(cons<F,nulltype> &functors, IO0 *acc, IO0 v)
+{
+    acc[0] = functors.first(v, acc[0]);
+}
+
+// combines accumulator k of another chunk into accumulator k
+template <class F, class R, class IO0>
+inline void cpuMultiReduceOp_1_combine(cons<F,R> &functors, IO0 *acc, const IO0 *other)
+{
+    acc[0] = functors.first(other[0], acc[0]);
+    cpuMultiReduceOp_1_combine(functors.rest, acc+1, other+1);
+}
+
+template <class F, class IO0>
+inline void cpuMultiReduceOp_1_combine(cons<F,nulltype> &functors, IO0 *acc, const IO0 *other)
+{
+    acc[0] = functors.first(other[0], acc[0]);
+}
+
+template <class F, class R, class IO0>
+inline void cpuMultiReduceOp_1_identity(cons<F,R> &functors, IO0 *out, int mul, int add)
+{
+    out[add] = functors.first.identity();
+    cpuMultiReduceOp_1_identity(functors.rest, out, mul, add + mul);
+}
+
+template <class F, class IO0>
+inline void cpuMultiReduceOp_1_identity(cons<F,nulltype> &functors, IO0 *out, int, int add)
+{
+    out[add] = functors.first.identity();
+}
+
+// four independent accumulators for each functor of a tuple, as
+// cpuReduceOp_1_range uses for one, held as separate members rather
+// than in an array so that once inlined they stay in registers
+template <class F, class R, class IO0>
+struct cpuMultiReduceOp_1_accumulators
+{
+    IO0 a0, a1, a2, a3;
+    cpuMultiReduceOp_1_accumulators<typename R::firsttype,
+                                    typename R::resttype, IO0> rest;
+
+    inline void init(IO0 v0, IO0 v1, IO0 v2, IO0 v3)
+    {
+        a0 = v0;
+        a1 = v1;
+        a2 = v2;
+        a3 = v3;
+        rest.init(v0, v1, v2, v3);
+    }
+    inline void apply(cons<F,R> &functors, IO0 v0, IO0 v1, IO0 v2, IO0 v3)
+    {
+        a0 = functors.first(v0, a0);
+        a1 = functors.first(v1, a1);
+        a2 = functors.first(v2, a2);
+        a3 = functors.first(v3, a3);
+        rest.apply(functors.rest, v0, v1, v2, v3);
+    }
+    inline void apply(cons<F,R> &functors, IO0 v)
+    {
+        a0 = functors.first(v, a0);
+        rest.apply(functors.rest, v);
+    }
+    inline void result(cons<F,R> &functors, IO0 *out)
+    {
+        out[0] = functors.first(functors.first(a3, a2),
+                                functors.first(a1, a0));
+        rest.result(functors.rest, out+1);
+    }
+};
+
+template <class F, class IO0>
+struct cpuMultiReduceOp_1_accumulators<F, nulltype, IO0>
+{
+    IO0 a0, a1, a2, a3;
+
+    inline void init(IO0 v0, IO0 v1, IO0 v2, IO0 v3)
+    {
+        a0 = v0;
+        a1 = v1;
+        a2 = v2;
+        a3 = v3;
+    }
+    inline void apply(cons<F,nulltype> &functors, IO0 v0, IO0 v1, IO0 v2, IO0 v3)
+    {
+        a0 = functors.first(v0, a0);
+        a1 = functors.first(v1, a1);
+        a2 = functors.first(v2, a2);
+        a3 = functors.first(v3, a3);
+    }
+    inline void apply(cons<F,nulltype> &functors, IO0 v)
+    {
+        a0 = functors.first(v, a0);
+    }
+    inline void result(cons<F,nulltype> &functors, IO0 *out)
+    {
+        out[0] = functors.first(functors.first(a3, a2),
+                                functors.first(a1, a0));
+    }
+};
+
+// reduces the values at indices [begin,end) of i0, which must not be
+// empty, with every functor of a tuple at once, into out.  As with
+// cpuReduceOp_1_range, a stride and offset index gets four
+// independent accumulators per functor.
+template <class FL, class IO0>
+inline void cpuMultiReduceOp_1_range(int begin, int end,
+                                     const IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
+                                     FL &functors, IO0 *out)
+{
+    enum values { nfunctors = cpuMultiReduceOp_1_count<FL>::length };
+    if (i0div == 1 && i0mod >= end)
+    {
+        const IO0 *p = i0 + i0add;
+        int s = i0mul;
+        if (end - begin >= 8)
+        {
+            cpuMultiReduceOp_1_accumulators<typename FL::firsttype,
+                                            typename FL::resttype, IO0> acc;
+            acc.init(p[(begin+0)*s], p[(begin+1)*s],
+                     p[(begin+2)*s], p[(begin+3)*s]);
+            int i = begin + 4;
+            for ( ; i+4 <= end; i += 4)
+                acc.apply(functors, p[(i+0)*s], p[(i+1)*s],
+                                    p[(i+2)*s], p[(i+3)*s]);
+            for ( ; i < end; ++i)
+                acc.apply(functors, p[i*s]);
+            acc.result(functors, out);
+            return;
+        }
+        for (int k=0; k<nfunctors; k++)
+            out[k] = p[begin*s];
+        for (int i=begin+1; i<end; ++i)
+            cpuMultiReduceOp_1_apply(functors, out, p[i*s]);
+        return;
+    }
+
+    IO0 v = i0[((begin / i0div) % i0mod) * i0mul + i0add];
+    for (int k=0; k<nfunctors; k++)
+        out[k] = v;
+    for (int i=begin+1; i<end; ++i)
+    {
+        int index_i0 = ((i / i0div) % i0mod) * i0mul + i0add;
+        cpuMultiReduceOp_1_apply(functors, out, i0[index_i0]);
+    }
+}
+
+// As cpuReduceOp_1_function, but with a tuple of functors reducing the
+// same values at once.
+template <class FL,
           class IO0>
-struct cpuReduceOp_1_function
+struct cpuMultiReduceOp_1_function
 {
-    static void call(int n, int &dummy,
+    enum values { nfunctors = cpuMultiReduceOp_1_count<FL>::length };
+    static void call(int n, int &,
                      IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
                      IO0 *o0, int o0mul, int o0add,
-                     F &functor)
+                     FL &functors)
     {
         if (n == 0)
         {
-            *o0 = functor.identity();
+            cpuMultiReduceOp_1_identity(functors, o0, o0mul, o0add);
             return;
         }
 
-        *o0 = *i0;
-        for (int i=1; i<n; i++)
+        IO0 result[nfunctors];
+        bool haveresult = false;
+#pragma omp parallel if (n > 10000)
         {
-            int index_i0 = ((i / i0div) % i0mod) * i0mul + i0add;
-            *o0 = functor(i0[index_i0], *o0);
+#ifdef HAVE_OPENMP
+            int nthreads = omp_get_num_threads();
+            int threadid = omp_get_thread_num();
+#else
+            int nthreads = 1;
+            int threadid = 0;
+#endif
+            int begin = int((long long)n * threadid / nthreads);
+            int end   = int((long long)n * (threadid+1) / nthreads);
+            IO0 local[nfunctors];
+            if (end > begin)
+                cpuMultiReduceOp_1_range(begin, end,
+                                         i0, i0div, i0mod, i0mul, i0add,
+                                         functors, local);
+
+#pragma omp for ordered schedule(static,1)
+            for (int t=0; t<nthreads; t++)
+            {
+#pragma omp ordered
+                if (end > begin)
+                {
+                    if (haveresult)
+                        cpuMultiReduceOp_1_combine(functors, result, local);
+                    else
+                        for (int k=0; k<nfunctors; k++)
+                            result[k] = local[k];
+                    haveresult = true;
+                }
+            }
         }
+        for (int k=0; k<nfunctors; k++)
+            o0[k*o0mul + o0add] = result[k];
     }
 };
-#endif
 
 #if defined __CUDACC__
 // Reduction Kernel
@@ -227,6 +526,47 @@ struct gpuReduceOp_1_function
     }
 };
 
+// the GPU reduces the values once per functor
+template <class F, class R, class IO0>
+inline void gpuMultiReduceOp_1_each(int n, IO0 *d_i0, int i0div, int i0mod, int i0mul, int i0add,
+                                    IO0 *d_o0, int o0mul, int o0add,
+                                    cons<F,R> &functors)
+{
+    int dummy;
+    gpuReduceOp_1_function<F,IO0>::call(n, dummy,
+                                        d_i0, i0div, i0mod, i0mul, i0add,
+                                        d_o0, o0mul, o0add,
+                                        functors.first);
+    gpuMultiReduceOp_1_each(n, d_i0, i0div, i0mod, i0mul, i0add,
+                            d_o0, o0mul, o0add + o0mul,
+                            functors.rest);
+}
+
+template <class F, class IO0>
+inline void gpuMultiReduceOp_1_each(int n, IO0 *d_i0, int i0div, int i0mod, int i0mul, int i0add,
+                                    IO0 *d_o0, int o0mul, int o0add,
+                                    cons<F,nulltype> &functors)
+{
+    int dummy;
+    gpuReduceOp_1_function<F,IO0>::call(n, dummy,
+                                        d_i0, i0div, i0mod, i0mul, i0add,
+                                        d_o0, o0mul, o0add,
+                                        functors.first);
+}
+
+template <class FL, class IO0>
+struct gpuMultiReduceOp_1_function
+{
+    static void call(int n, int &,
+                     IO0 *d_i0, int i0div, int i0mod, int i0mul, int i0add,
+                     IO0 *d_o0, int o0mul, int o0add,
+                     FL &functors)
+    {
+        gpuMultiReduceOp_1_each(n, d_i0, i0div, i0mod, i0mul, i0add,
+                                d_o0, o0mul, o0add, functors);
+    }
+};
+
 #endif
 
 #endif // DOXYGEN
@@ -243,6 +583,14 @@ struct gpuReduceOp_1_function
 // Creation:    April 13, 2012
 //
 // Modifications:
+//   agent, October 17, 2026
+//   On the host, each thread reduces a contiguous chunk of the input,
+//   and the chunks are combined in order without temporary storage.
+//   The result is written at the output's offset.
+//
+//   agent, October 17, 2026
+//   Reduce fixed blocks on the executor's thread pool when it runs this.
+//
 // ****************************************************************************
 template <class F>
 class eavlReduceOp_1 : public eavlOperation
@@ -262,8 +610,7 @@ class eavlReduceOp_1 : public eavlOperation
     {
         int n = inArray0.array->GetNumberOfTuples();
 
-        int dummy;
-        eavlDispatch_io1<cpuReduceOp_1_function>(n, eavlArray::HOST, dummy,
+        eavlDispatch_io1<cpuReduceOp_1_function>(n, eavlArray::HOST, cpuLoops,
                      inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
                      outArray0.array, outArray0.mul, outArray0.add,
                      functor);
@@ -282,7 +629,89 @@ class eavlReduceOp_1 : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inArray0, in);
+        eavlAddOperationArrays(outArray0, out);
+        return true;
+    }
 };
 
+// ****************************************************************************
+// Class:  eavlMultiReduceOp_1
+//
+// Purpose:
+///   Several reductions of one input array at once, such as its minimum,
+///   maximum and sum.  Takes a tuple of 2-input functors (each, like
+///   eavlReduceOp_1's, associative and commutative) and places the
+///   result of functor k at index k of the output array, which must be
+///   of the input's type.  On the host, the values are read in a single
+///   pass; the GPU still reduces them once per functor.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+//   agent, October 17, 2026
+//   Give each functor four independent accumulators on the host.
+//
+// ****************************************************************************
+template <class FL>
+class eavlMultiReduceOp_1 : public eavlOperation
+{
+  protected:
+    eavlArrayWithLinearIndex inArray0;
+    eavlArrayWithLinearIndex outArray0;
+    FL          functors;
+  public:
+    eavlMultiReduceOp_1(eavlArrayWithLinearIndex in0,
+                        eavlArrayWithLinearIndex out0,
+                        FL f)
+        : inArray0(in0), outArray0(out0), functors(f)
+    {
+    }
+    virtual void GoCPU()
+    {
+        int n = inArray0.array->GetNumberOfTuples();
+
+        int dummy;
+        eavlDispatch_io1<cpuMultiReduceOp_1_function>(n, eavlArray::HOST, dummy,
+                     inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
+                     outArray0.array, outArray0.mul, outArray0.add,
+                     functors);
+    }
+    virtual void GoGPU()
+    {
+#if defined __CUDACC__
+        int n = inArray0.array->GetNumberOfTuples();
+
+        int dummy;
+        eavlDispatch_io1<gpuMultiReduceOp_1_function>(n, eavlArray::DEVICE, dummy,
+                     inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
+                     outArray0.array, outArray0.mul, outArray0.add,
+                     functors);
+#else
+        THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
+#endif
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inArray0, in);
+        eavlAddOperationArrays(outArray0, out);
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class FL>
+eavlMultiReduceOp_1<FL> *new_eavlMultiReduceOp_1(eavlArrayWithLinearIndex in0,
+                                                 eavlArrayWithLinearIndex out0,
+                                                 FL functors)
+{
+    return new eavlMultiReduceOp_1<FL>(in0, out0, functors);
+}
+
 #endif
 
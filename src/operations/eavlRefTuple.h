@@ -40,6 +40,13 @@ struct refcons
         rest.CopyFrom(rc.rest);
     }
 
+    template <class FT2, class RT2>
+    EAVL_HOSTDEVICE void CopyFrom(const refcons<FT2,RT2> &rc)
+    {
+        first = rc.first;
+        rest.CopyFrom(rc.rest);
+    }
+
     template <class FT2,class RT2>
     EAVL_HOSTDEVICE void operator=(const cons<FT2,RT2> &c);
 
@@ -95,10 +102,116 @@ struct refcons<FT, nulltype>
         first = v;
     }
 
+    template <class FT2>
+    EAVL_HOSTDEVICE void CopyFrom(const refcons<FT2,nulltype> &rc)
+    {
+        first = rc.first;
+    }
+
   private:
     EAVL_HOSTDEVICE void operator=(const refcons &rc); // = delete
 };
 
+// ****************************************************************************
+// Class:  eavlImplicitValue
+//
+// Purpose:
+///   The element type of an eavlImplicitIndexable.  Its values are
+///   computed rather than stored, so there is nothing to refer to: a
+///   refcons of one holds the value of type T itself, and otherwise
+///   looks like a refcons of (const) T to the functors it's passed to.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlImplicitValue
+{
+    typedef T type;
+};
+
+template <class T, class RT>
+struct refcons<eavlImplicitValue<T>, RT>
+{
+    typedef T  firsttype;
+    typedef RT resttype;
+    T  first;
+    RT rest;
+
+    EAVL_HOSTDEVICE refcons(const refcons &rc) : first(rc.first), rest(rc.rest)
+    {
+    }
+
+    template <class T0>
+    EAVL_HOSTDEVICE refcons(const T0 &t0, const RT &rest) : first(t0), rest(rest)
+    {
+    }
+};
+
+template <class T, class RT>
+struct refcons<const eavlImplicitValue<T>, RT>
+{
+    typedef const T firsttype;
+    typedef RT      resttype;
+    const T first;
+    RT      rest;
+
+    EAVL_HOSTDEVICE refcons(const refcons &rc) : first(rc.first), rest(rc.rest)
+    {
+    }
+
+    template <class T0>
+    EAVL_HOSTDEVICE refcons(const T0 &t0, const RT &rest) : first(t0), rest(rest)
+    {
+    }
+};
+
+template <class T>
+struct refcons<eavlImplicitValue<T>, nulltype>
+{
+    typedef T        firsttype;
+    typedef nulltype resttype;
+    T first;
+
+    EAVL_HOSTDEVICE refcons(const refcons &rc) : first(rc.first)
+    {
+    }
+
+    template <class T0>
+    EAVL_HOSTDEVICE refcons(const T0 &t0, nulltype=cnull()) : first(t0)
+    {
+    }
+
+    EAVL_HOSTDEVICE operator T() const
+    {
+        return first;
+    }
+};
+
+template <class T>
+struct refcons<const eavlImplicitValue<T>, nulltype>
+{
+    typedef const T  firsttype;
+    typedef nulltype resttype;
+    const T first;
+
+    EAVL_HOSTDEVICE refcons(const refcons &rc) : first(rc.first)
+    {
+    }
+
+    template <class T0>
+    EAVL_HOSTDEVICE refcons(const T0 &t0, nulltype=cnull()) : first(t0)
+    {
+    }
+
+    EAVL_HOSTDEVICE operator T() const
+    {
+        return first;
+    }
+};
+
 // recursive (first+rest) typing structure
 template <class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15>
 struct refconstype
@@ -127,8 +127,8 @@ class eavlReverseIndexOp : public eavlOperation
             THROW(eavlException,"eavlReverseIndexOp expects all integer arrays.");
 
         eavlReverseIndexOp_CPU(n,
-                               (int*)inOC->GetHostArray(), inOutputCounts.div, inOutputCounts.mod, inOutputCounts.mul, inOutputCounts.add,
-                               (int*)inOI->GetHostArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
+                               (int*)inOC->GetConstHostArray(), inOutputCounts.div, inOutputCounts.mod, inOutputCounts.mul, inOutputCounts.add,
+                               (int*)inOI->GetConstHostArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
                                (int*)outII->GetHostArray(), outInputIndex.mul, outInputIndex.add,
                                (int*)outIS->GetHostArray(), outInputSubindex.mul, outInputSubindex.add,
                                maxPerInput);
@@ -147,8 +147,8 @@ class eavlReverseIndexOp : public eavlOperation
             THROW(eavlException,"eavlReverseIndexOp expects all integer arrays.");
 
         eavlReverseIndexOp_GPU(n,
-                               (int*)inOC->GetCUDAArray(), inOutputCounts.div, inOutputCounts.mod, inOutputCounts.mul, inOutputCounts.add,
-                               (int*)inOI->GetCUDAArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
+                               (int*)inOC->GetConstCUDAArray(), inOutputCounts.div, inOutputCounts.mod, inOutputCounts.mul, inOutputCounts.add,
+                               (int*)inOI->GetConstCUDAArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
                                (int*)outII->GetCUDAArray(), outInputIndex.mul, outInputIndex.add,
                                (int*)outIS->GetCUDAArray(), outInputSubindex.mul, outInputSubindex.add,
                                maxPerInput);
@@ -156,6 +156,15 @@ class eavlReverseIndexOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inOutputCounts, in);
+        eavlAddOperationArrays(inOutputIndex, in);
+        eavlAddOperationArrays(outInputIndex, out);
+        eavlAddOperationArrays(outInputSubindex, out);
+        return true;
+    }
 };
 
 #endif
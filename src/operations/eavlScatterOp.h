@@ -37,6 +37,29 @@ struct eavlScatterOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+struct eavlScatterOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT, class INDEX>
+    static void call(int end, int begin,
+                     const IN inputs, OUT outputs,
+                     INDEX indices, F&)
+    {
+        int *denseindices = get<0>(indices).array;
+
+        for (int sparseindex = begin; sparseindex < end; ++sparseindex)
+        {
+            int denseindex = denseindices[get<0>(indices).indexer.index(sparseindex)];
+            // can't use operator= because it's ambiguous when only
+            // one input and one output array (without a functor that
+            // would force a cast to a known type situation).
+            collect(denseindex, outputs).CopyFrom(collect(sparseindex, inputs));
+        }
+    }
+};
+
 #if defined __CUDACC__
 
 template <class IN, class OUT, class INDEX>
@@ -96,12 +119,18 @@ struct eavlScatterOp_GPU
 ///                           input   : [8 5 9]
 ///                         indexes   : [2 1 4]
 //                          output    : [0 5 8 0 9]
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool).
 //
 // Programmer:  Jeremy Meredith
 // Creation:    August  1, 2013
 //
 // Modifications:
 //     Matt Larsen- February 5, 2014 (used eavlGatherOp as a template)
+//
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class I, class O, class INDEX>
 class eavlScatterOp : public eavlOperation
@@ -120,7 +149,6 @@ class eavlScatterOp : public eavlOperation
     {
         int dummy;
         int n = inputs.first.length();
-        cerr<<"numInputs "<<n<<endl;
         eavlOpDispatch<eavlScatterOp_CPU>(n, dummy, inputs, outputs, indices, functor);
     }
     virtual void GoGPU()
@@ -133,6 +161,22 @@ class eavlScatterOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(indices, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return inputs.first.length();
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlOpDispatch<eavlScatterOp_CPU_Range>(end, begin, inputs, outputs, indices, functor);
+    }
 };
 
 // helper function for type deduction
@@ -0,0 +1,212 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_SEGMENTED_REDUCE_OP_1_H
+#define EAVL_SEGMENTED_REDUCE_OP_1_H
+
+#include "eavlOperation.h"
+#include "eavlArray.h"
+#include "eavlException.h"
+#include "eavlOpDispatch_io1.h"
+#include <algorithm>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN
+
+// below this many values, the fork/join overhead outweighs the benefit
+#define EAVL_SEGMENTED_REDUCE_MIN_PARALLEL_VALUES 32768
+
+struct eavlSegmentedReduceInfo
+{
+    const int *starts;
+    int        nsegments;
+};
+
+// folds the values at indices [begin,end) of i0 into sum, in order.
+// When the index is just a stride and offset, as for a whole array or
+// one of its components, the loop steps a pointer instead of working
+// out a division and modulus for every value.
+template <class F, class IO0>
+inline IO0 cpuSegmentedReduceOp_1_range(int begin, int end, IO0 sum,
+                                        const IO0 *i0, int i0div, int i0mod,
+                                        int i0mul, int i0add,
+                                        F &functor)
+{
+    if (i0div == 1 && i0mod >= end)
+    {
+        const IO0 *p = i0 + i0add;
+        for (int i=begin; i<end; ++i)
+            sum = functor(sum, p[i*i0mul]);
+        return sum;
+    }
+    for (int i=begin; i<end; ++i)
+        sum = functor(sum, i0[((i/i0div)%i0mod)*i0mul+i0add]);
+    return sum;
+}
+
+// Threads split the values, not the segments, so one long segment is
+// shared between several threads and many short ones are spread out.
+// Each thread reduces the segments which start in its chunk, stopping
+// at the end of the chunk, and separately the values at the start of
+// its chunk which belong to an earlier thread's segment; those are
+// folded into that segment's result serially, in thread order.
+template <class F,
+          class IO0>
+struct cpuSegmentedReduceOp_1_function
+{
+    static void call(int n, eavlSegmentedReduceInfo &info,
+                     IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
+                     IO0 *o0, int o0mul, int o0add,
+                     F &functor)
+    {
+        const int *starts = info.starts;
+        int nsegments = info.nsegments;
+
+        int maxthreads = 1;
+#ifdef HAVE_OPENMP
+        maxthreads = omp_get_max_threads();
+#endif
+        vector<IO0> carries(maxthreads);
+        vector<int> carrysegments(maxthreads);
+
+#pragma omp parallel if (n >= EAVL_SEGMENTED_REDUCE_MIN_PARALLEL_VALUES)
+        {
+            int nthreads = 1;
+            int threadid = 0;
+#ifdef HAVE_OPENMP
+            nthreads = omp_get_num_threads();
+            threadid = omp_get_thread_num();
+#endif
+            int chunksize = (n + nthreads - 1) / nthreads;
+            int start = threadid * chunksize;
+            int end   = start + chunksize;
+            if (start > n)
+                start = n;
+            if (end > n)
+                end = n;
+            int first = std::lower_bound(starts, starts + nsegments, start) - starts;
+
+            // the rest of the segment which started before this chunk
+            int headend = end;
+            if (first < nsegments && starts[first] < end)
+                headend = starts[first];
+            carrysegments[threadid] = -1;
+            if (first > 0 && start < headend)
+            {
+                carries[threadid] =
+                    cpuSegmentedReduceOp_1_range<F,IO0>(start, headend,
+                                                 functor.identity(),
+                                                 i0, i0div, i0mod, i0mul, i0add,
+                                                 functor);
+                carrysegments[threadid] = first - 1;
+            }
+
+            for (int s=first; s<nsegments && starts[s]<end; ++s)
+            {
+                int segend = (s+1 < nsegments) ? starts[s+1] : n;
+                if (segend > end)
+                    segend = end;
+                o0[s*o0mul+o0add] =
+                    cpuSegmentedReduceOp_1_range<F,IO0>(starts[s], segend,
+                                                 functor.identity(),
+                                                 i0, i0div, i0mod, i0mul, i0add,
+                                                 functor);
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                for (int t=0; t<nthreads; ++t)
+                {
+                    int s = carrysegments[t];
+                    if (s >= 0)
+                        o0[s*o0mul+o0add] = functor(o0[s*o0mul+o0add], carries[t]);
+                }
+                // empty segments after the last value
+                for (int s = std::lower_bound(starts, starts + nsegments, n) - starts;
+                     s < nsegments; ++s)
+                {
+                    o0[s*o0mul+o0add] = functor.identity();
+                }
+            }
+        }
+    }
+};
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlSegmentedReduceOp_1
+//
+// Purpose:
+///   Reduces each segment of a single input array, placing the result
+///   for segment i at index i of the output array, which must be of the
+///   input's type.  The segments are given by the (int) array of the index
+///   each one starts at, in increasing order, e.g. the exclusive prefix
+///   sum of their lengths; segment i ends where segment i+1 starts, and
+///   the last one at the end of the values.  An empty segment reduces to
+///   the functor's identity.  The 2-input functor must be associative.
+///   The output must not be the input array, since one thread may write
+///   a result over a value another thread has yet to read.
+///   The CPU version splits the values evenly between threads however
+///   uneven the segments are; there is not yet a GPU version.
+///   Example:
+///               input  : [1 2 3 4 5 6]
+///               starts : [0 2 2 5]
+///       with eavlAddFunctor,
+///               output : [3 0 12 6]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+//   agent, October 17, 2026
+//   Step a pointer through inputs with a plain stride and offset.
+//
+// ****************************************************************************
+template <class F>
+class eavlSegmentedReduceOp_1 : public eavlOperation
+{
+  protected:
+    eavlArrayWithLinearIndex inArray0;
+    eavlArrayWithLinearIndex outArray0;
+    eavlIntArray *starts;
+    F             functor;
+  public:
+    eavlSegmentedReduceOp_1(eavlArrayWithLinearIndex in0,
+                            eavlArrayWithLinearIndex out0,
+                            eavlIntArray *segstarts,
+                            F f)
+        : inArray0(in0), outArray0(out0), starts(segstarts), functor(f)
+    {
+    }
+    virtual void GoCPU()
+    {
+        if (outArray0.array == inArray0.array)
+            THROW(eavlException,"eavlSegmentedReduceOp_1 can't reduce in place.");
+
+        int n = inArray0.array->GetNumberOfTuples();
+
+        eavlSegmentedReduceInfo info;
+        info.starts = (const int*)starts->GetConstHostArray();
+        info.nsegments = starts->GetNumberOfTuples();
+        eavlDispatch_io1<cpuSegmentedReduceOp_1_function>(n, eavlArray::HOST, info,
+                     inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
+                     outArray0.array, outArray0.mul, outArray0.add,
+                     functor);
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"eavlSegmentedReduceOp_1 is not yet implemented on the GPU.");
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inArray0, in);
+        eavlAddOperationArrays(eavlArrayWithLinearIndex(starts), in);
+        eavlAddOperationArrays(outArray0, out);
+        return true;
+    }
+};
+
+#endif
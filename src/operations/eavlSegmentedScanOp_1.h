@@ -0,0 +1,255 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_SEGMENTED_SCAN_OP_1_H
+#define EAVL_SEGMENTED_SCAN_OP_1_H
+
+#include "eavlOperation.h"
+#include "eavlArray.h"
+#include "eavlException.h"
+#include "eavlOpDispatch_io1.h"
+#include "eavlSegmentedReduceOp_1.h"
+#include <algorithm>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN
+
+// below this many values, the fork/join overhead outweighs the benefit
+#define EAVL_SEGMENTED_SCAN_MIN_PARALLEL_VALUES 32768
+
+struct eavlSegmentedScanInfo
+{
+    const int *starts;
+    int        nsegments;
+    bool       inclusive;
+};
+
+// scans the values at indices [begin,end) of i0 into o0, continuing
+// from sum, and returns the sum after the last of them.  Each input
+// value is read before the output at the same location is written, so
+// this is also safe in place.  As cpuSegmentedReduceOp_1_range, this
+// steps pointers when the input index is just a stride and offset.
+template <class F, class IO0>
+inline IO0 cpuSegmentedScanOp_1_range(int begin, int end, IO0 sum,
+                                      bool inclusive,
+                                      const IO0 *i0, int i0div, int i0mod,
+                                      int i0mul, int i0add,
+                                      IO0 *o0, int o0mul, int o0add,
+                                      F &functor)
+{
+    IO0 *q = o0 + o0add;
+    if (i0div == 1 && i0mod >= end)
+    {
+        const IO0 *p = i0 + i0add;
+        if (inclusive)
+        {
+            for (int i=begin; i<end; ++i)
+            {
+                sum = functor(sum, p[i*i0mul]);
+                q[i*o0mul] = sum;
+            }
+        }
+        else
+        {
+            for (int i=begin; i<end; ++i)
+            {
+                IO0 val = p[i*i0mul];
+                q[i*o0mul] = sum;
+                sum = functor(sum, val);
+            }
+        }
+        return sum;
+    }
+    for (int i=begin; i<end; ++i)
+    {
+        IO0 val = i0[((i/i0div)%i0mod)*i0mul+i0add];
+        if (inclusive)
+        {
+            sum = functor(sum, val);
+            q[i*o0mul] = sum;
+        }
+        else
+        {
+            q[i*o0mul] = sum;
+            sum = functor(sum, val);
+        }
+    }
+    return sum;
+}
+
+// Threads split the values, not the segments, so one long segment is
+// shared between several threads and many short ones are spread out.
+// Each thread first reduces the values of the last segment in its
+// chunk; those are combined serially into the value each thread's
+// first segment carries in from earlier chunks; and then each thread
+// scans its chunk again starting from its carry.
+template <class F,
+          class IO0>
+struct cpuSegmentedScanOp_1_function
+{
+    static void call(int n, eavlSegmentedScanInfo &info,
+                     IO0 *i0, int i0div, int i0mod, int i0mul, int i0add,
+                     IO0 *o0, int o0mul, int o0add,
+                     F &functor)
+    {
+        const int *starts = info.starts;
+        int nsegments = info.nsegments;
+        bool inclusive = info.inclusive;
+
+        int maxthreads = 1;
+#ifdef HAVE_OPENMP
+        maxthreads = omp_get_max_threads();
+#endif
+        vector<IO0> tails(maxthreads);
+        vector<IO0> carries(maxthreads);
+        vector<char> tailstarts(maxthreads);
+
+#pragma omp parallel if (n >= EAVL_SEGMENTED_SCAN_MIN_PARALLEL_VALUES)
+        {
+            int nthreads = 1;
+            int threadid = 0;
+#ifdef HAVE_OPENMP
+            nthreads = omp_get_num_threads();
+            threadid = omp_get_thread_num();
+#endif
+            int chunksize = (n + nthreads - 1) / nthreads;
+            int start = threadid * chunksize;
+            int end   = start + chunksize;
+            if (start > n)
+                start = n;
+            if (end > n)
+                end = n;
+            int first = std::lower_bound(starts, starts + nsegments, start) - starts;
+
+            // only the values from the last segment start in the chunk
+            // on, which no later thread needs from the last one (so one
+            // thread reads the values only once)
+            if (threadid < nthreads-1)
+            {
+                int last = std::lower_bound(starts + first, starts + nsegments, end) - starts;
+                bool tailstart = (last > first);
+                int tailbegin = tailstart ? starts[last-1] : start;
+                tails[threadid] =
+                    cpuSegmentedReduceOp_1_range<F,IO0>(tailbegin, end,
+                                                 functor.identity(),
+                                                 i0, i0div, i0mod, i0mul, i0add,
+                                                 functor);
+                tailstarts[threadid] = tailstart;
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                carries[0] = functor.identity();
+                for (int t=1; t<nthreads; ++t)
+                {
+                    carries[t] = tailstarts[t-1] ? tails[t-1]
+                                                 : functor(carries[t-1], tails[t-1]);
+                }
+            }
+            // (implicit barrier at the end of the single)
+
+            // scan each run of values up to the next segment start
+            IO0 sum = carries[threadid];
+            int s = first;
+            int i = start;
+            while (i < end)
+            {
+                if (s < nsegments && starts[s] == i)
+                {
+                    sum = functor.identity();
+                    while (s < nsegments && starts[s] == i)
+                        ++s;
+                }
+                int next = (s < nsegments && starts[s] < end) ? starts[s] : end;
+                sum = cpuSegmentedScanOp_1_range<F,IO0>(i, next, sum, inclusive,
+                                                 i0, i0div, i0mod, i0mul, i0add,
+                                                 o0, o0mul, o0add,
+                                                 functor);
+                i = next;
+            }
+        }
+    }
+};
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlSegmentedScanOp_1
+//
+// Purpose:
+///   A prefix sum, either inclusive or exclusive, which starts again at
+///   the beginning of each segment of a single input array, placing the
+///   result in a single output array (which may be the input array).  The
+///   segments are given by the (int) array of the index each one starts
+///   at, in increasing order, e.g. the exclusive prefix sum of their
+///   lengths; segment i ends where segment i+1 starts, and the last one
+///   at the end of the values.  Any 2-input functor with an identity,
+///   such as eavlAddFunctor or eavlMaxFunctor, can be used in place of a
+///   sum; it must be associative.  The CPU version splits the values
+///   evenly between threads however uneven the segments are; there is
+///   not yet a GPU version.
+///   Example:
+///               input  : [1 2 3 4 5 6]
+///               starts : [0 2 5]
+///            inclusive : [1 3 3 7 12 6]
+///            exclusive : [0 1 0 3 7 0]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+//   agent, October 17, 2026
+//   Scan each run between segment starts as one loop, stepping a
+//   pointer through inputs with a plain stride and offset.
+//
+// ****************************************************************************
+template <class F>
+class eavlSegmentedScanOp_1 : public eavlOperation
+{
+  protected:
+    eavlArrayWithLinearIndex inArray0;
+    eavlArrayWithLinearIndex outArray0;
+    eavlIntArray *starts;
+    bool          inclusive;
+    F             functor;
+  public:
+    eavlSegmentedScanOp_1(eavlArrayWithLinearIndex in0,
+                          eavlArrayWithLinearIndex out0,
+                          eavlIntArray *segstarts,
+                          bool incl,
+                          F f)
+        : inArray0(in0), outArray0(out0), starts(segstarts),
+          inclusive(incl), functor(f)
+    {
+    }
+    virtual void GoCPU()
+    {
+        int n = inArray0.array->GetNumberOfTuples();
+        if (n == 0)
+            return;
+
+        eavlSegmentedScanInfo info;
+        info.starts = (const int*)starts->GetConstHostArray();
+        info.nsegments = starts->GetNumberOfTuples();
+        info.inclusive = inclusive;
+        eavlDispatch_io1<cpuSegmentedScanOp_1_function>(n, eavlArray::HOST, info,
+                     inArray0.array, inArray0.div, inArray0.mod, inArray0.mul, inArray0.add,
+                     outArray0.array, outArray0.mul, outArray0.add,
+                     functor);
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"eavlSegmentedScanOp_1 is not yet implemented on the GPU.");
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inArray0, in);
+        eavlAddOperationArrays(eavlArrayWithLinearIndex(starts), in);
+        eavlAddOperationArrays(outArray0, out);
+        return true;
+    }
+};
+
+#endif
@@ -109,8 +109,8 @@ class eavlSimpleReverseIndexOp : public eavlOperation
             THROW(eavlException,"eavlSimpleReverseIndexOp expects all integer arrays.");
 
         eavlSimpleReverseIndexOp_CPU(n,
-                               (int*)inOF->GetHostArray(), inOutputFlag.div, inOutputFlag.mod, inOutputFlag.mul, inOutputFlag.add,
-                               (int*)inOI->GetHostArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
+                               (int*)inOF->GetConstHostArray(), inOutputFlag.div, inOutputFlag.mod, inOutputFlag.mul, inOutputFlag.add,
+                               (int*)inOI->GetConstHostArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
                                (int*)outII->GetHostArray(), outInputIndex.mul, outInputIndex.add);
     }
 
@@ -126,13 +126,21 @@ class eavlSimpleReverseIndexOp : public eavlOperation
             THROW(eavlException,"eavlSimpleReverseIndexOp expects all integer arrays.");
 
         eavlSimpleReverseIndexOp_GPU(n,
-                               (int*)inOF->GetCUDAArray(), inOutputFlag.div, inOutputFlag.mod, inOutputFlag.mul, inOutputFlag.add,
-                               (int*)inOI->GetCUDAArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
+                               (int*)inOF->GetConstCUDAArray(), inOutputFlag.div, inOutputFlag.mod, inOutputFlag.mul, inOutputFlag.add,
+                               (int*)inOI->GetConstCUDAArray(), inOutputIndex.div, inOutputIndex.mod, inOutputIndex.mul, inOutputIndex.add,
                                (int*)outII->GetCUDAArray(), outInputIndex.mul, outInputIndex.add);
 #else
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inOutputFlag, in);
+        eavlAddOperationArrays(inOutputIndex, in);
+        eavlAddOperationArrays(outInputIndex, out);
+        return true;
+    }
 };
 
 #endif
@@ -0,0 +1,99 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_SORT_BY_KEY_OP_H
+#define EAVL_SORT_BY_KEY_OP_H
+
+#include "eavlSortOp.h"
+
+#ifndef DOXYGEN
+
+struct eavlSortByKeyOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class KEYSIN, class VALSIN, class KEYSOUT, class VALSOUT>
+    static void call(int n, int,
+                     const KEYSIN keysin, const VALSIN valsin,
+                     KEYSOUT keysout, VALSOUT valsout, F&)
+    {
+        typedef typename KEYSIN::firsttype::type K;
+        vector<unsigned int> keybuf;
+        vector<int> idbuf;
+        unsigned int *keys;
+        int *ids;
+        eavlRadixSortKeys(n, keysin, keybuf, idbuf, keys, ids);
+
+#pragma omp parallel for if (n >= EAVL_SORT_MIN_PARALLEL_VALUES)
+        for (int i = 0; i < n; ++i)
+        {
+            get<0>(keysout).array[get<0>(keysout).indexer.index(i)] = eavlRadixKey<K>::FromBits(keys[i]);
+            collect(i, valsout).CopyFrom(collect(ids[i], valsin));
+        }
+    }
+};
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlSortByKeyOp
+//
+// Purpose:
+///   Sorts a single int, float or byte key array into ascending order,
+///   and moves the values of any number of other arrays along with their
+///   keys.  The sort is stable, so values with equal keys stay in their
+///   input order.  The sorted keys may be written over the input keys,
+///   but the output values must not be the input values.  The CPU
+///   version is the radix sort of eavlSortOp; there is not yet a GPU
+///   version.
+///   Example:
+///               keys   : [3 1 2 1]
+///               values : [a b c d]
+///        sorted keys   : [1 1 2 3]
+///        sorted values : [b d c a]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class KI, class VI, class KO, class VO>
+class eavlSortByKeyOp : public eavlOperation
+{
+  protected:
+    DummyFunctor functor;
+    KI           keysin;
+    VI           valsin;
+    KO           keysout;
+    VO           valsout;
+  public:
+    eavlSortByKeyOp(KI ki, VI vi, KO ko, VO vo)
+        : keysin(ki), valsin(vi), keysout(ko), valsout(vo)
+    {
+    }
+    virtual void GoCPU()
+    {
+        int dummy;
+        int n = keysin.first.length();
+        eavlOpDispatch<eavlSortByKeyOp_CPU>(n, dummy, keysin, valsin, keysout, valsout, functor);
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"eavlSortByKeyOp is not yet implemented on the GPU.");
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(keysin, in);
+        eavlAddOperationArrays(valsin, in);
+        eavlAddOperationArrays(keysout, out);
+        eavlAddOperationArrays(valsout, out);
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class KI, class VI, class KO, class VO>
+eavlSortByKeyOp<KI,VI,KO,VO> *new_eavlSortByKeyOp(KI ki, VI vi, KO ko, VO vo)
+{
+    return new eavlSortByKeyOp<KI,VI,KO,VO>(ki,vi,ko,vo);
+}
+
+#endif
@@ -0,0 +1,280 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#ifndef EAVL_SORT_OP_H
+#define EAVL_SORT_OP_H
+
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlOpDispatch.h"
+#include "eavlOperation.h"
+#include "eavlException.h"
+#include <string.h>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN
+
+// below this many keys, the fork/join overhead outweighs the benefit
+#define EAVL_SORT_MIN_PARALLEL_VALUES 32768
+
+// ****************************************************************************
+// Class:  eavlRadixKey
+//
+// Purpose:
+///   Maps keys of type T to unsigned ints which sort in the same order
+///   byte by byte, and back again.  Signed ints have their sign bit
+///   flipped; floats have their sign bit flipped if positive and all
+///   their bits flipped if negative, so -0 sorts just before +0.
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class T>
+struct eavlRadixKey;
+
+template <>
+struct eavlRadixKey<int>
+{
+    static const int nbytes = 4;
+    static inline unsigned int ToBits(int v)
+    {
+        return (unsigned int)v ^ 0x80000000u;
+    }
+    static inline int FromBits(unsigned int b)
+    {
+        return int(b ^ 0x80000000u);
+    }
+};
+
+template <>
+struct eavlRadixKey<float>
+{
+    static const int nbytes = 4;
+    static inline unsigned int ToBits(float v)
+    {
+        unsigned int b;
+        memcpy(&b, &v, sizeof(b));
+        return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+    }
+    static inline float FromBits(unsigned int b)
+    {
+        b = (b & 0x80000000u) ? (b & 0x7fffffffu) : ~b;
+        float v;
+        memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+};
+
+template <>
+struct eavlRadixKey<byte>
+{
+    static const int nbytes = 1;
+    static inline unsigned int ToBits(byte v)
+    {
+        return v;
+    }
+    static inline byte FromBits(unsigned int b)
+    {
+        return byte(b);
+    }
+};
+
+// Stable least-significant-digit radix sort of n keys, already mapped
+// to unsigned ints, one byte per pass, carrying along each key's index.
+// Each thread counts the digits in one contiguous chunk, the counts are
+// scanned in digit-major, thread-minor order, and each thread scatters
+// its chunk to the resulting offsets.  Passes whose digit is the same
+// for every key are skipped.  On return, keys and ids point to whichever
+// of the two buffers holds the sorted result.
+inline void eavlRadixSortBits(int n, int nbytes,
+                              unsigned int *&keys, int *&ids,
+                              unsigned int *&tmpkeys, int *&tmpids)
+{
+    int maxthreads = 1;
+#ifdef HAVE_OPENMP
+    maxthreads = omp_get_max_threads();
+#endif
+    vector<int> counts(maxthreads * 256);
+    bool skip = false;
+
+#pragma omp parallel if (n >= EAVL_SORT_MIN_PARALLEL_VALUES)
+    {
+        int nthreads = 1;
+        int threadid = 0;
+#ifdef HAVE_OPENMP
+        nthreads = omp_get_num_threads();
+        threadid = omp_get_thread_num();
+#endif
+        int chunksize = (n + nthreads - 1) / nthreads;
+        int start = threadid * chunksize;
+        int end   = start + chunksize;
+        if (start > n)
+            start = n;
+        if (end > n)
+            end = n;
+        int *count = &counts[threadid * 256];
+
+        for (int pass = 0; pass < nbytes; ++pass)
+        {
+            int shift = 8 * pass;
+            for (int d = 0; d < 256; ++d)
+                count[d] = 0;
+            for (int i = start; i < end; ++i)
+                ++count[(keys[i] >> shift) & 0xff];
+
+#pragma omp barrier
+#pragma omp single
+            {
+                int sum = 0;
+                skip = false;
+                for (int d = 0; d < 256; ++d)
+                {
+                    int first = sum;
+                    for (int t = 0; t < nthreads; ++t)
+                    {
+                        int c = counts[t*256 + d];
+                        counts[t*256 + d] = sum;
+                        sum += c;
+                    }
+                    if (sum - first == n)
+                        skip = true;
+                }
+            }
+            // (implicit barrier at the end of the single)
+
+            if (!skip)
+            {
+                for (int i = start; i < end; ++i)
+                {
+                    int j = count[(keys[i] >> shift) & 0xff]++;
+                    tmpkeys[j] = keys[i];
+                    tmpids[j]  = ids[i];
+                }
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                if (!skip)
+                {
+                    std::swap(keys, tmpkeys);
+                    std::swap(ids, tmpids);
+                }
+            }
+        }
+    }
+}
+
+// Maps the keys to their radix bits, and sorts them with their indices.
+// Afterwards, keys[i] is the i'th smallest key's bits and ids[i] is
+// where it was in the input.
+template <class KEYS>
+void eavlRadixSortKeys(int n, const KEYS &keysin,
+                       vector<unsigned int> &keybuf, vector<int> &idbuf,
+                       unsigned int *&keys, int *&ids)
+{
+    typedef typename KEYS::firsttype::type K;
+    keys = NULL;
+    ids  = NULL;
+    if (n == 0)
+        return;
+
+    keybuf.resize(2 * n);
+    idbuf.resize(2 * n);
+    keys = &keybuf[0];
+    ids  = &idbuf[0];
+    unsigned int *tmpkeys = keys + n;
+    int *tmpids = ids + n;
+
+#pragma omp parallel for if (n >= EAVL_SORT_MIN_PARALLEL_VALUES)
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = eavlRadixKey<K>::ToBits(keysin.first.array[keysin.first.indexer.index(i)]);
+        ids[i] = i;
+    }
+
+    eavlRadixSortBits(n, eavlRadixKey<K>::nbytes, keys, ids, tmpkeys, tmpids);
+}
+
+struct eavlSortOp_CPU
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT>
+    static void call(int n, int,
+                     const IN inputs, OUT outputs, F&)
+    {
+        typedef typename IN::firsttype::type K;
+        vector<unsigned int> keybuf;
+        vector<int> idbuf;
+        unsigned int *keys;
+        int *ids;
+        eavlRadixSortKeys(n, inputs, keybuf, idbuf, keys, ids);
+
+        // the keys are rebuilt from their bits, so this is safe in-place
+#pragma omp parallel for if (n >= EAVL_SORT_MIN_PARALLEL_VALUES)
+        for (int i = 0; i < n; ++i)
+            get<0>(outputs).array[get<0>(outputs).indexer.index(i)] = eavlRadixKey<K>::FromBits(keys[i]);
+    }
+};
+
+#endif // DOXYGEN
+
+// ****************************************************************************
+// Class:  eavlSortOp
+//
+// Purpose:
+///   Sorts the values of a single int, float or byte array into ascending
+///   order, placing them in a single output array, which may be the
+///   input array itself.  The CPU version is a parallel least-significant-
+///   digit radix sort, one byte per pass, so its cost is linear in the
+///   number of values.  There is not yet a GPU version.
+///   Example:
+///               input  : [3 -1 4 1 -5 9 2 6]
+///               output : [-5 -1 1 2 3 4 6 9]
+//
+// Programmer:  agent
+// Creation:    October 17, 2026
+//
+// Modifications:
+// ****************************************************************************
+template <class I, class O>
+class eavlSortOp : public eavlOperation
+{
+  protected:
+    DummyFunctor functor;
+    I            inputs;
+    O            outputs;
+  public:
+    eavlSortOp(I i, O o)
+        : inputs(i), outputs(o)
+    {
+    }
+    virtual void GoCPU()
+    {
+        int dummy;
+        int n = inputs.first.length();
+        eavlOpDispatch<eavlSortOp_CPU>(n, dummy, inputs, outputs, functor);
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"eavlSortOp is not yet implemented on the GPU.");
+    }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(inputs, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+};
+
+// helper function for type deduction
+template <class I, class O>
+eavlSortOp<I,O> *new_eavlSortOp(I i, O o)
+{
+    return new eavlSortOp<I,O>(i,o);
+}
+
+#endif
@@ -39,6 +39,27 @@ struct eavlSourceTopologyMapOp_CPU
     }
 };
 
+// runs items [begin,end) serially, for when the executor is already
+// running ranges of them in parallel
+template <class CONN>
+struct eavlSourceTopologyMapOp_CPU_Range
+{
+    static inline eavlArray::Location location() { return eavlArray::HOST; }
+    template <class F, class IN, class OUT>
+    static void call(int end, eavlRangeStructure<CONN> &range,
+                     const IN s_inputs, OUT outputs, F &functor)
+    {
+        int ids[MAX_LOCAL_TOPOLOGY_IDS];
+        for (int index = range.begin; index < end; ++index)
+        {
+            int nids;
+            int shapeType = range.structure.GetElementComponents(index, nids, ids);
+
+            collect(index, outputs) = functor(shapeType, nids, ids, s_inputs);
+        }
+    }
+};
+
 #if defined __CUDACC__
 
 template <class CONN, class F, class IN, class OUT>
@@ -87,11 +108,16 @@ struct eavlSourceTopologyMapOp_GPU
 ///   input arrays on the source topology and with outputs
 ///   on the destination topology.  (If you need inputs on the
 ///   destination topology as well, use eavlCombinedTopologyMap.)
+///   Ranges of its items can be run separately (e.g. by the executor's
+///   thread pool), which balances cells with different numbers of ids.
 //
 // Programmer:  Jeremy Meredith
 // Creation:    July 26, 2013
 //
 // Modifications:
+//   agent, October 17, 2026
+//   Added GoCPURange.
+//
 // ****************************************************************************
 template <class IS, class O, class F>
 class eavlSourceTopologyMapOp : public eavlOperation
@@ -115,8 +141,17 @@ class eavlSourceTopologyMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-            eavlOpDispatch<eavlSourceTopologyMapOp_CPU<eavlExplicitConnectivity> >(n, conn, s_inputs, outputs, functor);
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlSourceTopologyMapOp_CPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlOpDispatch<eavlSourceTopologyMapOp_CPU<eavlMixedConnectivity> >(n, mconn, s_inputs, outputs, functor);
+            }
         }
         else if (elStr)
         {
@@ -132,23 +167,18 @@ class eavlSourceTopologyMapOp : public eavlOperation
         int n = outputs.first.length();
         if (elExp)
         {
-            eavlExplicitConnectivity &conn = elExp->GetConnectivity(topology);
-
-            cerr<<"copying shapetype to device...\n";
-            conn.shapetype.NeedOnDevice();
-            cerr<<"copying connectivity to device...\n";
-            conn.connectivity.NeedOnDevice();
-            cerr<<"copying mapCellToIndex to device...\n";
-            conn.mapCellToIndex.NeedOnDevice();
-
-            eavlOpDispatch<eavlSourceTopologyMapOp_GPU<eavlExplicitConnectivity> >(n, conn, s_inputs, outputs, functor);
-
-            cerr<<"copying shapetype from device...\n";
-            conn.shapetype.NeedOnHost();
-            cerr<<"copying connectivity from device...\n";
-            conn.connectivity.NeedOnHost();
-            cerr<<"copying mapCellToIndex from device...\n";
-            conn.mapCellToIndex.NeedOnHost();
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlSourceTopologyMapOp_GPU<eavlHomogeneousConnectivity> >(n, hconn, s_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::DEVICE);
+                eavlOpDispatch<eavlSourceTopologyMapOp_GPU<eavlMixedConnectivity> >(n, mconn, s_inputs, outputs, functor);
+            }
+            conn.NeedOnHost();
         }
         else if (elStr)
         {
@@ -159,6 +189,54 @@ class eavlSourceTopologyMapOp : public eavlOperation
         THROW(eavlException,"Executing GPU code without compiling under CUDA compiler.");
 #endif
     }
+    virtual bool GetArrays(vector<eavlOperationArray> &in,
+                           vector<eavlOperationArray> &out)
+    {
+        eavlAddOperationArrays(s_inputs, in);
+        eavlAddOperationArrays(outputs, out);
+        return true;
+    }
+    virtual eavlCellSet *GetCellSet()
+    {
+        return cells;
+    }
+    virtual int GetCPURangeLength()
+    {
+        return outputs.first.length();
+    }
+    virtual void PrepareCPURange()
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        if (elExp)
+            elExp->GetPackedConnectivity(topology);
+    }
+    virtual void GoCPURange(int begin, int end)
+    {
+        eavlCellSetExplicit *elExp = dynamic_cast<eavlCellSetExplicit*>(cells);
+        eavlCellSetAllStructured *elStr = dynamic_cast<eavlCellSetAllStructured*>(cells);
+        if (elExp)
+        {
+            eavlPackedConnectivity &conn = elExp->GetPackedConnectivity(topology);
+            if (conn.IsHomogeneous())
+            {
+                eavlHomogeneousConnectivity hconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlHomogeneousConnectivity> range(hconn, begin);
+                eavlOpDispatch<eavlSourceTopologyMapOp_CPU_Range<eavlHomogeneousConnectivity> >(end, range, s_inputs, outputs, functor);
+            }
+            else
+            {
+                eavlMixedConnectivity mconn(conn, eavlArray::HOST);
+                eavlRangeStructure<eavlMixedConnectivity> range(mconn, begin);
+                eavlOpDispatch<eavlSourceTopologyMapOp_CPU_Range<eavlMixedConnectivity> >(end, range, s_inputs, outputs, functor);
+            }
+        }
+        else if (elStr)
+        {
+            eavlRegularConnectivity conn = eavlRegularConnectivity(elStr->GetRegularStructure(),topology);
+            eavlRangeStructure<eavlRegularConnectivity> range(conn, begin);
+            eavlOpDispatch<eavlSourceTopologyMapOp_CPU_Range<eavlRegularConnectivity> >(end, range, s_inputs, outputs, functor);
+        }
+    }
 };
 
 // helper function for type deduction
@@ -76,6 +76,8 @@ class eavlPlot
             dim = 3;
 
         origpts = new double[npts*3];
+        vector<double> pts;
+        dataset->GetPoints(pts);
         for (int i=0; i<npts; i++)
         {
             origpts[3*i+0] = 0;
@@ -83,7 +85,7 @@ class eavlPlot
             origpts[3*i+2] = 0;
             for (int d=0; d<dim; d++)
             {
-                double v = dataset->GetPoint(i,d);
+                double v = pts[3*i+d];
                 origpts[3*i+d] = v;
                 if (v < min_coord_extents_orig[d])
                     min_coord_extents_orig[d] = v;
@@ -198,18 +200,10 @@ class eavlPlot
 
                     field_nodal = (f->GetAssociation() == eavlField::ASSOC_POINTS);
                 
-                    // get its limits
-                    int nvals = f->GetArray()->GetNumberOfTuples();
-                    //int ncomp = f->GetArray()->GetNumberOfComponents();
-                    for (int j=0; j<nvals; j++)
-                    {
-                        // just do min/max based on first component for now
-                        double value = f->GetArray()->GetComponentAsDouble(j,0);
-                        if (value < min_data_extents)
-                            min_data_extents = value;
-                        if (value > max_data_extents)
-                            max_data_extents = value;
-                    }
+                    // get its limits; just do min/max based on first
+                    // component for now (the array caches these)
+                    min_data_extents = f->GetArray()->GetComponentMin(0);
+                    max_data_extents = f->GetArray()->GetComponentMax(0);
 
                     // Do we break here?  In the old code, we would
                     // plot all cell sets for a field.  Now we pick one.
@@ -320,6 +314,30 @@ class eavlPlot
     }
 };
 
+// the values of one component of a field, as doubles, optionally log10'd
+struct eavl1DPlotValuesFunctor
+{
+    vector<double> &values;
+    bool logarithmic;
+    eavl1DPlotValuesFunctor(vector<double> &v, bool l)
+        : values(v), logarithmic(l)
+    {
+    }
+    template <class V>
+    void operator()(const V &in)
+    {
+        int n = in.size();
+        values.resize(n);
+        for (int i=0; i<n; i++)
+            values[i] = in[i];
+        if (logarithmic)
+        {
+            for (int i=0; i<n; i++)
+                values[i] = log10(values[i]);
+        }
+    }
+};
+
 class eavl1DPlot : public eavlPlot
 {
   protected:
@@ -364,6 +382,14 @@ class eavl1DPlot : public eavlPlot
         }
     }
 
+    ///\brief The first component of the field, converted once instead
+    /// of through a virtual call per value.
+    void GetFieldValues(vector<double> &values)
+    {
+        eavl1DPlotValuesFunctor get(values, logarithmic);
+        eavlDispatchView(field->GetArray(), get, 0);
+    }
+
     void GeneratePoints(eavlSceneRenderer *r)
     {
         bool PointField = (field &&
@@ -371,6 +397,10 @@ class eavl1DPlot : public eavlPlot
 
         r->SetActiveColor(color);
 
+        vector<double> values;
+        if (PointField)
+            GetFieldValues(values);
+
         r->StartPoints();
 
         double radius = 1.0;
@@ -380,10 +410,7 @@ class eavl1DPlot : public eavlPlot
 
             if (PointField)
             {
-                double v = field->GetArray()->GetComponentAsDouble(j,0);
-                if (logarithmic)
-                    v = log10(v);
-                r->AddPoint(x,v,0.0, radius);
+                r->AddPoint(x,values[j],0.0, radius);
             }
             else
             {
@@ -402,6 +429,10 @@ class eavl1DPlot : public eavlPlot
             field->GetAssociation() == eavlField::ASSOC_CELL_SET &&
             field->GetAssocCellSet() == cellset->GetName());
 
+        vector<double> values;
+        if (CellField || PointField)
+            GetFieldValues(values);
+
         r->SetActiveColor(color);
 
         r->StartLines();
@@ -422,27 +453,18 @@ class eavl1DPlot : public eavlPlot
 
             if (CellField)
             {
-                double v = field->GetArray()->GetComponentAsDouble(j,0);
-                if (logarithmic)
-                    v = log10(v);
+                double v = values[j];
                 if (j > 0)
                 {
-                    double v_last = field->GetArray()->GetComponentAsDouble(j-1,0);
-                    if (logarithmic)
-                        v_last = log10(v_last);
+                    double v_last = values[j-1];
                     r->AddLine(x0,v_last, 0.0,  x0,v, 0.0);
                 }
                 r->AddLine(x0,v, 0.0, x1,v, 0.0);
             }
             else if (PointField)
             {
-                double v0 = field->GetArray()->GetComponentAsDouble(i0,0);
-                double v1 = field->GetArray()->GetComponentAsDouble(i1,0);
-                if (logarithmic)
-                {
-                    v0 = log10(v0);
-                    v1 = log10(v1);
-                }
+                double v0 = values[i0];
+                double v1 = values[i1];
                 r->AddLine(x0,v0, 0.0, x1,v1, 0.0);
             }
             else
@@ -468,14 +490,15 @@ class eavl1DPlot : public eavlPlot
 
         r->SetActiveColor(color);
 
+        vector<double> values;
+        GetFieldValues(values);
+
         r->StartLines();
 
         for (int j=0; j<npts; j++)
         {
             double x = finalpts[j*3+0];
-            double v = field->GetArray()->GetComponentAsDouble(j,0);
-            if (logarithmic)
-                v = log10(v);
+            double v = values[j];
             r->AddLine(x,minval,0, x,v,0);
         }
 
@@ -499,6 +522,9 @@ class eavl1DPlot : public eavlPlot
 
         r->SetActiveColor(color);
 
+        vector<double> values;
+        GetFieldValues(values);
+
         r->StartTriangles();
 
         int ncells = cellset->GetNumCells();
@@ -522,9 +548,7 @@ class eavl1DPlot : public eavlPlot
 
             if (CellField)
             {
-                double v = field->GetArray()->GetComponentAsDouble(j,0);
-                if (logarithmic)
-                    v = log10(v);
+                double v = values[j];
                 r->AddTriangle(x0+g, minval, 0,
                                x1-g, minval, 0,
                                x1-g, v,      0);
@@ -534,13 +558,8 @@ class eavl1DPlot : public eavlPlot
             }
             else if (PointField)
             {
-                double v0 = field->GetArray()->GetComponentAsDouble(i0,0);
-                double v1 = field->GetArray()->GetComponentAsDouble(i1,0);
-                if (logarithmic)
-                {
-                    v0 = log10(v0);
-                    v1 = log10(v1);
-                }
+                double v0 = values[i0];
+                double v1 = values[i1];
                 r->AddTriangle(x0+g, minval, 0,
                                x1-g, minval, 0,
                                x1-g, v1,     0);
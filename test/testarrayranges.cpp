@@ -0,0 +1,306 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlImplicitArray.h"
+#include "eavlExecutor.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Checks the cached component and magnitude ranges of arrays of every
+// type against a serial reference, that every way of writing an array
+// invalidates them (including typed views), that typed views see the
+// same values as the virtual accessors, as do the generic views other
+// arrays get, that operations keep the ranges of the arrays they only
+// read and invalidate those they write, and times the first (computed)
+// and repeated (cached) queries.
+//
+
+struct Ranges
+{
+    vector<double> mins, maxs;
+    double cwmin, cwmax, magmin, magmax;
+};
+
+// the original serial definitions, one tuple at a time
+static Ranges Reference(eavlArray *arr)
+{
+    Ranges r;
+    int nt = arr->GetNumberOfTuples();
+    int nc = arr->GetNumberOfComponents();
+    r.mins.assign(nc, +DBL_MAX);
+    r.maxs.assign(nc, -DBL_MAX);
+    r.cwmin = +DBL_MAX;
+    r.cwmax = -DBL_MAX;
+    r.magmin = +DBL_MAX;
+    r.magmax = 0;
+    for (int i=0; i<nt; i++)
+    {
+        for (int c=0; c<nc; c++)
+        {
+            double v = arr->GetComponentAsDouble(i, c);
+            if (v < r.mins[c])
+                r.mins[c] = v;
+            if (v > r.maxs[c])
+                r.maxs[c] = v;
+        }
+        double tmin = arr->GetTupleMin(i);
+        double tmax = arr->GetTupleMax(i);
+        double mag = arr->GetTupleMagnitude(i);
+        if (tmin < r.cwmin)
+            r.cwmin = tmin;
+        if (tmax > r.cwmax)
+            r.cwmax = tmax;
+        if (mag < r.magmin)
+            r.magmin = mag;
+        if (mag > r.magmax)
+            r.magmax = mag;
+    }
+    return r;
+}
+
+static bool Same(const string &what, const char *which, double a, double b)
+{
+    if (a != b)
+    {
+        cerr << what << ": "<<which<<" is "<<a<<" but expected "<<b<<endl;
+        return false;
+    }
+    return true;
+}
+
+static bool Check(const string &what, eavlArray *arr)
+{
+    Ranges r = Reference(arr);
+    bool ok = true;
+    for (int c=0; c<arr->GetNumberOfComponents(); c++)
+    {
+        ok &= Same(what, "component min", arr->GetComponentMin(c), r.mins[c]);
+        ok &= Same(what, "component max", arr->GetComponentMax(c), r.maxs[c]);
+    }
+    ok &= Same(what, "component-wise min", arr->GetComponentWiseMin(), r.cwmin);
+    ok &= Same(what, "component-wise max", arr->GetComponentWiseMax(), r.cwmax);
+    ok &= Same(what, "magnitude min", arr->GetMagnitudeMin(), r.magmin);
+    ok &= Same(what, "magnitude max", arr->GetMagnitudeMax(), r.magmax);
+    return ok;
+}
+
+// sums every value of a view, for checking eavlDispatchView
+struct SumFunctor
+{
+    double sum;
+    SumFunctor() : sum(0)
+    {
+    }
+    template <class V>
+    void operator()(const V &vals)
+    {
+        for (int i=0; i<vals.size(); i++)
+            sum += vals[i];
+    }
+};
+
+template <class T>
+static bool TestType(const string &type, int n)
+{
+    bool ok = true;
+    for (int nc = 1; nc <= 3; ++nc)
+    {
+        ostringstream what;
+        what << type << "[" << n << "][" << nc << "]";
+        eavlConcreteArray<T> *arr = new eavlConcreteArray<T>("a", nc, n);
+        for (int i=0; i<n; i++)
+            for (int c=0; c<nc; c++)
+                arr->SetComponentFromDouble(i, c, double((i*37 + c*11) % 101) - 50.);
+        ok &= Check(what.str() + " initial", arr);
+
+        // views see the values the virtual accessors do
+        eavlStridedView<const T> view = arr->GetView();
+        for (int c=0; c<nc; c++)
+        {
+            SumFunctor sum;
+            eavlDispatchView(arr, sum, c);
+            double expected = 0;
+            for (int i=0; i<n; i++)
+            {
+                ok &= Same(what.str(), "view value", double(view(i,c)),
+                           arr->GetComponentAsDouble(i,c));
+                expected += arr->GetComponentAsDouble(i,c);
+            }
+            ok &= Same(what.str(), "dispatched view sum", sum.sum, expected);
+        }
+
+        // each way of writing must be seen by the next query
+        T big = T(100 + nc);
+        arr->SetValue(n/2, big);
+        ok &= Check(what.str() + " after SetValue", arr);
+        arr->GetTupleWritable(n/3)[nc-1] = T(-100);
+        ok &= Check(what.str() + " after GetTupleWritable", arr);
+        T tuple[3] = {T(0), T(0), T(0)};
+        arr->SetTuple(0, tuple);
+        ok &= Check(what.str() + " after SetTuple", arr);
+        T *raw = (T*)arr->GetHostArray();
+        raw[n-1] = T(120);
+        ok &= Check(what.str() + " after GetHostArray", arr);
+        raw[n-2] = T(121);
+        ((eavlArray*)arr)->MarkAsDirty(eavlArray::HOST);
+        ok &= Check(what.str() + " after MarkAsDirty", arr);
+        arr->GetComponentViewWritable(nc-1)[n/4] = T(122);
+        ok &= Check(what.str() + " after GetComponentViewWritable", arr);
+        arr->GetViewWritable()(n/5, 0) = T(-101);
+        ok &= Check(what.str() + " after GetViewWritable", arr);
+        arr->SetNumberOfTuples(n/2);
+        ok &= Check(what.str() + " after SetNumberOfTuples", arr);
+        delete arr;
+    }
+    return ok;
+}
+
+struct NegateFunctor
+{
+    EAVL_FUNCTOR float operator()(float x) { return -x; }
+};
+
+// reading an array in an operation (on either CPU backend) keeps its
+// ranges and modification stamp; the arrays written get new ones
+static bool TestOperations(int n)
+{
+    bool ok = true;
+    eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+    eavlExecutor::CPUBackend backends[2] = {eavlExecutor::OpenMPBackend,
+                                            eavlExecutor::ThreadPoolBackend};
+    eavlFloatArray in("in", 1, n), out("out", 1, n), sum("sum", 1, 1);
+    for (int i=0; i<n; i++)
+        in.SetValue(i, float(i % 1000));
+    for (int b=0; b<2; b++)
+    {
+        string what = (b == 0) ? "openmp" : "threadpool";
+        eavlExecutor::SetCPUBackend(backends[b]);
+        ok &= Check(what + " input", &in);
+        unsigned long instamp = in.GetModificationStamp();
+        in.GetConstHostArray();
+        unsigned long outstamp = out.GetModificationStamp();
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(&in), eavlOpArgs(&out), NegateFunctor()),
+            "negate");
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<float> >(&in, &sum,
+                                                      eavlAddFunctor<float>()),
+            "sum");
+        eavlExecutor::Go();
+        if (in.GetModificationStamp() != instamp)
+        {
+            cerr << what << ": reading an array changed its stamp\n";
+            ok = false;
+        }
+        if (out.GetModificationStamp() == outstamp)
+        {
+            cerr << what << ": writing an array kept its stamp\n";
+            ok = false;
+        }
+        ok &= Check(what + " output", &out);
+        ok &= Same(what, "output min", out.GetComponentMin(0), -999.);
+    }
+    eavlExecutor::SetCPUBackend(eavlExecutor::DefaultCPUBackend);
+    return ok;
+}
+
+// arrays without a typed view are dispatched a generic one
+static bool TestGenericView(int n)
+{
+    bool ok = true;
+    eavlCountingArray<float> counting("counting", n, -3.f, 0.5f);
+    for (int c=-1; c<=0; c++)
+    {
+        SumFunctor sum;
+        eavlDispatchView(&counting, sum, c);
+        double expected = 0;
+        for (int i=0; i<n; i++)
+            expected += counting.GetComponentAsDouble(i,0);
+        ok &= Same("counting", "dispatched view sum", sum.sum, expected);
+    }
+    return ok;
+}
+
+static bool TestSpecial()
+{
+    bool ok = true;
+    eavlFloatArray empty("empty", 2);
+    ok &= Check("empty", &empty);
+
+    // NaN values are ignored, as they always were
+    eavlFloatArray withnan("nan", 1, 4);
+    withnan.SetValue(0, 3.f);
+    withnan.SetValue(1, sqrt(-1.f));
+    withnan.SetValue(2, -2.f);
+    withnan.SetValue(3, 1.f);
+    ok &= Check("nan", &withnan);
+    ok &= Same("nan", "min", withnan.GetComponentMin(0), -2.);
+    ok &= Same("nan", "magnitude min", withnan.GetMagnitudeMin(), 1.);
+
+    eavlFloatArray vec("vec", 3, 2);
+    float a[3] = {3.f, -4.f, 0.f};
+    float b[3] = {1.f, 0.f, 0.f};
+    vec.SetTuple(0, a);
+    vec.SetTuple(1, b);
+    ok &= Same("vec", "magnitude max", vec.GetMagnitudeMax(), 5.);
+    ok &= Same("vec", "magnitude min", vec.GetMagnitudeMin(), 1.);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 4)
+            THROW(eavlException,"Expected a size of at least 4");
+
+        bool ok = true;
+        ok &= TestSpecial();
+        ok &= TestType<float>("float", 1000);
+        ok &= TestType<int>("int", 1000);
+        ok &= TestType<byte>("byte", 1000);
+        ok &= TestType<float>("float", n);
+        ok &= TestGenericView(1000);
+        ok &= TestOperations(n);
+        if (!ok)
+            THROW(eavlException,"Incorrect array ranges");
+
+        eavlFloatArray *arr = new eavlFloatArray("timing", 1, n);
+        for (int i=0; i<n; i++)
+            arr->SetValue(i, float(i % 1000));
+        int th = eavlTimer::Start();
+        Reference(arr);
+        double serial = eavlTimer::Stop(th, "serial range");
+        th = eavlTimer::Start();
+        arr->GetComponentWiseMin();
+        double first = eavlTimer::Stop(th, "first range");
+        th = eavlTimer::Start();
+        for (int i=0; i<100; i++)
+            arr->GetComponentWiseMax();
+        double cached = eavlTimer::Stop(th, "cached range") / 100.;
+        delete arr;
+
+        cout << "all array ranges were correct\n";
+        cout << "range of "<<n<<" floats: serial "<<serial
+             << " sec, first query "<<first
+             << " sec, cached query "<<cached<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
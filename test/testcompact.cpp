@@ -0,0 +1,181 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlCompactOp.h"
+#include "eavlGatherOp.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlReduceOp_1.h"
+#include "eavlSimpleReverseIndexOp.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Compacts an int array and one component of a float array by random
+// flags, for several sizes and fractions selected, and checks the values,
+// the selected indices and their count against serial ones.  Also finds
+// only the selected indices.  Reports the time taken to compact with
+// eavlCompactOp, and with a prefix sum, a reduction, a reverse index
+// and a gather.
+//
+
+static bool TestCompact(int n, double fraction,
+                        double &compactsec, double &separatesec)
+{
+    ostringstream what;
+    what << n<<" values with "<<fraction<<" selected";
+
+    eavlIntArray *flags = new eavlIntArray("flags", 1, n);
+    eavlIntArray *ivals = new eavlIntArray("ivals", 1, n);
+    eavlFloatArray *fvals = new eavlFloatArray("fvals", 2, n);
+    vector<int> expected;
+    for (int i=0; i<n; ++i)
+    {
+        int flag = (drand48() < fraction) ? 1 : 0;
+        flags->SetValue(i, flag);
+        ivals->SetValue(i, i*3 - 7);
+        fvals->SetComponentFromDouble(i, 0, -1.);
+        fvals->SetComponentFromDouble(i, 1, i * 0.5);
+        if (flag)
+            expected.push_back(i);
+    }
+    int nexpected = expected.size();
+
+    // the outputs have room for every value
+    eavlIntArray *iout = new eavlIntArray("iout", 1, n);
+    eavlFloatArray *fout = new eavlFloatArray("fout", 1, n);
+    eavlIntArray *indices = new eavlIntArray("indices", 1, n);
+    eavlIntArray *onlyindices = new eavlIntArray("onlyindices", 1, n);
+    eavlIntArray *count = new eavlIntArray("count", 1, 2);
+    eavlArrayWithLinearIndex count1(count);
+    count1.add = 1;
+
+    int th = eavlTimer::Start();
+    eavlExecutor::AddOperation(
+        new_eavlCompactOp(eavlOpArgs(flags),
+                          eavlOpArgs(eavlIndexable<eavlIntArray>(ivals),
+                                     eavlIndexable<eavlFloatArray>(fvals, 1)),
+                          eavlOpArgs(iout, fout),
+                          count, indices),
+        "compact values and indices");
+    eavlExecutor::Go();
+    compactsec = eavlTimer::Stop(th, "compact");
+
+    eavlExecutor::AddOperation(
+        new_eavlCompactOp(eavlOpArgs(flags), eavlOpArgs(), eavlOpArgs(),
+                          count1, onlyindices),
+        "compact indices");
+    eavlExecutor::Go();
+
+    // the same compaction in separate steps
+    th = eavlTimer::Start();
+    eavlIntArray *offsets = new eavlIntArray("offsets", 1, n);
+    eavlIntArray *total = new eavlIntArray("total", 1, 1);
+    eavlExecutor::AddOperation(
+        new eavlPrefixSumOp_1(flags, offsets, false), "scan");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(flags, total,
+                                                 eavlAddFunctor<int>()),
+        "count");
+    eavlExecutor::Go();
+    int nseparate = n > 0 ? total->GetValue(0) : 0;
+    eavlIntArray *sepindices = new eavlIntArray("sepindices", 1, nseparate);
+    eavlIntArray *sepiout = new eavlIntArray("sepiout", 1, nseparate);
+    eavlFloatArray *sepfout = new eavlFloatArray("sepfout", 1, nseparate);
+    if (nseparate > 0)
+    {
+        eavlExecutor::AddOperation(
+            new eavlSimpleReverseIndexOp(flags, offsets, sepindices),
+            "reverse index");
+        eavlExecutor::AddOperation(
+            new_eavlGatherOp(eavlOpArgs(eavlIndexable<eavlIntArray>(ivals),
+                                        eavlIndexable<eavlFloatArray>(fvals, 1)),
+                             eavlOpArgs(sepiout, sepfout),
+                             eavlOpArgs(sepindices)),
+            "gather");
+        eavlExecutor::Go();
+    }
+    separatesec = eavlTimer::Stop(th, "separate");
+
+    bool ok = true;
+    if (count->GetValue(0) != nexpected || count->GetValue(1) != nexpected)
+    {
+        cerr << what.str()<<": counted "<<count->GetValue(0)<<" and "
+             << count->GetValue(1)<<" but expected "<<nexpected<<endl;
+        ok = false;
+    }
+    for (int j=0; j<nexpected && ok; ++j)
+    {
+        int i = expected[j];
+        if (indices->GetValue(j) != i || onlyindices->GetValue(j) != i ||
+            iout->GetValue(j) != i*3 - 7 || fout->GetValue(j) != float(i * 0.5))
+        {
+            cerr << what.str()<<": output "<<j<<" is index "
+                 << indices->GetValue(j)<<" ("<<onlyindices->GetValue(j)
+                 << " alone), values "<<iout->GetValue(j)<<" and "
+                 << fout->GetValue(j)<<" but expected index "<<i<<endl;
+            ok = false;
+        }
+    }
+
+    delete flags;
+    delete ivals;
+    delete fvals;
+    delete iout;
+    delete fout;
+    delete indices;
+    delete onlyindices;
+    delete count;
+    delete offsets;
+    delete total;
+    delete sepindices;
+    delete sepiout;
+    delete sepfout;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 1)
+            THROW(eavlException,"Expected at least one value");
+
+        // sizes around the threading threshold
+        bool ok = true;
+        srand48(12345);
+        int sizes[] = {0, 1, 2, 7, 100, 32767, 32768, 100003};
+        int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+        double fractions[] = {0., 0.01, 0.5, 1.};
+        double compactsec, separatesec;
+        for (int s=0; s<nsizes; ++s)
+        {
+            for (int f=0; f<4; ++f)
+                ok &= TestCompact(sizes[s], fractions[f], compactsec, separatesec);
+        }
+        ok &= TestCompact(n, 0.5, compactsec, separatesec);
+        if (!ok)
+            THROW(eavlException,"Compactions differed from serial ones");
+
+        cout << "compactions matched serial ones\n";
+        cout << "compacting half of "<<n<<" values: eavlCompactOp "
+             << compactsec<<" sec, separate operations "<<separatesec
+             << " sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
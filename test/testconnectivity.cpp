@@ -0,0 +1,574 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlExecutor.h"
+#include "eavlCellSetExplicit.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+#include <algorithm>
+
+//
+// Builds the edge, face and reverse (node->cell) connectivity of
+// generated unstructured meshes (tetrahedra only, and a mix of every 3D
+// shape) and the reverse connectivity of triangle fans, validates it
+// against a serial reference construction, and reports the build times
+// of both on the tetrahedral mesh, and the memory its connectivity
+// takes before and after packing.
+//
+
+// ----------------------------------------------------------------------------
+// mesh generation
+// ----------------------------------------------------------------------------
+
+// shuffles the node ids so the cells don't arrive in node order
+static vector<int> MakePermutation(int npts)
+{
+    vector<int> perm(npts);
+    for (int i=0; i<npts; i++)
+        perm[i] = i;
+    unsigned int seed = 12345;
+    for (int i=npts-1; i>0; i--)
+    {
+        seed = seed * 1103515245u + 12345u;
+        std::swap(perm[i], perm[(seed >> 8) % (i+1)]);
+    }
+    return perm;
+}
+
+static void AddCell(eavlExplicitConnectivity &conn, eavlCellShape shape,
+                    int npts, const int *hex, const int *local)
+{
+    int ids[8];
+    for (int p=0; p<npts; p++)
+        ids[p] = hex[local[p]];
+    conn.AddElement(shape, npts, ids);
+}
+
+// an n^3 block of hexahedra, each one split into six tetrahedra around
+// its main diagonal, or (if mixed) turned into a hex, a voxel, two
+// wedges, six tets or a pyramid in turn
+static eavlCellSetExplicit *MakeMesh(int n, bool mixed)
+{
+    static const int tets[6][4] = {{0,1,2,6}, {0,2,3,6}, {0,3,7,6},
+                                   {0,7,4,6}, {0,4,5,6}, {0,5,1,6}};
+    static const int wedges[2][6] = {{0,1,2,4,5,6}, {0,2,3,4,6,7}};
+    static const int hexnodes[8] = {0,1,2,3,4,5,6,7};
+    static const int voxnodes[8] = {0,1,3,2,4,5,7,6};
+    static const int pyrnodes[5] = {0,1,2,3,4};
+
+    int np = n+1;
+    vector<int> perm = MakePermutation(np*np*np);
+    eavlExplicitConnectivity conn;
+    for (int k=0; k<n; k++)
+    {
+        for (int j=0; j<n; j++)
+        {
+            for (int i=0; i<n; i++)
+            {
+                int hex[8];
+                for (int c=0; c<8; c++)
+                {
+                    int x = i + ((c==1 || c==2 || c==5 || c==6) ? 1 : 0);
+                    int y = j + ((c==2 || c==3 || c==6 || c==7) ? 1 : 0);
+                    int z = k + ((c>=4) ? 1 : 0);
+                    hex[c] = perm[(z*np + y)*np + x];
+                }
+                int kind = mixed ? (i+j+k) % 5 : 3;
+                switch (kind)
+                {
+                  case 0:
+                    AddCell(conn, EAVL_HEX, 8, hex, hexnodes);
+                    break;
+                  case 1:
+                    AddCell(conn, EAVL_VOXEL, 8, hex, voxnodes);
+                    break;
+                  case 2:
+                    for (int w=0; w<2; w++)
+                        AddCell(conn, EAVL_WEDGE, 6, hex, wedges[w]);
+                    break;
+                  case 3:
+                    for (int t=0; t<6; t++)
+                        AddCell(conn, EAVL_TET, 4, hex, tets[t]);
+                    break;
+                  case 4:
+                    AddCell(conn, EAVL_PYRAMID, 5, hex, pyrnodes);
+                    break;
+                }
+            }
+        }
+    }
+
+    eavlCellSetExplicit *cells = new eavlCellSetExplicit("cells", 3);
+    cells->SetDSNumPoints(np*np*np);
+    cells->SetCellNodeConnectivity(conn);
+    return cells;
+}
+
+// a fan of n triangles around node 0, so that one node is in every cell
+static eavlCellSetExplicit *MakeFan(int n)
+{
+    eavlExplicitConnectivity conn;
+    for (int i=0; i<n; i++)
+    {
+        int ids[3] = {0, i+1, i+2};
+        conn.AddElement(EAVL_TRI, 3, ids);
+    }
+    eavlCellSetExplicit *cells = new eavlCellSetExplicit("fan", 2);
+    cells->SetDSNumPoints(n+2);
+    cells->SetCellNodeConnectivity(conn);
+    return cells;
+}
+
+// ----------------------------------------------------------------------------
+// serial references
+// ----------------------------------------------------------------------------
+
+struct RefKey
+{
+    int a, b, c;
+    RefKey(int x, int y, int z) : a(x), b(y), c(z) { }
+    bool operator<(const RefKey &o) const
+    {
+        if (a != o.a)
+            return a < o.a;
+        if (b != o.b)
+            return b < o.b;
+        return c < o.c;
+    }
+};
+
+// edges are keyed by their sorted nodes; faces by their lowest three
+static RefKey MakeKey(int npts, const int *ids)
+{
+    int s[4];
+    for (int p=0; p<npts; p++)
+        s[p] = ids[p];
+    std::sort(s, s+npts);
+    if (npts == 2)
+        return RefKey(s[0], s[1], -1);
+    return RefKey(s[0], s[1], s[2]);
+}
+
+static void ReferenceBuild(eavlCellSetExplicit *cells, bool faces,
+                           eavlExplicitConnectivity &cellconn,
+                           eavlExplicitConnectivity &nodeconn)
+{
+    map<RefKey,int> ids;
+    int ncells = cells->GetNumCells();
+    for (int i=0; i<ncells; i++)
+    {
+        eavlCell el = cells->GetCellNodes(i);
+        vector<int> npts;
+        vector<signed char*> local;
+        if (faces)
+        {
+            int ntris = 0, nquads = 0;
+            signed char (*tris)[3] = NULL;
+            signed char (*quads)[4] = NULL;
+            switch (el.type)
+            {
+              case EAVL_HEX:     nquads = 6; quads = eavlHexQuadFaces; break;
+              case EAVL_VOXEL:   nquads = 6; quads = eavlVoxQuadFaces; break;
+              case EAVL_TET:     ntris = 4;  tris = eavlTetTriangleFaces; break;
+              case EAVL_PYRAMID: ntris = 4;  tris = eavlPyramidTriangleFaces;
+                                 nquads = 1; quads = eavlPyramidQuadFaces; break;
+              case EAVL_WEDGE:   ntris = 2;  tris = eavlWedgeTriangleFaces;
+                                 nquads = 3; quads = eavlWedgeQuadFaces; break;
+              default: break;
+            }
+            for (int f=0; f<ntris; f++)
+            {
+                npts.push_back(3);
+                local.push_back(tris[f]);
+            }
+            for (int f=0; f<nquads; f++)
+            {
+                npts.push_back(4);
+                local.push_back(quads[f]);
+            }
+        }
+        else
+        {
+            int nedges = 0;
+            signed char (*edges)[2] = NULL;
+            switch (el.type)
+            {
+              case EAVL_TET:     nedges = 6;  edges = eavlTetEdges; break;
+              case EAVL_PYRAMID: nedges = 8;  edges = eavlPyramidEdges; break;
+              case EAVL_WEDGE:   nedges = 9;  edges = eavlWedgeEdges; break;
+              case EAVL_HEX:     nedges = 12; edges = eavlHexEdges; break;
+              case EAVL_VOXEL:   nedges = 12; edges = eavlVoxEdges; break;
+              default: break;
+            }
+            for (int e=0; e<nedges; e++)
+            {
+                npts.push_back(2);
+                local.push_back(edges[e]);
+            }
+        }
+
+        cellconn.shapetype.push_back(el.type);
+        cellconn.connectivity.push_back(npts.size());
+        for (size_t f=0; f<npts.size(); f++)
+        {
+            int nodes[4];
+            for (int p=0; p<npts[f]; p++)
+                nodes[p] = el.indices[local[f][p]];
+            if (!faces && nodes[0] > nodes[1])
+                std::swap(nodes[0], nodes[1]);
+            RefKey key = MakeKey(npts[f], nodes);
+            int id = ids.size();
+            if (ids.count(key) == 0)
+            {
+                ids[key] = id;
+                eavlCellShape shape = (npts[f] == 2) ? EAVL_BEAM :
+                                      (npts[f] == 3) ? EAVL_TRI : EAVL_QUAD;
+                nodeconn.AddElement(shape, npts[f], nodes);
+            }
+            else
+            {
+                id = ids[key];
+            }
+            cellconn.connectivity.push_back(id);
+        }
+    }
+    cellconn.CreateReverseIndex();
+    nodeconn.CreateReverseIndex();
+}
+
+// every node's cells in increasing order, with an empty list for each
+// point not used by any cell
+static void ReferenceNodeCells(eavlCellSetExplicit *cells, int npoints,
+                               eavlExplicitConnectivity &nodeconn)
+{
+    vector< vector<int> > cellsofnodes(npoints);
+    int ncells = cells->GetNumCells();
+    for (int i=0; i<ncells; i++)
+    {
+        eavlCell el = cells->GetCellNodes(i);
+        for (int p=0; p<el.numIndices; p++)
+        {
+            if (el.indices[p] >= (int)cellsofnodes.size())
+                cellsofnodes.resize(el.indices[p] + 1);
+            cellsofnodes[el.indices[p]].push_back(i);
+        }
+    }
+    for (size_t n=0; n<cellsofnodes.size(); n++)
+    {
+        nodeconn.AddElement(EAVL_POINT, cellsofnodes[n].size(),
+                            cellsofnodes[n].empty() ? NULL : &cellsofnodes[n][0]);
+    }
+    nodeconn.CreateReverseIndex();
+}
+
+// ----------------------------------------------------------------------------
+// validation and timing
+// ----------------------------------------------------------------------------
+
+static bool Same(const char *name, const eavlFlatArray<int> &a,
+                 const eavlFlatArray<int> &b)
+{
+    if (a.size() != b.size())
+    {
+        cerr << name << ": expected "<<b.size()<<" values but got "
+             << a.size() << endl;
+        return false;
+    }
+    for (int i=0; i<(int)a.size(); i++)
+    {
+        if (a[i] != b[i])
+        {
+            cerr << name << ": mismatch at index "<<i<<": expected "
+                 << b[i] << " but got "<<a[i]<<endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool Same(const char *name, const eavlExplicitConnectivity &a,
+                 const eavlExplicitConnectivity &b)
+{
+    string n(name);
+    return Same((n+" shapes").c_str(),  a.shapetype,      b.shapetype) &&
+           Same((n+" conn").c_str(),    a.connectivity,   b.connectivity) &&
+           Same((n+" index").c_str(),   a.mapCellToIndex, b.mapCellToIndex);
+}
+
+template <class VIEW>
+static bool SamePacked(const char *name, const VIEW &view,
+                       const eavlExplicitConnectivity &conn)
+{
+    for (int i=0; i<conn.GetNumElements(); i++)
+    {
+        // nodes have more cells than MAX_LOCAL_TOPOLOGY_IDS in a tet mesh
+        int npts, ids[64];
+        int refnpts, refids[64];
+        int shape = view.GetElementComponents(i, npts, ids);
+        int refshape = conn.GetElementComponents(i, refnpts, refids);
+        bool same = (shape == refshape && npts == refnpts &&
+                     shape == view.GetShapeType(i));
+        for (int p=0; same && p<npts; p++)
+            same = (ids[p] == refids[p]);
+        if (!same)
+        {
+            cerr << name << ": packed element "<<i<<" differs\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// the packed form of every topology must hold the same elements, be
+// what the cell set reads once the explicit form is released, and
+// unpack to the explicit form it was packed from.  cells has handed
+// out references to its explicit connectivity, which packing must keep;
+// fresh is the same mesh with none handed out, which packing releases.
+static bool ValidatePacked(eavlCellSetExplicit *cells,
+                           eavlCellSetExplicit *fresh, bool homogeneous)
+{
+    static const eavlTopology topologies[] = {
+        EAVL_NODES_OF_CELLS, EAVL_CELLS_OF_NODES, EAVL_NODES_OF_EDGES,
+        EAVL_NODES_OF_FACES, EAVL_EDGES_OF_CELLS, EAVL_FACES_OF_CELLS };
+    bool ok = true;
+    for (int t=0; t<6; t++)
+    {
+        eavlExplicitConnectivity &held = cells->GetConnectivity(topologies[t]);
+        eavlExplicitConnectivity conn;
+        conn.Replace(held);
+        conn.CreateReverseIndex();
+        long long heldbefore = cells->GetMemoryUsage();
+        eavlPackedConnectivity &heldpacked =
+            cells->GetPackedConnectivity(topologies[t]);
+        if (cells->GetMemoryUsage() - heldbefore != heldpacked.GetMemoryUsage())
+        {
+            cerr << "the explicit connectivity was released under a reference\n";
+            ok = false;
+        }
+        ok &= Same("held", held, conn);
+
+        // builds the topology without handing out a reference
+        fresh->GetElement(topologies[t], 0);
+        long long before = fresh->GetMemoryUsage();
+        eavlPackedConnectivity &packed = fresh->GetPackedConnectivity(topologies[t]);
+        long long after = fresh->GetMemoryUsage();
+        if (packed.GetNumElements() != conn.GetNumElements())
+        {
+            cerr << "packed connectivity has the wrong number of elements\n";
+            return false;
+        }
+        if (after - before != packed.GetMemoryUsage() - conn.GetMemoryUsage())
+        {
+            cerr << "the explicit connectivity was kept after packing\n";
+            ok = false;
+        }
+        if (packed.IsHomogeneous())
+            ok &= SamePacked("homogeneous",
+                             eavlHomogeneousConnectivity(packed, eavlArray::HOST),
+                             conn);
+        else
+            ok &= SamePacked("mixed",
+                             eavlMixedConnectivity(packed, eavlArray::HOST),
+                             conn);
+        for (int i=0; ok && i<conn.GetNumElements(); i++)
+        {
+            // an eavlCell holds at most 12 ids
+            int npts, ids[64];
+            int shape = conn.GetElementComponents(i, npts, ids);
+            if (npts > 12)
+                continue;
+            eavlCell el = fresh->GetElement(topologies[t], i);
+            bool same = (el.type == shape && el.numIndices == npts);
+            for (int p=0; same && p<npts; p++)
+                same = (el.indices[p] == ids[p]);
+            if (!same)
+            {
+                cerr << "released element "<<i<<" differs\n";
+                ok = false;
+            }
+        }
+        if (topologies[t] == EAVL_NODES_OF_CELLS &&
+            fresh->GetNumCells() != conn.GetNumElements())
+        {
+            cerr << "released cells have the wrong count\n";
+            ok = false;
+        }
+    }
+    // unpacking on request gives back the explicit form
+    for (int t=0; t<6; t++)
+    {
+        eavlExplicitConnectivity conn;
+        eavlPackedConnectivity &packed = fresh->GetPackedConnectivity(topologies[t]);
+        packed.Unpack(conn);
+        if (packed.IsHomogeneous())
+            ok &= SamePacked("unpacked homogeneous",
+                             eavlHomogeneousConnectivity(packed, eavlArray::HOST),
+                             conn);
+        else
+            ok &= SamePacked("unpacked mixed",
+                             eavlMixedConnectivity(packed, eavlArray::HOST),
+                             conn);
+        ok &= Same("unpacked", fresh->GetConnectivity(topologies[t]), conn);
+    }
+    // nodes of cells, edges and edges of cells are single-shape on a
+    // tet mesh; faces of cells and cells of nodes never are
+    bool h = fresh->GetPackedConnectivity(EAVL_NODES_OF_CELLS).IsHomogeneous();
+    if (h != homogeneous)
+    {
+        cerr << "expected the cells to be packed "
+             << (homogeneous ? "without" : "with") << " offsets\n";
+        ok = false;
+    }
+    return ok;
+}
+
+static bool Validate(int n, bool mixed)
+{
+    eavlCellSetExplicit *cells = MakeMesh(n, mixed);
+    eavlExplicitConnectivity refCellEdge, refEdgeNode;
+    eavlExplicitConnectivity refCellFace, refFaceNode;
+    ReferenceBuild(cells, false, refCellEdge, refEdgeNode);
+    ReferenceBuild(cells, true,  refCellFace, refFaceNode);
+
+    bool ok = true;
+    ok &= (cells->GetNumEdges() == refEdgeNode.GetNumElements());
+    ok &= (cells->GetNumFaces() == refFaceNode.GetNumElements());
+    if (!ok)
+        cerr << "unexpected number of edges or faces\n";
+    ok &= Same("cell edges", cells->GetConnectivity(EAVL_EDGES_OF_CELLS),
+               refCellEdge);
+    ok &= Same("edge nodes", cells->GetConnectivity(EAVL_NODES_OF_EDGES),
+               refEdgeNode);
+    ok &= Same("cell faces", cells->GetConnectivity(EAVL_FACES_OF_CELLS),
+               refCellFace);
+    ok &= Same("face nodes", cells->GetConnectivity(EAVL_NODES_OF_FACES),
+               refFaceNode);
+
+    // the reverse connectivity, then again with unused points at the end
+    int npoints = (n+1)*(n+1)*(n+1);
+    for (int extra = 0; extra <= 5; extra += 5)
+    {
+        eavlExplicitConnectivity refNodeCell;
+        ReferenceNodeCells(cells, npoints + extra, refNodeCell);
+        cells->SetDSNumPoints(npoints + extra);
+        ok &= Same("node cells", cells->GetConnectivity(EAVL_CELLS_OF_NODES),
+                   refNodeCell);
+    }
+    eavlCellSetExplicit *fresh = MakeMesh(n, mixed);
+    fresh->SetDSNumPoints(npoints + 5);
+    ok &= ValidatePacked(cells, fresh, !mixed);
+    delete cells;
+    delete fresh;
+    return ok;
+}
+
+// the node shared by every cell of a fan lists them all, in order
+static bool ValidateFan(int n)
+{
+    eavlCellSetExplicit *cells = MakeFan(n);
+    eavlExplicitConnectivity refNodeCell;
+    ReferenceNodeCells(cells, n+2, refNodeCell);
+    bool ok = Same("fan node cells", cells->GetConnectivity(EAVL_CELLS_OF_NODES),
+                   refNodeCell);
+    delete cells;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 3)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 40;
+        int reps = (argc > 2) ? atoi(argv[2]) : 3;
+        if (n < 1 || reps < 1)
+            THROW(eavlException,"Expected positive size and repetition count");
+
+        bool ok = true;
+        ok &= Validate(n, false);
+        ok &= Validate(1 + n/3, true);
+        ok &= ValidateFan(31);
+        ok &= ValidateFan(32);
+        ok &= ValidateFan(100000);
+        if (!ok)
+            THROW(eavlException,"Edge or face connectivity was incorrect");
+
+        eavlCellSetExplicit *cells = MakeMesh(n, false);
+        eavlExplicitConnectivity conn;
+        conn.Replace(cells->GetConnectivity(EAVL_NODES_OF_CELLS));
+        double tedge = -1, tface = -1, tnode = -1;
+        for (int r=0; r<reps; r++)
+        {
+            cells->SetCellNodeConnectivity(conn);
+            int th = eavlTimer::Start();
+            cells->GetNumEdges();
+            double t = eavlTimer::Stop(th, "edge connectivity");
+            if (tedge < 0 || t < tedge)
+                tedge = t;
+
+            th = eavlTimer::Start();
+            cells->GetNumFaces();
+            t = eavlTimer::Stop(th, "face connectivity");
+            if (tface < 0 || t < tface)
+                tface = t;
+
+            th = eavlTimer::Start();
+            cells->GetConnectivity(EAVL_CELLS_OF_NODES);
+            t = eavlTimer::Stop(th, "node cell connectivity");
+            if (tnode < 0 || t < tnode)
+                tnode = t;
+        }
+
+        eavlExplicitConnectivity c0, c1, c2, c3;
+        int th = eavlTimer::Start();
+        ReferenceBuild(cells, false, c0, c1);
+        double trefedge = eavlTimer::Stop(th, "map-based edge connectivity");
+        th = eavlTimer::Start();
+        ReferenceBuild(cells, true, c2, c3);
+        double trefface = eavlTimer::Stop(th, "map-based face connectivity");
+        eavlExplicitConnectivity c4;
+        th = eavlTimer::Start();
+        ReferenceNodeCells(cells, (n+1)*(n+1)*(n+1), c4);
+        double trefnode = eavlTimer::Stop(th, "serial node cell connectivity");
+
+        cout << cells->GetNumCells() << " tetrahedra, "
+             << cells->GetNumEdges() << " edges, "
+             << cells->GetNumFaces() << " faces, best of "<<reps<<" runs\n";
+        cout << "             parallel(s)  serial(s)\n";
+        cout << "edges   " << std::setw(12) << tedge << "    "
+             << std::setw(12) << trefedge << endl;
+        cout << "faces   " << std::setw(12) << tface << "    "
+             << std::setw(12) << trefface << endl;
+        cout << "nodes   " << std::setw(12) << tnode << "    "
+             << std::setw(12) << trefnode << endl;
+
+        // a cell set no one holds connectivity references into, with
+        // every topology built, before and after the topology map ops
+        // have packed all of them
+        eavlCellSetExplicit *unheld = MakeMesh(n, false);
+        for (int t=0; t<=EAVL_FACES_OF_CELLS; t++)
+            unheld->GetElement(eavlTopology(t), 0);
+        long long flatbytes = unheld->GetMemoryUsage();
+        for (int t=0; t<=EAVL_FACES_OF_CELLS; t++)
+            unheld->GetPackedConnectivity(eavlTopology(t));
+        long long packedbytes = unheld->GetMemoryUsage();
+        cout << "connectivity: "<<flatbytes<<" bytes explicit, "
+             << packedbytes<<" bytes once packed\n";
+        delete unheld;
+        delete cells;
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [cells per side] [repetitions]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -433,12 +433,87 @@ eavlDataSet *GenerateMoleculeTwoCellSets()
     return data;
 }
 
+//
+// Check that the cached points match the ones from the coordinates
+//
+void testPointCache(const char *fn, eavlDataSet *ds)
+{
+    int npts = ds->GetNumPoints();
+    vector<double> expected(3*npts);
+    for (int i=0; i<npts; ++i)
+        for (int c=0; c<3; ++c)
+            expected[3*i+c] = ds->GetPoint(i, c);
+
+    // reading them all at once doesn't leave them on the data set
+    long long mem = ds->GetMemoryUsage();
+    vector<double> all;
+    ds->GetPoints(all);
+    if (all != expected || ds->GetMemoryUsage() != mem)
+    {
+        cerr << fn << ": points read at once differed or were kept\n";
+        THROW(eavlException,"Points read at once differed");
+    }
+
+    const double *pts = ds->GetCachedPoints();
+    for (int i=0; i<3*npts; ++i)
+    {
+        if (pts[i] != expected[i] || ds->GetPoint(i/3, i%3) != expected[i])
+        {
+            cerr << fn << ": cached point "<<i/3<<" component "<<i%3
+                 << " is "<<pts[i]<<" but expected "<<expected[i]<<endl;
+            THROW(eavlException,"Cached points differed");
+        }
+    }
+}
+
+//
+// Check that a shallow copy shares the data set's parts, and that
+// deleting it leaves them with the data set
+//
+void testShallowCopy(const char *fn, eavlDataSet *ds)
+{
+    eavlDataSet *copy = ds->CreateShallowCopy();
+    bool ok = (copy->GetNumPoints() == ds->GetNumPoints() &&
+               copy->GetNumFields() == ds->GetNumFields() &&
+               copy->GetNumCellSets() == ds->GetNumCellSets() &&
+               copy->GetNumCoordinateSystems() == ds->GetNumCoordinateSystems() &&
+               copy->GetLogicalStructure() == ds->GetLogicalStructure());
+    for (int i=0; ok && i<ds->GetNumFields(); ++i)
+    {
+        eavlArray *a = ds->GetField(i)->GetArray();
+        ok = (copy->GetField(i) != ds->GetField(i) &&
+              copy->GetField(i)->GetArray() == a &&
+              a->GetReferenceCount() == 2);
+    }
+    for (int i=0; ok && i<ds->GetNumCellSets(); ++i)
+        ok = (copy->GetCellSet(i) == ds->GetCellSet(i));
+    if (!ok)
+    {
+        cerr << fn << ": the shallow copy differed\n";
+        THROW(eavlException,"Shallow copy did not share the data set's parts");
+    }
+
+    int nfields = ds->GetNumFields();
+    copy->AddField(new eavlField(1, new eavlFloatArray("extra", 1, 1),
+                                 eavlField::ASSOC_WHOLEMESH));
+    delete copy;
+    if (ds->GetNumFields() != nfields)
+        THROW(eavlException,"Adding a field to a shallow copy changed the original");
+    for (int i=0; i<ds->GetNumFields(); ++i)
+    {
+        if (ds->GetField(i)->GetArray()->GetReferenceCount() != 1)
+            THROW(eavlException,"Deleting a shallow copy left extra references");
+    }
+}
+
 //
 // Print a summary of the new data set and write to a file
 //
 void test(const char *fn, eavlDataSet *ds)
 {
     cerr << "------------ " << fn << " -----------\n";
+    testPointCache(fn, ds);
+    testShallowCopy(fn, ds);
     ds->PrintSummary(cout);
 
     ofstream out(fn);
@@ -463,6 +538,54 @@ int main(int argc, char *argv[])
         test("unstruc3d.vtk",    GenerateExplicit3DPyramidGrid(10, 12));
         test("explicitrect.vtk", GenerateExplicitOnLogical(10, 12));
         test("molecule.vtk",     GenerateMoleculeTwoCellSets());
+
+        // changing a coordinate in place is picked up by the cache
+        eavlDataSet *ds = GenerateRectXY(10, 12);
+        ds->GetCachedPoints();
+        ((eavlFloatArray*)ds->GetField("x")->GetArray())->SetValue(3, -1);
+        vector<double> all;
+        ds->GetPoints(all);
+        if (ds->GetCachedPoints()[3*3] != -1 || all[3*13] != -1 ||
+            ds->GetPoint(13, 0) != -1)
+            THROW(eavlException,"Point cache missed a change to the coordinates");
+        delete ds;
+
+        // a shallow copy outlives the data set it was made from
+        ds = GenerateMoleculeTwoCellSets();
+        eavlDataSet *copy = ds->CreateShallowCopy();
+        vector<double> expected;
+        for (int i=0; i<ds->GetNumPoints(); ++i)
+            expected.push_back(ds->GetPoint(i, 0));
+        delete ds;
+        for (int i=0; i<copy->GetNumPoints(); ++i)
+        {
+            if (copy->GetPoint(i, 0) != expected[i])
+                THROW(eavlException,"Shallow copy changed when the original was deleted");
+        }
+        if (copy->GetCellSet("bonds")->GetNumCells() <= 0)
+            THROW(eavlException,"Shallow copy lost its cell set");
+        delete copy;
+
+        // replacing a coordinate system releases the old one, and the new
+        // one keeps the axis it took from it
+        ds = GenerateRectXY(10, 12);
+        eavlCoordinates *oldcs = ds->GetCoordinateSystem(0);
+        oldcs->AddReference();
+        eavlCoordinateAxis *xaxis = oldcs->GetAxis(0);
+        eavlCoordinates *newcs =
+            new eavlCoordinatesCartesian(ds->GetLogicalStructure(),
+                                         eavlCoordinatesCartesian::X,
+                                         eavlCoordinatesCartesian::Y);
+        newcs->SetAxis(0, xaxis);
+        newcs->SetAxis(1, new eavlCoordinateAxisField("x"));
+        ds->SetCoordinateSystem(0, newcs);
+        if (oldcs->GetReferenceCount() != 1 || xaxis->GetReferenceCount() != 2)
+            THROW(eavlException,"Replacing a coordinate system kept the old one");
+        oldcs->Release();
+        if (xaxis->GetReferenceCount() != 1 ||
+            ds->GetPoint(13, 0) != 130 || ds->GetPoint(13, 1) != 130)
+            THROW(eavlException,"Replacing a coordinate system lost a shared axis");
+        delete ds;
     }
     catch (const eavlException &e)
     {
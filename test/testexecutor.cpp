@@ -0,0 +1,353 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Builds plans which the executor can fuse (chains of element-wise maps,
+// including ones which read and write single components of a
+// multi-component array) or run concurrently (independent reductions
+// and scans), and validates every result against a serial reference.
+// Also checks the profile recorded for those plans, and runs a captured
+// plan over several inputs and sizes, including one which shares the
+// values of an array another of its operations writes.
+//
+
+struct ScaleAndShiftFunctor
+{
+    int scale, shift;
+    ScaleAndShiftFunctor(int s, int o) : scale(s), shift(o) { }
+    EAVL_FUNCTOR int operator()(int x) { return x*scale + shift; }
+};
+
+struct SumFunctor
+{
+    EAVL_FUNCTOR int operator()(tuple<int,int> in)
+    {
+        return get<0>(in) + get<1>(in);
+    }
+};
+
+static bool Check(const char *name, eavlIntArray *arr, int comp,
+                  const vector<int> &expected)
+{
+    for (size_t i=0; i<expected.size(); ++i)
+    {
+        int val = (int)arr->GetComponentAsDouble(i, comp);
+        if (val != expected[i])
+        {
+            cerr << name << ": mismatch at index "<<i<<": expected "
+                 << expected[i] << " but got "<<val<<endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool RunPlans(int n)
+{
+    eavlIntArray *a    = new eavlIntArray("a", 1, n);
+    eavlIntArray *b    = new eavlIntArray("b", 1, n);
+    eavlIntArray *c    = new eavlIntArray("c", 1, n);
+    eavlIntArray *ab   = new eavlIntArray("ab", 2, n);
+    eavlIntArray *half = new eavlIntArray("half", 1, n);
+    eavlIntArray *scan = new eavlIntArray("scan", 1, n);
+    eavlIntArray *sumb = new eavlIntArray("sumb", 1, 1);
+    eavlIntArray *sumc = new eavlIntArray("sumc", 1, 1);
+    for (int i=0; i<n; ++i)
+        a->SetValue(i, (i*7) % 13);
+
+    // a chain of maps, each reading the one before (and the last one
+    // overwriting an array read earlier in the chain), followed by
+    // independent reductions and a scan
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a), eavlOpArgs(b),
+                      ScaleAndShiftFunctor(3, 1)),
+        "b = 3a+1");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a, b), eavlOpArgs(c), SumFunctor()),
+        "c = a+b");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(c),
+                      eavlOpArgs(eavlIndexable<eavlIntArray>(ab, 0)),
+                      ScaleAndShiftFunctor(1, 0)),
+        "ab.0 = c");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlIntArray>(ab, 0)),
+                      eavlOpArgs(eavlIndexable<eavlIntArray>(ab, 1)),
+                      ScaleAndShiftFunctor(-1, 5)),
+        "ab.1 = 5-ab.0");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlIntArray>(ab, 1)),
+                      eavlOpArgs(b),
+                      ScaleAndShiftFunctor(2, 0)),
+        "b = 2 ab.1");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(b, sumb,
+                                                 eavlAddFunctor<int>()),
+        "sum b");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(c, sumc,
+                                                 eavlAddFunctor<int>()),
+        "sum c");
+    eavlExecutor::AddOperation(
+        new eavlPrefixSumOp_1(c, scan, false),
+        "scan c");
+    eavlExecutor::Go();
+
+    // a map reading another array at different locations than the
+    // ones it was written; this must run after the map which writes
+    // that array, and not be fused with it
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a), eavlOpArgs(c),
+                      ScaleAndShiftFunctor(1, 2)),
+        "c = a+2");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlIntArray>(c, eavlArrayIndexer(2, n, 1, 0))),
+                      eavlOpArgs(half),
+                      ScaleAndShiftFunctor(1, 0)),
+        "half = c[i/2]");
+    eavlExecutor::Go();
+
+    vector<int> eb(n), ec(n), eab0(n), eab1(n), escan(n), ehalf(n);
+    int esumb = 0, esumc = 0;
+    for (int i=0; i<n; ++i)
+    {
+        int va = (i*7) % 13;
+        ec[i] = va + 3*va+1;
+        eab0[i] = ec[i];
+        eab1[i] = 5 - eab0[i];
+        eb[i] = 2 * eab1[i];
+        escan[i] = esumc;
+        esumb += eb[i];
+        esumc += ec[i];
+    }
+    for (int i=0; i<n; ++i)
+        ehalf[i] = ((i/2)*7) % 13 + 2;
+
+    bool ok = true;
+    ok &= Check("b", b, 0, eb);
+    ok &= Check("ab.0", ab, 0, eab0);
+    ok &= Check("ab.1", ab, 1, eab1);
+    ok &= Check("scan", scan, 0, escan);
+    ok &= Check("sumb", sumb, 0, vector<int>(1, esumb));
+    ok &= Check("sumc", sumc, 0, vector<int>(1, esumc));
+    ok &= Check("half", half, 0, ehalf);
+
+    delete a;
+    delete b;
+    delete c;
+    delete ab;
+    delete half;
+    delete scan;
+    delete sumb;
+    delete sumc;
+    return ok;
+}
+
+// a plan captured once and run over two inputs in turn, by sharing
+// their values with the array it was captured over, then again after
+// every array has been shrunk
+static bool RunCapturedPlan(int n)
+{
+    eavlIntArray *in    = new eavlIntArray("in", 1);
+    eavlIntArray *one   = new eavlIntArray("one", 1, n);
+    eavlIntArray *two   = new eavlIntArray("two", 1, n);
+    eavlIntArray *b     = new eavlIntArray("b", 1, n);
+    eavlIntArray *c     = new eavlIntArray("c", 1, n);
+    eavlIntArray *sumc  = new eavlIntArray("sumc", 1, 1);
+    for (int i=0; i<n; ++i)
+    {
+        one->SetValue(i, (i*7) % 13);
+        two->SetValue(i, (i*5) % 11);
+    }
+    in->ShareHostArray(one);
+
+    eavlPlan plan;
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(in), eavlOpArgs(b),
+                      ScaleAndShiftFunctor(3, 1)),
+        "b = 3in+1");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(in, b), eavlOpArgs(c), SumFunctor()),
+        "c = in+b");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(c, sumc,
+                                                 eavlAddFunctor<int>()),
+        "sum c");
+    eavlExecutor::Capture(plan);
+
+    bool ok = (plan.GetNumOperations() == 3);
+    if (!ok)
+        cerr << "captured "<<plan.GetNumOperations()<<" operations\n";
+    for (int pass=0; pass<4; ++pass)
+    {
+        if (pass == 2)
+        {
+            int m = (n+1) / 2;
+            one->SetNumberOfTuples(m);
+            two->SetNumberOfTuples(m);
+            b->SetNumberOfTuples(m);
+            c->SetNumberOfTuples(m);
+        }
+        eavlIntArray *src = (pass % 2) ? two : one;
+        in->ShareHostArray(src);
+        eavlExecutor::Go(plan);
+
+        int m = src->GetNumberOfTuples();
+        vector<int> eb(m), ec(m);
+        int esumc = 0;
+        for (int i=0; i<m; ++i)
+        {
+            int v = src->GetValue(i);
+            eb[i] = 3*v + 1;
+            ec[i] = v + eb[i];
+            esumc += ec[i];
+        }
+        ok &= Check("captured b", b, 0, eb);
+        ok &= Check("captured c", c, 0, ec);
+        ok &= Check("captured sumc", sumc, 0, vector<int>(1, esumc));
+    }
+    ok &= !plan.IsEmpty();
+
+    plan.Clear();
+    delete in;
+    delete one;
+    delete two;
+    delete b;
+    delete c;
+    delete sumc;
+    return ok;
+}
+
+// a captured plan reading, in reverse, an array which shares the values
+// of either another input or the array the plan's first map writes; in
+// the latter case the maps must not be fused, so the schedule worked out
+// for the former can't be kept
+static bool RunAliasedPlan(int n)
+{
+    eavlIntArray *a     = new eavlIntArray("a", 1, n);
+    eavlIntArray *other = new eavlIntArray("other", 1, n);
+    eavlIntArray *c     = new eavlIntArray("c", 1, n);
+    eavlIntArray *view  = new eavlIntArray("view", 1);
+    eavlIntArray *rev   = new eavlIntArray("rev", 1, n);
+    for (int i=0; i<n; ++i)
+    {
+        a->SetValue(i, (i*7) % 13);
+        other->SetValue(i, (i*5) % 11);
+    }
+    view->ShareHostArray(other);
+
+    eavlPlan plan;
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a), eavlOpArgs(c),
+                      ScaleAndShiftFunctor(1, 2)),
+        "c = a+2");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlIntArray>(view, eavlArrayIndexer(1, n, -1, n-1))),
+                      eavlOpArgs(rev),
+                      ScaleAndShiftFunctor(1, 0)),
+        "rev = view[n-1-i]");
+    eavlExecutor::Capture(plan);
+
+    bool ok = true;
+    for (int pass=0; pass<3; ++pass)
+    {
+        for (int i=0; i<n; ++i)
+            c->SetValue(i, 0);
+        eavlIntArray *src = (pass == 1) ? c : other;
+        view->ShareHostArray(src);
+        eavlExecutor::Go(plan);
+
+        vector<int> erev(n);
+        for (int i=0; i<n; ++i)
+        {
+            int j = n-1-i;
+            erev[i] = (pass == 1) ? (j*7) % 13 + 2 : (j*5) % 11;
+        }
+        ok &= Check((pass == 1) ? "reversed c" : "reversed other",
+                    rev, 0, erev);
+    }
+
+    plan.Clear();
+    delete a;
+    delete other;
+    delete c;
+    delete view;
+    delete rev;
+    return ok;
+}
+
+static bool CheckProfile(int n)
+{
+    const vector<eavlExecutor::ProfileRecord> &prof =
+        eavlExecutor::GetProfile();
+    bool foundsum = false;
+    for (size_t i=0; i<prof.size(); ++i)
+    {
+        const eavlExecutor::ProfileRecord &r = prof[i];
+        if (r.path != "CPU" || r.duration < 0 || r.items < 0)
+        {
+            cerr << "bad profile record for "<<r.name<<endl;
+            return false;
+        }
+        if (r.name == "sum c")
+        {
+            foundsum = true;
+            if (r.items != n || r.bytesRead != 4*(long long)n ||
+                r.bytesWritten != 4)
+            {
+                cerr << "unexpected traffic for sum c: items="<<r.items
+                     << " read="<<r.bytesRead
+                     << " written="<<r.bytesWritten<<endl;
+                return false;
+            }
+        }
+    }
+    if (!foundsum)
+        cerr << "no profile record for sum c\n";
+    return foundsum;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 100000;
+        if (n < 1)
+            THROW(eavlException,"Expected a positive size");
+
+        // try sizes with a single partial chunk of fused work, too
+        eavlExecutor::SetProfiling(true);
+        eavlExecutor::ClearProfile();
+        bool ok = RunPlans(n);
+        ok &= CheckProfile(n);
+        ok &= RunPlans(1 + n/1000);
+        ok &= RunCapturedPlan(n);
+        ok &= RunCapturedPlan(1 + n/1000);
+        ok &= RunAliasedPlan(n);
+        if (!ok)
+            THROW(eavlException,"Executor produced incorrect results");
+        cout << "all plans produced correct results\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlIsosurfaceFilter.h"
+
+#include "eavlCellSetAllStructured.h"
+#include "eavlCoordinates.h"
+#include "eavlLogicalStructureRegular.h"
+
+//
+// Isosurfaces generated rectilinear grids with the flying edges path
+// and with the general algorithm, checks that the two outputs are
+// identical (points, triangles and every field), and reports the time
+// each one took.
+//
+
+// an ni x nj x nk rectilinear grid with unevenly spaced coordinates, a
+// float and an int nodal field, and a float zonal field
+static eavlDataSet *GenerateRectXYZ(int ni, int nj, int nk)
+{
+    eavlDataSet *data = new eavlDataSet();
+
+    int npts = ni * nj * nk;
+    int ncells = (ni-1) * (nj-1) * (nk-1);
+    data->SetNumPoints(npts);
+
+    eavlRegularStructure reg;
+    reg.SetNodeDimension3D(ni, nj, nk);
+
+    eavlLogicalStructure *log = new eavlLogicalStructureRegular(reg.dimension,
+                                                                reg);
+    data->SetLogicalStructure(log);
+
+    int dims[3] = {ni, nj, nk};
+    const char *names[3] = {"x", "y", "z"};
+    for (int d=0; d<3; d++)
+    {
+        eavlFloatArray *axis = new eavlFloatArray(names[d], 1, dims[d]);
+        for (int i=0; i<dims[d]; ++i)
+        {
+            float t = float(i)/float(dims[d]-1);
+            axis->SetValue(i, 2.f*t*t - 1.f);
+        }
+        data->AddField(new eavlField(1, axis, eavlField::ASSOC_LOGICALDIM, d));
+    }
+
+    eavlFloatArray *nodal = new eavlFloatArray("nodal", 1, npts);
+    eavlIntArray *nodalint = new eavlIntArray("nodalint", 1, npts);
+    for (int k=0; k<nk; ++k)
+    {
+        for (int j=0; j<nj; ++j)
+        {
+            for (int i=0; i<ni; ++i)
+            {
+                int n = (k*nj + j)*ni + i;
+                float x = float(i)/float(ni-1);
+                float y = float(j)/float(nj-1);
+                float z = float(k)/float(nk-1);
+                nodal->SetValue(n, sin(7.f*x) + cos(5.f*y) + sin(3.f*z+x*y));
+                nodalint->SetValue(n, (i*3 + j*5 + k*7) % 100);
+            }
+        }
+    }
+    data->AddField(new eavlField(1, nodal, eavlField::ASSOC_POINTS));
+    data->AddField(new eavlField(1, nodalint, eavlField::ASSOC_POINTS));
+
+    eavlFloatArray *zonal = new eavlFloatArray("zonal", 1, ncells);
+    for (int c=0; c<ncells; ++c)
+        zonal->SetValue(c, float(c % 1000) * 0.5f);
+    data->AddField(new eavlField(0, zonal, eavlField::ASSOC_CELL_SET, "cells"));
+
+    eavlCoordinates *coords = new eavlCoordinatesCartesian(log,
+                                            eavlCoordinatesCartesian::X,
+                                            eavlCoordinatesCartesian::Y,
+                                            eavlCoordinatesCartesian::Z);
+    coords->SetAxis(0, new eavlCoordinateAxisField("x"));
+    coords->SetAxis(1, new eavlCoordinateAxisField("y"));
+    coords->SetAxis(2, new eavlCoordinateAxisField("z"));
+    data->AddCoordinateSystem(coords);
+
+    eavlCellSet *cells = new eavlCellSetAllStructured("cells", reg);
+    data->AddCellSet(cells);
+
+    return data;
+}
+
+static eavlDataSet *Isosurface(eavlDataSet *data, double value,
+                               bool flyingedges, double &seconds)
+{
+    eavlIsosurfaceFilter *iso = new eavlIsosurfaceFilter;
+    iso->SetInput(data);
+    iso->SetCellSet("cells");
+    iso->SetField("nodal");
+    iso->SetIsoValue(value);
+    iso->SetUseFlyingEdges(flyingedges);
+    int th = eavlTimer::Start();
+    iso->Execute();
+    seconds = eavlTimer::Stop(th, flyingedges ? "flying edges" : "general");
+    eavlDataSet *result = iso->GetOutput();
+    delete iso;
+    return result;
+}
+
+static bool Compare(const string &what, eavlDataSet *a, eavlDataSet *b)
+{
+    if (a->GetNumPoints() != b->GetNumPoints())
+    {
+        cerr << what << ": "<<a->GetNumPoints()<<" points but expected "
+             << b->GetNumPoints() << endl;
+        return false;
+    }
+
+    eavlCellSet *ca = a->GetCellSet(0);
+    eavlCellSet *cb = b->GetCellSet(0);
+    if (ca->GetNumCells() != cb->GetNumCells())
+    {
+        cerr << what << ": "<<ca->GetNumCells()<<" triangles but expected "
+             << cb->GetNumCells() << endl;
+        return false;
+    }
+    for (int c=0; c<ca->GetNumCells(); c++)
+    {
+        eavlCell ea = ca->GetCellNodes(c);
+        eavlCell eb = cb->GetCellNodes(c);
+        bool same = (ea.type == eb.type && ea.numIndices == eb.numIndices);
+        for (int p=0; same && p<ea.numIndices; p++)
+            same = (ea.indices[p] == eb.indices[p]);
+        if (!same)
+        {
+            cerr << what << ": triangle "<<c<<" differs\n";
+            return false;
+        }
+    }
+
+    if (a->GetNumFields() != b->GetNumFields())
+    {
+        cerr << what << ": "<<a->GetNumFields()<<" fields but expected "
+             << b->GetNumFields() << endl;
+        return false;
+    }
+    for (int f=0; f<a->GetNumFields(); f++)
+    {
+        eavlArray *fa = a->GetField(f)->GetArray();
+        eavlArray *fb = b->GetField(f)->GetArray();
+        if (fa->GetName() != fb->GetName() ||
+            a->GetField(f)->GetAssociation() != b->GetField(f)->GetAssociation() ||
+            fa->GetNumberOfTuples() != fb->GetNumberOfTuples())
+        {
+            cerr << what << ": field "<<fa->GetName()<<" differs from "
+                 << fb->GetName() << endl;
+            return false;
+        }
+        for (int i=0; i<fa->GetNumberOfTuples(); i++)
+        {
+            if (fa->GetComponentAsDouble(i,0) != fb->GetComponentAsDouble(i,0))
+            {
+                cerr << what << ": field "<<fa->GetName()<<" value "<<i
+                     << " is "<<fa->GetComponentAsDouble(i,0)
+                     << " but expected "<<fb->GetComponentAsDouble(i,0)<<endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 100;
+        if (n < 2)
+            THROW(eavlException,"Expected a size of at least 2");
+
+        // a tiny grid, an anisotropic one, and the requested size
+        int sizes[3][3] = {{2,2,2}, {17,5,9}, {n,n,n}};
+        double values[4] = {-0.5, 0.25, 1.0, 10.0};
+        bool ok = true;
+        double fetime = 0, generaltime = 0;
+        for (int s=0; s<3; s++)
+        {
+            eavlDataSet *data = GenerateRectXYZ(sizes[s][0], sizes[s][1],
+                                                sizes[s][2]);
+            for (int v=0; v<4; v++)
+            {
+                ostringstream what;
+                what << sizes[s][0]<<"x"<<sizes[s][1]<<"x"<<sizes[s][2]
+                     << " at "<<values[v];
+                double fesec, generalsec;
+                eavlDataSet *fe = Isosurface(data, values[v], true, fesec);
+                eavlDataSet *general = Isosurface(data, values[v], false,
+                                                  generalsec);
+                ok &= Compare(what.str(), fe, general);
+                if (s == 2)
+                {
+                    fetime += fesec;
+                    generaltime += generalsec;
+                }
+                delete fe;
+                delete general;
+            }
+            delete data;
+        }
+        if (!ok)
+            THROW(eavlException,"Flying edges output differed");
+
+        cout << "flying edges output matched the general algorithm\n";
+        cout << "isosurfacing "<<n<<"^3 nodes four times: flying edges "
+             << fetime << " sec, general "<<generaltime<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [nodes per axis]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlCellSetExplicit.h"
+#include "eavl2DGraphLayoutForceMutator.h"
+
+//
+// Lays out a generated graph for one iteration, with the repulsive
+// forces computed exactly and with the Barnes-Hut quadtree, and checks
+// the quadtree forces against the exact ones: they should agree to
+// rounding error with a tiny opening angle, and closely with the
+// default one.  Then times a full layout of a larger graph each way.
+//
+
+// a ring of n vertices with a chord from every tenth one, or just the
+// vertices with no edges
+static eavlDataSet *GenerateGraph(int n, bool edges)
+{
+    eavlDataSet *data = new eavlDataSet();
+    data->SetNumPoints(n);
+
+    eavlExplicitConnectivity conn;
+    for (int i=0; edges && i<n; i++)
+    {
+        int ring[2] = {i, (i+1) % n};
+        conn.AddElement(EAVL_BEAM, 2, ring);
+        if (i % 10 == 0)
+        {
+            int chord[2] = {i, (i*7 + n/2) % n};
+            conn.AddElement(EAVL_BEAM, 2, chord);
+        }
+    }
+    eavlCellSetExplicit *cells = new eavlCellSetExplicit("edges", 1);
+    cells->SetCellNodeConnectivity(conn);
+    data->AddCellSet(cells);
+    return data;
+}
+
+// lays out a new graph from the same random start, returning the final
+// positions and the time taken; without edges or gravity, only the
+// repulsive forces move the vertices
+static void Layout(int n, bool attract, int niter, double start,
+                   double theta, vector<float> &x, vector<float> &y,
+                   double &seconds)
+{
+    eavlDataSet *data = GenerateGraph(n, attract);
+    eavl2DGraphLayoutForceMutator layout;
+    layout.SetDataSet(data);
+    layout.SetCellSet("edges");
+    layout.SetNumIterations(niter);
+    layout.SetStartDist(start);
+    layout.SetFinalDist(start);
+    layout.SetOpeningAngle(theta);
+    if (!attract)
+        layout.SetGravityConstant(0);
+
+    srand(12345);
+    int th = eavlTimer::Start();
+    layout.Execute();
+    seconds = eavlTimer::Stop(th, "layout");
+
+    eavlArray *ax = data->GetField("newx")->GetArray();
+    eavlArray *ay = data->GetField("newy")->GetArray();
+    x.resize(n);
+    y.resize(n);
+    for (int i=0; i<n; i++)
+    {
+        x[i] = ax->GetComponentAsDouble(i,0);
+        y[i] = ay->GetComponentAsDouble(i,0);
+    }
+    delete data;
+}
+
+// the RMS difference of two layouts' displacements from the same start,
+// relative to the RMS of the first's displacements
+static double RelativeError(const vector<float> &x0, const vector<float> &y0,
+                            const vector<float> &xa, const vector<float> &ya,
+                            const vector<float> &xb, const vector<float> &yb)
+{
+    double diff = 0, norm = 0;
+    for (size_t i=0; i<x0.size(); i++)
+    {
+        double dax = xa[i] - x0[i], day = ya[i] - y0[i];
+        double dbx = xb[i] - x0[i], dby = yb[i] - y0[i];
+        diff += (dax-dbx)*(dax-dbx) + (day-dby)*(day-dby);
+        norm += dax*dax + day*day;
+    }
+    return sqrt(diff / norm);
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 20000;
+        if (n < 10)
+            THROW(eavlException,"Expected at least 10 vertices");
+
+        // no iterations gives the starting positions; a large enough
+        // limit on the motion leaves the forces unclamped
+        int small = 2000;
+        double sec;
+        vector<float> x0, y0, xe, ye, xt, yt, xb, yb;
+        Layout(small, false, 0, 1.e6, 0.0, x0, y0, sec);
+        Layout(small, false, 1, 1.e6, 0.0, xe, ye, sec);
+        Layout(small, false, 1, 1.e6, 1.e-3, xt, yt, sec);
+        Layout(small, false, 1, 1.e6, 0.5, xb, yb, sec);
+        double tinyerr = RelativeError(x0, y0, xe, ye, xt, yt);
+        double bherr = RelativeError(x0, y0, xe, ye, xb, yb);
+        cout << "relative force error with opening angle 0.001: "<<tinyerr
+             << ", with 0.5: "<<bherr<<endl;
+        if (!(tinyerr < 1.e-4) || !(bherr < 2.e-2))
+            THROW(eavlException,"Quadtree forces differed from exact ones");
+
+        // a full layout, which should stay finite
+        double exactsec, bhsec;
+        Layout(n, true, 20, 1.0, 0.0, xe, ye, exactsec);
+        Layout(n, true, 20, 1.0, 0.5, xb, yb, bhsec);
+        for (int i=0; i<n; i++)
+        {
+            if (!(fabs(xb[i]) < 1.e10 && fabs(yb[i]) < 1.e10))
+                THROW(eavlException,"Layout produced an invalid position");
+        }
+
+        cout << "quadtree forces matched exact ones\n";
+        cout << "20 iterations on "<<n<<" vertices: exact "<<exactsec
+             << " sec, Barnes-Hut "<<bhsec<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvertices]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,260 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlHistogramOp.h"
+#include "eavlScalarBinFilter.h"
+
+//
+// Counts values into bins with eavlHistogramOp, both over a given range
+// holding values outside it, on its cutoffs and NaNs, and over the range
+// it finds itself, and runs eavlScalarBinFilter.  Checks the counts,
+// ranges and cutoffs against a serial count.
+//
+
+// the bin a value falls in, by scanning the cutoffs: the first bin below
+// the first cutoff, the last above the last, and none for NaN
+static int SerialBin(float v, float lo, float hi, int nbins)
+{
+    if (v != v)
+        return -1;
+    eavlUniformBinFunctor binner(lo, hi, nbins);
+    int bin = 0;
+    for (int i=1; i<nbins; ++i)
+        if (v >= binner.cutoff(i))
+            bin = i;
+    return bin;
+}
+
+static vector<int> SerialCounts(eavlFloatArray *values, float lo, float hi,
+                                int nbins)
+{
+    vector<int> counts(nbins, 0);
+    for (int i=0; i<values->GetNumberOfTuples(); ++i)
+    {
+        int bin = SerialBin(values->GetValue(i), lo, hi, nbins);
+        if (bin >= 0)
+            counts[bin]++;
+    }
+    return counts;
+}
+
+// values spread over lo..hi and beyond it, with every cutoff, the range
+// ends and a few NaNs among them
+static eavlFloatArray *MakeValues(int n, float lo, float hi, int nbins)
+{
+    eavlFloatArray *values = new eavlFloatArray("values", 1, n);
+    eavlUniformBinFunctor binner(lo, hi, nbins);
+    unsigned int seed = 12345;
+    for (int i=0; i<n; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        float t = float((seed >> 8) % 100000) / 100000.f;
+        values->SetValue(i, lo - 0.25f*(hi-lo) + 1.5f*(hi-lo)*t);
+    }
+    int k = 0;
+    for (int i=0; i<=nbins && k<n; ++i, k+=7)
+        values->SetValue(k, binner.cutoff(i));
+    for (int i=0; i<4 && k<n; ++i, k+=7)
+    {
+        float edges[4] = {lo, hi, lo - 1000.f, hi + 1000.f};
+        values->SetValue(k, edges[i]);
+    }
+    float zero = 0.f;
+    for (int i=0; i<3 && k<n; ++i, k+=7)
+        values->SetValue(k, zero / zero);
+    return values;
+}
+
+static bool SameCounts(const string &what, eavlIntArray *counts,
+                       const vector<int> &expected)
+{
+    for (size_t b=0; b<expected.size(); ++b)
+    {
+        if (counts->GetValue(b) != expected[b])
+        {
+            cerr << what << ": bin " << b << " has " << counts->GetValue(b)
+                 << " values but expected " << expected[b] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// bins over a given range, which some values fall outside
+static bool CheckGivenRange(int n, int nbins)
+{
+    float lo = -2.5f, hi = 7.f;
+    eavlFloatArray *values = MakeValues(n, lo, hi, nbins);
+    eavlIntArray *counts = new eavlIntArray("counts", 1, nbins);
+    eavlFloatArray *range = new eavlFloatArray("range", 1, 2);
+    range->SetValue(0, lo);
+    range->SetValue(1, hi);
+    eavlExecutor::AddOperation(
+        new_eavlHistogramOp(eavlOpArgs(values), counts, range, false),
+        "count values in each bin of a given range");
+    eavlExecutor::Go();
+
+    bool ok = SameCounts("given range", counts,
+                         SerialCounts(values, lo, hi, nbins));
+    if (range->GetValue(0) != lo || range->GetValue(1) != hi)
+    {
+        cerr << "given range: the range was changed\n";
+        ok = false;
+    }
+    int total = 0, nans = 0;
+    for (int b=0; b<nbins; ++b)
+        total += counts->GetValue(b);
+    for (int i=0; i<n; ++i)
+        nans += (values->GetValue(i) != values->GetValue(i));
+    if (total != n - nans)
+    {
+        cerr << "given range: counted " << total << " values, expected "
+             << n - nans << endl;
+        ok = false;
+    }
+    delete values;
+    delete counts;
+    delete range;
+    return ok;
+}
+
+// bins over the range the operation finds
+static bool CheckFoundRange(int n, int nbins)
+{
+    eavlFloatArray *values = new eavlFloatArray("values", 1, n);
+    float minval = FLT_MAX, maxval = -FLT_MAX;
+    for (int i=0; i<n; ++i)
+    {
+        float v = float((i * 7919) % 1013) * 0.37f - 90.f;
+        values->SetValue(i, v);
+        minval = (v < minval) ? v : minval;
+        maxval = (v > maxval) ? v : maxval;
+    }
+    eavlIntArray *counts = new eavlIntArray("counts", 1, nbins);
+    eavlFloatArray *range = new eavlFloatArray("range", 1, 2);
+    eavlExecutor::AddOperation(
+        new_eavlHistogramOp(eavlOpArgs(values), counts, range, true),
+        "find range and count values in each bin");
+    eavlExecutor::Go();
+
+    bool ok = true;
+    if (range->GetValue(0) != minval || range->GetValue(1) != maxval)
+    {
+        cerr << "found range: " << range->GetValue(0) << ".."
+             << range->GetValue(1) << " but expected " << minval << ".."
+             << maxval << endl;
+        ok = false;
+    }
+    ok &= SameCounts("found range", counts,
+                     SerialCounts(values, minval, maxval, nbins));
+    delete values;
+    delete counts;
+    delete range;
+    return ok;
+}
+
+// the filter's cutoffs and counts match a serial count over the range
+static bool CheckFilter(int n, int nbins)
+{
+    eavlDataSet *data = new eavlDataSet;
+    data->SetNumPoints(n);
+    eavlFloatArray *values = new eavlFloatArray("values", 1, n);
+    float minval = FLT_MAX, maxval = -FLT_MAX;
+    for (int i=0; i<n; ++i)
+    {
+        float v = sin(float(i) * 0.01f) * float(i % 17);
+        values->SetValue(i, v);
+        minval = (v < minval) ? v : minval;
+        maxval = (v > maxval) ? v : maxval;
+    }
+    data->AddField(new eavlField(1, values, eavlField::ASSOC_POINTS));
+
+    eavlScalarBinFilter bin;
+    bin.SetInput(data);
+    bin.SetField("values");
+    bin.SetNumBins(nbins);
+    bin.Execute();
+    eavlDataSet *out = bin.GetOutput();
+
+    bool ok = true;
+    eavlArray *cutoffs = out->GetField("cutoffs")->GetArray();
+    eavlArray *counts = out->GetField("counts")->GetArray();
+    if (cutoffs->GetNumberOfTuples() != nbins+1 ||
+        counts->GetNumberOfTuples() != nbins ||
+        out->GetNumPoints() != nbins+1)
+    {
+        cerr << "filter: wrong number of cutoffs or bins\n";
+        ok = false;
+    }
+    else
+    {
+        eavlUniformBinFunctor binner(minval, maxval, nbins);
+        if (cutoffs->GetComponentAsDouble(0,0) != minval ||
+            cutoffs->GetComponentAsDouble(nbins,0) != maxval)
+        {
+            cerr << "filter: cutoffs don't span the range\n";
+            ok = false;
+        }
+        for (int i=0; i<=nbins; ++i)
+        {
+            if (cutoffs->GetComponentAsDouble(i,0) != binner.cutoff(i))
+            {
+                cerr << "filter: cutoff " << i << " differs\n";
+                ok = false;
+                break;
+            }
+        }
+        vector<int> expected = SerialCounts(values, minval, maxval, nbins);
+        for (int b=0; b<nbins; ++b)
+        {
+            if (counts->GetComponentAsDouble(b,0) != expected[b])
+            {
+                cerr << "filter: bin " << b << " has "
+                     << counts->GetComponentAsDouble(b,0)
+                     << " values but expected " << expected[b] << endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+    delete out;
+    delete data;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 3)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 100000;
+        int nbins = (argc > 2) ? atoi(argv[2]) : 37;
+        if (n < 100 || nbins < 1)
+            THROW(eavlException,"Expected at least 100 values and one bin");
+
+        bool ok = true;
+        ok &= CheckGivenRange(n, nbins);
+        ok &= CheckGivenRange(n, 1);
+        ok &= CheckFoundRange(n, nbins);
+        ok &= CheckFilter(n, nbins);
+        if (!ok)
+            THROW(eavlException,"Histogram counts were incorrect");
+        cout << "histogram counts matched a serial count\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [values] [bins]\n";
+        return 1;
+    }
+
+    return 0;
+}
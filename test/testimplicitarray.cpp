@@ -0,0 +1,321 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlImplicitArray.h"
+#include "eavlExecutor.h"
+#include "eavlMapOp.h"
+#include "eavlGatherOp.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Checks the values and ranges of constant, counting, uniform and
+// Cartesian product arrays against the same values stored in ordinary
+// arrays, then runs maps and a gather reading them, and compares the
+// results with the same operations over the stored arrays.  Also checks
+// that they survive serialization, and reports the time taken to map
+// over the coordinates of a uniform grid each way.
+//
+
+struct SumFunctor
+{
+    EAVL_FUNCTOR float operator()(tuple<float,float,float> in)
+    {
+        return get<0>(in) + get<1>(in) + get<2>(in);
+    }
+};
+
+struct MultiplyAddFunctor
+{
+    EAVL_FUNCTOR float operator()(tuple<float,float,float> in)
+    {
+        return get<0>(in) * get<1>(in) + get<2>(in);
+    }
+};
+
+// an ordinary float array holding the same values as a
+static eavlFloatArray *Materialize(eavlArray *a)
+{
+    int nt = a->GetNumberOfTuples();
+    int nc = a->GetNumberOfComponents();
+    eavlFloatArray *m = new eavlFloatArray(a->GetName(), nc, nt);
+    for (int i=0; i<nt; ++i)
+        for (int c=0; c<nc; ++c)
+            m->SetComponentFromDouble(i, c, a->GetComponentAsDouble(i, c));
+    return m;
+}
+
+static bool Same(double a, double b)
+{
+    return fabs(a - b) <= 1.e-6 * (fabs(a) + fabs(b) + 1.);
+}
+
+static bool CheckValues(const string &what, eavlArray *a, eavlArray *expected)
+{
+    if (a->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+        a->GetNumberOfComponents() != expected->GetNumberOfComponents())
+    {
+        cerr << what << ": size "<<a->GetNumberOfTuples()<<"x"
+             << a->GetNumberOfComponents()<<" but expected "
+             << expected->GetNumberOfTuples()<<"x"
+             << expected->GetNumberOfComponents()<<endl;
+        return false;
+    }
+    for (int i=0; i<a->GetNumberOfTuples(); ++i)
+    {
+        for (int c=0; c<a->GetNumberOfComponents(); ++c)
+        {
+            double v = a->GetComponentAsDouble(i, c);
+            double e = expected->GetComponentAsDouble(i, c);
+            if (!Same(v, e))
+            {
+                cerr << what << ": value "<<i<<","<<c<<" is "<<v
+                     << " but expected "<<e<<endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// values, and ranges computed from the parameters, against the stored copy
+static bool CheckArray(const string &what, eavlArray *a)
+{
+    eavlFloatArray *m = Materialize(a);
+    bool ok = CheckValues(what, a, m);
+    for (int c=0; ok && c<a->GetNumberOfComponents(); ++c)
+    {
+        if (!Same(a->GetComponentMin(c), m->GetComponentMin(c)) ||
+            !Same(a->GetComponentMax(c), m->GetComponentMax(c)))
+        {
+            cerr << what << ": component "<<c<<" range "
+                 << a->GetComponentMin(c)<<".."<<a->GetComponentMax(c)
+                 << " but expected "<<m->GetComponentMin(c)<<".."
+                 << m->GetComponentMax(c)<<endl;
+            ok = false;
+        }
+    }
+    if (ok && (!Same(a->GetMagnitudeMin(), m->GetMagnitudeMin()) ||
+               !Same(a->GetMagnitudeMax(), m->GetMagnitudeMax())))
+    {
+        cerr << what << ": magnitude range "<<a->GetMagnitudeMin()<<".."
+             << a->GetMagnitudeMax()<<" but expected "
+             << m->GetMagnitudeMin()<<".."<<m->GetMagnitudeMax()<<endl;
+        ok = false;
+    }
+    delete m;
+    return ok;
+}
+
+// writes a to a file and reads it back
+static eavlArray *RoundTrip(eavlArray *a)
+{
+    const char *fn = "testimplicitarray.tmp";
+    {
+        ofstream f(fn, ios::binary);
+        eavlStream s(f);
+        a->serialize(s);
+    }
+    ifstream f(fn, ios::binary);
+    eavlStream s(f);
+    string nm;
+    s >> nm;
+    eavlArray *b = eavlArray::CreateObjFromName(nm);
+    b->deserialize(s);
+    return b;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 64;
+        if (n < 2)
+            THROW(eavlException,"Expected a size of at least 2");
+
+        bool ok = true;
+        int dims[3] = {n, n/2+1, n/3+2};
+        double origin[3] = {-1.5, 0.25, -7.};
+        double spacing[3] = {0.05, 0.5, 0.125};
+        int nnodes = dims[0] * dims[1] * dims[2];
+
+        eavlConstantArray<float> cnst("const", 2.5f, nnodes);
+        eavlConstantArray<int> cnst2("const2", -3, 10, 3);
+        eavlCountingArray<float> count("count", nnodes, -10.f, 0.5f);
+        eavlCountingArray<int> index("index", nnodes);
+        eavlUniformArray<float> uniform("uniform", 3, dims, origin, spacing);
+        eavlUniformArray<float> axis("axis", 1, dims, origin, spacing);
+
+        eavlFloatArray *xs = new eavlFloatArray("x", 1, dims[0]);
+        eavlFloatArray *ys = new eavlFloatArray("y", 1, dims[1]);
+        eavlFloatArray *zs = new eavlFloatArray("z", 1, dims[2]);
+        for (int i=0; i<dims[0]; ++i)
+            xs->SetValue(i, float(i*i) * 0.01f - 1.f);
+        for (int j=0; j<dims[1]; ++j)
+            ys->SetValue(j, sin(float(j)));
+        for (int k=0; k<dims[2]; ++k)
+            zs->SetValue(k, float(k) - 0.5f);
+        eavlCartesianProductArray<float> rect("rect", xs, ys, zs);
+        eavlCartesianProductArray<float> rect2("rect2", xs, ys);
+
+        ok &= CheckArray("constant", &cnst);
+        ok &= CheckArray("multi-component constant", &cnst2);
+        ok &= CheckArray("counting", &count);
+        ok &= CheckArray("index", &index);
+        ok &= CheckArray("uniform", &uniform);
+        ok &= CheckArray("uniform axis", &axis);
+        ok &= CheckArray("cartesian product", &rect);
+        ok &= CheckArray("2D cartesian product", &rect2);
+
+        // the stored copies
+        eavlFloatArray *mcnst = Materialize(&cnst);
+        eavlFloatArray *mcount = Materialize(&count);
+        eavlFloatArray *muniform = Materialize(&uniform);
+        eavlFloatArray *mrect = Materialize(&rect);
+        eavlIntArray *mindex = new eavlIntArray("mindex", 1, nnodes);
+        for (int i=0; i<nnodes; ++i)
+            mindex->SetValue(i, i);
+
+        eavlFloatArray *out = new eavlFloatArray("out", 1, nnodes);
+        eavlFloatArray *expected = new eavlFloatArray("expected", 1, nnodes);
+
+        // sum of the components of each node of a uniform grid
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlUniformArray<float> >(&uniform, 0),
+                                     eavlIndexable<eavlUniformArray<float> >(&uniform, 1),
+                                     eavlIndexable<eavlUniformArray<float> >(&uniform, 2)),
+                          eavlOpArgs(out), SumFunctor()), "implicit sum");
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlFloatArray>(muniform, 0),
+                                     eavlIndexable<eavlFloatArray>(muniform, 1),
+                                     eavlIndexable<eavlFloatArray>(muniform, 2)),
+                          eavlOpArgs(expected), SumFunctor()), "stored sum");
+        eavlExecutor::Go();
+        ok &= CheckValues("uniform sum", out, expected);
+
+        // a counting sequence times a constant, plus a rectilinear
+        // coordinate, mixing implicit and stored inputs
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlCountingArray<float> >(&count),
+                                     eavlIndexable<eavlConstantArray<float> >(&cnst),
+                                     eavlIndexable<eavlCartesianProductArray<float> >(&rect, 1)),
+                          eavlOpArgs(out), MultiplyAddFunctor()), "implicit multiply-add");
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlFloatArray>(mcount),
+                                     eavlIndexable<eavlFloatArray>(mcnst),
+                                     eavlIndexable<eavlFloatArray>(mrect, 1)),
+                          eavlOpArgs(expected), MultiplyAddFunctor()), "stored multiply-add");
+        eavlExecutor::Go();
+        ok &= CheckValues("multiply-add", out, expected);
+
+        // gathers from a counting sequence, with a counting sequence of
+        // indices, in reverse
+        int ngather = nnodes / 3;
+        eavlIntArray *gathered = new eavlIntArray("gathered", 1, ngather);
+        eavlCountingArray<int> reverse("reverse", ngather, nnodes-1, -3);
+        eavlExecutor::AddOperation(
+            new_eavlGatherOp(eavlOpArgs(eavlIndexable<eavlCountingArray<int> >(&index)),
+                             eavlOpArgs(gathered),
+                             eavlOpArgs(eavlIndexable<eavlIntArray>(mindex))),
+            "implicit gather");
+        eavlExecutor::Go();
+        for (int i=0; ok && i<ngather; ++i)
+        {
+            if (gathered->GetValue(i) != i)
+            {
+                cerr << "gather: value "<<i<<" is "<<gathered->GetValue(i)
+                     << " but expected "<<i<<endl;
+                ok = false;
+            }
+        }
+        eavlExecutor::AddOperation(
+            new_eavlGatherOp(eavlOpArgs(mindex),
+                             eavlOpArgs(gathered),
+                             eavlOpArgs(eavlIndexable<eavlCountingArray<int> >(&reverse))),
+            "implicit indices");
+        eavlExecutor::Go();
+        for (int i=0; ok && i<ngather; ++i)
+        {
+            if (gathered->GetValue(i) != nnodes-1 - 3*i)
+            {
+                cerr << "gather by implicit indices: value "<<i<<" is "
+                     << gathered->GetValue(i)<<" but expected "
+                     << nnodes-1 - 3*i<<endl;
+                ok = false;
+            }
+        }
+
+        // serialization
+        eavlArray *implicit[5] = {&cnst, &cnst2, &count, &uniform, &rect};
+        for (int a=0; a<5; ++a)
+        {
+            eavlArray *b = RoundTrip(implicit[a]);
+            ok &= (b->className() == implicit[a]->className() &&
+                   b->GetName() == implicit[a]->GetName() &&
+                   CheckValues("serialized " + implicit[a]->className(),
+                               b, implicit[a]));
+            delete b;
+        }
+        remove("testimplicitarray.tmp");
+
+        if (!ok)
+            THROW(eavlException,"Implicit arrays differed from stored ones");
+        cout << "implicit arrays matched stored ones\n";
+
+        // times the sum over the uniform grid each way
+        int th = eavlTimer::Start();
+        for (int r=0; r<10; ++r)
+        {
+            eavlExecutor::AddOperation(
+                new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlUniformArray<float> >(&uniform, 0),
+                                         eavlIndexable<eavlUniformArray<float> >(&uniform, 1),
+                                         eavlIndexable<eavlUniformArray<float> >(&uniform, 2)),
+                              eavlOpArgs(out), SumFunctor()), "implicit sum");
+            eavlExecutor::Go();
+        }
+        double implicitsec = eavlTimer::Stop(th, "implicit");
+        th = eavlTimer::Start();
+        for (int r=0; r<10; ++r)
+        {
+            eavlExecutor::AddOperation(
+                new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlFloatArray>(muniform, 0),
+                                         eavlIndexable<eavlFloatArray>(muniform, 1),
+                                         eavlIndexable<eavlFloatArray>(muniform, 2)),
+                              eavlOpArgs(expected), SumFunctor()), "stored sum");
+            eavlExecutor::Go();
+        }
+        double storedsec = eavlTimer::Stop(th, "stored");
+        cout << "10 sums over "<<nnodes<<" uniform nodes: implicit "
+             << implicitsec<<" sec, stored "<<storedsec<<" sec; the stored "
+             << "coordinates take "<<muniform->GetMemoryUsage()
+             << " bytes, the implicit ones "<<uniform.GetMemoryUsage()
+             << endl;
+
+        delete mcnst;
+        delete mcount;
+        delete muniform;
+        delete mrect;
+        delete mindex;
+        delete out;
+        delete expected;
+        delete gathered;
+        delete xs;
+        delete ys;
+        delete zs;
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [nodes per axis]\n";
+        return 1;
+    }
+
+    return 0;
+}
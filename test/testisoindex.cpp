@@ -0,0 +1,491 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlIsosurfaceFilter.h"
+#include "eavlIsosurfaceIndex.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+
+#include "eavlCellSetAllStructured.h"
+#include "eavlCellSetExplicit.h"
+#include "eavlCoordinates.h"
+#include "eavlLogicalStructureRegular.h"
+
+//
+// Sweeps the isovalue over generated structured and tetrahedral
+// meshes with the isosurface filter's index, checking that the
+// index finds exactly the bricks a brute force search does, that it
+// notices changes to the field but isn't rebuilt when operations only
+// read it, and that the indexed output is identical to the general
+// algorithm's.  Also extracts all the isovalues at once, checking each
+// level against the single value output.  Reports the time taken by a
+// sweep with and without the index, and by the single multi-level pass.
+//
+
+struct DoubleFunctor
+{
+    EAVL_FUNCTOR float operator()(float x) { return 2.f*x; }
+};
+
+static float Value(int i, int j, int k, int n)
+{
+    float x = float(i)/float(n-1);
+    float y = float(j)/float(n-1);
+    float z = float(k)/float(n-1);
+    return sin(7.f*x) + cos(5.f*y) + sin(3.f*z+x*y);
+}
+
+// coordinates, a float and an int nodal field, and a zonal field
+static void AddFields(eavlDataSet *data, int n, int ncells, bool separate)
+{
+    int npts = n*n*n;
+    eavlFloatArray *nodal = new eavlFloatArray("nodal", 1, npts);
+    eavlIntArray *nodalint = new eavlIntArray("nodalint", 1, npts);
+    eavlFloatArray *xc = new eavlFloatArray("xcoord", 1, npts);
+    eavlFloatArray *yc = new eavlFloatArray("ycoord", 1, npts);
+    eavlFloatArray *zc = new eavlFloatArray("zcoord", 1, npts);
+    for (int k=0; k<n; ++k)
+    {
+        for (int j=0; j<n; ++j)
+        {
+            for (int i=0; i<n; ++i)
+            {
+                int p = (k*n + j)*n + i;
+                nodal->SetValue(p, Value(i,j,k,n));
+                nodalint->SetValue(p, (i*3 + j*5 + k*7) % 100);
+                xc->SetValue(p, float(i));
+                yc->SetValue(p, float(j)*0.5f);
+                zc->SetValue(p, float(k)*float(k));
+            }
+        }
+    }
+    data->AddField(new eavlField(1, nodal, eavlField::ASSOC_POINTS));
+    data->AddField(new eavlField(1, nodalint, eavlField::ASSOC_POINTS));
+    if (separate)
+    {
+        data->AddField(new eavlField(1, xc, eavlField::ASSOC_POINTS));
+        data->AddField(new eavlField(1, yc, eavlField::ASSOC_POINTS));
+        data->AddField(new eavlField(1, zc, eavlField::ASSOC_POINTS));
+    }
+    else
+    {
+        delete xc;
+        delete yc;
+        delete zc;
+    }
+
+    eavlFloatArray *zonal = new eavlFloatArray("zonal", 1, ncells);
+    for (int c=0; c<ncells; ++c)
+        zonal->SetValue(c, float(c % 1000) * 0.5f);
+    data->AddField(new eavlField(0, zonal, eavlField::ASSOC_CELL_SET, "cells"));
+}
+
+// an n^3 node rectilinear grid
+static eavlDataSet *GenerateRect(int n)
+{
+    eavlDataSet *data = new eavlDataSet();
+    data->SetNumPoints(n*n*n);
+
+    eavlRegularStructure reg;
+    reg.SetNodeDimension3D(n, n, n);
+    eavlLogicalStructure *log = new eavlLogicalStructureRegular(reg.dimension,
+                                                                reg);
+    data->SetLogicalStructure(log);
+
+    const char *names[3] = {"x", "y", "z"};
+    for (int d=0; d<3; d++)
+    {
+        eavlFloatArray *axis = new eavlFloatArray(names[d], 1, n);
+        for (int i=0; i<n; ++i)
+            axis->SetValue(i, float(i*(d+1)));
+        data->AddField(new eavlField(1, axis, eavlField::ASSOC_LOGICALDIM, d));
+    }
+    AddFields(data, n, (n-1)*(n-1)*(n-1), false);
+
+    eavlCoordinates *coords = new eavlCoordinatesCartesian(log,
+                                            eavlCoordinatesCartesian::X,
+                                            eavlCoordinatesCartesian::Y,
+                                            eavlCoordinatesCartesian::Z);
+    coords->SetAxis(0, new eavlCoordinateAxisField("x"));
+    coords->SetAxis(1, new eavlCoordinateAxisField("y"));
+    coords->SetAxis(2, new eavlCoordinateAxisField("z"));
+    data->AddCoordinateSystem(coords);
+    data->AddCellSet(new eavlCellSetAllStructured("cells", reg));
+    return data;
+}
+
+// the same nodes, with each hexahedron split into six tetrahedra
+static eavlDataSet *GenerateTets(int n)
+{
+    static const int tets[6][4] = {{0,1,2,6}, {0,2,3,6}, {0,3,7,6},
+                                   {0,7,4,6}, {0,4,5,6}, {0,5,1,6}};
+    eavlDataSet *data = new eavlDataSet();
+    data->SetNumPoints(n*n*n);
+
+    eavlExplicitConnectivity conn;
+    for (int k=0; k<n-1; ++k)
+    {
+        for (int j=0; j<n-1; ++j)
+        {
+            for (int i=0; i<n-1; ++i)
+            {
+                int p = (k*n + j)*n + i;
+                int hex[8] = {p, p+1, p+n+1, p+n,
+                              p+n*n, p+n*n+1, p+n*n+n+1, p+n*n+n};
+                for (int t=0; t<6; t++)
+                {
+                    int ids[4];
+                    for (int v=0; v<4; v++)
+                        ids[v] = hex[tets[t][v]];
+                    conn.AddElement(EAVL_TET, 4, ids);
+                }
+            }
+        }
+    }
+    AddFields(data, n, 6*(n-1)*(n-1)*(n-1), true);
+
+    eavlCoordinates *coords = new eavlCoordinatesCartesian(NULL,
+                                            eavlCoordinatesCartesian::X,
+                                            eavlCoordinatesCartesian::Y,
+                                            eavlCoordinatesCartesian::Z);
+    coords->SetAxis(0, new eavlCoordinateAxisField("xcoord"));
+    coords->SetAxis(1, new eavlCoordinateAxisField("ycoord"));
+    coords->SetAxis(2, new eavlCoordinateAxisField("zcoord"));
+    data->AddCoordinateSystem(coords);
+    eavlCellSetExplicit *cells = new eavlCellSetExplicit("cells", 3);
+    cells->SetCellNodeConnectivity(conn);
+    data->AddCellSet(cells);
+    return data;
+}
+
+// what an isosurface filter produced, kept after the filter moves on
+struct Result
+{
+    int npoints;
+    vector<int> conn;
+    int ntris;
+    vector<string> names;
+    vector<bool> nodal;
+    vector<vector<double> > values;
+};
+
+static Result Extract(eavlDataSet *data)
+{
+    Result r;
+    r.npoints = data->GetNumPoints();
+    eavlCellSet *cells = data->GetCellSet(0);
+    r.ntris = cells->GetNumCells();
+    for (int c=0; c<cells->GetNumCells(); c++)
+    {
+        eavlCell cell = cells->GetCellNodes(c);
+        r.conn.push_back(cell.type);
+        for (int p=0; p<cell.numIndices; p++)
+            r.conn.push_back(cell.indices[p]);
+    }
+    for (int f=0; f<data->GetNumFields(); f++)
+    {
+        eavlArray *a = data->GetField(f)->GetArray();
+        r.names.push_back(a->GetName());
+        r.nodal.push_back(data->GetField(f)->GetAssociation() ==
+                          eavlField::ASSOC_POINTS);
+        r.values.push_back(vector<double>());
+        for (int i=0; i<a->GetNumberOfTuples(); i++)
+            r.values.back().push_back(a->GetComponentAsDouble(i,0));
+    }
+    return r;
+}
+
+static bool Compare(const string &what, const Result &a, const Result &b)
+{
+    if (a.npoints != b.npoints)
+    {
+        cerr << what << ": "<<a.npoints<<" points but expected "
+             << b.npoints << endl;
+        return false;
+    }
+    if (a.conn != b.conn)
+    {
+        cerr << what << ": the triangles differ\n";
+        return false;
+    }
+    if (a.names != b.names)
+    {
+        cerr << what << ": the fields differ\n";
+        return false;
+    }
+    for (size_t f=0; f<a.values.size(); f++)
+    {
+        if (a.values[f] != b.values[f])
+        {
+            cerr << what << ": the values of "<<a.names[f]<<" differ\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static double Sweep(eavlIsosurfaceFilter &iso, eavlDataSet *data,
+                    int nvalues, vector<Result> &results)
+{
+    double seconds = 0;
+    results.clear();
+    for (int v=0; v<=nvalues; v++)
+    {
+        iso.SetInput(data);
+        iso.SetCellSet("cells");
+        iso.SetField("nodal");
+        iso.SetIsoValue(-1.5 + 4.*double(v)/double(nvalues));
+        int th = eavlTimer::Start();
+        iso.Execute();
+        seconds += eavlTimer::Stop(th, "isosurface");
+        results.push_back(Extract(iso.GetOutput()));
+    }
+    return seconds;
+}
+
+// each level of a multi-level extraction must be the single value
+// output, with its point ids offset past the earlier levels' points
+static bool CheckLevels(const string &what, const Result &multi,
+                        const vector<Result> &singles)
+{
+    int nlevels = singles.size();
+    int nfields = singles[0].names.size();
+    if (multi.names.size() != size_t(nfields + 1) ||
+        multi.names[nfields] != "isolevel")
+    {
+        cerr << what << ": expected the single level fields and isolevel\n";
+        return false;
+    }
+    const vector<double> &levels = multi.values[nfields];
+
+    int ptoffset = 0;
+    vector<int> conn;
+    vector<vector<double> > values(nfields);
+    for (int l=0; l<nlevels; l++)
+    {
+        const Result &single = singles[l];
+        conn.clear();
+        for (int f=0; f<nfields; f++)
+            values[f].clear();
+        for (int t=0; t<multi.ntris; t++)
+        {
+            if (levels[t] != l)
+                continue;
+            conn.push_back(multi.conn[4*t]);
+            for (int k=1; k<4; k++)
+                conn.push_back(multi.conn[4*t+k] - ptoffset);
+            for (int f=0; f<nfields; f++)
+                if (!multi.nodal[f])
+                    values[f].push_back(multi.values[f][t]);
+        }
+        for (int f=0; f<nfields; f++)
+        {
+            if (multi.nodal[f])
+                values[f].assign(multi.values[f].begin() + ptoffset,
+                                 multi.values[f].begin() + ptoffset +
+                                 single.npoints);
+        }
+        if (conn != single.conn || values != single.values)
+        {
+            cerr << what << ": level "<<l<<" differs from its single value\n";
+            return false;
+        }
+        ptoffset += single.npoints;
+    }
+    if (ptoffset != multi.npoints)
+    {
+        cerr << what << ": "<<multi.npoints<<" points but expected "
+             << ptoffset << endl;
+        return false;
+    }
+    return true;
+}
+
+// the index must find exactly the bricks with nodes on both sides
+static bool CheckBricks(const string &what, eavlIsosurfaceIndex &index,
+                        eavlCellSet *cells, eavlFloatArray *field,
+                        float value)
+{
+    vector<int> found;
+    index.FindBricks(value, found);
+    vector<int> expected;
+    for (int b=0; b<index.GetNumBricks(); b++)
+    {
+        bool lo = false, hi = false;
+        for (int c=index.GetBrickFirstCell(b); c<index.GetBrickEndCell(b); c++)
+        {
+            eavlCell cell = cells->GetCellNodes(c);
+            for (int n=0; n<cell.numIndices; n++)
+            {
+                if (field->GetValue(cell.indices[n]) < value)
+                    lo = true;
+                else
+                    hi = true;
+            }
+        }
+        if (lo && hi)
+            expected.push_back(b);
+    }
+    if (found != expected)
+    {
+        cerr << what << ": index found "<<found.size()<<" bricks at "<<value
+             << " but expected "<<expected.size()<<endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 64;
+        if (n < 2)
+            THROW(eavlException,"Expected a size of at least 2");
+
+        const int nvalues = 8;
+        bool ok = true;
+        double indexedtime = 0, generaltime = 0, multitime = 0;
+        vector<double> isovalues;
+        for (int v=0; v<=nvalues; v++)
+            isovalues.push_back(-1.5 + 4.*double(v)/double(nvalues));
+        for (int m=0; m<2; m++)
+        {
+            eavlDataSet *data = (m == 0) ? GenerateRect(n) : GenerateTets(n);
+            string mesh = (m == 0) ? "rectilinear" : "tetrahedral";
+            eavlCellSet *cells = data->GetCellSet(0);
+            eavlFloatArray *field =
+                (eavlFloatArray*)data->GetField("nodal")->GetArray();
+
+            eavlIsosurfaceIndex index(16);
+            index.Build(cells, field);
+            if (!index.IsCurrent(cells, field))
+                THROW(eavlException,"New index was not current");
+            for (int v=0; v<=nvalues; v++)
+                ok &= CheckBricks(mesh, index, cells, field,
+                                  -1.5f + 4.f*float(v)/float(nvalues));
+
+            // the first indexed execution builds the filter's index,
+            // and the rest of the sweep mustn't touch the field
+            eavlIsosurfaceFilter indexed;
+            indexed.SetUseIndex(true);
+            eavlIsosurfaceFilter general;
+            general.SetUseFlyingEdges(false);
+            for (int pass=0; pass<2; pass++)
+            {
+                vector<Result> fast, slow;
+                double t = Sweep(indexed, data, nvalues, fast);
+                if (!index.IsCurrent(cells, field))
+                    THROW(eavlException,"Indexed isosurface wrote the field");
+
+                // operations which only read the field between sweeps
+                // mustn't make the filter rebuild its index
+                int builds = indexed.GetIndex()->GetNumBuilds();
+                eavlFloatArray doubled("doubled", 1, field->GetNumberOfTuples());
+                eavlFloatArray sum("sum", 1, 1);
+                eavlExecutor::AddOperation(
+                    new_eavlMapOp(eavlOpArgs(field), eavlOpArgs(&doubled),
+                                  DoubleFunctor()),
+                    "double the field");
+                eavlExecutor::AddOperation(
+                    new eavlReduceOp_1<eavlAddFunctor<float> >(field, &sum,
+                                                   eavlAddFunctor<float>()),
+                    "sum the field");
+                eavlExecutor::Go();
+                vector<Result> again;
+                Sweep(indexed, data, nvalues, again);
+                if (indexed.GetIndex()->GetNumBuilds() != builds)
+                    THROW(eavlException,"Reading the field rebuilt the index");
+                for (int v=0; v<=nvalues; v++)
+                {
+                    ostringstream what;
+                    what << mesh << " pass "<<pass<<" value "<<v
+                         << " after reading the field";
+                    ok &= Compare(what.str(), again[v], fast[v]);
+                }
+                double tg = Sweep(general, data, nvalues, slow);
+                if (pass == 0)
+                {
+                    indexedtime += t;
+                    generaltime += tg;
+                }
+                for (int v=0; v<=nvalues; v++)
+                {
+                    ostringstream what;
+                    what << mesh << " pass "<<pass<<" value "<<v;
+                    ok &= Compare(what.str(), fast[v], slow[v]);
+                }
+
+                // all the levels at once, with and without the index
+                for (int ui=0; ui<2; ui++)
+                {
+                    eavlIsosurfaceFilter multi;
+                    multi.SetUseIndex(ui == 1);
+                    multi.SetInput(data);
+                    multi.SetCellSet("cells");
+                    multi.SetField("nodal");
+                    multi.SetIsoValues(isovalues);
+                    int th = eavlTimer::Start();
+                    multi.Execute();
+                    double tm = eavlTimer::Stop(th, "multi-level isosurface");
+                    if (pass == 0 && ui == 0)
+                        multitime += tm;
+                    ostringstream what;
+                    what << mesh << " pass "<<pass<<" multi-level"
+                         << (ui ? " indexed" : "");
+                    ok &= CheckLevels(what.str(), Extract(multi.GetOutput()),
+                                      slow);
+                }
+
+                // changing the field must make the index stale
+                field->SetValue(field->GetNumberOfTuples()/2, 5.f);
+                if (index.IsCurrent(cells, field))
+                    THROW(eavlException,"Index didn't notice a changed field");
+                index.Build(cells, field);
+
+                // and so must replacing the cells, even with as many
+                eavlCellSetExplicit *explicitCells =
+                    dynamic_cast<eavlCellSetExplicit*>(cells);
+                if (explicitCells)
+                {
+                    eavlExplicitConnectivity conn;
+                    for (int c=0; c<cells->GetNumCells(); c++)
+                        conn.AddElement(cells->GetCellNodes(c));
+                    explicitCells->SetCellNodeConnectivity(conn);
+                    if (index.IsCurrent(cells, field))
+                        THROW(eavlException,"Index didn't notice replaced cells");
+                    index.Build(cells, field);
+                }
+            }
+            delete data;
+        }
+        if (!ok)
+            THROW(eavlException,"Indexed isosurface output differed");
+
+        cout << "indexed and multi-level isosurfaces matched the general "
+             << "algorithm\n";
+        cout << "sweeping "<<nvalues+1<<" isovalues over "<<n<<"^3 nodes "
+             << "(hex and tet): indexed " << indexedtime
+             << " sec (including building the index), general "
+             << generaltime << " sec, all levels in one pass "
+             << multitime << " sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [nodes per axis]\n";
+        return 1;
+    }
+
+    return 0;
+}
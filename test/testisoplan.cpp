@@ -0,0 +1,351 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlIsosurfaceFilter.h"
+
+#include "eavlCellSetAllStructured.h"
+#include "eavlCellSetExplicit.h"
+#include "eavlCoordinates.h"
+#include "eavlLogicalStructureRegular.h"
+
+//
+// Isosurfaces a time series on a few grids with one filter, which keeps
+// its plan between timesteps, and checks every output against a new
+// filter's.  The field changes in place every timestep, and partway
+// through the series the filter switches to another field of the same
+// type; both should reuse the kept plan.  Moving to another input, or
+// changing the cells of an explicit cell set in place, should not.
+// Reports the time taken each way.
+//
+
+// gives access to the plan the filter is keeping
+class PlanIsosurfaceFilter : public eavlIsosurfaceFilter
+{
+  public:
+    eavlPlan *GetPlan()
+    {
+        return plan;
+    }
+    unsigned long GetPlanCellsStamp()
+    {
+        return planCellsStamp;
+    }
+};
+
+// an ni x nj (x nk, if nk > 1) rectilinear grid with two float nodal
+// fields and a float zonal field
+static eavlDataSet *GenerateRect(int ni, int nj, int nk)
+{
+    eavlDataSet *data = new eavlDataSet();
+
+    int ndims = (nk > 1) ? 3 : 2;
+    int npts = ni * nj * nk;
+    int ncells = (ni-1) * (nj-1) * (ndims == 3 ? nk-1 : 1);
+    data->SetNumPoints(npts);
+
+    eavlRegularStructure reg;
+    if (ndims == 3)
+        reg.SetNodeDimension3D(ni, nj, nk);
+    else
+        reg.SetNodeDimension2D(ni, nj);
+
+    eavlLogicalStructure *log = new eavlLogicalStructureRegular(reg.dimension,
+                                                                reg);
+    data->SetLogicalStructure(log);
+
+    int dims[3] = {ni, nj, nk};
+    const char *names[3] = {"x", "y", "z"};
+    for (int d=0; d<ndims; d++)
+    {
+        eavlFloatArray *axis = new eavlFloatArray(names[d], 1, dims[d]);
+        for (int i=0; i<dims[d]; ++i)
+            axis->SetValue(i, float(i)/float(dims[d]-1));
+        data->AddField(new eavlField(1, axis, eavlField::ASSOC_LOGICALDIM, d));
+    }
+
+    data->AddField(new eavlField(1, new eavlFloatArray("nodal", 1, npts),
+                                 eavlField::ASSOC_POINTS));
+    data->AddField(new eavlField(1, new eavlFloatArray("other", 1, npts),
+                                 eavlField::ASSOC_POINTS));
+
+    eavlFloatArray *zonal = new eavlFloatArray("zonal", 1, ncells);
+    for (int c=0; c<ncells; ++c)
+        zonal->SetValue(c, float(c % 100));
+    data->AddField(new eavlField(0, zonal, eavlField::ASSOC_CELL_SET, "cells"));
+
+    eavlCoordinates *coords;
+    if (ndims == 3)
+    {
+        coords = new eavlCoordinatesCartesian(log,
+                                              eavlCoordinatesCartesian::X,
+                                              eavlCoordinatesCartesian::Y,
+                                              eavlCoordinatesCartesian::Z);
+    }
+    else
+    {
+        coords = new eavlCoordinatesCartesian(log,
+                                              eavlCoordinatesCartesian::X,
+                                              eavlCoordinatesCartesian::Y);
+    }
+    for (int d=0; d<ndims; d++)
+        coords->SetAxis(d, new eavlCoordinateAxisField(names[d]));
+    data->AddCoordinateSystem(coords);
+
+    data->AddCellSet(new eavlCellSetAllStructured("cells", reg));
+
+    return data;
+}
+
+// overwrites the nodal fields with their values at timestep t
+static void SetTimestep(eavlDataSet *data, int ni, int nj, int nk, int t)
+{
+    float *nodal = (float*)data->GetField("nodal")->GetArray()->GetHostArray();
+    float *other = (float*)data->GetField("other")->GetArray()->GetHostArray();
+    float time = 0.3f * float(t);
+    for (int k=0; k<nk; ++k)
+    {
+        for (int j=0; j<nj; ++j)
+        {
+            for (int i=0; i<ni; ++i)
+            {
+                int n = (k*nj + j)*ni + i;
+                float x = float(i)/float(ni-1);
+                float y = float(j)/float(nj-1);
+                float z = (nk > 1) ? float(k)/float(nk-1) : 0.f;
+                nodal[n] = sin(7.f*x + time) + cos(5.f*y - time) + sin(3.f*z);
+                other[n] = cos(4.f*x*y + time) + z;
+            }
+        }
+    }
+}
+
+// the hexahedra of an ni x nj x nk grid, starting from the given one
+static eavlExplicitConnectivity MakeHexes(int ni, int nj, int nk, int first)
+{
+    eavlExplicitConnectivity conn;
+    int ncells = (ni-1) * (nj-1) * (nk-1);
+    for (int c=0; c<ncells; c++)
+    {
+        int h = (c + first) % ncells;
+        int i = h % (ni-1);
+        int j = (h / (ni-1)) % (nj-1);
+        int k = h / ((ni-1) * (nj-1));
+        int ids[8];
+        for (int p=0; p<8; p++)
+        {
+            int x = i + ((p==1 || p==2 || p==5 || p==6) ? 1 : 0);
+            int y = j + ((p==2 || p==3 || p==6 || p==7) ? 1 : 0);
+            int z = k + ((p>=4) ? 1 : 0);
+            ids[p] = (z*nj + y)*ni + x;
+        }
+        conn.AddElement(EAVL_HEX, 8, ids);
+    }
+    return conn;
+}
+
+static bool Compare(const string &what, eavlDataSet *a, eavlDataSet *b);
+
+// the plan kept for an explicit cell set is not reused once its cells
+// are replaced in place, even with the same numbers of everything
+static bool TestModifiedCells(int n)
+{
+    eavlDataSet *data = GenerateRect(n, n, n);
+    SetTimestep(data, n, n, n, 0);
+    eavlCellSetExplicit *hexes = new eavlCellSetExplicit("hexes", 3);
+    hexes->SetCellNodeConnectivity(MakeHexes(n, n, n, 0));
+    data->AddCellSet(hexes);
+
+    bool ok = true;
+    PlanIsosurfaceFilter kept;
+    kept.SetCellSet("hexes");
+    kept.SetField("nodal");
+    kept.SetIsoValue(0.25);
+    for (int r=0; r<3; r++)
+    {
+        ostringstream what;
+        what << "explicit cells, replaced "<<r<<" times";
+        if (r > 0)
+            hexes->SetCellNodeConnectivity(MakeHexes(n, n, n, r));
+        kept.SetInput(data);
+        kept.Execute();
+        if (kept.GetPlanCellsStamp() != hexes->GetModificationStamp())
+        {
+            cerr << what.str() << ": the plan was kept for the old cells\n";
+            ok = false;
+        }
+
+        eavlIsosurfaceFilter *fresh = new eavlIsosurfaceFilter;
+        fresh->SetInput(data);
+        fresh->SetCellSet("hexes");
+        fresh->SetField("nodal");
+        fresh->SetIsoValue(0.25);
+        fresh->Execute();
+        ok &= Compare(what.str(), kept.GetOutput(), fresh->GetOutput());
+        delete fresh->GetOutput();
+        delete fresh;
+    }
+    kept.SetInput(NULL);
+    delete data;
+    return ok;
+}
+
+static bool Compare(const string &what, eavlDataSet *a, eavlDataSet *b)
+{
+    if (a->GetNumPoints() != b->GetNumPoints())
+    {
+        cerr << what << ": "<<a->GetNumPoints()<<" points but expected "
+             << b->GetNumPoints() << endl;
+        return false;
+    }
+
+    eavlCellSet *ca = a->GetCellSet(0);
+    eavlCellSet *cb = b->GetCellSet(0);
+    if (ca->GetNumCells() != cb->GetNumCells())
+    {
+        cerr << what << ": "<<ca->GetNumCells()<<" cells but expected "
+             << cb->GetNumCells() << endl;
+        return false;
+    }
+    for (int c=0; c<ca->GetNumCells(); c++)
+    {
+        eavlCell ea = ca->GetCellNodes(c);
+        eavlCell eb = cb->GetCellNodes(c);
+        bool same = (ea.type == eb.type && ea.numIndices == eb.numIndices);
+        for (int p=0; same && p<ea.numIndices; p++)
+            same = (ea.indices[p] == eb.indices[p]);
+        if (!same)
+        {
+            cerr << what << ": cell "<<c<<" differs\n";
+            return false;
+        }
+    }
+
+    if (a->GetNumFields() != b->GetNumFields())
+    {
+        cerr << what << ": "<<a->GetNumFields()<<" fields but expected "
+             << b->GetNumFields() << endl;
+        return false;
+    }
+    for (int f=0; f<a->GetNumFields(); f++)
+    {
+        eavlArray *fa = a->GetField(f)->GetArray();
+        eavlArray *fb = b->GetField(f)->GetArray();
+        if (fa->GetName() != fb->GetName() ||
+            fa->GetNumberOfTuples() != fb->GetNumberOfTuples())
+        {
+            cerr << what << ": field "<<fa->GetName()<<" differs from "
+                 << fb->GetName() << endl;
+            return false;
+        }
+        for (int i=0; i<fa->GetNumberOfTuples(); i++)
+        {
+            if (fa->GetComponentAsDouble(i,0) != fb->GetComponentAsDouble(i,0))
+            {
+                cerr << what << ": field "<<fa->GetName()<<" value "<<i
+                     << " is "<<fa->GetComponentAsDouble(i,0)
+                     << " but expected "<<fb->GetComponentAsDouble(i,0)<<endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 3)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 64;
+        int nsteps = (argc > 2) ? atoi(argv[2]) : 10;
+        if (n < 3 || nsteps < 2)
+            THROW(eavlException,"Expected a size of at least 3 and at "
+                  "least 2 timesteps");
+
+        // the requested grid, a smaller one, and a 2D one
+        int sizes[3][3] = {{n,n,n}, {n/2+2,n/3+2,5}, {2*n,n,1}};
+        bool ok = true;
+        double kepttime = 0, freshtime = 0;
+        PlanIsosurfaceFilter kept;
+        kept.SetCellSet("cells");
+        kept.SetIsoValue(0.25);
+        kept.SetUseFlyingEdges(false);
+        for (int s=0; s<3; s++)
+        {
+            int ni = sizes[s][0], nj = sizes[s][1], nk = sizes[s][2];
+            eavlDataSet *data = GenerateRect(ni, nj, nk);
+            eavlPlan *plan = NULL;
+            for (int t=0; t<nsteps; t++)
+            {
+                ostringstream what;
+                what << ni<<"x"<<nj<<"x"<<nk<<" at timestep "<<t;
+
+                SetTimestep(data, ni, nj, nk, t);
+                const char *field = (t < nsteps/2) ? "nodal" : "other";
+
+                kept.SetInput(data);
+                kept.SetField(field);
+                int th = eavlTimer::Start();
+                kept.Execute();
+                double keptsec = eavlTimer::Stop(th, "kept plan");
+
+                eavlIsosurfaceFilter *fresh = new eavlIsosurfaceFilter;
+                fresh->SetInput(data);
+                fresh->SetCellSet("cells");
+                fresh->SetField(field);
+                fresh->SetIsoValue(0.25);
+                fresh->SetUseFlyingEdges(false);
+                th = eavlTimer::Start();
+                fresh->Execute();
+                double freshsec = eavlTimer::Stop(th, "new plan");
+
+                ok &= Compare(what.str(), kept.GetOutput(), fresh->GetOutput());
+                if (t > 0 && kept.GetPlan() != plan)
+                {
+                    cerr << what.str() << ": the plan was not reused\n";
+                    ok = false;
+                }
+                plan = kept.GetPlan();
+                if (s == 0 && t > 0)
+                {
+                    kepttime += keptsec;
+                    freshtime += freshsec;
+                }
+                delete fresh->GetOutput();
+                delete fresh;
+            }
+            kept.SetInput(NULL);
+            if (kept.GetPlan())
+            {
+                cerr << "the plan was kept after the input changed\n";
+                ok = false;
+            }
+            delete data;
+        }
+        ok &= TestModifiedCells(n/4 + 3);
+        if (!ok)
+            THROW(eavlException,"Isosurfaces with a kept plan differed");
+
+        cout << "isosurfaces with a kept plan matched new ones\n";
+        cout << "isosurfacing "<<nsteps-1<<" more timesteps of "<<n
+             << "^3 nodes: kept plan "<<kepttime<<" sec, new plan "
+             << freshtime<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [nodes per axis] [timesteps]\n";
+        return 1;
+    }
+
+    return 0;
+}
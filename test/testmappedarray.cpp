@@ -0,0 +1,447 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlMappedFile.h"
+#include "eavlDataSet.h"
+#include "eavlBOVImporter.h"
+#include "eavlVTKImporter.h"
+#include "eavlException.h"
+
+#include <stdio.h>
+
+//
+// Writes raw, native serialized, BOV and binary VTK files, maps arrays
+// from them read-only and copy-on-write, and checks that the values
+// match what was written, that read-only arrays refuse writes, and that
+// writes to copy-on-write arrays never reach the file.
+//
+
+static float Value(int i, int c)
+{
+    return float(i) * 0.5f - float(c) * 3.f;
+}
+
+template <class T>
+static T Swapped(T v)
+{
+    char *b = reinterpret_cast<char*>(&v);
+    for (size_t k = 0; k < sizeof(T)/2; k++)
+        std::swap(b[k], b[sizeof(T)-1-k]);
+    return v;
+}
+
+static bool HostIsLittleEndian()
+{
+    int one = 1;
+    return *reinterpret_cast<char*>(&one) == 1;
+}
+
+static bool CheckValues(const char *what, eavlArray *arr, int n, int nc)
+{
+    if (arr->GetNumberOfTuples() != n || arr->GetNumberOfComponents() != nc)
+    {
+        cerr << what << ": expected "<<n<<" tuples of "<<nc
+             << " components but got "<<arr->GetNumberOfTuples()<<" of "
+             << arr->GetNumberOfComponents()<<endl;
+        return false;
+    }
+    for (int i=0; i<n; ++i)
+    {
+        for (int c=0; c<nc; ++c)
+        {
+            double v = arr->GetComponentAsDouble(i, c);
+            if (v != Value(i, c))
+            {
+                cerr << what << ": mismatch at "<<i<<","<<c<<": expected "
+                     << Value(i, c) << " but got "<<v<<endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// a mapped array's values aren't on the heap, so it reports
+// (much) less memory than the values take up
+static bool CheckMapped(const char *what, eavlArray *arr, bool mapped)
+{
+    long long valuebytes = (long long)arr->GetNumberOfTuples() *
+        arr->GetNumberOfComponents() * sizeof(float);
+    if ((arr->GetMemoryUsage() < valuebytes) != mapped)
+    {
+        cerr << what << ": expected the array "<<(mapped ? "" : "not ")
+             << "to be mapped\n";
+        return false;
+    }
+    return true;
+}
+
+static bool CheckFileUnchanged(const char *what, const string &fn,
+                               size_t offset, int n)
+{
+    vector<float> v(n);
+    FILE *fp = fopen(fn.c_str(), "rb");
+    fseek(fp, (long)offset, SEEK_SET);
+    size_t nread = fread(&v[0], sizeof(float), n, fp);
+    fclose(fp);
+    if ((int)nread != n)
+    {
+        cerr << what << ": could not re-read "<<fn<<endl;
+        return false;
+    }
+    for (int i=0; i<n; ++i)
+    {
+        if (v[i] != Value(i, 0))
+        {
+            cerr << what << ": a write to the array reached the file at "
+                 << i << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// raw values after a header which is longer than a page, so that
+// neither the mapping nor its start are page aligned
+static bool TestRaw(int n)
+{
+    const char *fn = "mapped_raw.dat";
+    const size_t header = 5000;
+    FILE *fp = fopen(fn, "wb");
+    vector<char> pad(header, 'x');
+    fwrite(&pad[0], 1, header, fp);
+    for (int i=0; i<n; ++i)
+    {
+        float v = Value(i, 0);
+        fwrite(&v, sizeof(float), 1, fp);
+    }
+    fclose(fp);
+
+    bool ok = true;
+    eavlFloatArray *ro = new eavlFloatArray(fn, header,
+                                            eavlMappedFile::READONLY,
+                                            "ro", 1, n);
+    ok &= CheckValues("raw read-only", ro, n, 1);
+    ok &= CheckMapped("raw read-only", ro, true);
+    bool threw = false;
+    try
+    {
+        ro->SetValue(0, 1.f);
+    }
+    catch (const eavlException &)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        cerr << "raw read-only: write to a read-only array didn't throw\n";
+        ok = false;
+    }
+    delete ro;
+
+    eavlFloatArray *cow = new eavlFloatArray(fn, header,
+                                             eavlMappedFile::COPYONWRITE,
+                                             "cow", 1, n);
+    for (int i=0; i<n; i+=7)
+        cow->SetValue(i, -1.f);
+    cow->SetComponentFromDouble(n-1, 0, -2.);
+    if (cow->GetValue(0) != -1.f || cow->GetValue(n-1) != -2.f ||
+        cow->GetValue(1) != Value(1, 0))
+    {
+        cerr << "raw copy-on-write: writes weren't seen by the array\n";
+        ok = false;
+    }
+    threw = false;
+    try
+    {
+        cow->AddValue(0.f);
+    }
+    catch (const eavlException &)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        cerr << "raw copy-on-write: resizing a mapped array didn't throw\n";
+        ok = false;
+    }
+    delete cow;
+    ok &= CheckFileUnchanged("raw copy-on-write", fn, header, n);
+
+    threw = false;
+    try
+    {
+        eavlFloatArray past(fn, header + sizeof(float),
+                            eavlMappedFile::READONLY, "past", 1, n);
+    }
+    catch (const eavlException &)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        cerr << "raw: mapping past the end of the file didn't throw\n";
+        ok = false;
+    }
+
+    remove(fn);
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// the native serialized format; the array name is chosen so the values
+// of a float array on a 64-bit host land on a 4-byte boundary, which
+// they must to be mapped
+static bool TestSerialized(int n)
+{
+    const char *fn = "mapped_serialized.dat";
+    eavlFloatArray *orig = new eavlFloatArray("values1", 1, n);
+    for (int i=0; i<n; ++i)
+        orig->SetValue(i, Value(i, 0));
+    {
+        ofstream out(fn, ios::binary);
+        eavlStream s(out);
+        orig->serialize(s);
+    }
+    delete orig;
+
+    bool ok = true;
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        // read, map copy-on-write, then map read-only
+        ifstream in(fn, ios::binary);
+        eavlStream *s;
+        if (pass == 0)
+            s = new eavlStream(in);
+        else
+            s = new eavlStream(in, fn, pass == 1);
+        string nm;
+        *s >> nm;
+        eavlArray *arr = eavlArray::CreateObjFromName(nm);
+        arr->deserialize(*s);
+        delete s;
+
+        const char *what = (pass == 0) ? "serialized, read" :
+                           (pass == 1) ? "serialized, copy-on-write" :
+                                         "serialized, read-only";
+        ok &= CheckValues(what, arr, n, 1);
+        ok &= CheckMapped(what, arr, pass > 0 && sizeof(size_t) == 8);
+        if (pass == 1)
+            arr->SetComponentFromDouble(0, 0, -1.);
+
+        // a mapped array must serialize its values, not the mapping
+        ostringstream out;
+        {
+            eavlStream s2(out);
+            arr->serialize(s2);
+        }
+        istringstream in2(out.str());
+        eavlStream s3(in2);
+        s3 >> nm;
+        eavlFloatArray copy("");
+        copy.deserialize(s3);
+        if (copy.GetNumberOfTuples() != n ||
+            copy.GetValue(n-1) != Value(n-1, 0) ||
+            copy.GetValue(0) != (pass == 1 ? -1.f : Value(0, 0)))
+        {
+            cerr << what << ": re-serialized array doesn't match\n";
+            ok = false;
+        }
+        delete arr;
+    }
+
+    remove(fn);
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// a BOV file with a single native float component is mapped; one with
+// doubles in the other byte order is read and converted
+static bool TestBOV(int n)
+{
+    bool ok = true;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        bool mapped = (pass == 0);
+        const char *bovfn = "mapped_bov.bov";
+        const char *datafn = "mapped_bov.dat";
+        bool little = HostIsLittleEndian() != !mapped;
+        FILE *fp = fopen(bovfn, "w");
+        fprintf(fp, "DATA_FILE: %s\n", datafn);
+        fprintf(fp, "DATA SIZE: %d 1 1\n", n);
+        fprintf(fp, "DATA FORMAT: %s\n", mapped ? "FLOAT" : "DOUBLE");
+        fprintf(fp, "VARIABLE: \"var\"\n");
+        fprintf(fp, "DATA_ENDIAN: %s\n", little ? "LITTLE" : "BIG");
+        fprintf(fp, "CENTERING: nodal\n");
+        fprintf(fp, "BRICK_ORIGIN: 0 0 0\n");
+        fprintf(fp, "BRICK_SIZE: 1 1 1\n");
+        fprintf(fp, "DATA_BRICKLETS: %d 1 1\n", n);
+        fclose(fp);
+
+        fp = fopen(datafn, "wb");
+        for (int i=0; i<n; ++i)
+        {
+            if (mapped)
+            {
+                float v = Value(i, 0);
+                fwrite(&v, sizeof(v), 1, fp);
+            }
+            else
+            {
+                double v = Swapped(double(Value(i, 0)));
+                fwrite(&v, sizeof(v), 1, fp);
+            }
+        }
+        fclose(fp);
+
+        const char *what = mapped ? "BOV, mapped" : "BOV, swapped doubles";
+        eavlBOVImporter importer(bovfn);
+        eavlField *field = importer.GetField("var", "mesh", 0);
+        eavlArray *arr = field->GetArray();
+        ok &= CheckValues(what, arr, n, 1);
+        ok &= CheckMapped(what, arr, mapped);
+        // importers map copy-on-write, so their arrays stay writable
+        arr->SetComponentFromDouble(0, 0, -1.);
+        delete field;
+        if (mapped)
+            ok &= CheckFileUnchanged(what, datafn, 0, n);
+
+        remove(bovfn);
+        remove(datafn);
+    }
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+// reads binary VTK written in host byte order, which VTK itself does
+// not allow, so the mapped path can be tested on any host
+class eavlHostOrderVTKImporter : public eavlVTKImporter
+{
+  public:
+    eavlHostOrderVTKImporter(const string &fn) : eavlVTKImporter(fn, true) { }
+};
+
+// binary legacy VTK; the comment is padded so the scalars are aligned.
+// Big-endian scalars, as VTK specifies, only get mapped on big-endian
+// hosts and are read and swapped elsewhere; scalars in host order always
+// get mapped.  The vectors which follow are not aligned and always get
+// read.
+static bool TestVTK(int n, bool hostOrder)
+{
+    const char *fn = "mapped_vtk.vtk";
+#ifdef WORDS_BIGENDIAN
+    bool swap = false;
+#else
+    bool swap = !hostOrder;
+#endif
+    int np = n*2*2;
+    string head = "# vtk DataFile Version 3.0\n";
+    string rest = "BINARY\nDATASET RECTILINEAR_GRID\n";
+    char line[256];
+    sprintf(line, "DIMENSIONS %d 2 2\n", n);
+    rest += line;
+
+    string body;
+    const char *axes[3] = {"X", "Y", "Z"};
+    for (int a=0; a<3; ++a)
+    {
+        int na = (a == 0) ? n : 2;
+        sprintf(line, "%s_COORDINATES %d float\n", axes[a], na);
+        body += line;
+        for (int i=0; i<na; ++i)
+        {
+            float v = swap ? Swapped(float(i)) : float(i);
+            body.append(reinterpret_cast<char*>(&v), sizeof(v));
+        }
+        body += "\n";
+    }
+    sprintf(line, "POINT_DATA %d\nSCALARS s float 1\nLOOKUP_TABLE default\n",
+            np);
+    body += line;
+
+    string comment = "mapped array test";
+    while ((head.size() + comment.size() + 1 + rest.size() + body.size())
+           % sizeof(float) != 0)
+        comment += ".";
+    string file = head + comment + "\n" + rest + body;
+
+    for (int nc = 1; nc <= 3; nc += 2)
+    {
+        if (nc == 3)
+            file += "\nVECTORS vec float\n";
+        for (int i=0; i<np; ++i)
+        {
+            for (int c=0; c<nc; ++c)
+            {
+                float v = swap ? Swapped(Value(i, c)) : Value(i, c);
+                file.append(reinterpret_cast<char*>(&v), sizeof(v));
+            }
+        }
+    }
+    file += "\n";
+
+    FILE *fp = fopen(fn, "wb");
+    fwrite(file.c_str(), 1, file.size(), fp);
+    fclose(fp);
+
+    bool ok = true;
+    {
+        eavlVTKImporter *importer = hostOrder ?
+            new eavlHostOrderVTKImporter(fn) : new eavlVTKImporter(fn);
+        eavlArray *s = importer->GetField("s", "mesh", 0)->GetArray();
+        eavlArray *v = importer->GetField("vec", "mesh", 0)->GetArray();
+        const char *what = hostOrder ? "VTK host order scalars" :
+                                       "VTK scalars";
+        ok &= CheckValues(what, s, np, 1);
+        ok &= CheckMapped(what, s, !swap);
+        ok &= CheckValues("VTK vectors", v, np, 3);
+        ok &= CheckMapped("VTK vectors", v, false);
+        delete importer;
+    }
+
+    remove(fn);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 10000;
+        if (n < 2)
+            THROW(eavlException,"Expected a size of at least 2");
+
+        // the importers trust the configured byte order
+#ifdef WORDS_BIGENDIAN
+        if (HostIsLittleEndian())
+#else
+        if (!HostIsLittleEndian())
+#endif
+            THROW(eavlException,"WORDS_BIGENDIAN doesn't match this host");
+
+        bool ok = true;
+        ok &= TestRaw(n);
+        ok &= TestSerialized(n);
+        ok &= TestBOV(n);
+        ok &= TestVTK(n, false);
+        ok &= TestVTK(n, true);
+        if (!ok)
+            THROW(eavlException,"Mapped arrays produced incorrect results");
+        cout << "all mapped arrays produced correct results\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
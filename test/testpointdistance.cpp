@@ -0,0 +1,183 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlCoordinates.h"
+#include "eavlPointDistanceFieldFilter.h"
+
+//
+// Finds the distance field for random points in 1, 2 and 3 dimensions,
+// exactly and approximately, and checks the exact distances against
+// ones found by visiting every point from every node.  The approximate
+// distances are to some input point, so they may only be larger than
+// the exact ones, and should usually match them.  Reports the time
+// taken each way.
+//
+
+// npts random points in the unit square (or line, or cube)
+static eavlDataSet *GeneratePoints(int dim, int npts)
+{
+    eavlDataSet *data = new eavlDataSet();
+    data->SetNumPoints(npts);
+
+    eavlFloatArray *pts = new eavlFloatArray("coords", 3, npts);
+    for (int i=0; i<npts; ++i)
+    {
+        for (int c=0; c<3; ++c)
+            pts->SetComponentFromDouble(i, c, c < dim ? drand48() : 0.);
+    }
+    data->AddField(new eavlField(1, pts, eavlField::ASSOC_POINTS));
+
+    eavlCoordinatesCartesian *coords;
+    if (dim == 1)
+        coords = new eavlCoordinatesCartesian(NULL,
+                                              eavlCoordinatesCartesian::X);
+    else if (dim == 2)
+        coords = new eavlCoordinatesCartesian(NULL,
+                                              eavlCoordinatesCartesian::X,
+                                              eavlCoordinatesCartesian::Y);
+    else
+        coords = new eavlCoordinatesCartesian(NULL,
+                                              eavlCoordinatesCartesian::X,
+                                              eavlCoordinatesCartesian::Y,
+                                              eavlCoordinatesCartesian::Z);
+    for (int c=0; c<dim; ++c)
+        coords->SetAxis(c, new eavlCoordinateAxisField("coords", c));
+    data->AddCoordinateSystem(coords);
+    return data;
+}
+
+static eavlDataSet *DistanceField(eavlDataSet *input, int dim, int n,
+                                  bool exact, double &seconds)
+{
+    eavlPointDistanceFieldFilter df;
+    df.SetInput(input);
+    if (dim == 1)
+        df.SetRange1D(n, -0.2, 1.2);
+    else if (dim == 2)
+        df.SetRange2D(n, n, -0.2, 1.2, -0.2, 1.2);
+    else
+        df.SetRange3D(n, n, n, -0.2, 1.2, -0.2, 1.2, -0.2, 1.2);
+    if (exact)
+        df.SetDoExact();
+    else
+        df.SetDoApproximateIter(3);
+
+    int th = eavlTimer::Start();
+    df.Execute();
+    seconds = eavlTimer::Stop(th, exact ? "exact" : "approximate");
+    return df.GetOutput();
+}
+
+// the distances from every output node to its nearest input point,
+// visiting every point from every node
+static void BruteForce(eavlDataSet *input, eavlDataSet *output, int dim,
+                       vector<double> &dist, double &seconds)
+{
+    int th = eavlTimer::Start();
+    int npts = input->GetNumPoints();
+    vector<double> pts(3 * npts, 0.);
+    for (int p=0; p<npts; ++p)
+    {
+        for (int c=0; c<dim; ++c)
+            pts[3*p+c] = input->GetPoint(p, c);
+    }
+
+    int nnodes = output->GetNumPoints();
+    dist.resize(nnodes);
+    for (int n=0; n<nnodes; ++n)
+    {
+        double q[3] = {0, 0, 0};
+        for (int c=0; c<dim; ++c)
+            q[c] = output->GetPoint(n, c);
+        double best2 = -1;
+        for (int p=0; p<npts; ++p)
+        {
+            double dx = pts[3*p+0] - q[0];
+            double dy = pts[3*p+1] - q[1];
+            double dz = pts[3*p+2] - q[2];
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if (best2 < 0 || d2 < best2)
+                best2 = d2;
+        }
+        dist[n] = sqrt(best2);
+    }
+    seconds = eavlTimer::Stop(th, "brute force");
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int npts = (argc > 1) ? atoi(argv[1]) : 2000;
+        if (npts < 1)
+            THROW(eavlException,"Expected at least one point");
+
+        // nodes per axis for each dimension
+        int sizes[3] = {10000, 200, 40};
+        bool ok = true;
+        srand48(12345);
+        for (int dim=1; dim<=3; ++dim)
+        {
+            eavlDataSet *input = GeneratePoints(dim, npts);
+            double exactsec, approxsec, brutesec;
+            eavlDataSet *exact = DistanceField(input, dim, sizes[dim-1],
+                                               true, exactsec);
+            eavlDataSet *approx = DistanceField(input, dim, sizes[dim-1],
+                                                false, approxsec);
+            vector<double> truth;
+            BruteForce(input, exact, dim, truth, brutesec);
+
+            eavlArray *ed = exact->GetField("dist")->GetArray();
+            eavlArray *ad = approx->GetField("dist")->GetArray();
+            int nnodes = truth.size();
+            int nwrong = 0;
+            for (int n=0; n<nnodes; ++n)
+            {
+                double e = ed->GetComponentAsDouble(n,0);
+                double a = ad->GetComponentAsDouble(n,0);
+                double tol = 1.e-5 * (truth[n] + 1.);
+                if (fabs(e - truth[n]) > tol || a < truth[n] - tol)
+                {
+                    if (ok)
+                        cerr << dim<<"D node "<<n<<": exact "<<e
+                             << ", approximate "<<a<<", but expected "
+                             << truth[n]<<endl;
+                    ok = false;
+                }
+                if (a > truth[n] + tol)
+                    ++nwrong;
+            }
+
+            cout << dim<<"D, "<<nnodes<<" nodes and "<<npts<<" points: "
+                 << "exact "<<exactsec<<" sec, approximate "<<approxsec
+                 << " sec, brute force "<<brutesec<<" sec; "
+                 << nwrong<<" approximate distances too large\n";
+
+            delete exact;
+            delete approx;
+            delete input;
+        }
+        if (!ok)
+            THROW(eavlException,"Distances differed from brute force ones");
+
+        cout << "exact distances matched brute force ones\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numpoints]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+//
+// Validates the CPU prefix sum (inclusive and exclusive, with linear and
+// div/mod/mul/add indexing) against a serial reference, then reports its
+// run time as a function of thread count.
+//
+
+// serial reference for an input indexed as ((i/div)%mod)*mul+add
+static bool CheckResult(eavlIntArray *in, eavlArrayWithLinearIndex idx,
+                        eavlIntArray *out, int n, bool inclusive)
+{
+    const int *raw = (const int*)in->GetHostArray();
+    int sum = 0;
+    for (int i=0; i<n; ++i)
+    {
+        int val = raw[((i/idx.div)%idx.mod)*idx.mul+idx.add];
+        if (inclusive)
+            sum += val;
+        if (out->GetValue(i) != sum)
+        {
+            cerr << "Mismatch at index "<<i<<": expected "<<sum
+                 << " but got "<<out->GetValue(i)<<endl;
+            return false;
+        }
+        if (!inclusive)
+            sum += val;
+    }
+    return true;
+}
+
+static double RunScan(eavlArrayWithLinearIndex in, eavlIntArray *out,
+                      bool inclusive, int reps)
+{
+    double best = -1;
+    for (int r=0; r<reps; ++r)
+    {
+        int th = eavlTimer::Start();
+        eavlExecutor::AddOperation(new eavlPrefixSumOp_1(in, out, inclusive),
+                                   "prefix sum");
+        eavlExecutor::Go();
+        double t = eavlTimer::Stop(th, "prefix sum benchmark");
+        if (best < 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 3)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        int reps = (argc > 2) ? atoi(argv[2]) : 5;
+        if (n < 1 || reps < 1)
+            THROW(eavlException,"Expected positive size and repetition count");
+
+        // a two-component input lets us exercise mul/add indexing
+        eavlIntArray *in  = new eavlIntArray("in", 2, n);
+        eavlIntArray *out = new eavlIntArray("out", 1, n);
+        for (int i=0; i<n; ++i)
+        {
+            in->SetComponentFromDouble(i, 0, (i*7) % 5);
+            in->SetComponentFromDouble(i, 1, (i*3) % 11);
+        }
+
+        eavlArrayWithLinearIndex comp0(in, 0);
+        eavlArrayWithLinearIndex comp1(in, 1);
+        // repeat each of the first 100 tuples 3 times, like a logical dim
+        eavlArrayWithLinearIndex divmod(in, 1);
+        divmod.div = 3;
+        divmod.mod = 100;
+
+        bool ok = true;
+        for (int incl = 0; incl <= 1; ++incl)
+        {
+            RunScan(comp0, out, incl, 1);
+            ok &= CheckResult(in, comp0, out, n, incl);
+            RunScan(comp1, out, incl, 1);
+            ok &= CheckResult(in, comp1, out, n, incl);
+            RunScan(divmod, out, incl, 1);
+            ok &= CheckResult(in, divmod, out, n, incl);
+        }
+        if (!ok)
+            THROW(eavlException,"Prefix sum produced incorrect results");
+
+        int maxthreads = 1;
+#ifdef HAVE_OPENMP
+        maxthreads = omp_get_max_threads();
+#endif
+        cout << "prefix sum of "<<n<<" values, best of "<<reps<<" runs\n";
+        cout << "threads   inclusive(s)   exclusive(s)\n";
+        vector<int> threadcounts;
+        for (int nt = 1; nt < maxthreads; nt *= 2)
+            threadcounts.push_back(nt);
+        threadcounts.push_back(maxthreads);
+        for (size_t t = 0; t < threadcounts.size(); ++t)
+        {
+            int nt = threadcounts[t];
+#ifdef HAVE_OPENMP
+            omp_set_num_threads(nt);
+#endif
+            double ti = RunScan(comp0, out, true, reps);
+            double te = RunScan(comp0, out, false, reps);
+            cout << std::setw(7) << nt << "   "
+                 << std::setw(12) << ti << "   "
+                 << std::setw(12) << te << endl;
+        }
+
+        delete in;
+        delete out;
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues] [repetitions]\n";
+        return 1;
+    }
+
+    return 0;
+}
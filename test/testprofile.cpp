@@ -0,0 +1,471 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+#include "eavlException.h"
+
+//
+// Profiles a small captured plan, run twice, which includes an
+// operation that can't describe its arrays and one whose name needs
+// escaping.  Parses the Chrome trace back as JSON and the summary back
+// as CSV, and checks both against the recorded profile: every event's
+// fields, and every summary row's columns, call count and totals.
+//
+
+struct ScaleAndShiftFunctor
+{
+    int scale, shift;
+    ScaleAndShiftFunctor(int s, int o) : scale(s), shift(o) { }
+    EAVL_FUNCTOR int operator()(int x) { return x*scale + shift; }
+};
+
+struct SumFunctor
+{
+    EAVL_FUNCTOR int operator()(tuple<int,int> in)
+    {
+        return get<0>(in) + get<1>(in);
+    }
+};
+
+// counts how often it runs, without telling the executor what it touches
+class TouchOp : public eavlOperation
+{
+  protected:
+    eavlIntArray *count;
+  public:
+    TouchOp(eavlIntArray *c) : count(c) { }
+    virtual void GoCPU()
+    {
+        count->SetValue(0, count->GetValue(0) + 1);
+    }
+    virtual void GoGPU()
+    {
+        THROW(eavlException,"TouchOp only runs on the CPU.");
+    }
+};
+
+// ----------------------------------------------------------------------------
+// a small JSON reader, enough to take the trace apart
+// ----------------------------------------------------------------------------
+
+struct JSONValue
+{
+    enum Type { Null, Bool, Number, String, Array, Object };
+    Type              type;
+    double            number;
+    string            str;
+    vector<string>    keys;
+    vector<JSONValue> items;
+    JSONValue() : type(Null), number(0) { }
+    const JSONValue *Get(const string &key) const
+    {
+        for (size_t i=0; i<keys.size(); ++i)
+            if (keys[i] == key)
+                return &items[i];
+        return NULL;
+    }
+};
+
+class JSONReader
+{
+  protected:
+    const string &text;
+    size_t        pos;
+    void Fail(const string &why)
+    {
+        ostringstream msg;
+        msg << "JSON error at " << pos << ": " << why;
+        THROW(eavlException, msg.str());
+    }
+    void Skip()
+    {
+        while (pos < text.size() && isspace(text[pos]))
+            ++pos;
+    }
+    void Expect(char c)
+    {
+        Skip();
+        if (pos >= text.size() || text[pos] != c)
+            Fail(string("expected '") + c + "'");
+        ++pos;
+    }
+    string ReadString()
+    {
+        Expect('"');
+        string s;
+        while (pos < text.size() && text[pos] != '"')
+        {
+            if (text[pos] == '\\')
+            {
+                ++pos;
+                if (pos >= text.size() || !strchr("\"\\/", text[pos]))
+                    Fail("unexpected escape");
+            }
+            else if ((unsigned char)text[pos] < 0x20)
+            {
+                Fail("control character in a string");
+            }
+            s += text[pos++];
+        }
+        Expect('"');
+        return s;
+    }
+    void ReadValue(JSONValue &v)
+    {
+        Skip();
+        if (pos >= text.size())
+            Fail("unexpected end");
+        char c = text[pos];
+        if (c == '{')
+        {
+            v.type = JSONValue::Object;
+            ++pos;
+            Skip();
+            if (pos < text.size() && text[pos] == '}')
+            {
+                ++pos;
+                return;
+            }
+            do
+            {
+                v.keys.push_back(ReadString());
+                Expect(':');
+                v.items.push_back(JSONValue());
+                ReadValue(v.items.back());
+                Skip();
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            Expect('}');
+        }
+        else if (c == '[')
+        {
+            v.type = JSONValue::Array;
+            ++pos;
+            Skip();
+            if (pos < text.size() && text[pos] == ']')
+            {
+                ++pos;
+                return;
+            }
+            do
+            {
+                v.items.push_back(JSONValue());
+                ReadValue(v.items.back());
+                Skip();
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            Expect(']');
+        }
+        else if (c == '"')
+        {
+            v.type = JSONValue::String;
+            v.str = ReadString();
+        }
+        else if (text.compare(pos, 4, "true") == 0 ||
+                 text.compare(pos, 5, "false") == 0)
+        {
+            v.type = JSONValue::Bool;
+            v.number = (c == 't');
+            pos += (c == 't') ? 4 : 5;
+        }
+        else if (text.compare(pos, 4, "null") == 0)
+        {
+            pos += 4;
+        }
+        else
+        {
+            const char *start = text.c_str() + pos;
+            char *end;
+            v.type = JSONValue::Number;
+            v.number = strtod(start, &end);
+            if (end == start)
+                Fail("expected a value");
+            pos += end - start;
+        }
+    }
+  public:
+    JSONReader(const string &t) : text(t), pos(0) { }
+    void Read(JSONValue &v)
+    {
+        ReadValue(v);
+        Skip();
+        if (pos != text.size())
+            Fail("trailing text");
+    }
+};
+
+// splits a CSV line, undoing the quoting of quoted fields
+static vector<string> SplitCSV(const string &line)
+{
+    vector<string> fields(1);
+    bool quoted = false;
+    for (size_t i=0; i<line.size(); ++i)
+    {
+        char c = line[i];
+        if (quoted && c == '"' && i+1 < line.size() && line[i+1] == '"')
+            fields.back() += line[++i];
+        else if (c == '"')
+            quoted = !quoted;
+        else if (c == ',' && !quoted)
+            fields.push_back("");
+        else
+            fields.back() += c;
+    }
+    return fields;
+}
+
+// ----------------------------------------------------------------------------
+// checks
+// ----------------------------------------------------------------------------
+
+static bool CheckNumber(const string &what, const JSONValue *v, double expect)
+{
+    if (!v || v->type != JSONValue::Number || v->number != expect)
+    {
+        cerr << "trace: " << what << " should be " << expect << endl;
+        return false;
+    }
+    return true;
+}
+
+static bool CheckTrace(const vector<eavlExecutor::ProfileRecord> &prof)
+{
+    ostringstream out;
+    eavlExecutor::WriteProfileTrace(out);
+    JSONValue root;
+    JSONReader(out.str()).Read(root);
+
+    const JSONValue *events = root.Get("traceEvents");
+    const JSONValue *unit = root.Get("displayTimeUnit");
+    if (root.type != JSONValue::Object || root.keys.size() != 2 ||
+        !events || events->type != JSONValue::Array ||
+        !unit || unit->str != "ms")
+    {
+        cerr << "trace: expected traceEvents and displayTimeUnit\n";
+        return false;
+    }
+    if (events->items.size() != prof.size())
+    {
+        cerr << "trace: " << events->items.size() << " events for "
+             << prof.size() << " records\n";
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i=0; ok && i<prof.size(); ++i)
+    {
+        const eavlExecutor::ProfileRecord &r = prof[i];
+        const JSONValue &e = events->items[i];
+        const JSONValue *name = e.Get("name");
+        const JSONValue *cat = e.Get("cat");
+        const JSONValue *ph = e.Get("ph");
+        const JSONValue *args = e.Get("args");
+        if (e.keys.size() != 8 || !name || name->str != r.name ||
+            !cat || cat->str != r.path || !ph || ph->str != "X" ||
+            !args || args->type != JSONValue::Object)
+        {
+            cerr << "trace: event " << i << " doesn't describe " << r.name
+                 << endl;
+            return false;
+        }
+        ok &= CheckNumber("ts", e.Get("ts"), (long long)(r.start * 1.e6));
+        ok &= CheckNumber("dur", e.Get("dur"), (long long)(r.duration * 1.e6));
+        ok &= CheckNumber("pid", e.Get("pid"), 0);
+        ok &= CheckNumber("tid", e.Get("tid"), r.lane);
+        ok &= CheckNumber("operations", args->Get("operations"), r.nops);
+        ok &= CheckNumber("threads", args->Get("threads"), r.threads);
+        if (r.items < 0)
+        {
+            if (args->keys.size() != 2)
+            {
+                cerr << "trace: unknown traffic written for " << r.name << endl;
+                ok = false;
+            }
+        }
+        else
+        {
+            ok &= (args->keys.size() == 5);
+            ok &= CheckNumber("items", args->Get("items"), r.items);
+            ok &= CheckNumber("bytes read", args->Get("bytes read"),
+                              r.bytesRead);
+            ok &= CheckNumber("bytes written", args->Get("bytes written"),
+                              r.bytesWritten);
+        }
+    }
+    return ok;
+}
+
+static bool Close(const string &field, double expect)
+{
+    double v = atof(field.c_str());
+    return fabs(v - expect) <= 1.e-5 * fabs(expect) + 1.e-9;
+}
+
+static bool CheckSummary(const vector<eavlExecutor::ProfileRecord> &prof)
+{
+    ostringstream out;
+    eavlExecutor::WriteProfileSummary(out);
+    istringstream in(out.str());
+    string line;
+    getline(in, line);
+    if (line != "operation,path,calls,threads,items,bytes_read,"
+                "bytes_written,total_seconds,mean_seconds,GB_per_second")
+    {
+        cerr << "summary: unexpected header " << line << endl;
+        return false;
+    }
+
+    bool ok = true;
+    size_t nrecords = 0;
+    vector<string> seen;
+    while (getline(in, line))
+    {
+        vector<string> f = SplitCSV(line);
+        if (f.size() != 10)
+        {
+            cerr << "summary: " << f.size() << " columns in " << line << endl;
+            return false;
+        }
+        string key = f[0] + "\n" + f[1];
+        if (std::find(seen.begin(), seen.end(), key) != seen.end())
+        {
+            cerr << "summary: " << f[0] << " has two rows\n";
+            ok = false;
+        }
+        seen.push_back(key);
+
+        // the totals over every run of this operation on this path
+        int calls = 0, threads = 0;
+        long long items = 0, bytesRead = 0, bytesWritten = 0;
+        double seconds = 0;
+        for (size_t i=0; i<prof.size(); ++i)
+        {
+            const eavlExecutor::ProfileRecord &r = prof[i];
+            if (r.name != f[0] || r.path != f[1])
+                continue;
+            calls++;
+            threads = std::max(threads, r.threads);
+            seconds += r.duration;
+            if (items < 0 || r.items < 0)
+            {
+                items = -1;
+            }
+            else
+            {
+                items += r.items;
+                bytesRead += r.bytesRead;
+                bytesWritten += r.bytesWritten;
+            }
+        }
+        nrecords += calls;
+        bool row = (calls > 0 && atoi(f[2].c_str()) == calls &&
+                    atoi(f[3].c_str()) == threads &&
+                    Close(f[7], seconds) && Close(f[8], seconds / calls));
+        if (items < 0)
+            row &= (f[4] == "" && f[5] == "" && f[6] == "" && f[9] == "");
+        else
+            row &= (atoll(f[4].c_str()) == items &&
+                    atoll(f[5].c_str()) == bytesRead &&
+                    atoll(f[6].c_str()) == bytesWritten &&
+                    (seconds > 0 ?
+                     Close(f[9], double(bytesRead + bytesWritten) / seconds / 1.e9) :
+                     f[9] == ""));
+        if (!row)
+        {
+            cerr << "summary: row doesn't match the profile: " << line << endl;
+            ok = false;
+        }
+    }
+    if (nrecords != prof.size())
+    {
+        cerr << "summary: rows cover " << nrecords << " of " << prof.size()
+             << " records\n";
+        ok = false;
+    }
+    return ok;
+}
+
+static bool RunProfiledPlan(int n, int runs)
+{
+    eavlIntArray *a    = new eavlIntArray("a", 1, n);
+    eavlIntArray *b    = new eavlIntArray("b", 1, n);
+    eavlIntArray *c    = new eavlIntArray("c", 1, n);
+    eavlIntArray *sumc = new eavlIntArray("sumc", 1, 1);
+    eavlIntArray *ran  = new eavlIntArray("ran", 1, 1);
+    for (int i=0; i<n; ++i)
+        a->SetValue(i, i % 17);
+    ran->SetValue(0, 0);
+
+    eavlPlan plan;
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a), eavlOpArgs(b),
+                      ScaleAndShiftFunctor(3, 1)),
+        "b = 3a+1");
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(a, b), eavlOpArgs(c), SumFunctor()),
+        "c = a+b");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(c, sumc,
+                                                 eavlAddFunctor<int>()),
+        "sum c");
+    eavlExecutor::AddOperation(new TouchOp(ran), "touch \"ran\", once\\run");
+    eavlExecutor::Capture(plan);
+
+    eavlExecutor::SetProfiling(true);
+    eavlExecutor::ClearProfile();
+    for (int r=0; r<runs; ++r)
+        eavlExecutor::Go(plan);
+    eavlExecutor::SetProfiling(false);
+
+    const vector<eavlExecutor::ProfileRecord> &prof =
+        eavlExecutor::GetProfile();
+    bool ok = true;
+    int nops = 0;
+    for (size_t i=0; i<prof.size(); ++i)
+        nops += prof[i].nops;
+    if (nops != runs * plan.GetNumOperations() || ran->GetValue(0) != runs)
+    {
+        cerr << "profiled " << nops << " operations in " << runs << " runs\n";
+        ok = false;
+    }
+    ok &= CheckTrace(prof);
+    ok &= CheckSummary(prof);
+
+    plan.Clear();
+    delete a;
+    delete b;
+    delete c;
+    delete sumc;
+    delete ran;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 10000;
+        if (n < 1)
+            THROW(eavlException,"Expected a positive size");
+
+        bool ok = RunProfiledPlan(n, 2);
+        if (!ok)
+            THROW(eavlException,"Profile output didn't match the profile");
+        cout << "profile trace and summary matched the profile\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlReduceOp_1.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Reduces int and float arrays of several sizes, including one
+// component of a multi-component array, and checks the sums, minima
+// and maxima against serial ones.  Then finds all three at once with a
+// multiple reduction, and checks those too.  Reports the time taken to
+// find them (the best of several runs) with three reductions and with
+// one multiple reduction.
+//
+
+typedef tuple<eavlMinFunctor<int>, eavlMaxFunctor<int>, eavlAddFunctor<int> > IntRangeAndSum;
+typedef tuple<eavlMinFunctor<float>, eavlMaxFunctor<float>, eavlAddFunctor<float> > FloatRangeAndSum;
+
+static bool Check(const string &what, double value, double expected, double tol)
+{
+    if (fabs(value - expected) > tol)
+    {
+        cerr << what << " is "<<value<<" but expected "<<expected<<endl;
+        return false;
+    }
+    return true;
+}
+
+// ints reduce exactly, so these must match the serial results exactly
+static bool TestInt(int n, int nc)
+{
+    ostringstream what;
+    what << n<<" ints with "<<nc<<" components";
+
+    eavlIntArray *in = new eavlIntArray("in", nc, n);
+    int comp = nc - 1;
+    int mn = INT_MAX, mx = INT_MIN, sum = 0;
+    for (int i=0; i<n; ++i)
+    {
+        for (int c=0; c<nc; ++c)
+            in->SetComponentFromDouble(i, c, (i*7919 + c*31) % 1000 - 500);
+        int v = int(in->GetComponentAsDouble(i, comp));
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+        sum += v;
+    }
+    if (n == 0)
+    {
+        mn = eavlMinFunctor<int>().identity();
+        mx = eavlMaxFunctor<int>().identity();
+    }
+
+    // the single results go after a value which must not be touched
+    eavlIntArray *out = new eavlIntArray("out", 1, 4);
+    eavlIntArray *multi = new eavlIntArray("multi", 1, 3);
+    out->SetValue(0, 12345);
+    eavlArrayWithLinearIndex inidx(in, comp);
+    eavlArrayWithLinearIndex outidx[3] = {out, out, out};
+    for (int k=0; k<3; ++k)
+        outidx[k].add = k+1;
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlMinFunctor<int> >(inidx, outidx[0], eavlMinFunctor<int>()), "min");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlMaxFunctor<int> >(inidx, outidx[1], eavlMaxFunctor<int>()), "max");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<int> >(inidx, outidx[2], eavlAddFunctor<int>()), "sum");
+    eavlExecutor::AddOperation(
+        new_eavlMultiReduceOp_1(inidx, multi,
+                                IntRangeAndSum(eavlMinFunctor<int>(),
+                                               eavlMaxFunctor<int>(),
+                                               eavlAddFunctor<int>())),
+        "min, max and sum");
+    eavlExecutor::Go();
+
+    bool ok = true;
+    ok &= Check(what.str()+": untouched value", out->GetValue(0), 12345, 0);
+    ok &= Check(what.str()+": min", out->GetValue(1), mn, 0);
+    ok &= Check(what.str()+": max", out->GetValue(2), mx, 0);
+    ok &= Check(what.str()+": sum", out->GetValue(3), sum, 0);
+    ok &= Check(what.str()+": multiple min", multi->GetValue(0), mn, 0);
+    ok &= Check(what.str()+": multiple max", multi->GetValue(1), mx, 0);
+    ok &= Check(what.str()+": multiple sum", multi->GetValue(2), sum, 0);
+    delete in;
+    delete out;
+    delete multi;
+    return ok;
+}
+
+static bool TestFloat(int n, double &separatesec, double &multisec)
+{
+    ostringstream what;
+    what << n<<" floats";
+
+    eavlFloatArray *in = new eavlFloatArray("in", 1, n);
+    float mn = FLT_MAX, mx = -FLT_MAX;
+    double sum = 0;
+    for (int i=0; i<n; ++i)
+    {
+        float v = sin(float(i) * 0.001f) * 100.f;
+        in->SetValue(i, v);
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+        sum += v;
+    }
+
+    eavlFloatArray *out = new eavlFloatArray("out", 1, 3);
+    eavlFloatArray *multi = new eavlFloatArray("multi", 1, 3);
+    eavlArrayWithLinearIndex outidx[3] = {out, out, out};
+    for (int k=0; k<3; ++k)
+        outidx[k].add = k;
+
+    // the best of several runs of each
+    separatesec = multisec = -1;
+    for (int r=0; r<5; ++r)
+    {
+        int th = eavlTimer::Start();
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlMinFunctor<float> >(in, outidx[0], eavlMinFunctor<float>()), "min");
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlMaxFunctor<float> >(in, outidx[1], eavlMaxFunctor<float>()), "max");
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<float> >(in, outidx[2], eavlAddFunctor<float>()), "sum");
+        eavlExecutor::Go();
+        double t = eavlTimer::Stop(th, "separate");
+        if (separatesec < 0 || t < separatesec)
+            separatesec = t;
+
+        th = eavlTimer::Start();
+        eavlExecutor::AddOperation(
+            new_eavlMultiReduceOp_1(in, multi,
+                                    FloatRangeAndSum(eavlMinFunctor<float>(),
+                                                     eavlMaxFunctor<float>(),
+                                                     eavlAddFunctor<float>())),
+            "min, max and sum");
+        eavlExecutor::Go();
+        t = eavlTimer::Stop(th, "multiple");
+        if (multisec < 0 || t < multisec)
+            multisec = t;
+    }
+
+    // float sums are rounded differently in each order
+    double tol = 1.e-4 * (fabs(sum) + n);
+    bool ok = true;
+    ok &= Check(what.str()+": min", out->GetValue(0), mn, 0);
+    ok &= Check(what.str()+": max", out->GetValue(1), mx, 0);
+    ok &= Check(what.str()+": sum", out->GetValue(2), sum, tol);
+    ok &= Check(what.str()+": multiple min", multi->GetValue(0), mn, 0);
+    ok &= Check(what.str()+": multiple max", multi->GetValue(1), mx, 0);
+    ok &= Check(what.str()+": multiple sum", multi->GetValue(2), sum, tol);
+    delete in;
+    delete out;
+    delete multi;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 1)
+            THROW(eavlException,"Expected at least one value");
+
+        // sizes around the unrolling and the threading thresholds
+        bool ok = true;
+        int sizes[] = {0, 1, 3, 7, 8, 9, 100, 9999, 10001, 123457, n};
+        int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+        for (int s=0; s<nsizes; ++s)
+        {
+            ok &= TestInt(sizes[s], 1);
+            ok &= TestInt(sizes[s], 3);
+        }
+        double separatesec, multisec;
+        ok &= TestFloat(1000, separatesec, multisec);
+        ok &= TestFloat(n, separatesec, multisec);
+        if (!ok)
+            THROW(eavlException,"Reductions differed from serial ones");
+
+        cout << "reductions matched serial ones\n";
+        cout << "min, max and sum of "<<n<<" floats, best of 5: three reductions "
+             << separatesec<<" sec, one multiple reduction "<<multisec
+             << " sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
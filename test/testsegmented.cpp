@@ -0,0 +1,278 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlSegmentedScanOp_1.h"
+#include "eavlSegmentedReduceOp_1.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Splits int arrays of several sizes into segments of very uneven
+// lengths -- a few long ones, many short and some empty -- and checks
+// segmented sums, maxima and inclusive and exclusive scans against
+// serial ones, including a scan in place.  Reports the time taken to
+// sum the segments with eavlSegmentedReduceOp_1, and with a parallel
+// loop over the segments, and the best times of the segmented sum and
+// inclusive scan of a plain array against serial loops doing the same.
+//
+
+static void MakeSegments(int n, vector<int> &starts)
+{
+    starts.clear();
+    int i = 0;
+    while (i < n)
+    {
+        starts.push_back(i);
+        double r = drand48();
+        int len;
+        if (r < 0.001)
+            len = n / 3;
+        else if (r < 0.2)
+            len = 0;
+        else
+            len = int(lrand48() % 8);
+        i += len;
+    }
+    // and empty segments at the end
+    starts.push_back(n);
+    starts.push_back(n);
+}
+
+static bool Check(const string &what, int i, int value, int expected)
+{
+    if (value != expected)
+    {
+        cerr << what<<" "<<i<<" is "<<value<<" but expected "<<expected<<endl;
+        return false;
+    }
+    return true;
+}
+
+static bool TestSegmented(int n, double &segmentedsec, double &loopsec)
+{
+    ostringstream what;
+    what << n<<" values: ";
+
+    vector<int> s;
+    MakeSegments(n, s);
+    int nseg = s.size();
+    eavlIntArray *starts = new eavlIntArray("starts", 1, nseg);
+    for (int k=0; k<nseg; ++k)
+        starts->SetValue(k, s[k]);
+
+    // the values are one component of two
+    eavlIntArray *in = new eavlIntArray("in", 2, n);
+    for (int i=0; i<n; ++i)
+    {
+        in->SetComponentFromDouble(i, 0, -1);
+        in->SetComponentFromDouble(i, 1, int(lrand48() % 201) - 100);
+    }
+    eavlIntArray *copy = new eavlIntArray("copy", 1, n);
+    for (int i=0; i<n; ++i)
+        copy->SetValue(i, int(in->GetComponentAsDouble(i, 1)));
+
+    eavlIntArray *sums = new eavlIntArray("sums", 1, nseg);
+    eavlIntArray *maxes = new eavlIntArray("maxes", 1, nseg);
+    eavlIntArray *incl = new eavlIntArray("incl", 1, n);
+    eavlIntArray *excl = new eavlIntArray("excl", 1, n);
+
+    int th = eavlTimer::Start();
+    eavlExecutor::AddOperation(
+        new eavlSegmentedReduceOp_1<eavlAddFunctor<int> >(
+            eavlArrayWithLinearIndex(in, 1), sums, starts, eavlAddFunctor<int>()),
+        "segmented sum");
+    eavlExecutor::Go();
+    segmentedsec = eavlTimer::Stop(th, "segmented");
+
+    eavlExecutor::AddOperation(
+        new eavlSegmentedReduceOp_1<eavlMaxFunctor<int> >(
+            eavlArrayWithLinearIndex(in, 1), maxes, starts, eavlMaxFunctor<int>()),
+        "segmented max");
+    eavlExecutor::AddOperation(
+        new eavlSegmentedScanOp_1<eavlAddFunctor<int> >(
+            eavlArrayWithLinearIndex(in, 1), incl, starts, true, eavlAddFunctor<int>()),
+        "segmented inclusive scan");
+    eavlExecutor::AddOperation(
+        new eavlSegmentedScanOp_1<eavlAddFunctor<int> >(
+            eavlArrayWithLinearIndex(in, 1), excl, starts, false, eavlAddFunctor<int>()),
+        "segmented exclusive scan");
+    eavlExecutor::AddOperation(
+        new eavlSegmentedScanOp_1<eavlAddFunctor<int> >(
+            copy, copy, starts, true, eavlAddFunctor<int>()),
+        "segmented inclusive scan in place");
+    eavlExecutor::Go();
+
+    // the same sums, with one segment per iteration
+    th = eavlTimer::Start();
+    vector<int> loopsums(nseg);
+    const int *v = (const int*)in->GetHostArray();
+#pragma omp parallel for
+    for (int k=0; k<nseg; ++k)
+    {
+        int end = (k+1 < nseg) ? s[k+1] : n;
+        int sum = 0;
+        for (int i=s[k]; i<end; ++i)
+            sum += v[2*i+1];
+        loopsums[k] = sum;
+    }
+    loopsec = eavlTimer::Stop(th, "loop");
+
+    bool ok = true;
+    for (int k=0; k<nseg && ok; ++k)
+    {
+        int end = (k+1 < nseg) ? s[k+1] : n;
+        int sum = 0;
+        int mx = eavlMaxFunctor<int>().identity();
+        for (int i=s[k]; i<end && ok; ++i)
+        {
+            int val = int(in->GetComponentAsDouble(i, 1));
+            ok &= Check(what.str()+"exclusive scan", i, excl->GetValue(i), sum);
+            sum += val;
+            mx = std::max(mx, val);
+            ok &= Check(what.str()+"inclusive scan", i, incl->GetValue(i), sum);
+            ok &= Check(what.str()+"scan in place", i, copy->GetValue(i), sum);
+        }
+        ok &= Check(what.str()+"sum of segment", k, sums->GetValue(k), sum);
+        ok &= Check(what.str()+"max of segment", k, maxes->GetValue(k), mx);
+        ok &= Check(what.str()+"loop sum of segment", k, loopsums[k], sum);
+    }
+
+    delete starts;
+    delete in;
+    delete copy;
+    delete sums;
+    delete maxes;
+    delete incl;
+    delete excl;
+    return ok;
+}
+
+// best of several runs of the segmented sum and inclusive scan of a
+// whole array, and of serial loops computing the same
+static bool Benchmark(int n, double sec[4])
+{
+    vector<int> s;
+    MakeSegments(n, s);
+    int nseg = s.size();
+    eavlIntArray *starts = new eavlIntArray("starts", 1, nseg);
+    for (int k=0; k<nseg; ++k)
+        starts->SetValue(k, s[k]);
+    eavlIntArray *in = new eavlIntArray("in", 1, n);
+    for (int i=0; i<n; ++i)
+        in->SetValue(i, int(lrand48() % 201) - 100);
+    eavlIntArray *sums = new eavlIntArray("sums", 1, nseg);
+    eavlIntArray *scan = new eavlIntArray("scan", 1, n);
+    vector<int> loopsums(nseg), loopscan(n);
+    const int *v = (const int*)in->GetConstHostArray();
+
+    for (int t=0; t<4; ++t)
+        sec[t] = -1;
+    for (int r=0; r<5; ++r)
+    {
+        double t[4];
+        int th = eavlTimer::Start();
+        eavlExecutor::AddOperation(
+            new eavlSegmentedReduceOp_1<eavlAddFunctor<int> >(
+                in, sums, starts, eavlAddFunctor<int>()),
+            "segmented sum");
+        eavlExecutor::Go();
+        t[0] = eavlTimer::Stop(th, "segmented sum");
+
+        th = eavlTimer::Start();
+        for (int k=0; k<nseg; ++k)
+        {
+            int end = (k+1 < nseg) ? s[k+1] : n;
+            int sum = 0;
+            for (int i=s[k]; i<end; ++i)
+                sum += v[i];
+            loopsums[k] = sum;
+        }
+        t[1] = eavlTimer::Stop(th, "serial sum");
+
+        th = eavlTimer::Start();
+        eavlExecutor::AddOperation(
+            new eavlSegmentedScanOp_1<eavlAddFunctor<int> >(
+                in, scan, starts, true, eavlAddFunctor<int>()),
+            "segmented scan");
+        eavlExecutor::Go();
+        t[2] = eavlTimer::Stop(th, "segmented scan");
+
+        th = eavlTimer::Start();
+        for (int k=0; k<nseg; ++k)
+        {
+            int end = (k+1 < nseg) ? s[k+1] : n;
+            int sum = 0;
+            for (int i=s[k]; i<end; ++i)
+            {
+                sum += v[i];
+                loopscan[i] = sum;
+            }
+        }
+        t[3] = eavlTimer::Stop(th, "serial scan");
+
+        for (int k=0; k<4; ++k)
+            if (sec[k] < 0 || t[k] < sec[k])
+                sec[k] = t[k];
+    }
+
+    bool ok = true;
+    for (int k=0; k<nseg && ok; ++k)
+        ok &= Check("benchmark sum of segment", k, sums->GetValue(k), loopsums[k]);
+    for (int i=0; i<n && ok; ++i)
+        ok &= Check("benchmark scan", i, scan->GetValue(i), loopscan[i]);
+
+    delete starts;
+    delete in;
+    delete sums;
+    delete scan;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 1)
+            THROW(eavlException,"Expected at least one value");
+
+        // sizes around the threading threshold
+        bool ok = true;
+        srand48(12345);
+        int sizes[] = {0, 1, 2, 7, 100, 32767, 32768, 100003, n};
+        int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+        double segmentedsec, loopsec;
+        for (int s=0; s<nsizes; ++s)
+            ok &= TestSegmented(sizes[s], segmentedsec, loopsec);
+        double bench[4];
+        ok &= Benchmark(n, bench);
+        if (!ok)
+            THROW(eavlException,"Segmented operations differed from serial ones");
+
+        cout << "segmented operations matched serial ones\n";
+        cout << "summing uneven segments of "<<n<<" values: "
+             << "eavlSegmentedReduceOp_1 "<<segmentedsec
+             << " sec, loop over segments "<<loopsec<<" sec\n";
+        cout << "best of 5 over "<<n<<" contiguous values: "
+             << "eavlSegmentedReduceOp_1 "<<bench[0]
+             << " sec, serial sum "<<bench[1]<<" sec; "
+             << "eavlSegmentedScanOp_1 "<<bench[2]
+             << " sec, serial scan "<<bench[3]<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
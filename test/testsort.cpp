@@ -0,0 +1,241 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlExecutor.h"
+#include "eavlSortOp.h"
+#include "eavlSortByKeyOp.h"
+#include "eavlReduceByKeyOp.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Sorts int and float arrays of several sizes, including one component
+// of a multi-component array and an array sorted in place, and checks
+// them against std::sort.  Sorts keys with two value arrays, checking
+// that values with equal keys keep their order, and then reduces the
+// values of equal keys and checks them against serial sums.  Reports
+// the time taken to sort floats with eavlSortOp and with std::sort.
+//
+
+static bool TestInt(int n, int nc)
+{
+    ostringstream what;
+    what << n<<" ints with "<<nc<<" components";
+
+    // keys from a small range, so there are many duplicates
+    eavlIntArray *in = new eavlIntArray("in", nc, n);
+    eavlIntArray *out = new eavlIntArray("out", 1, n);
+    int comp = nc - 1;
+    vector<int> expected(n);
+    for (int i=0; i<n; ++i)
+    {
+        for (int c=0; c<nc; ++c)
+            in->SetComponentFromDouble(i, c, (i*7919 + c*31) % 2001 - 1000);
+        expected[i] = int(in->GetComponentAsDouble(i, comp));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    eavlExecutor::AddOperation(
+        new_eavlSortOp(eavlOpArgs(eavlIndexable<eavlIntArray>(in, comp)),
+                       eavlOpArgs(out)), "sort");
+    eavlExecutor::Go();
+
+    bool ok = true;
+    for (int i=0; i<n && ok; ++i)
+    {
+        if (out->GetValue(i) != expected[i])
+        {
+            cerr << what.str()<<": value "<<i<<" is "<<out->GetValue(i)
+                 << " but expected "<<expected[i]<<endl;
+            ok = false;
+        }
+    }
+    delete in;
+    delete out;
+    return ok;
+}
+
+static bool TestFloat(int n, double &sortsec, double &stdsec)
+{
+    ostringstream what;
+    what << n<<" floats";
+
+    eavlFloatArray *a = new eavlFloatArray("a", 1, n);
+    vector<float> expected(n);
+    for (int i=0; i<n; ++i)
+    {
+        float v = float(drand48() - 0.5) * 1.e6f;
+        if (i % 97 == 0)
+            v = 0.f;
+        a->SetValue(i, v);
+        expected[i] = v;
+    }
+
+    int th = eavlTimer::Start();
+    std::sort(expected.begin(), expected.end());
+    stdsec = eavlTimer::Stop(th, "std::sort");
+
+    // sort in place
+    th = eavlTimer::Start();
+    eavlExecutor::AddOperation(
+        new_eavlSortOp(eavlOpArgs(a), eavlOpArgs(a)), "sort");
+    eavlExecutor::Go();
+    sortsec = eavlTimer::Stop(th, "eavlSortOp");
+
+    bool ok = true;
+    for (int i=0; i<n && ok; ++i)
+    {
+        if (a->GetValue(i) != expected[i])
+        {
+            cerr << what.str()<<": value "<<i<<" is "<<a->GetValue(i)
+                 << " but expected "<<expected[i]<<endl;
+            ok = false;
+        }
+    }
+    delete a;
+    return ok;
+}
+
+static bool TestByKey(int n)
+{
+    ostringstream what;
+    what << n<<" keys";
+
+    // negative and positive keys, with about ten values per key
+    int nkeys = n / 10 + 1;
+    eavlIntArray *keys = new eavlIntArray("keys", 1, n);
+    eavlIntArray *index = new eavlIntArray("index", 1, n);
+    eavlFloatArray *vals = new eavlFloatArray("vals", 1, n);
+    // pairs of a key and its input index, which a stable sort must
+    // leave in order of key and then index
+    vector<pair<int,int> > expected(n);
+    for (int i=0; i<n; ++i)
+    {
+        int k = int(lrand48() % nkeys) - nkeys/2;
+        keys->SetValue(i, k);
+        index->SetValue(i, i);
+        vals->SetValue(i, float(i % 10));
+        expected[i] = pair<int,int>(k, i);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    eavlIntArray *sortedkeys = new eavlIntArray("sortedkeys", 1, n);
+    eavlIntArray *sortedindex = new eavlIntArray("sortedindex", 1, n);
+    eavlFloatArray *sortedvals = new eavlFloatArray("sortedvals", 1, n);
+    eavlIntArray *reducedkeys = new eavlIntArray("reducedkeys", 1, n);
+    eavlFloatArray *reducedvals = new eavlFloatArray("reducedvals", 1, n);
+    eavlIntArray *count = new eavlIntArray("count", 1, 1);
+    eavlExecutor::AddOperation(
+        new_eavlSortByKeyOp(eavlOpArgs(keys),
+                            eavlOpArgs(index, vals),
+                            eavlOpArgs(sortedkeys),
+                            eavlOpArgs(sortedindex, sortedvals)),
+        "sort by key");
+    eavlExecutor::AddOperation(
+        new_eavlReduceByKeyOp(eavlOpArgs(sortedkeys),
+                              eavlOpArgs(sortedvals),
+                              eavlOpArgs(reducedkeys),
+                              eavlOpArgs(reducedvals),
+                              count, eavlAddFunctor<float>()),
+        "reduce by key");
+    eavlExecutor::Go();
+
+    bool ok = true;
+    for (int i=0; i<n && ok; ++i)
+    {
+        int k = sortedkeys->GetValue(i);
+        int s = sortedindex->GetValue(i);
+        float v = sortedvals->GetValue(i);
+        if (k != expected[i].first || s != expected[i].second ||
+            v != float(expected[i].second % 10))
+        {
+            cerr << what.str()<<": value "<<i<<" is key "<<k<<", index "<<s
+                 << ", value "<<v<<" but expected key "<<expected[i].first
+                 << ", index "<<expected[i].second<<endl;
+            ok = false;
+        }
+    }
+
+    // the serial sums of each run of equal keys
+    int nruns = 0;
+    for (int i=0; i<n && ok; )
+    {
+        int k = expected[i].first;
+        float sum = 0;
+        for ( ; i<n && expected[i].first == k; ++i)
+            sum += float(expected[i].second % 10);
+        if (nruns < count->GetValue(0) &&
+            (reducedkeys->GetValue(nruns) != k ||
+             reducedvals->GetValue(nruns) != sum))
+        {
+            cerr << what.str()<<": run "<<nruns<<" is key "
+                 << reducedkeys->GetValue(nruns)<<", sum "
+                 << reducedvals->GetValue(nruns)<<" but expected key "<<k
+                 << ", sum "<<sum<<endl;
+            ok = false;
+        }
+        ++nruns;
+    }
+    if (ok && count->GetValue(0) != nruns)
+    {
+        cerr << what.str()<<": "<<count->GetValue(0)<<" runs but expected "
+             << nruns<<endl;
+        ok = false;
+    }
+
+    delete keys;
+    delete index;
+    delete vals;
+    delete sortedkeys;
+    delete sortedindex;
+    delete sortedvals;
+    delete reducedkeys;
+    delete reducedvals;
+    delete count;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 1)
+            THROW(eavlException,"Expected at least one value");
+
+        // sizes around the threading threshold
+        bool ok = true;
+        srand48(12345);
+        int sizes[] = {0, 1, 2, 7, 100, 32767, 32768, 100003, n};
+        int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+        double sortsec, stdsec;
+        for (int s=0; s<nsizes; ++s)
+        {
+            ok &= TestInt(sizes[s], 1);
+            ok &= TestInt(sizes[s], 3);
+            ok &= TestFloat(sizes[s], sortsec, stdsec);
+            ok &= TestByKey(sizes[s]);
+        }
+        if (!ok)
+            THROW(eavlException,"Sorts differed from serial ones");
+
+        cout << "sorts matched serial ones\n";
+        cout << "sorting "<<n<<" floats: eavlSortOp "<<sortsec
+             << " sec, std::sort "<<stdsec<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numvalues]\n";
+        return 1;
+    }
+
+    return 0;
+}
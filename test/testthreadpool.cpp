@@ -0,0 +1,458 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlArray.h"
+#include "eavlCellSetExplicit.h"
+#include "eavlExecutor.h"
+#include "eavlThreadPool.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+#include "eavlPrefixSumOp_1.h"
+#include "eavlGatherOp.h"
+#include "eavlScatterOp.h"
+#include "eavlInfoTopologyMapOp.h"
+#include "eavlSourceTopologyMapOp.h"
+#include "eavlSourceTopologyGatherMapOp.h"
+#include "eavlTimer.h"
+#include "eavlException.h"
+
+//
+// Runs loops of several sizes and grain sizes on a four-thread
+// eavlThreadPool and checks every item ran exactly once, including loops
+// started from inside a loop body and loops whose body throws.  Then
+// runs maps (alone and fused), topology maps over polygons with
+// different numbers of nodes, a reduction, prefix sums, a gather and a
+// scatter on the thread pool backend, chosen for the process and for
+// single operations, and checks them against serial results.  Reports the time taken by a loop whose items have very
+// uneven costs, with the default grain size and with one chunk per
+// thread, and by many small maps on each backend.
+//
+
+// counts the times each item was run
+struct CountBody : public eavlThreadPool::Body
+{
+    vector<int> &counts;
+    bool         nested;
+    CountBody(vector<int> &c, bool n) : counts(c), nested(n) { }
+    virtual void operator()(int begin, int end)
+    {
+        for (int i=begin; i<end; ++i)
+            counts[i]++;
+        if (nested)
+        {
+            vector<int> inner(100, 0);
+            CountBody body(inner, false);
+            eavlThreadPool::ParallelFor(100, 10, body);
+            for (int i=0; i<100; ++i)
+            {
+                if (inner[i] != 1)
+                    THROW(eavlException,"A nested loop missed an item");
+            }
+        }
+    }
+};
+
+// throws at one item
+struct ThrowBody : public eavlThreadPool::Body
+{
+    int bad;
+    ThrowBody(int b) : bad(b) { }
+    virtual void operator()(int begin, int end)
+    {
+        if (begin <= bad && bad < end)
+            THROW(eavlException,"Expected error from a loop body");
+    }
+};
+
+// items whose cost varies a lot (and grows toward the end)
+struct UnevenBody : public eavlThreadPool::Body
+{
+    vector<double> &out;
+    UnevenBody(vector<double> &o) : out(o) { }
+    virtual void operator()(int begin, int end)
+    {
+        int n = out.size();
+        for (int i=begin; i<end; ++i)
+        {
+            int cost = (i % 64 == 0) ? 2000 : ((i > n/2) ? 40 : 1);
+            double x = i;
+            for (int k=0; k<cost; ++k)
+                x = x * 0.999 + 1.;
+            out[i] = x;
+        }
+    }
+};
+
+struct ScaleAndShiftFunctor
+{
+    int scale, shift;
+    ScaleAndShiftFunctor(int s, int o) : scale(s), shift(o) { }
+    EAVL_FUNCTOR int operator()(int x) { return x*scale + shift; }
+};
+
+struct ShapeAndValueFunctor
+{
+    EAVL_FUNCTOR int operator()(int shapeType, int x) { return shapeType*1000 + x; }
+};
+
+struct SumNodesFunctor
+{
+    template <class IN>
+    EAVL_FUNCTOR int operator()(int shapeType, int n, int ids[], const IN inputs)
+    {
+        int result = shapeType * 1000;
+        for (int i=0; i<n; i++)
+            result += collect(ids[i], inputs);
+        return result;
+    }
+};
+
+static bool CheckCounts(const string &what, const vector<int> &counts)
+{
+    for (size_t i=0; i<counts.size(); ++i)
+    {
+        if (counts[i] != 1)
+        {
+            cerr << what<<": item "<<i<<" ran "<<counts[i]<<" times\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CheckArray(const string &what, eavlIntArray *arr,
+                       const vector<int> &expected)
+{
+    for (size_t i=0; i<expected.size(); ++i)
+    {
+        if (arr->GetValue(i) != expected[i])
+        {
+            cerr << what<<": value "<<i<<" is "<<arr->GetValue(i)
+                 << " but expected "<<expected[i]<<endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool TestLoops(int n)
+{
+    bool ok = true;
+    int grains[] = {0, 1, 7, 1000, n+1};
+    for (int g=0; g<5; ++g)
+    {
+        for (int nested=0; nested<2; ++nested)
+        {
+            // nested loops are slow with tiny grains
+            if (nested && grains[g] > 0 && grains[g] < 1000 && n > 1000)
+                continue;
+            ostringstream what;
+            what << n<<" items with grain "<<grains[g]
+                 << (nested ? " and nested loops" : "");
+            vector<int> counts(n, 0);
+            CountBody body(counts, nested);
+            eavlThreadPool::ParallelFor(n, grains[g], body);
+            ok &= CheckCounts(what.str(), counts);
+        }
+    }
+
+    if (n > 1)
+    {
+        bool threw = false;
+        try
+        {
+            ThrowBody body(n/2);
+            eavlThreadPool::ParallelFor(n, 1, body);
+        }
+        catch (const eavlException &)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            cerr << n<<" items: an error in a loop body was lost\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// polygons of 3 to 12 nodes, around a ring of points
+static eavlCellSetExplicit *MakePolygons(int ncells, vector<vector<int> > &cellnodes)
+{
+    eavlExplicitConnectivity conn;
+    cellnodes.resize(ncells);
+    for (int c=0; c<ncells; ++c)
+    {
+        int nids = 3 + int(lrand48() % (MAX_LOCAL_TOPOLOGY_IDS - 2));
+        int ids[MAX_LOCAL_TOPOLOGY_IDS];
+        for (int i=0; i<nids; ++i)
+            ids[i] = (c + i*7) % ncells;
+        conn.AddElement(EAVL_POLYGON, nids, ids);
+        cellnodes[c].assign(ids, ids + nids);
+    }
+    eavlCellSetExplicit *cells = new eavlCellSetExplicit("polygons", 2);
+    cells->SetDSNumPoints(ncells);
+    cells->SetCellNodeConnectivity(conn);
+    return cells;
+}
+
+static bool TestOperations(int n)
+{
+    ostringstream what;
+    what << n<<" items";
+
+    eavlIntArray *a = new eavlIntArray("a", 1, n);
+    eavlIntArray *b = new eavlIntArray("b", 1, n);
+    eavlIntArray *c = new eavlIntArray("c", 1, n);
+    eavlIntArray *sums = new eavlIntArray("sums", 1, n);
+    int nsparse = n / 3;
+    eavlIntArray *sparse = new eavlIntArray("sparse", 1, nsparse);
+    eavlIntArray *sparsesums = new eavlIntArray("sparsesums", 1, nsparse);
+    eavlIntArray *info = new eavlIntArray("info", 1, n);
+    eavlIntArray *total = new eavlIntArray("total", 1, 1);
+    eavlIntArray *incl = new eavlIntArray("incl", 1, n);
+    eavlIntArray *excl = new eavlIntArray("excl", 1, n);
+    eavlIntArray *gathered = new eavlIntArray("gathered", 1, nsparse);
+    eavlIntArray *scattered = new eavlIntArray("scattered", 1, n);
+    vector<int> expb(n), expc(n), expsums(n), expsparse(nsparse);
+    vector<int> expinfo(n), exptotal(1, 0), expincl(n), expexcl(n);
+    vector<int> expgathered(nsparse), expscattered(n, 0);
+    vector<vector<int> > cellnodes;
+    eavlCellSetExplicit *cells = MakePolygons(n, cellnodes);
+    for (int i=0; i<n; ++i)
+    {
+        a->SetValue(i, i % 1000 - 500);
+        expb[i] = (i % 1000 - 500) * 3 + 1;
+        expc[i] = expb[i] * 2 - 4;
+    }
+    for (int i=0; i<n; ++i)
+    {
+        expsums[i] = EAVL_POLYGON * 1000;
+        for (size_t j=0; j<cellnodes[i].size(); ++j)
+            expsums[i] += a->GetValue(cellnodes[i][j]);
+    }
+    for (int i=0; i<n; ++i)
+    {
+        expinfo[i] = EAVL_POLYGON * 1000 + a->GetValue(i);
+        expexcl[i] = exptotal[0];
+        exptotal[0] += a->GetValue(i);
+        expincl[i] = exptotal[0];
+    }
+    for (int i=0; i<nsparse; ++i)
+    {
+        sparse->SetValue(i, i*3 + 1);
+        expsparse[i] = expsums[i*3 + 1];
+        expgathered[i] = a->GetValue(i*3 + 1);
+        expscattered[i*3 + 1] = expgathered[i];
+    }
+
+    bool ok = true;
+    for (int pass=0; pass<3; ++pass)
+    {
+        for (int i=0; i<n; ++i)
+        {
+            b->SetValue(i, 0);
+            c->SetValue(i, 0);
+            sums->SetValue(i, 0);
+            info->SetValue(i, 0);
+            incl->SetValue(i, 0);
+            excl->SetValue(i, 0);
+            scattered->SetValue(i, 0);
+        }
+        for (int i=0; i<nsparse; ++i)
+        {
+            sparsesums->SetValue(i, 0);
+            gathered->SetValue(i, 0);
+        }
+        total->SetValue(0, 0);
+
+        // the whole process on the thread pool, with the default grain
+        // and then with a small one; then only these operations
+        string passname;
+        eavlExecutor::CPUBackend backend = eavlExecutor::DefaultCPUBackend;
+        int grainsize = 0;
+        if (pass == 0)
+        {
+            passname = " (thread pool)";
+            eavlExecutor::SetCPUBackend(eavlExecutor::ThreadPoolBackend);
+            eavlExecutor::SetCPUGrainSize(0);
+        }
+        else if (pass == 1)
+        {
+            passname = " (thread pool, grain 100)";
+            eavlExecutor::SetCPUGrainSize(100);
+        }
+        else
+        {
+            passname = " (thread pool for each operation)";
+            eavlExecutor::SetCPUBackend(eavlExecutor::OpenMPBackend);
+            eavlExecutor::SetCPUGrainSize(0);
+            backend = eavlExecutor::ThreadPoolBackend;
+            grainsize = 37;
+        }
+
+        // the two maps are fused
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(a), eavlOpArgs(b),
+                          ScaleAndShiftFunctor(3, 1)),
+            "scale", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs(b), eavlOpArgs(c),
+                          ScaleAndShiftFunctor(2, -4)),
+            "scale again", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new_eavlSourceTopologyMapOp(cells, EAVL_NODES_OF_CELLS,
+                                        eavlOpArgs(a), eavlOpArgs(sums),
+                                        SumNodesFunctor()),
+            "sum nodes", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new_eavlSourceTopologyGatherMapOp(cells, EAVL_NODES_OF_CELLS,
+                                              eavlOpArgs(a),
+                                              eavlOpArgs(sparsesums),
+                                              eavlOpArgs(sparse),
+                                              SumNodesFunctor()),
+            "sum nodes of some cells", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new_eavlInfoTopologyMapOp(cells, EAVL_NODES_OF_CELLS,
+                                      eavlOpArgs(a), eavlOpArgs(info),
+                                      ShapeAndValueFunctor()),
+            "shape and value", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new eavlReduceOp_1<eavlAddFunctor<int> >(a, total,
+                                                     eavlAddFunctor<int>()),
+            "sum", backend, grainsize);
+        eavlExecutor::AddOperation(new eavlPrefixSumOp_1(a, incl, true),
+                                   "inclusive prefix sum", backend, grainsize);
+        eavlExecutor::AddOperation(new eavlPrefixSumOp_1(a, excl, false),
+                                   "exclusive prefix sum", backend, grainsize);
+        eavlExecutor::AddOperation(
+            new_eavlGatherOp(eavlOpArgs(a), eavlOpArgs(gathered),
+                             eavlOpArgs(sparse)),
+            "gather", backend, grainsize);
+        eavlExecutor::Go();
+        // (reads what the gather wrote)
+        eavlExecutor::AddOperation(
+            new_eavlScatterOp(eavlOpArgs(gathered), eavlOpArgs(scattered),
+                              eavlOpArgs(sparse)),
+            "scatter", backend, grainsize);
+        eavlExecutor::Go();
+
+        ok &= CheckArray(what.str()+passname+" map", b, expb);
+        ok &= CheckArray(what.str()+passname+" fused map", c, expc);
+        ok &= CheckArray(what.str()+passname+" topology map", sums, expsums);
+        ok &= CheckArray(what.str()+passname+" topology gather map",
+                         sparsesums, expsparse);
+        ok &= CheckArray(what.str()+passname+" info topology map", info, expinfo);
+        ok &= CheckArray(what.str()+passname+" reduce", total, exptotal);
+        ok &= CheckArray(what.str()+passname+" inclusive prefix sum",
+                         incl, expincl);
+        ok &= CheckArray(what.str()+passname+" exclusive prefix sum",
+                         excl, expexcl);
+        ok &= CheckArray(what.str()+passname+" gather", gathered, expgathered);
+        ok &= CheckArray(what.str()+passname+" scatter", scattered, expscattered);
+    }
+    eavlExecutor::SetCPUBackend(eavlExecutor::DefaultCPUBackend);
+    eavlExecutor::SetCPUGrainSize(0);
+
+    delete a;
+    delete b;
+    delete c;
+    delete sums;
+    delete sparse;
+    delete sparsesums;
+    delete info;
+    delete total;
+    delete incl;
+    delete excl;
+    delete gathered;
+    delete scattered;
+    delete cells;
+    return ok;
+}
+
+// many maps over a few items each, on one backend
+static double TimeSmallMaps(eavlExecutor::CPUBackend backend)
+{
+    int nitems = 1000;
+    int nmaps = 2000;
+    eavlIntArray *a = new eavlIntArray("a", 1, nitems);
+    eavlIntArray *b = new eavlIntArray("b", 1, nitems);
+    for (int i=0; i<nitems; ++i)
+        a->SetValue(i, i);
+
+    int th = eavlTimer::Start();
+    for (int m=0; m<nmaps; ++m)
+    {
+        // (alternating, so that they are not fused)
+        eavlExecutor::AddOperation(
+            new_eavlMapOp(eavlOpArgs((m%2) ? b : a), eavlOpArgs((m%2) ? a : b),
+                          ScaleAndShiftFunctor(1, 1)),
+            "small map", backend);
+        eavlExecutor::Go();
+    }
+    double sec = eavlTimer::Stop(th, "small maps");
+
+    delete a;
+    delete b;
+    return sec;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+        if (n < 1)
+            THROW(eavlException,"Expected at least one item");
+
+        // more threads than items in some of these, and (likely) than
+        // processors
+        eavlThreadPool::SetNumberOfThreads(4);
+        if (eavlThreadPool::GetNumberOfThreads() != 4)
+            THROW(eavlException,"Could not set the number of threads");
+
+        bool ok = true;
+        srand48(12345);
+        int sizes[] = {0, 1, 2, 3, 1023, 1024, 1025, 4097, 100003, n};
+        int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+        for (int s=0; s<nsizes; ++s)
+            ok &= TestLoops(sizes[s]);
+        for (int s=1; s<nsizes; ++s)
+            ok &= TestOperations(sizes[s]);
+        if (!ok)
+            THROW(eavlException,"Thread pool results differed from serial ones");
+
+        vector<double> out(n);
+        UnevenBody body(out);
+        int th = eavlTimer::Start();
+        eavlThreadPool::ParallelFor(n, 0, body);
+        double stealsec = eavlTimer::Stop(th, "uneven loop");
+        th = eavlTimer::Start();
+        eavlThreadPool::ParallelFor(n, (n+3)/4, body);
+        double staticsec = eavlTimer::Stop(th, "uneven loop, static");
+
+        double poolsec = TimeSmallMaps(eavlExecutor::ThreadPoolBackend);
+        double ompsec = TimeSmallMaps(eavlExecutor::OpenMPBackend);
+
+        cout << "thread pool results matched serial ones\n";
+        cout << "uneven loop over "<<n<<" items on 4 threads: default grain "
+             << stealsec<<" sec, one chunk per thread "<<staticsec<<" sec\n";
+        cout << "2000 maps over 1000 items: thread pool "<<poolsec
+             << " sec, OpenMP "<<ompsec<<" sec\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [numitems]\n";
+        return 1;
+    }
+
+    return 0;
+}
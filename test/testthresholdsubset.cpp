@@ -0,0 +1,262 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlThresholdMutator.h"
+
+#include "eavlCellSetAllPoints.h"
+#include "eavlCellSetAllStructured.h"
+#include "eavlCellSetSubset.h"
+#include "eavlCoordinates.h"
+#include "eavlLogicalStructureRegular.h"
+
+//
+// Thresholds cell sets the topology map ops don't walk -- a subset of a
+// structured grid's cells, and the grid's points as a cell set -- by
+// nodal and zonal fields, and checks the cells kept, their nodes and
+// their gathered fields against a serial pass over GetCellNodes.  Also
+// thresholds the whole structured cell set, which does use the ops, and
+// checks it matches a subset of all its cells.
+//
+
+static float Value(int i, int j, int k)
+{
+    return float((i*7 + j*3 + k*5) % 11);
+}
+
+// an n^3 node grid with a nodal field, every stride'th cell in a
+// subset, and a zonal field on the subset
+static eavlDataSet *GenerateSubsetGrid(int n, int stride)
+{
+    eavlDataSet *data = new eavlDataSet();
+    data->SetNumPoints(n*n*n);
+
+    eavlRegularStructure reg;
+    reg.SetNodeDimension3D(n, n, n);
+    eavlLogicalStructure *log = new eavlLogicalStructureRegular(reg.dimension,
+                                                                reg);
+    data->SetLogicalStructure(log);
+
+    const char *names[3] = {"x", "y", "z"};
+    for (int d=0; d<3; d++)
+    {
+        eavlFloatArray *axis = new eavlFloatArray(names[d], 1, n);
+        for (int i=0; i<n; ++i)
+            axis->SetValue(i, float(i));
+        data->AddField(new eavlField(1, axis, eavlField::ASSOC_LOGICALDIM, d));
+    }
+    eavlCoordinates *coords = new eavlCoordinatesCartesian(log,
+                                            eavlCoordinatesCartesian::X,
+                                            eavlCoordinatesCartesian::Y,
+                                            eavlCoordinatesCartesian::Z);
+    coords->SetAxis(0, new eavlCoordinateAxisField("x"));
+    coords->SetAxis(1, new eavlCoordinateAxisField("y"));
+    coords->SetAxis(2, new eavlCoordinateAxisField("z"));
+    data->AddCoordinateSystem(coords);
+
+    eavlFloatArray *nodal = new eavlFloatArray("nodal", 1, n*n*n);
+    for (int k=0; k<n; ++k)
+        for (int j=0; j<n; ++j)
+            for (int i=0; i<n; ++i)
+                nodal->SetValue((k*n + j)*n + i, Value(i,j,k));
+    data->AddField(new eavlField(1, nodal, eavlField::ASSOC_POINTS));
+
+    eavlCellSetAllStructured *cells = new eavlCellSetAllStructured("cells",
+                                                                   reg);
+    data->AddCellSet(cells);
+    eavlCellSetSubset *subset = new eavlCellSetSubset(cells);
+    for (int c=0; c<cells->GetNumCells(); c+=stride)
+        subset->subset.push_back(c);
+    data->AddCellSet(subset);
+
+    int nsub = subset->GetNumCells();
+    eavlFloatArray *zonal = new eavlFloatArray("zonal", 1, nsub);
+    for (int c=0; c<nsub; ++c)
+        zonal->SetValue(c, float(c % 13));
+    data->AddField(new eavlField(0, zonal, eavlField::ASSOC_CELL_SET,
+                                 subset->GetName()));
+
+    data->AddCellSet(new eavlCellSetAllPoints("points", n*n*n));
+    return data;
+}
+
+static bool InRange(double v, double lo, double hi)
+{
+    return v >= lo && v <= hi;
+}
+
+// the cells a serial pass keeps
+static vector<int> Expected(eavlCellSet *cells, eavlField *field, double lo, double hi,
+                            bool allpoints)
+{
+    eavlArray *values = field->GetArray();
+    vector<int> kept;
+    for (int c=0; c<cells->GetNumCells(); c++)
+    {
+        bool keep;
+        if (field->GetAssociation() == eavlField::ASSOC_CELL_SET)
+        {
+            keep = InRange(values->GetComponentAsDouble(c,0), lo, hi);
+        }
+        else
+        {
+            eavlCell cell = cells->GetCellNodes(c);
+            int count = 0;
+            for (int j=0; j<cell.numIndices; j++)
+                count += InRange(values->GetComponentAsDouble(cell.indices[j],0),
+                                 lo, hi);
+            keep = allpoints ? (count == cell.numIndices) : (count > 0);
+        }
+        if (keep)
+            kept.push_back(c);
+    }
+    return kept;
+}
+
+static bool CheckThreshold(const string &what, eavlDataSet *data,
+                           const string &cellsetname,
+                           const string &fieldname,
+                           double lo, double hi, bool allpoints)
+{
+    eavlCellSet *cells = data->GetCellSet(cellsetname);
+    eavlField *field = data->GetField(fieldname);
+    vector<int> kept = Expected(cells, field, lo, hi, allpoints);
+
+    eavlThresholdMutator thresh;
+    thresh.SetDataSet(data);
+    thresh.SetField(fieldname);
+    thresh.SetRange(lo, hi);
+    thresh.SetCellSet(cellsetname);
+    thresh.SetNodalThresholdAllPointsRequired(allpoints);
+    thresh.Execute();
+
+    eavlCellSet *out = data->GetCellSet(data->GetNumCellSets()-1);
+    if (out->GetNumCells() != (int)kept.size())
+    {
+        cerr << what << ": kept " << out->GetNumCells()
+             << " cells, expected " << kept.size() << endl;
+        return false;
+    }
+    if (kept.empty())
+    {
+        cerr << what << ": the range should keep some cells\n";
+        return false;
+    }
+    for (size_t j=0; j<kept.size(); j++)
+    {
+        eavlCell a = out->GetCellNodes(j);
+        eavlCell b = cells->GetCellNodes(kept[j]);
+        bool same = (a.type == b.type && a.numIndices == b.numIndices);
+        for (int k=0; same && k<a.numIndices; k++)
+            same = (a.indices[k] == b.indices[k]);
+        if (!same)
+        {
+            cerr << what << ": output cell " << j << " isn't input cell "
+                 << kept[j] << endl;
+            return false;
+        }
+    }
+
+    // the subset's zonal field comes along with it
+    for (int f=0; f<data->GetNumFields(); f++)
+    {
+        eavlField *in = data->GetField(f);
+        if (in->GetAssociation() != eavlField::ASSOC_CELL_SET ||
+            in->GetAssocCellSet() != cellsetname)
+            continue;
+        eavlField *gathered = NULL;
+        for (int g=0; g<data->GetNumFields(); g++)
+        {
+            eavlField *o = data->GetField(g);
+            if (o->GetAssociation() == eavlField::ASSOC_CELL_SET &&
+                o->GetAssocCellSet() == out->GetName() &&
+                o->GetArray()->GetName() ==
+                    "subset_of_" + in->GetArray()->GetName())
+                gathered = o;
+        }
+        if (!gathered)
+        {
+            cerr << what << ": no gathered " << in->GetArray()->GetName()
+                 << endl;
+            return false;
+        }
+        for (size_t j=0; j<kept.size(); j++)
+        {
+            if (gathered->GetArray()->GetComponentAsDouble(j,0) !=
+                in->GetArray()->GetComponentAsDouble(kept[j],0))
+            {
+                cerr << what << ": gathered " << in->GetArray()->GetName()
+                     << " differs at " << j << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// thresholds a new grid, leaving the number of cells kept in nkept
+static bool Check(const string &what, int n, int stride,
+                  const string &cellsetname, const string &fieldname,
+                  double lo, double hi, bool allpoints, int &nkept)
+{
+    eavlDataSet *data = GenerateSubsetGrid(n, stride);
+    bool ok = CheckThreshold(what, data, cellsetname, fieldname,
+                             lo, hi, allpoints);
+    nkept = data->GetCellSet(data->GetNumCellSets()-1)->GetNumCells();
+    delete data;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 12;
+        if (n < 3)
+            THROW(eavlException,"Expected a size of at least 3");
+
+        string subset = "subset_of_cells";
+        int nkept, nstructured;
+
+        bool ok = true;
+        ok &= Check("subset, zonal", n, 2, subset, "zonal",
+                    2, 7, false, nkept);
+        ok &= Check("subset, nodal, some points", n, 2, subset, "nodal",
+                    3, 4, false, nkept);
+        ok &= Check("subset, nodal, all points", n, 2, subset, "nodal",
+                    1, 10, true, nkept);
+        ok &= Check("points, nodal", n, 2, "points", "nodal",
+                    5, 8, false, nkept);
+
+        // the structured cell set's result matches a subset of all its cells
+        ok &= Check("structured, nodal", n, 1, "cells", "nodal",
+                    3, 4, false, nstructured);
+        ok &= Check("whole subset, nodal", n, 1, subset, "nodal",
+                    3, 4, false, nkept);
+        if (nkept != nstructured)
+        {
+            cerr << "whole subset kept " << nkept << " cells, structured "
+                 << nstructured << endl;
+            ok = false;
+        }
+
+        if (!ok)
+            THROW(eavlException,"Threshold produced incorrect results");
+        cout << "threshold produced correct results on subsets and points\n";
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [size]\n";
+        return 1;
+    }
+
+    return 0;
+}
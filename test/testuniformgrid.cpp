@@ -0,0 +1,321 @@
+// Copyright 2010-2014 UT-Battelle, LLC.  See LICENSE.txt for more information.
+#include "eavl.h"
+#include "eavlCUDA.h"
+#include "eavlDataSet.h"
+#include "eavlException.h"
+#include "eavlExecutor.h"
+#include "eavlImplicitArray.h"
+#include "eavlIsosurfaceFilter.h"
+#include "eavlThresholdMutator.h"
+#include "eavlMapOp.h"
+#include "eavlReduceOp_1.h"
+#include "eavlVTKImporter.h"
+
+//
+// Builds a uniform grid, whose axes are implicit arrays, both with
+// AddUniformMesh and by importing a VTK structured points file, and the
+// same grid with stored rectilinear axes.  Runs an isosurface and a
+// threshold on each and checks the outputs are identical, and reads the
+// implicit axes through the eavlArray base class in a map and a reduce.
+//
+
+static const double origin[3] = {-1.5, 0.25, 2.};
+static const double spacing[3] = {0.125, 0.5, 0.25};
+
+static float Value(int i, int j, int k)
+{
+    return sin(0.4f*float(i)) + cos(0.3f*float(j)) + 0.2f*float(k);
+}
+
+// the nodal field both grids share
+static void AddNodal(eavlDataSet *data, const int dims[3])
+{
+    eavlFloatArray *nodal = new eavlFloatArray("nodal", 1,
+                                               dims[0]*dims[1]*dims[2]);
+    for (int k=0; k<dims[2]; ++k)
+        for (int j=0; j<dims[1]; ++j)
+            for (int i=0; i<dims[0]; ++i)
+                nodal->SetValue((k*dims[1] + j)*dims[0] + i, Value(i,j,k));
+    data->AddField(new eavlField(1, nodal, eavlField::ASSOC_POINTS));
+}
+
+static vector<string> CoordNames()
+{
+    vector<string> names;
+    names.push_back("xcoord");
+    names.push_back("ycoord");
+    names.push_back("zcoord");
+    return names;
+}
+
+static eavlDataSet *GenerateUniform(const int dims[3])
+{
+    eavlDataSet *data = new eavlDataSet;
+    AddUniformMesh(data, dims, origin, spacing, CoordNames(), true, "cells");
+    AddNodal(data, dims);
+    return data;
+}
+
+static eavlDataSet *GenerateRectilinear(const int dims[3])
+{
+    vector<vector<double> > coords(3);
+    for (int d=0; d<3; ++d)
+        for (int i=0; i<dims[d]; ++i)
+            coords[d].push_back(float(origin[d] + spacing[d] * double(i)));
+    eavlDataSet *data = new eavlDataSet;
+    AddRectilinearMesh(data, coords, CoordNames(), true, "cells");
+    AddNodal(data, dims);
+    return data;
+}
+
+// the same grid as a VTK structured points file, values and all
+static eavlDataSet *ImportStructuredPoints(const int dims[3])
+{
+    ostringstream out;
+    out << "# vtk DataFile Version 3.0\n"
+        << "uniform grid test\n"
+        << "ASCII\n"
+        << "DATASET STRUCTURED_POINTS\n"
+        << "DIMENSIONS " << dims[0] << " " << dims[1] << " " << dims[2] << "\n"
+        << "SPACING " << spacing[0] << " " << spacing[1] << " " << spacing[2] << "\n"
+        << "ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2] << "\n"
+        << "POINT_DATA " << dims[0]*dims[1]*dims[2] << "\n"
+        << "SCALARS nodal float 1\n"
+        << "LOOKUP_TABLE default\n";
+    out.precision(9);
+    for (int k=0; k<dims[2]; ++k)
+        for (int j=0; j<dims[1]; ++j)
+            for (int i=0; i<dims[0]; ++i)
+                out << Value(i,j,k) << "\n";
+    string file = out.str();
+
+    eavlVTKImporter importer(file.c_str(), file.size());
+    string mesh = importer.GetMeshList()[0];
+    eavlDataSet *data = importer.GetMesh(mesh, 0);
+    vector<string> fields = importer.GetFieldList(mesh);
+    for (size_t i=0; i<fields.size(); i++)
+        data->AddField(importer.GetField(fields[i], mesh, 0));
+    return data;
+}
+
+static bool CheckImplicitAxes(const string &what, eavlDataSet *data)
+{
+    for (int d=0; d<3; ++d)
+    {
+        eavlArray *axis = data->GetField(CoordNames()[d])->GetArray();
+        if (!dynamic_cast<eavlUniformArray<float>*>(axis))
+        {
+            cerr << what << ": axis " << d << " is a " << axis->className()
+                 << ", not a uniform array\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// the points, cells and fields of two data sets match exactly
+static bool Same(const string &what, eavlDataSet *a, eavlDataSet *b)
+{
+    if (a->GetNumPoints() != b->GetNumPoints() ||
+        a->GetNumCellSets() != b->GetNumCellSets())
+    {
+        cerr << what << ": " << a->GetNumPoints() << " and "
+             << b->GetNumPoints() << " points\n";
+        return false;
+    }
+    if (a->GetNumPoints() == 0)
+    {
+        cerr << what << ": expected some points\n";
+        return false;
+    }
+    for (int i=0; i<a->GetNumPoints(); ++i)
+    {
+        for (int c=0; c<3; ++c)
+        {
+            if (a->GetPoint(i,c) != b->GetPoint(i,c))
+            {
+                cerr << what << ": point " << i << " differs\n";
+                return false;
+            }
+        }
+    }
+    for (int s=0; s<a->GetNumCellSets(); ++s)
+    {
+        eavlCellSet *ca = a->GetCellSet(s);
+        eavlCellSet *cb = b->GetCellSet(s);
+        if (ca->GetNumCells() != cb->GetNumCells())
+        {
+            cerr << what << ": cell set " << s << " differs in size\n";
+            return false;
+        }
+        for (int e=0; e<ca->GetNumCells(); ++e)
+        {
+            eavlCell x = ca->GetCellNodes(e);
+            eavlCell y = cb->GetCellNodes(e);
+            bool same = (x.type == y.type && x.numIndices == y.numIndices);
+            for (int k=0; same && k<x.numIndices; ++k)
+                same = (x.indices[k] == y.indices[k]);
+            if (!same)
+            {
+                cerr << what << ": cell " << e << " of cell set " << s
+                     << " differs\n";
+                return false;
+            }
+        }
+    }
+    for (int f=0; f<b->GetNumFields(); ++f)
+    {
+        eavlArray *fb = b->GetField(f)->GetArray();
+        if (b->GetField(f)->GetAssociation() == eavlField::ASSOC_LOGICALDIM)
+            continue;
+        eavlArray *fa = a->GetField(fb->GetName())->GetArray();
+        if (fa->GetNumberOfTuples() != fb->GetNumberOfTuples())
+        {
+            cerr << what << ": field " << fb->GetName() << " differs in size\n";
+            return false;
+        }
+        for (int i=0; i<fb->GetNumberOfTuples(); ++i)
+        {
+            for (int c=0; c<fb->GetNumberOfComponents(); ++c)
+            {
+                if (fa->GetComponentAsDouble(i,c) != fb->GetComponentAsDouble(i,c))
+                {
+                    cerr << what << ": field " << fb->GetName()
+                         << " differs at " << i << endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool CheckFilters(const string &what, eavlDataSet *uniform,
+                         const string &cells, eavlDataSet *rect)
+{
+    bool ok = true;
+    eavlIsosurfaceFilter isoa, isob;
+    isoa.SetInput(uniform);
+    isob.SetInput(rect);
+    isoa.SetCellSet(cells);
+    isob.SetCellSet("cells");
+    isoa.SetField("nodal");
+    isob.SetField("nodal");
+    isoa.SetIsoValue(1.1);
+    isob.SetIsoValue(1.1);
+    isoa.Execute();
+    isob.Execute();
+    ok &= Same(what + " isosurface", isoa.GetOutput(), isob.GetOutput());
+
+    eavlDataSet *data[2] = {uniform, rect};
+    string cellsets[2] = {cells, "cells"};
+    for (int d=0; d<2; ++d)
+    {
+        eavlThresholdMutator thresh;
+        thresh.SetDataSet(data[d]);
+        thresh.SetField("nodal");
+        thresh.SetRange(0.5, 1.5);
+        thresh.SetCellSet(cellsets[d]);
+        thresh.Execute();
+    }
+    eavlCellSet *ta = uniform->GetCellSet(uniform->GetNumCellSets()-1);
+    eavlCellSet *tb = rect->GetCellSet(rect->GetNumCellSets()-1);
+    if (ta->GetNumCells() == 0 || ta->GetNumCells() != tb->GetNumCells())
+    {
+        cerr << what << " threshold: kept " << ta->GetNumCells() << " and "
+             << tb->GetNumCells() << " cells\n";
+        ok = false;
+    }
+    ok &= Same(what + " threshold", uniform, rect);
+    return ok;
+}
+
+struct NegateFunctor
+{
+    EAVL_FUNCTOR float operator()(float x) { return -x; }
+};
+
+// reads an implicit axis through the eavlArray base class
+static bool CheckGenericDispatch(eavlDataSet *data, int n)
+{
+    bool ok = true;
+    eavlArray *axis = data->GetField("xcoord")->GetArray();
+    eavlFloatArray *negated = new eavlFloatArray("negated", 1, n);
+    eavlFloatArray *sum = new eavlFloatArray("sum", 1, 1);
+    eavlExecutor::AddOperation(
+        new_eavlMapOp(eavlOpArgs(eavlIndexable<eavlArray>(axis)),
+                      eavlOpArgs(negated), NegateFunctor()),
+        "negate an implicit axis");
+    eavlExecutor::AddOperation(
+        new eavlReduceOp_1<eavlAddFunctor<float> >(axis, sum,
+                                                   eavlAddFunctor<float>()),
+        "sum an implicit axis");
+    eavlExecutor::Go();
+    float expected = 0;
+    for (int i=0; i<n; ++i)
+    {
+        float x = float(axis->GetComponentAsDouble(i,0));
+        expected += x;
+        if (negated->GetValue(i) != -x)
+        {
+            cerr << "generic map: value " << i << " is "
+                 << negated->GetValue(i) << " but expected " << -x << endl;
+            ok = false;
+            break;
+        }
+    }
+    if (fabs(sum->GetValue(0) - expected) > 1e-4 * (1 + fabs(expected)))
+    {
+        cerr << "generic reduce: sum is " << sum->GetValue(0)
+             << " but expected " << expected << endl;
+        ok = false;
+    }
+    delete negated;
+    delete sum;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        eavlExecutor::SetExecutionMode(eavlExecutor::ForceCPU);
+        eavlInitializeGPU();
+
+        if (argc > 2)
+            THROW(eavlException,"Incorrect number of arguments");
+
+        int n = (argc > 1) ? atoi(argv[1]) : 20;
+        if (n < 3)
+            THROW(eavlException,"Expected a size of at least 3");
+        int dims[3] = {n, n-1, n+2};
+
+        bool ok = true;
+        eavlDataSet *uniform = GenerateUniform(dims);
+        eavlDataSet *imported = ImportStructuredPoints(dims);
+        eavlDataSet *rect = GenerateRectilinear(dims);
+        eavlDataSet *rect2 = GenerateRectilinear(dims);
+        ok &= CheckImplicitAxes("AddUniformMesh", uniform);
+        ok &= CheckImplicitAxes("structured points", imported);
+        ok &= CheckGenericDispatch(uniform, dims[0]);
+        ok &= CheckFilters("uniform", uniform, "cells", rect);
+        ok &= CheckFilters("structured points", imported,
+                           "StructuredPointsCells", rect2);
+
+        if (!ok)
+            THROW(eavlException,"Uniform grids differed from rectilinear ones");
+        cout << "uniform grids matched rectilinear ones\n";
+        delete uniform;
+        delete imported;
+        delete rect;
+        delete rect2;
+    }
+    catch (const eavlException &e)
+    {
+        cerr << e.GetErrorText() << endl;
+        cerr << "\nUsage: "<<argv[0]<<" [size]\n";
+        return 1;
+    }
+
+    return 0;
+}